@@ -0,0 +1,99 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+#include "fateman1.hpp"
+#include "pearce1.hpp"
+
+#define BOOST_TEST_MODULE division_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <iostream>
+
+#include <boost/lexical_cast.hpp>
+
+#include <mp++/integer.hpp>
+
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/settings.hpp>
+
+#include "simple_timer.hpp"
+
+using namespace piranha;
+
+using p_type = polynomial<mppp::integer<2>, kronecker_monomial<>>;
+
+// Divide back the products of Fateman's and Pearce's multiplication tests number 1,
+// and compute the GCD of two products sharing a common factor. The first elapsed time
+// printed in each test refers to the multiplication.
+
+BOOST_AUTO_TEST_CASE(division_fateman1_test)
+{
+    settings::set_thread_binding(true);
+    if (boost::unit_test::framework::master_test_suite().argc > 1) {
+        settings::set_n_threads(
+            boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+    }
+    const auto res = fateman1<mppp::integer<2>, kronecker_monomial<>>();
+    p_type x("x"), y("y"), z("z"), t("t");
+    const auto f = (x + y + z + t + 1).pow(20);
+    p_type q;
+    {
+        std::cout << "Division: ";
+        simple_timer st;
+        q = p_type::divexact(res, f);
+    }
+    BOOST_CHECK_EQUAL(q, f + 1);
+}
+
+BOOST_AUTO_TEST_CASE(division_pearce1_test)
+{
+    const auto res = pearce1<mppp::integer<2>, kronecker_monomial<>>();
+    p_type x("x"), y("y"), z("z"), t("t"), u("u");
+    const auto g = (u + t + z * z * 2 + y * y * y * 3 + x * x * x * x * x * 5 + 1).pow(12);
+    p_type q;
+    {
+        std::cout << "Division: ";
+        simple_timer st;
+        q = p_type::divexact(res, g);
+    }
+    BOOST_CHECK_EQUAL(q.size(), 6188u);
+}
+
+BOOST_AUTO_TEST_CASE(division_gcd_test)
+{
+    p_type x("x"), y("y"), z("z"), t("t");
+    const auto f = (x + y + z + t + 1).pow(8), g = (x - y + 2 * z * t + 3).pow(6), h = (x * y + z - t + 5).pow(6);
+    const auto a = f * g, b = f * h;
+    p_type res;
+    {
+        std::cout << "GCD: ";
+        simple_timer st;
+        res = p_type::gcd(a, b);
+    }
+    BOOST_CHECK_EQUAL(res, f);
+}
@@ -29,11 +29,16 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE evaluate_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <vector>
+
 #include <mp++/integer.hpp>
 
 #include <piranha/integer.hpp>
 #include <piranha/kronecker_monomial.hpp>
+#include <piranha/lambdify.hpp>
 #include <piranha/rational.hpp>
+#include <piranha/series_evaluator.hpp>
+#include <piranha/symbol_utils.hpp>
 
 #include "pearce1.hpp"
 #include "simple_timer.hpp"
@@ -57,6 +62,12 @@ BOOST_AUTO_TEST_CASE(evaluate_test)
             simple_timer t;
             std::cout << math::evaluate<double>(ret1, {{"x", 1.}, {"y", 1.}, {"z", 1.}, {"t", 1.}, {"u", 1.}}) << '\n';
         }
+        {
+            series_evaluator<decltype(ret1)> ev(ret1);
+            std::cout << "Timing evaluation via series_evaluator, integer: ";
+            simple_timer t;
+            std::cout << ev(symbol_fmap<integer>{{"x", 1_z}, {"y", 1_z}, {"z", 1_z}, {"t", 1_z}, {"u", 1_z}}) << '\n';
+        }
     }
     {
         std::cout << "Timing multiplication, double:\n";
@@ -66,6 +77,45 @@ BOOST_AUTO_TEST_CASE(evaluate_test)
             simple_timer t;
             std::cout << math::evaluate<double>(ret1, {{"x", 1.}, {"y", 1.}, {"z", 1.}, {"t", 1.}, {"u", 1.}}) << '\n';
         }
+        // Repeated evaluation at different points, as in the evaluation of a time series at many epochs.
+        const unsigned n_evals = 10u;
+        auto make_dict = [](unsigned i) {
+            const double v = 1. + i / 100.;
+            return symbol_fmap<double>{{"x", v}, {"y", v}, {"z", v}, {"t", v}, {"u", v}};
+        };
+        {
+            std::cout << "Timing " << n_evals << " evaluations via math::evaluate(), double: ";
+            simple_timer t;
+            double acc = 0;
+            for (unsigned i = 0u; i < n_evals; ++i) {
+                acc += math::evaluate(ret1, make_dict(i));
+            }
+            std::cout << acc << '\n';
+        }
+        {
+            std::cout << "Timing " << n_evals << " evaluations via series_evaluator, double (including setup): ";
+            simple_timer t;
+            series_evaluator<decltype(ret1)> ev(ret1);
+            double acc = 0;
+            for (unsigned i = 0u; i < n_evals; ++i) {
+                acc += ev(make_dict(i));
+            }
+            std::cout << acc << '\n';
+        }
+        {
+            std::cout << "Timing " << n_evals << " evaluations via lambdified::batch(), double (including setup): ";
+            simple_timer t;
+            auto l = math::lambdify<double>(ret1, {"x", "y", "z", "t", "u"});
+            std::vector<std::vector<double>> points;
+            for (unsigned i = 0u; i < n_evals; ++i) {
+                points.emplace_back(5u, 1. + i / 100.);
+            }
+            double acc = 0;
+            for (const auto &r : l.batch(points)) {
+                acc += r;
+            }
+            std::cout << acc << '\n';
+        }
     }
     {
         std::cout << "Timing multiplication, rational:\n";
@@ -0,0 +1,103 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#define BOOST_TEST_MODULE evaluation_plan_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include <piranha/evaluation_plan.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+#include "gastineau1.hpp"
+#include "pearce1.hpp"
+#include "simple_timer.hpp"
+
+using namespace piranha;
+
+static const unsigned n_evals = 10u;
+
+// Compare n_evals evaluations at different points via math::evaluate() and via an evaluation plan.
+template <typename P>
+static inline void run_evals(const P &p)
+{
+    const auto &ss = p.get_symbol_set();
+    auto make_values = [&ss](unsigned i) { return std::vector<double>(ss.size(), 1. - i / 1000.); };
+    auto make_dict = [&ss, &make_values](unsigned i) {
+        const auto values = make_values(i);
+        symbol_fmap<double> retval;
+        auto it = values.begin();
+        for (const auto &s : ss) {
+            retval.emplace(s, *it++);
+        }
+        return retval;
+    };
+    {
+        std::cout << "Timing " << n_evals << " evaluations via math::evaluate(): ";
+        simple_timer t;
+        double acc = 0;
+        for (unsigned i = 0u; i < n_evals; ++i) {
+            acc += math::evaluate(p, make_dict(i));
+        }
+        std::cout << acc << '\n';
+    }
+    {
+        std::cout << "Timing the construction of the evaluation plan: ";
+        evaluation_plan<P, double> plan = [&p]() {
+            simple_timer t;
+            return evaluation_plan<P, double>(p);
+        }();
+        std::cout << "Number of terms: " << plan.size() << ", number of multiplications: " << plan.n_multiplications()
+                  << '\n';
+        std::cout << "Timing " << n_evals << " evaluations via the evaluation plan: ";
+        simple_timer t;
+        double acc = 0;
+        for (unsigned i = 0u; i < n_evals; ++i) {
+            acc += plan(make_values(i));
+        }
+        std::cout << acc << '\n';
+    }
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_pearce1_test)
+{
+    settings::set_thread_binding(true);
+    std::cout << "Timing multiplication, pearce1:\n";
+    run_evals(pearce1<integer, kronecker_monomial<>>());
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_gastineau1_test)
+{
+    std::cout << "Timing multiplication, gastineau1:\n";
+    run_evals(gastineau1<integer, kronecker_monomial<>>());
+}
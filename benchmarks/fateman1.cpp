@@ -32,6 +32,7 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <boost/lexical_cast.hpp>
+#include <iostream>
 
 #include <mp++/integer.hpp>
 
@@ -39,6 +40,8 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/settings.hpp>
 
+#include "simple_timer.hpp"
+
 using namespace piranha;
 
 // Fateman's polynomial multiplication test number 1. Calculate:
@@ -54,3 +57,47 @@ BOOST_AUTO_TEST_CASE(fateman1_test)
     }
     BOOST_CHECK_EQUAL((fateman1<mppp::integer<2>, kronecker_monomial<>>().size()), 135751u);
 }
+
+// Comparison of the exponentiation strategies on the computation of f.
+
+BOOST_AUTO_TEST_CASE(fateman1_pow_test)
+{
+    using p_type = polynomial<integer, kronecker_monomial<>>;
+    p_type x("x"), y("y"), z("z"), t("t");
+    const auto f = x + y + z + t + 1;
+    p_type ref(f);
+    {
+        std::cout << "Timing repeated multiplications: ";
+        simple_timer st;
+        for (auto i = 1; i < 20; ++i) {
+            ref *= f;
+        }
+    }
+    p_type ret;
+    {
+        std::cout << "Timing multinomial expansion: ";
+        simple_timer st;
+        ret = f._pow_multinomial(20);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    {
+        std::cout << "Timing Miller's recurrence: ";
+        simple_timer st;
+        ret = f._pow_miller(20);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    {
+        std::cout << "Timing exponentiation by squaring: ";
+        simple_timer st;
+        ret = f._pow_squaring(20);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    p_type::clear_pow_cache();
+    {
+        std::cout << "Timing pow() with automatic selection: ";
+        simple_timer st;
+        ret = f.pow(20);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    BOOST_CHECK_EQUAL(ret.size(), 10626u);
+}
@@ -38,10 +38,13 @@ see https://www.gnu.org/licenses/. */
 #include <iostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <piranha/detail/demangle.hpp>
+#include <piranha/hash_set.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/settings.hpp>
+#include <piranha/thread_pool.hpp>
 
 #include "simple_timer.hpp"
 
@@ -126,3 +129,131 @@ BOOST_AUTO_TEST_CASE(memory_parallel_array_test)
         throw;
     }
 }
+
+// Number of elements inserted in the hash set test. The table is sized so that
+// most insertions land in overflow nodes.
+static const long hs_size = 20000000l;
+
+BOOST_AUTO_TEST_CASE(memory_hash_set_arena_test)
+{
+    settings::set_thread_binding(true);
+    if (boost::unit_test::framework::master_test_suite().argc > 1) {
+        settings::set_n_threads(
+            boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+    }
+    using hs_type = hash_set<long>;
+    try {
+        std::cout << "Testing hash_set arena\n"
+                     "======================\n";
+        for (unsigned i = 0u; i < settings::get_n_threads(); ++i) {
+            const unsigned n_threads = i + 1u;
+            std::cout << "n = " << n_threads << '\n';
+            {
+                std::cout << "Baseline new/delete: ";
+                simple_timer t;
+                // Node-sized allocations and deallocations through the global allocator,
+                // one call per overflow node.
+                std::vector<unsigned long long> counts(n_threads);
+                auto f = [n_threads, &counts](unsigned t_idx) {
+                    std::vector<std::pair<long, void *> *> v;
+                    for (long j = t_idx; j < hs_size; j += n_threads) {
+                        if (j % 4) {
+                            v.push_back(::new std::pair<long, void *>(j, nullptr));
+                        }
+                    }
+                    for (auto p : v) {
+                        ::delete p;
+                    }
+                    counts[t_idx] = v.size();
+                };
+                future_list<decltype(f(0u))> f_list;
+                try {
+                    for (unsigned t_idx = 0u; t_idx < n_threads; ++t_idx) {
+                        f_list.push_back(thread_pool::enqueue(t_idx, f, t_idx));
+                    }
+                    f_list.wait_all();
+                    f_list.get_all();
+                } catch (...) {
+                    f_list.wait_all();
+                    throw;
+                }
+                unsigned long long n_allocs = 0u;
+                for (auto c : counts) {
+                    n_allocs += c;
+                }
+                std::cout << n_allocs << " allocations\n";
+            }
+            {
+                std::cout << "Arena: ";
+                simple_timer t;
+                hs_type h;
+                // Size the table so that on average 4 elements share a bucket.
+                h.rehash(static_cast<hs_type::size_type>(hs_size / 4), n_threads);
+                const auto bc = h.bucket_count();
+                // Each thread inserts into its own zone of buckets, like the series multipliers do.
+                auto f = [&h, bc, n_threads](unsigned t_idx) {
+                    const auto start = static_cast<hs_type::size_type>(bc / n_threads * t_idx),
+                               end = (t_idx == n_threads - 1u) ? bc : static_cast<hs_type::size_type>(
+                                                                         bc / n_threads * (t_idx + 1u));
+                    for (long j = 0; j < hs_size; ++j) {
+                        const auto b = h._bucket(j);
+                        if (b >= start && b < end) {
+                            h._unique_insert(j, b);
+                        }
+                    }
+                };
+                future_list<decltype(f(0u))> f_list;
+                try {
+                    for (unsigned t_idx = 0u; t_idx < n_threads; ++t_idx) {
+                        f_list.push_back(thread_pool::enqueue(t_idx, f, t_idx));
+                    }
+                    f_list.wait_all();
+                    f_list.get_all();
+                } catch (...) {
+                    f_list.wait_all();
+                    throw;
+                }
+                h._update_size(static_cast<hs_type::size_type>(hs_size));
+                const auto stats = h._arena_stats();
+                std::cout << stats.first << " nodes in " << stats.second << " slab allocations\n";
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        std::cout << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        throw;
+    }
+}
+
+// Number of small hash sets created in the small tables test, and number of elements in each.
+static const std::size_t n_small_tables = 1000000u;
+static const long small_table_size = 8l;
+
+BOOST_AUTO_TEST_CASE(memory_hash_set_small_tables_test)
+{
+    using hs_type = hash_set<long>;
+    try {
+        std::cout << "Testing small hash_sets\n"
+                     "=======================\n";
+        simple_timer t;
+        // Small tables, like the coefficients of Poisson series or the terms of echelon series: most of them
+        // have no collisions at all, and they should not pay for an arena.
+        std::size_t n_arenas = 0u, n_nodes = 0u, n_slabs = 0u;
+        for (std::size_t i = 0u; i < n_small_tables; ++i) {
+            hs_type h;
+            for (long j = 0; j < small_table_size; ++j) {
+                h.insert(static_cast<long>(i) * small_table_size + j * 3);
+            }
+            const auto stats = h._arena_stats();
+            n_arenas += stats.second ? 1u : 0u;
+            n_nodes += stats.first;
+            n_slabs += stats.second;
+        }
+        std::cout << n_small_tables << " tables, " << n_arenas << " with an arena, " << n_nodes << " nodes in "
+                  << n_slabs << " slab allocations\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        std::cout << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        throw;
+    }
+}
@@ -35,6 +35,7 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/integer.hpp>
 #include <piranha/kronecker_monomial.hpp>
+#include <piranha/polynomial.hpp>
 
 #include "pearce1.hpp"
 #include "simple_timer.hpp"
@@ -68,3 +69,42 @@ BOOST_AUTO_TEST_CASE(pearce1_test)
         ret2 = ret1.truncate_degree(30, {"u", "z"});
     }
 }
+
+// Comparison of the exponentiation strategies in presence of auto-truncation.
+
+BOOST_AUTO_TEST_CASE(power_series_truncated_pow_test)
+{
+    using p_type = polynomial<integer, kronecker_monomial<>>;
+    p_type x("x"), y("y"), z("z"), t("t"), u("u");
+    const auto f = 1 + x + y + z + t + u + x * y * z + 2 * z * t * u;
+    p_type::set_auto_truncate_degree(30);
+    p_type ref(f);
+    {
+        std::cout << "Timing truncated repeated multiplications: ";
+        simple_timer st;
+        for (auto i = 1; i < 40; ++i) {
+            ref *= f;
+        }
+    }
+    p_type ret;
+    {
+        std::cout << "Timing truncated exponentiation by squaring: ";
+        simple_timer st;
+        ret = f._pow_squaring(40);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    {
+        std::cout << "Timing truncated Miller's recurrence: ";
+        simple_timer st;
+        ret = f._pow_miller(40);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    p_type::clear_pow_cache();
+    {
+        std::cout << "Timing truncated pow() with automatic selection: ";
+        simple_timer st;
+        ret = f.pow(40);
+    }
+    BOOST_CHECK_EQUAL(ret, ref);
+    p_type::unset_auto_truncate_degree();
+}
@@ -35,14 +35,20 @@ see https://www.gnu.org/licenses/. */
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
+#include <piranha/chunked_file.hpp>
 #include <piranha/config.hpp>
 #include <piranha/exceptions.hpp>
 #include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/mapped_series.hpp>
 #include <piranha/monomial.hpp>
 #include <piranha/polynomial.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
 
 #include "pearce1.hpp"
 #include "simple_timer.hpp"
@@ -164,7 +170,8 @@ BOOST_AUTO_TEST_CASE(s11n_series_file_test)
     pt tmp;
     for (auto f : {data_format::boost_binary, data_format::boost_portable, data_format::msgpack_binary,
                    data_format::msgpack_portable}) {
-        for (auto c : {compression::none, compression::bzip2, compression::gzip, compression::zlib}) {
+        for (auto c :
+             {compression::none, compression::bzip2, compression::gzip, compression::zlib, compression::zstd}) {
             auto fn = static_cast<int>(f);
             auto cn = static_cast<int>(c);
             tmp_file file;
@@ -187,3 +194,99 @@ BOOST_AUTO_TEST_CASE(s11n_series_file_test)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(s11n_series_mapped_test)
+{
+    // NOTE: the mapped format requires coefficients and keys with a bitwise representation.
+    std::cout << "Multiplication time: ";
+    const auto res = pearce1<double, k_monomial>();
+    std::cout << '\n';
+    using pt = decltype(res * res);
+    const symbol_fmap<double> dict{{"x", .1}, {"y", .2}, {"z", .3}, {"t", .4}, {"u", .5}};
+    for (auto f : {data_format::boost_binary, data_format::msgpack_portable}) {
+        const auto fn = static_cast<int>(f);
+        tmp_file file;
+        try {
+            simple_timer t;
+            save_file(res, file.name(), f, compression::none);
+            std::cout << "File save, " << fn << ": ";
+        } catch (const not_implemented_error &) {
+            std::cout << "Not supported: " << fn << '\n';
+            continue;
+        }
+        pt tmp;
+        {
+            simple_timer t;
+            load_file(tmp, file.name(), f, compression::none);
+            std::cout << "File load, " << fn << ": ";
+        }
+        std::cout << "File size, " << fn << ": " << filesize(file.name()) << '\n';
+        BOOST_CHECK_EQUAL(tmp, res);
+        std::cout << '\n';
+    }
+    tmp_file file;
+    {
+        simple_timer t;
+        save_mapped_file(res, file.name());
+        std::cout << "Mapped file save: ";
+    }
+    std::cout << "Mapped file size: " << filesize(file.name()) << '\n';
+    std::unique_ptr<mapped_series<pt>> m;
+    {
+        simple_timer t;
+        m.reset(new mapped_series<pt>(file.name()));
+        std::cout << "Mapped file open: ";
+    }
+    {
+        simple_timer t;
+        const auto ev = m->evaluate(dict);
+        std::cout << "Mapped file evaluation (" << ev << "): ";
+    }
+    pt tmp;
+    {
+        simple_timer t;
+        tmp = m->thaw(1u);
+        std::cout << "Mapped file thaw, 1 thread: ";
+    }
+    BOOST_CHECK_EQUAL(tmp, res);
+    tmp = pt{};
+    {
+        simple_timer t;
+        tmp = m->thaw();
+        std::cout << "Mapped file thaw, " << settings::get_n_threads() << " threads: ";
+    }
+    BOOST_CHECK_EQUAL(tmp, res);
+}
+
+BOOST_AUTO_TEST_CASE(s11n_series_chunked_test)
+{
+    std::cout << "Multiplication time: ";
+    const auto res = pearce1<integer, monomial<signed char>>();
+    std::cout << '\n';
+    using pt = decltype(res * res);
+    pt tmp;
+    for (auto f : {data_format::boost_binary, data_format::msgpack_binary}) {
+        for (auto c :
+             {compression::none, compression::bzip2, compression::gzip, compression::zlib, compression::zstd}) {
+            auto fn = static_cast<int>(f);
+            auto cn = static_cast<int>(c);
+            tmp_file file;
+            try {
+                simple_timer t;
+                save_chunked_file(res, file.name(), f, c);
+                std::cout << "Chunked file save, " << fn << ", " << cn << ": ";
+            } catch (const not_implemented_error &) {
+                std::cout << "Not supported: " << fn << ", " << cn << '\n';
+                continue;
+            }
+            {
+                simple_timer t;
+                load_chunked_file(tmp, file.name());
+                std::cout << "Chunked file load, " << fn << ", " << cn << ": ";
+            }
+            std::cout << "Chunked file size, " << fn << ", " << cn << ": " << filesize(file.name()) << '\n';
+            BOOST_CHECK_EQUAL(tmp, res);
+            std::cout << '\n';
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+#include <piranha/polynomial.hpp>
+
+#define BOOST_TEST_MODULE small_products_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/tuning.hpp>
+
+using namespace piranha;
+
+using p_type = polynomial<integer, k_monomial>;
+
+// Expose the plain multiplication routine, which was used for small Kronecker products
+// before the introduction of the estimation-free Kronecker multiplication.
+struct plain_mult : series_multiplier<p_type> {
+    using series_multiplier<p_type>::series_multiplier;
+    p_type run() const
+    {
+        return this->plain_multiplication();
+    }
+};
+
+// Build a random sparse polynomial with roughly n terms in 4 variables.
+static p_type random_poly(unsigned n, std::mt19937 &eng)
+{
+    p_type x("x"), y("y"), z("z"), t("t"), retval;
+    std::uniform_int_distribution<int> e_dist(0, 12), c_dist(-10, 10);
+    for (unsigned i = 0u; i < n; ++i) {
+        retval += c_dist(eng) * x.pow(e_dist(eng)) * y.pow(e_dist(eng)) * z.pow(e_dist(eng)) * t.pow(e_dist(eng));
+    }
+    return retval;
+}
+
+template <typename F>
+static double time_it(unsigned n_rep, const F &f)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned i = 0u; i < n_rep; ++i) {
+        f();
+    }
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start)
+                   .count())
+           / n_rep;
+}
+
+// Sweep the operand sizes across the estimation threshold, comparing the plain multiplication, the
+// Kronecker multiplication with size estimation and the Kronecker multiplication without estimation.
+BOOST_AUTO_TEST_CASE(small_products_test)
+{
+    settings::set_n_threads(1u);
+    std::mt19937 eng;
+    std::cout << "size\tplain (us)\testimated (us)\tno estimate (us)\n";
+    for (unsigned n = 25u; n <= 800u; n *= 2u) {
+        const auto f = random_poly(n, eng), g = random_poly(n, eng);
+        const unsigned n_rep = 20000u / n + 1u;
+        const auto t_plain = time_it(n_rep, [&f, &g]() { return plain_mult(f, g).run(); });
+        tuning::set_estimate_threshold(0u);
+        const auto res_est = f * g;
+        const auto t_est = time_it(n_rep, [&f, &g]() { return f * g; });
+        tuning::set_estimate_threshold(100000u);
+        BOOST_CHECK_EQUAL(f * g, res_est);
+        const auto t_no_est = time_it(n_rep, [&f, &g]() { return f * g; });
+        std::cout << f.size() << '\t' << t_plain << '\t' << t_est << '\t' << t_no_est << '\n';
+    }
+    tuning::reset_estimate_threshold();
+    settings::reset_n_threads();
+}
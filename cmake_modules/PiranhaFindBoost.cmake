@@ -13,7 +13,7 @@ if(PIRANHA_WITH_BOOST_STACKTRACE)
 endif()
 
 # Boost::iostreams is needed if any compression is enabled (in which case we need the iostreams filters).
-if(PIRANHA_WITH_ZLIB OR PIRANHA_WITH_BZIP2)
+if(PIRANHA_WITH_ZLIB OR PIRANHA_WITH_BZIP2 OR PIRANHA_WITH_ZSTD)
 	list(APPEND _PIRANHA_REQUIRED_BOOST_LIBS iostreams)
 endif()
 
@@ -28,7 +28,10 @@ endif()
 
 message(STATUS "Required Boost libraries: ${_PIRANHA_REQUIRED_BOOST_LIBS}")
 
-if(PIRANHA_WITH_BOOST_STACKTRACE)
+if(PIRANHA_WITH_ZSTD)
+	# The zstd filter of Boost iostreams is available since 1.67.
+	find_package(Boost 1.67.0 REQUIRED COMPONENTS "${_PIRANHA_REQUIRED_BOOST_LIBS}")
+elseif(PIRANHA_WITH_BOOST_STACKTRACE)
 	# Boost stacktrace is available since 1.65.
 	find_package(Boost 1.65.0 REQUIRED COMPONENTS "${_PIRANHA_REQUIRED_BOOST_LIBS}")
 else()
@@ -0,0 +1,14 @@
+# NOTE: CMake does not ship a module for finding zstd, look for the header and the library directly.
+find_path(ZSTD_INCLUDE_DIR NAMES zstd.h)
+find_library(ZSTD_LIBRARY NAMES zstd zstd_static)
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+if(NOT ZSTD_FOUND)
+  message(FATAL_ERROR "zstd support was requested, but the zstd library could not be found.")
+endif()
+if(NOT TARGET Zstd::Zstd)
+  add_library(Zstd::Zstd UNKNOWN IMPORTED)
+  set_target_properties(Zstd::Zstd PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIR}")
+  set_property(TARGET Zstd::Zstd APPEND PROPERTY IMPORTED_LOCATION "${ZSTD_LIBRARY}")
+endif()
@@ -56,6 +56,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math.hpp>
 #include <piranha/math/gcd3.hpp>
 #include <piranha/math/is_one.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/rational.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/series.hpp>
@@ -329,6 +330,23 @@ private:
     void finalise_impl(T &) const
     {
     }
+    // Attach the number of terms, buckets and collisions (i.e., terms which do not occupy the first slot
+    // of their bucket) of the container of a multiplication result to a profiler section.
+    static void profile_buckets(profiler::scope &prof, const container_type &container)
+    {
+        if (!prof.active()) {
+            return;
+        }
+        unsigned long long collisions = 0u;
+        for (bucket_size_type i = 0u; i < container.bucket_count(); ++i) {
+            const auto &bl = container._get_bucket_list(i);
+            const auto n = static_cast<unsigned long long>(std::distance(bl.begin(), bl.end()));
+            collisions += n > 1u ? n - 1u : 0u;
+        }
+        prof.count("terms", container.size());
+        prof.count("buckets", container.bucket_count());
+        prof.count("collisions", collisions);
+    }
 
 public:
     /// Constructor.
@@ -362,6 +380,7 @@ public:
      */
     explicit base_series_multiplier(const Series &s1, const Series &s2) : m_ss(s1.get_symbol_set())
     {
+        profiler::scope prof("multiplication.setup");
         if (unlikely(s1.get_symbol_set() != s2.get_symbol_set())) {
             piranha_throw(std::invalid_argument, "incompatible arguments sets");
         }
@@ -398,6 +417,9 @@ public:
                                                      integer(settings::get_min_work_per_thread()))
                           : 1u;
         this->fill_term_pointers(*ctr1, *ctr2, m_v1, m_v2);
+        prof.count("terms1", m_v1.size());
+        prof.count("terms2", m_v2.size());
+        prof.count("threads", m_n_threads);
     }
 
 private:
@@ -566,6 +588,7 @@ protected:
         PIRANHA_TT_CHECK(is_function_object, MultFunctor, void, const size_type &, const size_type &);
         PIRANHA_TT_CHECK(std::is_constructible, MultFunctor, const base_series_multiplier &, Series &);
         PIRANHA_TT_CHECK(is_function_object, LimitFunctor, size_type, const size_type &);
+        profiler::scope prof("multiplication.estimate");
         // Cache these.
         const size_type size1 = m_v1.size(), size2 = m_v2.size();
         constexpr std::size_t result_size = MultArity;
@@ -591,21 +614,24 @@ protected:
         // just 1 trial per thread.
         const unsigned n_threads = (n_trials >= m_n_threads) ? m_n_threads : n_trials;
         piranha_assert(n_threads > 0u);
-        // Trials per thread. This will always be at least 1.
-        const unsigned tpt = n_trials / n_threads;
-        piranha_assert(tpt >= 1u);
         // The cumulative estimate.
         integer c_estimate(0);
         // Sync mutex - actually used only in multithreading.
         std::mutex mut;
-        // The estimation functor.
-        auto estimator = [&lf, size1, n_threads, tpt, this, &c_estimate, &mut, multiplier](unsigned thread_idx) {
+        // The vector of indices into m_v1, used as initial state for each trial.
+        std::vector<size_type> v_idx1_orig(piranha::safe_cast<typename std::vector<size_type>::size_type>(size1));
+        std::iota(v_idx1_orig.begin(), v_idx1_orig.end(), size_type(0));
+        // Per-thread temporary series.
+        std::vector<Series> tmps(static_cast<typename std::vector<Series>::size_type>(n_threads));
+        for (auto &tmp : tmps) {
+            tmp.set_symbol_set(m_ss);
+        }
+        // The estimation functor. It will run the trials in the [begin, end) range.
+        auto estimator = [&lf, n_threads, this, &c_estimate, &mut, multiplier, &v_idx1_orig,
+                          &tmps](const unsigned &thread_idx, const std::size_t &begin, const std::size_t &end) {
             piranha_assert(thread_idx < n_threads);
             // Vectors of indices into m_v1.
-            std::vector<size_type> v_idx1(piranha::safe_cast<typename std::vector<size_type>::size_type>(size1));
-            std::iota(v_idx1.begin(), v_idx1.end(), size_type(0));
-            // Copy in order to reset to initial state later.
-            const auto v_idx1_copy = v_idx1;
+            auto v_idx1 = v_idx1_orig;
             // Random number engine.
             std::mt19937 engine;
             // Uniform int distribution.
@@ -613,24 +639,19 @@ protected:
             dist_type dist;
             // Init the accumulated estimation for averaging later.
             integer acc(0);
-            // Number of trials for this thread - usual special casing for the last thread.
-            const unsigned cur_trials = (thread_idx == n_threads - 1u) ? (n_trials - thread_idx * tpt) : tpt;
-            // This should always be guaranteed because tpt is never 0.
-            piranha_assert(cur_trials > 0u);
-            // Create and setup the temp series.
-            Series tmp;
-            tmp.set_symbol_set(m_ss);
+            // The temp series.
+            auto &tmp = tmps[thread_idx];
             // Create the multiplier.
             MultFunctor mf(*this, tmp);
             // Go with the trials.
-            for (auto n = 0u; n < cur_trials; ++n) {
-                // Seed the engine. The seed should be the global trial number, accounting for multiple
-                // threads. This way the estimation will not depend on the number of threads.
-                engine.seed(static_cast<std::mt19937::result_type>(tpt * thread_idx + n));
+            for (auto n = begin; n != end; ++n) {
+                // Seed the engine. The seed is the trial number, so that the estimation will not depend
+                // on the number of threads or on which thread runs the trial.
+                engine.seed(static_cast<std::mt19937::result_type>(n));
                 // Reset the indices vector and re-randomise it.
                 // NOTE: we need to do this as every run inside this for loop must be completely independent
                 // of any previous run, we cannot keep any state.
-                v_idx1 = v_idx1_copy;
+                v_idx1 = v_idx1_orig;
                 std::shuffle(v_idx1.begin(), v_idx1.end(), engine);
                 // The counter. This will be increased each time a term-by-term multiplication
                 // does not generate a duplicate term.
@@ -694,27 +715,14 @@ protected:
                 c_estimate += acc;
             }
         };
-        // Run the estimation functor.
-        if (n_threads == 1u) {
-            estimator(0u);
-        } else {
-            future_list<void> f_list;
-            try {
-                for (unsigned i = 0u; i < n_threads; ++i) {
-                    f_list.push_back(thread_pool::enqueue(i, estimator, i));
-                }
-                // First let's wait for everything to finish.
-                f_list.wait_all();
-                // Then, let's handle the exceptions.
-                f_list.get_all();
-            } catch (...) {
-                f_list.wait_all();
-                throw;
-            }
-        }
+        // Run the estimation functor. The trials are distributed dynamically among the threads,
+        // one at a time, as their cost can vary considerably.
+        thread_pool::parallel_for(n_threads, n_trials, 1u, estimator);
         piranha_assert(c_estimate >= n_trials);
         // Return the mean.
-        return static_cast<bucket_size_type>(c_estimate / n_trials);
+        const auto retval = static_cast<bucket_size_type>(c_estimate / n_trials);
+        prof.count("estimate", retval);
+        return retval;
     }
     /// Estimate size of series multiplication (convenience overload)
     /**
@@ -858,6 +866,7 @@ protected:
         if (unlikely(n_threads == 0u)) {
             piranha_throw(std::invalid_argument, "invalid number of threads");
         }
+        profiler::scope prof("multiplication.sanitise");
         auto &container = retval._container();
         const auto &args = retval.get_symbol_set();
         // Reset the size to zero before doing anything.
@@ -880,6 +889,7 @@ protected:
                     ++it;
                 }
             }
+            profile_buckets(prof, container);
             return;
         }
         // Multi-thread implementation.
@@ -946,6 +956,7 @@ protected:
         }
         // Final update of the total count.
         container._update_size(static_cast<bucket_size_type>(global_count));
+        profile_buckets(prof, container);
     }
     /// A plain series multiplication routine.
     /**
@@ -1127,6 +1138,7 @@ protected:
      */
     void finalise_series(Series &s) const
     {
+        profiler::scope prof("multiplication.finalise");
         finalise_impl(s);
     }
 
@@ -0,0 +1,609 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_CHUNKED_FILE_HPP
+#define PIRANHA_CHUNKED_FILE_HPP
+
+#include <algorithm>
+#include <array>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/demangle.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/profiler.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
+#include <piranha/type_traits.hpp>
+
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#endif
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Compression and decompression of a chunk held in memory.
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+
+template <typename CompressionFilter>
+inline std::string chunk_compress_impl(const std::string &in)
+{
+    std::string retval;
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(CompressionFilter{});
+        out.push(boost::iostreams::back_inserter(retval));
+        out.write(in.data(), safe_cast<std::streamsize>(in.size()));
+        // NOTE: the filters are flushed when the stream is destroyed.
+    }
+    return retval;
+}
+
+template <typename DecompressionFilter>
+inline std::string chunk_decompress_impl(const std::string &in)
+{
+    std::string retval;
+    boost::iostreams::filtering_istream is;
+    is.push(DecompressionFilter{});
+    is.push(boost::iostreams::array_source(in.data(), in.size()));
+    boost::iostreams::copy(is, boost::iostreams::back_inserter(retval));
+    return retval;
+}
+
+#endif
+
+inline std::string chunk_compress(const std::string &in, compression c)
+{
+    switch (c) {
+        case compression::bzip2:
+            PIRANHA_BZIP2_CONDITIONAL(return chunk_compress_impl<boost::iostreams::bzip2_compressor>(in));
+        case compression::gzip:
+            PIRANHA_ZLIB_CONDITIONAL(return chunk_compress_impl<boost::iostreams::gzip_compressor>(in));
+        case compression::zlib:
+            PIRANHA_ZLIB_CONDITIONAL(return chunk_compress_impl<boost::iostreams::zlib_compressor>(in));
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(return chunk_compress_impl<boost::iostreams::zstd_compressor>(in));
+        case compression::none:
+            break;
+    }
+    return in;
+}
+
+inline std::string chunk_decompress(std::string &&in, compression c)
+{
+    switch (c) {
+        case compression::bzip2:
+            PIRANHA_BZIP2_CONDITIONAL(return chunk_decompress_impl<boost::iostreams::bzip2_decompressor>(in));
+        case compression::gzip:
+            PIRANHA_ZLIB_CONDITIONAL(return chunk_decompress_impl<boost::iostreams::gzip_decompressor>(in));
+        case compression::zlib:
+            PIRANHA_ZLIB_CONDITIONAL(return chunk_decompress_impl<boost::iostreams::zlib_decompressor>(in));
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(return chunk_decompress_impl<boost::iostreams::zstd_decompressor>(in));
+        case compression::none:
+            break;
+    }
+    return std::move(in);
+}
+
+// Serialization of a chunk of terms. A chunk is written with the same layout used for a whole series,
+// so that it can be deserialized directly into a series.
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+template <typename Series>
+using chunk_boost_enabler
+    = conjunction<has_boost_save<boost::archive::binary_oarchive, Series>,
+                  has_boost_save<boost::archive::text_oarchive, Series>,
+                  has_boost_load<boost::archive::binary_iarchive, Series>,
+                  has_boost_load<boost::archive::text_iarchive, Series>>;
+
+template <typename Archive, typename Series>
+inline void chunk_boost_save_terms(Archive &ar, const symbol_fset &ss,
+                                   const std::vector<const typename Series::term_type *> &terms, std::size_t begin,
+                                   std::size_t end)
+{
+    boost_save(ar, ss.size());
+    for (const auto &sym : ss) {
+        boost_save(ar, sym);
+    }
+    boost_save(ar, safe_cast<decltype(std::declval<const Series &>().size())>(end - begin));
+    for (auto i = begin; i != end; ++i) {
+        boost_save(ar, terms[i]->m_cf);
+        boost_save(ar, boost_s11n_key_wrapper<typename Series::term_type::key_type>{terms[i]->m_key, ss});
+    }
+}
+
+template <typename Series, enable_if_t<chunk_boost_enabler<Series>::value, int> = 0>
+inline std::string chunk_boost_save(const symbol_fset &ss, const std::vector<const typename Series::term_type *> &terms,
+                                    std::size_t begin, std::size_t end, data_format f)
+{
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    {
+        if (f == data_format::boost_binary) {
+            boost::archive::binary_oarchive oa(oss);
+            chunk_boost_save_terms<boost::archive::binary_oarchive, Series>(oa, ss, terms, begin, end);
+        } else {
+            boost::archive::text_oarchive oa(oss);
+            chunk_boost_save_terms<boost::archive::text_oarchive, Series>(oa, ss, terms, begin, end);
+        }
+    }
+    return oss.str();
+}
+
+template <typename Series, enable_if_t<chunk_boost_enabler<Series>::value, int> = 0>
+inline void chunk_boost_load(Series &s, const std::string &buffer, data_format f)
+{
+    std::istringstream iss(buffer, std::ios::in | std::ios::binary);
+    if (f == data_format::boost_binary) {
+        boost::archive::binary_iarchive ia(iss);
+        boost_load(ia, s);
+    } else {
+        boost::archive::text_iarchive ia(iss);
+        boost_load(ia, s);
+    }
+}
+
+template <typename Series, enable_if_t<!chunk_boost_enabler<Series>::value, int> = 0>
+inline std::string chunk_boost_save(const symbol_fset &, const std::vector<const typename Series::term_type *> &,
+                                    std::size_t, std::size_t, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support serialization via Boost");
+}
+
+template <typename Series, enable_if_t<!chunk_boost_enabler<Series>::value, int> = 0>
+inline void chunk_boost_load(Series &, const std::string &, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support deserialization via Boost");
+}
+
+#else
+
+template <typename Series>
+inline std::string chunk_boost_save(const symbol_fset &, const std::vector<const typename Series::term_type *> &,
+                                    std::size_t, std::size_t, data_format)
+{
+    piranha_throw(not_implemented_error, "support for Boost serialization is not enabled");
+}
+
+template <typename Series>
+inline void chunk_boost_load(Series &, const std::string &, data_format)
+{
+    piranha_throw(not_implemented_error, "support for Boost serialization is not enabled");
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+// NOTE: the chunks are packed into a std::ostringstream wrapped for use with msgpack.
+template <typename Series>
+using chunk_msgpack_enabler = conjunction<has_msgpack_pack<msgpack_stream_wrapper<std::ostringstream>, Series>,
+                                          has_msgpack_convert<Series>>;
+
+template <typename Series, enable_if_t<chunk_msgpack_enabler<Series>::value, int> = 0>
+inline std::string chunk_msgpack_save(const symbol_fset &ss,
+                                      const std::vector<const typename Series::term_type *> &terms, std::size_t begin,
+                                      std::size_t end, data_format f)
+{
+    const auto mf = (f == data_format::msgpack_binary) ? msgpack_format::binary : msgpack_format::portable;
+    msgpack_stream_wrapper<std::ostringstream> oss(std::ios::out | std::ios::binary);
+    msgpack::packer<decltype(oss)> packer(oss);
+    packer.pack_array(2u);
+    packer.pack_array(safe_cast<std::uint32_t>(ss.size()));
+    for (const auto &sym : ss) {
+        msgpack_pack(packer, sym, mf);
+    }
+    packer.pack_array(safe_cast<std::uint32_t>(end - begin));
+    for (auto i = begin; i != end; ++i) {
+        packer.pack_array(2u);
+        msgpack_pack(packer, terms[i]->m_cf, mf);
+        terms[i]->m_key.msgpack_pack(packer, mf, ss);
+    }
+    return oss.str();
+}
+
+template <typename Series, enable_if_t<chunk_msgpack_enabler<Series>::value, int> = 0>
+inline void chunk_msgpack_load(Series &s, const std::string &buffer, data_format f)
+{
+    const auto mf = (f == data_format::msgpack_binary) ? msgpack_format::binary : msgpack_format::portable;
+    auto oh = msgpack::unpack(buffer.data(), buffer.size());
+    msgpack_convert(s, oh.get(), mf);
+}
+
+template <typename Series, enable_if_t<!chunk_msgpack_enabler<Series>::value, int> = 0>
+inline std::string chunk_msgpack_save(const symbol_fset &, const std::vector<const typename Series::term_type *> &,
+                                      std::size_t, std::size_t, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support serialization via msgpack");
+}
+
+template <typename Series, enable_if_t<!chunk_msgpack_enabler<Series>::value, int> = 0>
+inline void chunk_msgpack_load(Series &, const std::string &, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support deserialization via msgpack");
+}
+
+#else
+
+template <typename Series>
+inline std::string chunk_msgpack_save(const symbol_fset &, const std::vector<const typename Series::term_type *> &,
+                                      std::size_t, std::size_t, data_format)
+{
+    piranha_throw(not_implemented_error, "msgpack support is not enabled");
+}
+
+template <typename Series>
+inline void chunk_msgpack_load(Series &, const std::string &, data_format)
+{
+    piranha_throw(not_implemented_error, "msgpack support is not enabled");
+}
+
+#endif
+
+template <typename = void>
+struct chunked_constants {
+    static const char magic[8];
+    static const std::uint64_t version = 1u;
+};
+
+template <typename T>
+const char chunked_constants<T>::magic[8] = {'p', 'i', 'r', 'a', 'n', 'h', 'a', 'C'};
+
+template <typename T>
+const std::uint64_t chunked_constants<T>::version;
+
+// The integers in the header and in the index of a chunked file are always stored in little-endian order,
+// so that files written with the portable data formats remain portable.
+inline void chunked_write_u64(std::ofstream &ofile, std::uint64_t n)
+{
+    char buffer[8];
+    for (auto &c : buffer) {
+        c = static_cast<char>(static_cast<unsigned char>(n & 0xffu));
+        n >>= 8;
+    }
+    ofile.write(buffer, 8);
+}
+
+inline std::uint64_t chunked_read_u64(std::ifstream &ifile, const std::string &filename)
+{
+    unsigned char buffer[8];
+    ifile.read(reinterpret_cast<char *>(buffer), 8);
+    if (unlikely(!ifile.good())) {
+        piranha_throw(std::invalid_argument, "invalid chunked file '" + filename + "': the header is truncated");
+    }
+    std::uint64_t retval = 0u;
+    for (auto i = 8; i > 0; --i) {
+        retval = (retval << 8) | buffer[i - 1];
+    }
+    return retval;
+}
+
+// Number of threads to be used for the processing of n_chunks chunks containing n_terms terms in total.
+inline unsigned chunked_n_threads(std::size_t n_terms, std::size_t n_chunks)
+{
+    if (!n_terms) {
+        return 1u;
+    }
+    const auto n_threads = thread_pool::use_threads(integer(n_terms), integer(settings::get_min_work_per_thread()));
+    return static_cast<unsigned>(std::min<std::size_t>(n_threads, std::max<std::size_t>(n_chunks, 1u)));
+}
+} // namespace impl
+
+/// Save a series to a chunked file.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series.
+ *
+ * The terms of \p s are split into blocks of \p chunk_size terms, and each block is serialized with the data format
+ * \p f and compressed with the method \p c independently of the others. The blocks are serialized and compressed in
+ * parallel using the threads of piranha::thread_pool, and they are then written to the file \p filename preceded by
+ * a header recording the data and compression formats and an index of the blocks. Each block contains the symbol set
+ * of the series, and it has the same layout as a series serialized with \p f, hence the blocks can be deserialized
+ * independently. Files written by this function can be read back with piranha::load_chunked_file().
+ *
+ * If \p chunk_size is zero, a chunk size yielding a few blocks per thread will be chosen automatically. The
+ * header and the index of the file are stored in little-endian order, so that the portability of the file depends
+ * only on the data format \p f.
+ *
+ * @param s the series to be saved.
+ * @param filename the name of the output file.
+ * @param f the data format.
+ * @param c the compression format.
+ * @param chunk_size the number of terms in each block.
+ *
+ * @throws piranha::not_implemented_error if \p Series does not support serialization in the data format \p f, or if
+ * the compression format \p c is not available.
+ * @throws std::runtime_error if the file cannot be opened or written.
+ * @throws unspecified any exception thrown by:
+ * - the low-level serialization functions,
+ * - the public interface of the Boost iostreams library,
+ * - thread_pool::use_threads() and thread_pool::parallel_for(),
+ * - memory errors in standard containers,
+ * - piranha::safe_cast().
+ */
+template <typename Series, enable_if_t<is_series<Series>::value, int> = 0>
+inline void save_chunked_file(const Series &s, const std::string &filename, data_format f, compression c,
+                              std::size_t chunk_size = 0u)
+{
+    using term_type = typename Series::term_type;
+    profiler::scope prof("s11n.save_chunked_file");
+    const bool boost_f = (f == data_format::boost_binary || f == data_format::boost_portable);
+    // Collect pointers to the terms, in iteration order.
+    std::vector<const term_type *> terms;
+    terms.reserve(safe_cast<typename std::vector<const term_type *>::size_type>(s.size()));
+    for (const auto &t : s._container()) {
+        terms.push_back(&t);
+    }
+    const auto n_terms = terms.size();
+    if (!chunk_size) {
+        const auto n_threads = chunked_n_threads(n_terms, n_terms);
+        chunk_size = std::max<std::size_t>(n_terms / (4u * n_threads), 1024u);
+    }
+    // NOTE: there is always at least one chunk, so that the symbol set is stored also for empty series.
+    const std::size_t n_chunks = n_terms ? (n_terms - 1u) / chunk_size + 1u : 1u;
+    std::vector<std::string> chunks(safe_cast<std::vector<std::string>::size_type>(n_chunks));
+    const auto &ss = s.get_symbol_set();
+    thread_pool::parallel_for(chunked_n_threads(n_terms, n_chunks), n_chunks, 1u,
+                              [&](const unsigned &, const std::size_t &b, const std::size_t &e) {
+                                  for (auto i = b; i != e; ++i) {
+                                      const auto begin = i * chunk_size,
+                                                 end = std::min(n_terms, begin + chunk_size);
+                                      chunks[i] = chunk_compress(
+                                          boost_f ? chunk_boost_save<Series>(ss, terms, begin, end, f)
+                                                  : chunk_msgpack_save<Series>(ss, terms, begin, end, f),
+                                          c);
+                                  }
+                              });
+    std::ofstream ofile(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+    }
+    ofile.write(chunked_constants<>::magic, sizeof(chunked_constants<>::magic));
+    chunked_write_u64(ofile, chunked_constants<>::version);
+    chunked_write_u64(ofile, static_cast<std::uint64_t>(f));
+    chunked_write_u64(ofile, static_cast<std::uint64_t>(c));
+    chunked_write_u64(ofile, safe_cast<std::uint64_t>(n_terms));
+    chunked_write_u64(ofile, safe_cast<std::uint64_t>(n_chunks));
+    for (const auto &chunk : chunks) {
+        chunked_write_u64(ofile, safe_cast<std::uint64_t>(chunk.size()));
+    }
+    for (const auto &chunk : chunks) {
+        ofile.write(chunk.data(), safe_cast<std::streamsize>(chunk.size()));
+    }
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "an error occurred while writing the file '" + filename + "'");
+    }
+}
+
+/// Load a series from a chunked file.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series.
+ *
+ * This function will load into \p s the content of the file \p filename, written by piranha::save_chunked_file().
+ * The data and compression formats are read from the header of the file. The blocks are decompressed and deserialized
+ * in parallel using the threads of piranha::thread_pool, and their terms are then inserted concurrently in \p s,
+ * with each thread taking care of a contiguous range of buckets.
+ *
+ * If an exception is thrown, \p s is not modified.
+ *
+ * @param s the output series.
+ * @param filename the name of the input file.
+ *
+ * @throws std::runtime_error if the file cannot be opened.
+ * @throws std::invalid_argument if the file is not a valid chunked file, if the blocks have different symbol sets,
+ * or if they contain duplicate terms.
+ * @throws piranha::not_implemented_error if \p Series does not support deserialization in the data format of the file,
+ * or if the compression format of the file is not available.
+ * @throws unspecified any exception thrown by:
+ * - the low-level deserialization functions,
+ * - the public interface of the Boost iostreams library,
+ * - the public interface of piranha::series and of its terms container,
+ * - thread_pool::use_threads() and thread_pool::parallel_for(),
+ * - memory errors in standard containers,
+ * - piranha::safe_cast() and <tt>boost::numeric_cast()</tt>.
+ */
+template <typename Series, enable_if_t<is_series<Series>::value, int> = 0>
+inline void load_chunked_file(Series &s, const std::string &filename)
+{
+    using term_type = typename Series::term_type;
+    using s_size_t = decltype(s.size());
+    profiler::scope prof("s11n.load_chunked_file");
+    std::ifstream ifile(filename, std::ios::in | std::ios::binary);
+    if (unlikely(!ifile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+    }
+    const auto error = [&filename](const std::string &msg) {
+        piranha_throw(std::invalid_argument, "invalid chunked file '" + filename + "': " + msg);
+    };
+    // Header.
+    char magic[sizeof(chunked_constants<>::magic)];
+    ifile.read(magic, sizeof(magic));
+    if (!ifile.good() || std::memcmp(magic, chunked_constants<>::magic, sizeof(magic))) {
+        error("the file signature is not valid");
+    }
+    if (chunked_read_u64(ifile, filename) != chunked_constants<>::version) {
+        error("unsupported format version");
+    }
+    const auto f_n = chunked_read_u64(ifile, filename), c_n = chunked_read_u64(ifile, filename);
+    if (f_n > static_cast<std::uint64_t>(data_format::msgpack_portable)
+        || c_n > static_cast<std::uint64_t>(compression::zstd)) {
+        error("invalid data or compression format");
+    }
+    const auto f = static_cast<data_format>(f_n);
+    const auto c = static_cast<compression>(c_n);
+    const bool boost_f = (f == data_format::boost_binary || f == data_format::boost_portable);
+    const auto n_terms = safe_cast<std::size_t>(chunked_read_u64(ifile, filename));
+    const auto n_chunks = safe_cast<std::size_t>(chunked_read_u64(ifile, filename));
+    // Read the index and the chunks.
+    std::vector<std::uint64_t> sizes;
+    for (std::size_t i = 0u; i < n_chunks; ++i) {
+        sizes.push_back(chunked_read_u64(ifile, filename));
+    }
+    std::vector<std::string> chunks;
+    for (const auto &size : sizes) {
+        // NOTE: read in blocks, so that a corrupted size does not trigger a huge allocation upfront.
+        std::string chunk;
+        auto remaining = size;
+        char buffer[4096];
+        while (remaining) {
+            const auto n = static_cast<std::streamsize>(std::min<std::uint64_t>(remaining, sizeof(buffer)));
+            ifile.read(buffer, n);
+            if (unlikely(ifile.gcount() != n)) {
+                error("the file is truncated");
+            }
+            chunk.append(buffer, static_cast<std::size_t>(n));
+            remaining -= static_cast<std::uint64_t>(n);
+        }
+        chunks.push_back(std::move(chunk));
+    }
+    if (ifile.peek() != std::ifstream::traits_type::eof()) {
+        error("unexpected data at the end of the file");
+    }
+    // Decode the chunks in parallel, moving their terms into vectors.
+    const auto n_threads = chunked_n_threads(n_terms, n_chunks);
+    std::vector<std::vector<term_type>> terms(n_chunks);
+    std::vector<symbol_fset> ssets(n_chunks);
+    thread_pool::parallel_for(n_threads, n_chunks, 1u,
+                              [&](const unsigned &, const std::size_t &b, const std::size_t &e) {
+                                  for (auto i = b; i != e; ++i) {
+                                      Series tmp;
+                                      const auto buffer = chunk_decompress(std::move(chunks[i]), c);
+                                      if (boost_f) {
+                                          chunk_boost_load(tmp, buffer, f);
+                                      } else {
+                                          chunk_msgpack_load(tmp, buffer, f);
+                                      }
+                                      ssets[i] = tmp.get_symbol_set();
+                                      terms[i].reserve(tmp.size());
+                                      auto &cont = tmp._container();
+                                      const auto it_f = cont._m_end();
+                                      for (auto it = cont._m_begin(); it != it_f; ++it) {
+                                          terms[i].push_back(std::move(*it));
+                                      }
+                                  }
+                              });
+    std::size_t tot = 0u;
+    for (std::size_t i = 0u; i < n_chunks; ++i) {
+        if (ssets[i] != ssets[0]) {
+            error("the chunks have different symbol sets");
+        }
+        tot += terms[i].size();
+    }
+    if (!n_chunks || tot != n_terms) {
+        error("the number of terms does not match the number recorded in the header");
+    }
+    // Prepare the output series.
+    Series retval;
+    retval.set_symbol_set(ssets[0]);
+    auto &cont = retval._container();
+    if (n_terms) {
+        cont.rehash(boost::numeric_cast<s_size_t>(std::ceil(static_cast<double>(n_terms) / cont.max_load_factor())),
+                    tuning::get_parallel_memory_set() ? n_threads : 1u);
+    }
+    // Compute the destination buckets.
+    using bucket_size_type = typename std::decay<decltype(cont.bucket_count())>::type;
+    std::vector<std::vector<bucket_size_type>> b_idx(n_chunks);
+    thread_pool::parallel_for(n_threads, n_chunks, 1u,
+                              [&](const unsigned &, const std::size_t &b, const std::size_t &e) {
+                                  for (auto i = b; i != e; ++i) {
+                                      b_idx[i].reserve(terms[i].size());
+                                      for (const auto &t : terms[i]) {
+                                          b_idx[i].push_back(cont._bucket(t));
+                                      }
+                                  }
+                              });
+    // Insert the terms concurrently, each thread taking care of a contiguous range of buckets.
+    const auto b_count = cont.bucket_count();
+    const std::size_t n_ranges = n_threads;
+    // NOTE: if duplicate terms are found, the terms already inserted by the other threads must be
+    // destroyed before retval, as the size of the container has not been updated yet.
+    try {
+        thread_pool::parallel_for(
+            n_threads, n_ranges, 1u, [&](const unsigned &, const std::size_t &b, const std::size_t &e) {
+                for (auto r = b; r != e; ++r) {
+                    const auto start = static_cast<bucket_size_type>(b_count / n_ranges * r),
+                               end = (r + 1u == n_ranges)
+                                         ? b_count
+                                         : static_cast<bucket_size_type>(b_count / n_ranges * (r + 1u));
+                    for (std::size_t i = 0u; i < n_chunks; ++i) {
+                        for (decltype(terms[i].size()) j = 0u; j < terms[i].size(); ++j) {
+                            const auto idx = b_idx[i][j];
+                            if (idx < start || idx >= end) {
+                                continue;
+                            }
+                            if (unlikely(cont._find(terms[i][j], idx) != cont.end())) {
+                                piranha_throw(std::invalid_argument,
+                                              "invalid chunked file '" + filename + "': duplicate terms were found");
+                            }
+                            cont._unique_insert(std::move(terms[i][j]), idx);
+                        }
+                    }
+                }
+            });
+    } catch (...) {
+        cont.clear();
+        throw;
+    }
+    cont._update_size(safe_cast<s_size_t>(n_terms));
+    s = std::move(retval);
+}
+} // namespace piranha
+
+#endif
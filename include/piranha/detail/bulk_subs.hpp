@@ -0,0 +1,383 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#ifndef PIRANHA_DETAIL_BULK_SUBS_HPP
+#define PIRANHA_DETAIL_BULK_SUBS_HPP
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/exceptions.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/profiler.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Formal polynomial with integral coefficients, used to probe the substitution methods of the keys in the bulk
+// substitution engine below. The quantities being substituted are replaced by formal variables, so that the
+// substitution in a key yields a (small) formal polynomial which identifies the value of the substitution
+// independently of the actual quantities. E.g., the substitution of x and y in x**2*y*z yields (a**2*b, z), where
+// a and b are the formal variables standing for the values of x and y.
+class subs_formal
+{
+public:
+    // A monomial is a vector of (variable index, nonzero exponent) pairs, sorted by index.
+    using monomial_type = std::vector<std::pair<std::size_t, integer>>;
+    using container_type = std::map<monomial_type, integer>;
+    subs_formal() = default;
+    explicit subs_formal(const int &n) : subs_formal(integer(n)) {}
+    explicit subs_formal(const integer &n)
+    {
+        if (!n.is_zero()) {
+            m_terms.emplace(monomial_type{}, n);
+        }
+    }
+    // The i-th formal variable.
+    static subs_formal var(std::size_t i)
+    {
+        subs_formal retval;
+        retval.m_terms.emplace(monomial_type{{i, integer(1)}}, integer(1));
+        return retval;
+    }
+    const container_type &terms() const
+    {
+        return m_terms;
+    }
+    bool is_zero() const
+    {
+        return m_terms.empty();
+    }
+    subs_formal &operator+=(const subs_formal &other)
+    {
+        for (const auto &t : other.m_terms) {
+            add_term(monomial_type(t.first), t.second);
+        }
+        return *this;
+    }
+    subs_formal operator-() const
+    {
+        auto retval(*this);
+        for (auto &t : retval.m_terms) {
+            t.second.neg();
+        }
+        return retval;
+    }
+    subs_formal &operator*=(const subs_formal &other)
+    {
+        return *this = *this * other;
+    }
+    friend subs_formal operator*(const subs_formal &a, const subs_formal &b)
+    {
+        subs_formal retval;
+        for (const auto &t1 : a.m_terms) {
+            for (const auto &t2 : b.m_terms) {
+                retval.add_term(mul_monomials(t1.first, t2.first), t1.second * t2.second);
+            }
+        }
+        return retval;
+    }
+    friend subs_formal operator*(const integer &n, const subs_formal &f)
+    {
+        subs_formal retval;
+        if (!n.is_zero()) {
+            retval = f;
+            for (auto &t : retval.m_terms) {
+                t.second *= n;
+            }
+        }
+        return retval;
+    }
+    friend bool operator<(const subs_formal &a, const subs_formal &b)
+    {
+        return a.m_terms < b.m_terms;
+    }
+    friend bool operator==(const subs_formal &a, const subs_formal &b)
+    {
+        return a.m_terms == b.m_terms;
+    }
+    // Exponentiation. Negative powers are supported only for monomials with unitary coefficient.
+    subs_formal pow(const integer &n) const
+    {
+        if (m_terms.size() == 1u) {
+            const auto &t = *m_terms.begin();
+            subs_formal retval;
+            monomial_type m(t.first);
+            for (auto &p : m) {
+                p.second *= n;
+            }
+            if (n.sgn() >= 0) {
+                retval.add_term(std::move(m), piranha::pow(t.second, n));
+                return retval;
+            }
+            if (unlikely(t.second != 1 && t.second != -1)) {
+                piranha_throw(std::invalid_argument, "cannot raise a formal monomial with non-unitary coefficient to "
+                                                     "a negative power");
+            }
+            retval.add_term(std::move(m), (t.second.sgn() < 0 && n.odd_p()) ? integer(-1) : integer(1));
+            return retval;
+        }
+        if (unlikely(n.sgn() < 0)) {
+            if (m_terms.empty()) {
+                piranha_throw(mppp::zero_division_error, "cannot raise a zero formal polynomial to a negative power");
+            }
+            piranha_throw(std::invalid_argument, "cannot raise a formal polynomial with more than one term to a "
+                                                 "negative power");
+        }
+        subs_formal retval(1), sq(*this);
+        for (integer m(n); !m.is_zero();) {
+            if (m.odd_p()) {
+                retval *= sq;
+            }
+            m /= 2;
+            if (!m.is_zero()) {
+                sq *= subs_formal(sq);
+            }
+        }
+        return retval;
+    }
+
+private:
+    void add_term(monomial_type &&m, const integer &cf)
+    {
+        const auto it = m_terms.find(m);
+        if (it == m_terms.end()) {
+            if (!cf.is_zero()) {
+                m_terms.emplace(std::move(m), cf);
+            }
+            return;
+        }
+        it->second += cf;
+        if (it->second.is_zero()) {
+            m_terms.erase(it);
+        }
+    }
+    static monomial_type mul_monomials(const monomial_type &a, const monomial_type &b)
+    {
+        monomial_type retval;
+        auto it_a = a.begin(), it_b = b.begin();
+        while (it_a != a.end() || it_b != b.end()) {
+            if (it_b == b.end() || (it_a != a.end() && it_a->first < it_b->first)) {
+                retval.push_back(*it_a++);
+            } else if (it_a == a.end() || it_b->first < it_a->first) {
+                retval.push_back(*it_b++);
+            } else {
+                auto e = it_a->second + it_b->second;
+                if (!e.is_zero()) {
+                    retval.emplace_back(it_a->first, std::move(e));
+                }
+                ++it_a;
+                ++it_b;
+            }
+        }
+        return retval;
+    }
+    container_type m_terms;
+};
+
+// Table of the powers of the quantities substituted for the formal variables. All the powers needed by a set of
+// formal polynomials are computed once (via piranha::pow(), and thus via the pow cache for series) before the
+// evaluation of the formal polynomials, which can then proceed concurrently.
+template <typename T>
+class subs_power_table
+{
+public:
+    using power_type = pow_t<const T &, const integer &>;
+
+private:
+    template <typename W>
+    using eval_enabler = enable_if_t<
+        conjunction<std::is_constructible<W, const int &>, std::is_constructible<W, const power_type &>,
+                    is_multipliable_in_place<W, power_type>, is_multipliable_in_place<W, integer>,
+                    is_addable_in_place<W>, std::is_move_assignable<W>>::value,
+        int>;
+
+public:
+    explicit subs_power_table(std::vector<const T *> values) : m_values(std::move(values)), m_powers(m_values.size())
+    {
+    }
+    // Compute the powers needed by the evaluation of f.
+    void prepare(const subs_formal &f)
+    {
+        for (const auto &t : f.terms()) {
+            for (const auto &p : t.first) {
+                auto &m = m_powers[p.first];
+                if (m.find(p.second) == m.end()) {
+                    m.emplace(p.second, piranha::pow(*m_values[p.first], p.second));
+                }
+            }
+        }
+    }
+    // Evaluate f (whose powers must have been prepared) as an object of type W.
+    template <typename W, eval_enabler<W> = 0>
+    W eval(const subs_formal &f) const
+    {
+        W retval(0);
+        bool first = true;
+        for (const auto &t : f.terms()) {
+            W tmp = eval_monomial<W>(t.first);
+            if (t.second != 1) {
+                tmp *= t.second;
+            }
+            if (first) {
+                retval = std::move(tmp);
+                first = false;
+            } else {
+                retval += tmp;
+            }
+        }
+        return retval;
+    }
+
+private:
+    template <typename W>
+    W eval_monomial(const subs_formal::monomial_type &m) const
+    {
+        if (m.empty()) {
+            return W(1);
+        }
+        W retval(power(m[0]));
+        for (decltype(m.size()) i = 1u; i < m.size(); ++i) {
+            retval *= power(m[i]);
+        }
+        return retval;
+    }
+    const power_type &power(const std::pair<std::size_t, integer> &p) const
+    {
+        const auto it = m_powers[p.first].find(p.second);
+        piranha_assert(it != m_powers[p.first].end());
+        return it->second;
+    }
+
+private:
+    std::vector<const T *> m_values;
+    std::vector<std::map<integer, power_type>> m_powers;
+};
+
+template <typename W, typename T>
+using subs_power_table_eval_t
+    = decltype(std::declval<const subs_power_table<T> &>().template eval<W>(std::declval<const subs_formal &>()));
+
+// Detect if the values of type T can be substituted via a subs_power_table, yielding objects of type W.
+template <typename W, typename T, typename = void>
+struct bulk_subs_evaluable : std::false_type {
+};
+
+template <typename W, typename T>
+struct bulk_subs_evaluable<W, T, enable_if_t<is_exponentiable<const T &, const integer &>::value>>
+    : is_detected<subs_power_table_eval_t, W, T> {
+};
+
+// Bulk substitution engine.
+//
+// The substitution in the keys is first performed with formal variables via probe(), which returns a vector of
+// (formal polynomial, residual key) pairs for each key. The terms of s are grouped by formal polynomial, and the
+// terms with the residual keys accumulate in one series per group. The result is then the sum, over the groups, of
+// mult(residual series, value of the formal polynomial). In this way the powers of the substituted quantities are
+// computed once in the table and shared among all the terms, and the number of series multiplications is equal to
+// the number of distinct formal polynomials rather than to the number of terms. If there are enough groups,
+// they are processed in parallel, each thread accumulating the products in its own partial sum.
+template <typename Ret, typename W, typename Series, typename T, typename Probe, typename Mult>
+inline Ret bulk_subs(const Series &s, subs_power_table<T> &table, const Probe &probe, const Mult &mult)
+{
+    using term_type = typename Series::term_type;
+    profiler::scope prof("series.bulk_subs");
+    prof.count("terms", s.size());
+    std::map<subs_formal, Series> groups;
+    for (const auto &t : s._container()) {
+        auto ks = probe(t.m_key);
+        for (auto &p : ks) {
+            if (p.first.is_zero()) {
+                continue;
+            }
+            auto res = groups.emplace(std::move(p.first), Series{});
+            if (res.second) {
+                res.first->second.set_symbol_set(s.get_symbol_set());
+            }
+            res.first->second.insert(term_type(t.m_cf, std::move(p.second)));
+        }
+    }
+    prof.count("groups", groups.size());
+    if (groups.empty()) {
+        return Ret(0);
+    }
+    std::vector<std::pair<const subs_formal *, const Series *>> gv;
+    gv.reserve(groups.size());
+    for (const auto &g : groups) {
+        table.prepare(g.first);
+        gv.emplace_back(&g.first, &g.second);
+    }
+    // NOTE: with few groups, it is better to leave the parallelisation to the multiplications.
+    auto n_threads = thread_pool::use_threads(integer(s.size()), integer(settings::get_min_work_per_thread()));
+    if (n_threads > gv.size()) {
+        n_threads = 1u;
+    }
+    std::vector<Ret> acc(n_threads);
+    thread_pool::parallel_for(n_threads, gv.size(), 1u,
+                              [&gv, &acc, &table, &mult](const unsigned &ti, const std::size_t &b, const std::size_t &e) {
+                                  for (auto i = b; i < e; ++i) {
+                                      acc[ti] += mult(*gv[i].second, table.template eval<W>(*gv[i].first));
+                                  }
+                              });
+    if (acc.size() == 1u) {
+        return std::move(acc[0]);
+    }
+    return piranha::sum(acc);
+}
+}
+
+// Exponentiation of formal polynomials.
+template <typename T>
+class pow_impl<detail::subs_formal, T,
+               enable_if_t<disjunction<std::is_integral<T>, std::is_same<T, integer>>::value>>
+{
+public:
+    detail::subs_formal operator()(const detail::subs_formal &b, const T &e) const
+    {
+        return b.pow(integer(e));
+    }
+};
+}
+
+#endif
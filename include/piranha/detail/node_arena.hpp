@@ -0,0 +1,256 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_NODE_ARENA_HPP
+#define PIRANHA_DETAIL_NODE_ARENA_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/profiler.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Arena for fixed-size memory blocks, used for the overflow nodes of hash_set.
+// The blocks are carved out of large slabs. Each thread allocates from, and recycles into, its own
+// lane of the arena, so that the threads operating concurrently on distinct buckets of the same table do not
+// contend for a lock or for the system allocator. The slabs of a lane are first touched by the thread owning
+// the lane, so that with thread binding enabled they end up on the NUMA node of the thread. Blocks are never
+// returned to the system individually: all the slabs are released at once when the arena is destroyed.
+// The first slab of a lane is small, so that tables with only a handful of collisions stay cheap.
+template <std::size_t Size, std::size_t Align>
+class node_arena
+{
+    // A recycled block, linked in the free list of a lane.
+    struct free_block {
+        free_block *m_next;
+    };
+    // Distance between consecutive blocks in a slab.
+    static constexpr std::size_t block_size()
+    {
+        return (((Size > sizeof(free_block) ? Size : sizeof(free_block)) + Align - 1u) / Align) * Align;
+    }
+    // Min/max number of blocks in a slab. The slab size doubles at each new slab of a lane.
+    static const std::size_t min_slab_blocks = 4u;
+    static const std::size_t max_slab_blocks = 1u << 16;
+    struct lane {
+        lane() : m_free(nullptr), m_cur(nullptr), m_end(nullptr), m_slab_blocks(min_slab_blocks), m_n_blocks(0u) {}
+        void *allocate()
+        {
+            if (m_free) {
+                const auto retval = m_free;
+                m_free = m_free->m_next;
+                return retval;
+            }
+            if (unlikely(m_cur == m_end)) {
+                // NOTE: new[] returns memory aligned for any fundamental type, allocate some
+                // extra space in order to satisfy the alignment of the blocks.
+                profiler::add_counter("node_arena.slab_allocations");
+                const std::size_t n_bytes = m_slab_blocks * block_size() + Align;
+                std::unique_ptr<unsigned char[]> slab(::new unsigned char[n_bytes]);
+                m_slabs.push_back(std::move(slab));
+                const auto base = reinterpret_cast<std::uintptr_t>(m_slabs.back().get());
+                m_cur = m_slabs.back().get() + (Align - base % Align) % Align;
+                m_end = m_cur + m_slab_blocks * block_size();
+                m_slab_blocks = std::min(m_slab_blocks * 2u, max_slab_blocks);
+            }
+            const auto retval = m_cur;
+            m_cur += block_size();
+            ++m_n_blocks;
+            return retval;
+        }
+        void deallocate(void *ptr)
+        {
+            const auto b = ::new (ptr) free_block;
+            b->m_next = m_free;
+            m_free = b;
+        }
+        free_block *m_free;
+        unsigned char *m_cur;
+        unsigned char *m_end;
+        std::size_t m_slab_blocks;
+        // Number of blocks carved out of the slabs.
+        std::size_t m_n_blocks;
+        std::vector<std::unique_ptr<unsigned char[]>> m_slabs;
+    };
+    // Number of entries in the per-thread cache of lanes.
+    static const std::size_t cache_size = 16u;
+    // Locate (or create) the lane of the calling thread.
+    lane &get_lane()
+    {
+        // Per-thread cache of lanes, direct-mapped on the arena id, so that a thread alternating between
+        // a few tables (e.g., the per-thread tables of the multipliers, or the two operands of an in-place
+        // addition) keeps hitting the cache. The arenas are identified via a unique id, rather than their
+        // address, which might be recycled: an entry referring to a destroyed arena is never matched again.
+        static thread_local std::array<std::pair<unsigned long long, lane *>, cache_size> cache{};
+        auto &entry = cache[static_cast<std::size_t>(m_id % cache_size)];
+        if (likely(entry.first == m_id)) {
+            return *entry.second;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto tid = std::this_thread::get_id();
+        auto it = std::find_if(m_lanes.begin(), m_lanes.end(),
+                               [&tid](const std::pair<std::thread::id, std::unique_ptr<lane>> &p) {
+                                   return p.first == tid;
+                               });
+        if (it == m_lanes.end()) {
+            m_lanes.emplace_back(tid, std::unique_ptr<lane>(::new lane));
+            it = m_lanes.end() - 1;
+        }
+        entry = std::make_pair(m_id, it->second.get());
+        return *it->second;
+    }
+
+public:
+    node_arena() : m_id(++s_counter) {}
+    node_arena(const node_arena &) = delete;
+    node_arena(node_arena &&) = delete;
+    node_arena &operator=(const node_arena &) = delete;
+    node_arena &operator=(node_arena &&) = delete;
+    // Allocate a block of Size bytes aligned to Align. Thread-safe.
+    void *allocate()
+    {
+        return get_lane().allocate();
+    }
+    // Recycle a block previously returned by allocate(). Thread-safe.
+    void deallocate(void *ptr)
+    {
+        piranha_assert(ptr);
+        get_lane().deallocate(ptr);
+    }
+    // Number of blocks carved out of the slabs, and number of slabs. Not thread-safe.
+    std::pair<std::size_t, std::size_t> stats() const
+    {
+        std::pair<std::size_t, std::size_t> retval(0u, 0u);
+        for (const auto &p : m_lanes) {
+            retval.first += p.second->m_n_blocks;
+            retval.second += p.second->m_slabs.size();
+        }
+        return retval;
+    }
+
+private:
+    const unsigned long long m_id;
+    std::mutex m_mutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<lane>>> m_lanes;
+    static std::atomic<unsigned long long> s_counter;
+};
+
+template <std::size_t Size, std::size_t Align>
+const std::size_t node_arena<Size, Align>::min_slab_blocks;
+
+template <std::size_t Size, std::size_t Align>
+const std::size_t node_arena<Size, Align>::max_slab_blocks;
+
+template <std::size_t Size, std::size_t Align>
+const std::size_t node_arena<Size, Align>::cache_size;
+
+template <std::size_t Size, std::size_t Align>
+std::atomic<unsigned long long> node_arena<Size, Align>::s_counter(0u);
+
+// Owner of a node_arena which is created only when the first block is requested, so that tables
+// without collisions never pay for an arena. The creation is thread-safe, as the first overflow nodes of a
+// table might be requested concurrently by threads operating on distinct buckets. Not copyable; moves and
+// swaps are not thread-safe.
+template <std::size_t Size, std::size_t Align>
+class lazy_node_arena
+{
+    using arena_type = node_arena<Size, Align>;
+
+public:
+    lazy_node_arena() : m_ptr(nullptr) {}
+    lazy_node_arena(const lazy_node_arena &) = delete;
+    lazy_node_arena(lazy_node_arena &&other) noexcept : m_ptr(other.m_ptr.exchange(nullptr)) {}
+    lazy_node_arena &operator=(const lazy_node_arena &) = delete;
+    lazy_node_arena &operator=(lazy_node_arena &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            reset();
+            m_ptr.store(other.m_ptr.exchange(nullptr));
+        }
+        return *this;
+    }
+    ~lazy_node_arena()
+    {
+        reset();
+    }
+    // Get the arena, creating it if needed. Thread-safe.
+    arena_type &get()
+    {
+        auto retval = m_ptr.load(std::memory_order_acquire);
+        if (likely(retval)) {
+            return *retval;
+        }
+        profiler::add_counter("node_arena.arenas");
+        std::unique_ptr<arena_type> new_arena(::new arena_type);
+        arena_type *expected = nullptr;
+        if (m_ptr.compare_exchange_strong(expected, new_arena.get(), std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+            return *new_arena.release();
+        }
+        // Another thread created the arena in the meantime.
+        return *expected;
+    }
+    // Pointer to the arena, null if it was never created.
+    arena_type *ptr() const
+    {
+        return m_ptr.load(std::memory_order_acquire);
+    }
+    // Destroy the arena, releasing all its memory.
+    void reset()
+    {
+        ::delete m_ptr.exchange(nullptr);
+    }
+    void swap(lazy_node_arena &other) noexcept
+    {
+        const auto tmp = m_ptr.load();
+        m_ptr.store(other.m_ptr.load());
+        other.m_ptr.store(tmp);
+    }
+
+private:
+    std::atomic<arena_type *> m_ptr;
+};
+}
+}
+
+#endif
@@ -0,0 +1,565 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_POLYNOMIAL_DIVISION_HPP
+#define PIRANHA_DETAIL_POLYNOMIAL_DIVISION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_array.hpp>
+#include <piranha/math.hpp>
+#include <piranha/symbol_utils.hpp>
+
+// NOTE: the routines in this file implement exact division and GCD for polynomials with integer coefficients
+// and Kronecker monomials. They work directly on the Kronecker codes: since the codification is linear, the codes
+// define a monomial order compatible with multiplication, and monomials can be multiplied/divided by
+// adding/subtracting codes, as long as the exponents stay within the limits of the codification.
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Kronecker code of the monomial consisting of the variable at index idx.
+template <typename Poly>
+inline typename Poly::term_type::key_type::value_type kpoly_var_code(const symbol_fset &ss, const symbol_idx &idx)
+{
+    using key_type = typename Poly::term_type::key_type;
+    using ka = kronecker_array<typename key_type::value_type>;
+    typename key_type::v_type unit(static_cast<typename key_type::v_type::size_type>(ss.size()), 0);
+    unit[static_cast<typename key_type::v_type::size_type>(idx)] = 1;
+    return ka::encode(unit);
+}
+
+// Compute the minimum and maximum exponent of each variable in the nonempty polynomial p.
+template <typename Poly>
+inline void kpoly_expo_bounds(const Poly &p, std::vector<typename Poly::term_type::key_type::value_type> &lo,
+                              std::vector<typename Poly::term_type::key_type::value_type> &hi)
+{
+    piranha_assert(!p.empty());
+    const auto &ss = p.get_symbol_set();
+    lo.clear();
+    hi.clear();
+    for (const auto &t : p._container()) {
+        const auto tmp = t.m_key.unpack(ss);
+        if (lo.empty()) {
+            lo.assign(tmp.begin(), tmp.end());
+            hi.assign(tmp.begin(), tmp.end());
+            continue;
+        }
+        for (decltype(lo.size()) i = 0u; i < lo.size(); ++i) {
+            lo[i] = std::min(lo[i], tmp[static_cast<decltype(tmp.size())>(i)]);
+            hi[i] = std::max(hi[i], tmp[static_cast<decltype(tmp.size())>(i)]);
+        }
+    }
+}
+
+// Degree of p in the variable at index idx. p must be nonempty.
+template <typename Poly>
+inline typename Poly::term_type::key_type::value_type kpoly_degree(const Poly &p, const symbol_idx &idx)
+{
+    std::vector<typename Poly::term_type::key_type::value_type> lo, hi;
+    kpoly_expo_bounds(p, lo, hi);
+    return hi[static_cast<decltype(hi.size())>(idx)];
+}
+
+// Pointers to the terms of p, sorted in decreasing code order.
+template <typename Poly>
+inline std::vector<typename Poly::term_type const *> kpoly_sorted_terms(const Poly &p)
+{
+    using term_type = typename Poly::term_type;
+    std::vector<term_type const *> retval;
+    retval.reserve(boost::numeric_cast<decltype(retval.size())>(p.size()));
+    for (const auto &t : p._container()) {
+        retval.push_back(&t);
+    }
+    std::sort(retval.begin(), retval.end(), [](term_type const *t1, term_type const *t2) {
+        return t1->m_key.get_int() > t2->m_key.get_int();
+    });
+    return retval;
+}
+
+// The term of p with the highest code. p must be nonempty.
+template <typename Poly>
+inline const typename Poly::term_type &kpoly_leading_term(const Poly &p)
+{
+    piranha_assert(!p.empty());
+    return *std::max_element(p._container().begin(), p._container().end(),
+                             [](const typename Poly::term_type &t1, const typename Poly::term_type &t2) {
+                                 return t1.m_key.get_int() < t2.m_key.get_int();
+                             });
+}
+
+// Insert a vector of terms with unique keys into the empty polynomial retval.
+template <typename Poly>
+inline void kpoly_unique_insert(Poly &retval, std::vector<typename Poly::term_type> &terms)
+{
+    using bucket_size_type = typename Poly::size_type;
+    auto &container = retval._container();
+    piranha_assert(container.empty());
+    if (terms.empty()) {
+        return;
+    }
+    container.rehash(boost::numeric_cast<bucket_size_type>(
+        std::ceil(static_cast<double>(terms.size()) / container.max_load_factor())));
+    for (auto &t : terms) {
+        const auto b_idx = container._bucket(t);
+        container._unique_insert(std::move(t), b_idx);
+    }
+    container._update_size(boost::numeric_cast<bucket_size_type>(terms.size()));
+}
+
+// Heap-based exact division (Johnson's algorithm). The terms of the quotient are generated in decreasing code order,
+// and the products of the terms of the quotient already computed by the non-leading terms of the divisor are merged
+// via a binary heap containing at most one entry per term of the quotient. Returns false if d does not divide n,
+// in which case q is left in an unspecified state.
+template <typename Poly>
+inline bool kpoly_heap_divide(Poly &q, const Poly &n, const Poly &d)
+{
+    using term_type = typename Poly::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    using int_type = typename key_type::value_type;
+    using ka = kronecker_array<int_type>;
+    using tv_type = std::vector<term_type const *>;
+    using size_type = typename tv_type::size_type;
+    const auto &ss = n.get_symbol_set();
+    piranha_assert(ss == d.get_symbol_set() && !d.empty());
+    q = Poly{};
+    q.set_symbol_set(ss);
+    if (n.empty()) {
+        return true;
+    }
+    // The exponents of the quotient are bounded by the differences of the exponent bounds of dividend and divisor.
+    std::vector<int_type> nlo, nhi, dlo, dhi;
+    kpoly_expo_bounds(n, nlo, nhi);
+    kpoly_expo_bounds(d, dlo, dhi);
+    std::vector<int_type> qlo(nlo.size()), qhi(nlo.size());
+    for (decltype(nlo.size()) i = 0u; i < nlo.size(); ++i) {
+        qlo[i] = static_cast<int_type>(nlo[i] - dlo[i]);
+        qhi[i] = static_cast<int_type>(nhi[i] - dhi[i]);
+        if (qlo[i] > qhi[i]) {
+            return false;
+        }
+    }
+    // Limits of the codes.
+    const auto &limit = ka::get_limits()[static_cast<decltype(ka::get_limits().size())>(ss.size())];
+    const integer hmin(std::get<1u>(limit)), hmax(std::get<2u>(limit));
+    const auto vn = kpoly_sorted_terms(n), vd = kpoly_sorted_terms(d);
+    const auto &lt_d = *vd[0u];
+    const int_type c_d0 = lt_d.m_key.get_int();
+    // The terms of the quotient, in decreasing code order.
+    std::vector<term_type> qt;
+    // Heap entry: the code of the product, the index of the term in the quotient and the index of the
+    // term in the divisor.
+    struct heap_entry {
+        int_type m_code;
+        size_type m_i;
+        size_type m_j;
+    };
+    auto cmp = [](const heap_entry &e1, const heap_entry &e2) { return e1.m_code < e2.m_code; };
+    std::vector<heap_entry> heap;
+    typename key_type::v_type tmp(static_cast<typename key_type::v_type::size_type>(ss.size()), 0);
+    cf_type acc, sum, qcf, rem;
+    size_type k = 0u;
+    while (!heap.empty() || k != vn.size()) {
+        // The current code is the largest between the next term of the dividend and the top of the heap.
+        int_type c;
+        if (heap.empty() || (k != vn.size() && vn[k]->m_key.get_int() >= heap.front().m_code)) {
+            c = vn[k]->m_key.get_int();
+        } else {
+            c = heap.front().m_code;
+        }
+        sum = 0;
+        while (!heap.empty() && heap.front().m_code == c) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            auto &e = heap.back();
+            math::multiply_accumulate(sum, qt[e.m_i].m_cf, vd[e.m_j]->m_cf);
+            if (++e.m_j != vd.size()) {
+                e.m_code = static_cast<int_type>(qt[e.m_i].m_key.get_int() + vd[e.m_j]->m_key.get_int());
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            } else {
+                heap.pop_back();
+            }
+        }
+        if (k != vn.size() && vn[k]->m_key.get_int() == c) {
+            acc = vn[k]->m_cf;
+            ++k;
+        } else {
+            acc = 0;
+        }
+        acc -= sum;
+        if (acc.is_zero()) {
+            continue;
+        }
+        // Compute the new term of the quotient, checking that its monomial is within the bounds.
+        const integer tmp_qc = integer(c) - c_d0;
+        if (tmp_qc < hmin || tmp_qc > hmax) {
+            return false;
+        }
+        const auto qc = static_cast<int_type>(tmp_qc);
+        ka::decode(tmp, qc);
+        for (decltype(qlo.size()) i = 0u; i < qlo.size(); ++i) {
+            const auto e = tmp[static_cast<decltype(tmp.size())>(i)];
+            if (e < qlo[i] || e > qhi[i]) {
+                return false;
+            }
+        }
+        mppp::tdiv_qr(qcf, rem, acc, lt_d.m_cf);
+        if (!rem.is_zero()) {
+            return false;
+        }
+        qt.emplace_back(std::move(qcf), key_type(qc));
+        qcf = cf_type{};
+        if (vd.size() > 1u) {
+            heap.push_back(heap_entry{static_cast<int_type>(qc + vd[1u]->m_key.get_int()),
+                                      static_cast<size_type>(qt.size() - 1u), size_type(1u)});
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+    }
+    kpoly_unique_insert(q, qt);
+    return true;
+}
+
+// Content (i.e., the GCD of the coefficients) of p. The result is non-negative.
+template <typename Poly>
+inline typename Poly::term_type::cf_type kpoly_content(const Poly &p)
+{
+    typename Poly::term_type::cf_type retval;
+    for (const auto &t : p._container()) {
+        mppp::gcd(retval, retval, t.m_cf);
+    }
+    return retval;
+}
+
+// Exact division of the coefficients of p by the nonzero integer c.
+template <typename Poly>
+inline Poly kpoly_divexact_cf(const Poly &p, const typename Poly::term_type::cf_type &c)
+{
+    Poly retval(p);
+    for (const auto &t : retval._container()) {
+        mppp::divexact(t.m_cf, t.m_cf, c);
+    }
+    return retval;
+}
+
+// Maximum absolute value of the coefficients of p.
+template <typename Poly>
+inline typename Poly::term_type::cf_type kpoly_norm(const Poly &p)
+{
+    typename Poly::term_type::cf_type retval;
+    for (const auto &t : p._container()) {
+        if (mppp::abs(t.m_cf) > retval) {
+            retval = mppp::abs(t.m_cf);
+        }
+    }
+    return retval;
+}
+
+// Normalise the sign of p so that its leading coefficient is positive.
+template <typename Poly>
+inline Poly kpoly_normalise(Poly p)
+{
+    if (!p.empty() && kpoly_leading_term(p).m_cf.sgn() < 0) {
+        for (const auto &t : p._container()) {
+            t.m_cf.neg();
+        }
+    }
+    return p;
+}
+
+// Evaluate the variable at index idx of p at the integer value xi. The variable stays in the symbol set of the
+// result, with zero exponent.
+template <typename Poly>
+inline Poly kpoly_eval_var(const Poly &p, const symbol_idx &idx, const typename Poly::term_type::cf_type &xi)
+{
+    using term_type = typename Poly::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    using int_type = typename key_type::value_type;
+    const auto &ss = p.get_symbol_set();
+    const auto code_x = kpoly_var_code<Poly>(ss, idx);
+    Poly retval;
+    retval.set_symbol_set(ss);
+    // Cache of the powers of xi.
+    std::vector<cf_type> pw{cf_type{1}};
+    for (const auto &t : p._container()) {
+        const auto e = t.m_key.unpack(ss)[static_cast<typename key_type::v_type::size_type>(idx)];
+        piranha_assert(e >= 0);
+        while (pw.size() <= static_cast<decltype(pw.size())>(e)) {
+            pw.push_back(pw.back() * xi);
+        }
+        retval.insert(term_type(t.m_cf * pw[static_cast<decltype(pw.size())>(e)],
+                                key_type(static_cast<int_type>(t.m_key.get_int() - e * code_x))));
+    }
+    return retval;
+}
+
+// Reconstruct a polynomial from its evaluation gamma at the integer value xi of the variable at index idx, via the
+// xi-adic expansion of the coefficients in the symmetric range. Returns false if the degree of the reconstructed
+// polynomial would exceed max_deg.
+template <typename Poly>
+inline bool kpoly_interpolate(Poly &out, const Poly &gamma, const symbol_idx &idx,
+                              const typename Poly::term_type::cf_type &xi,
+                              const typename Poly::term_type::key_type::value_type &max_deg)
+{
+    using term_type = typename Poly::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    using int_type = typename key_type::value_type;
+    const auto &ss = gamma.get_symbol_set();
+    const auto code_x = kpoly_var_code<Poly>(ss, idx);
+    const cf_type half_xi = xi / 2;
+    out = Poly{};
+    out.set_symbol_set(ss);
+    // Copy of the coefficients of gamma, which will be consumed by the expansion.
+    std::vector<std::pair<int_type, cf_type>> h;
+    for (const auto &t : gamma._container()) {
+        h.emplace_back(t.m_key.get_int(), t.m_cf);
+    }
+    std::vector<term_type> terms;
+    cf_type q, r;
+    for (int_type i = 0; !h.empty(); ++i) {
+        if (i > max_deg) {
+            return false;
+        }
+        for (auto &p : h) {
+            // Symmetric remainder.
+            mppp::tdiv_qr(q, r, p.second, xi);
+            if (r.sgn() < 0) {
+                r += xi;
+            }
+            if (r > half_xi) {
+                r -= xi;
+            }
+            p.second -= r;
+            mppp::divexact(p.second, p.second, xi);
+            if (!r.is_zero()) {
+                terms.emplace_back(r, key_type(static_cast<int_type>(p.first + i * code_x)));
+            }
+        }
+        h.erase(std::remove_if(h.begin(), h.end(),
+                               [](const std::pair<int_type, cf_type> &p) { return p.second.is_zero(); }),
+                h.end());
+    }
+    kpoly_unique_insert(out, terms);
+    return true;
+}
+
+template <typename Poly>
+inline Poly kpoly_gcd(const Poly &, const Poly &);
+
+// Heuristic GCD (Char, Geddes and Gonnet) of the nonzero primitive polynomials a and b, evaluating
+// the variable at index idx. Returns false if the heuristic failed.
+template <typename Poly>
+inline bool kpoly_gcdheu(Poly &out, const Poly &a, const Poly &b, const symbol_idx &idx,
+                         const typename Poly::term_type::key_type::value_type &min_deg,
+                         const typename Poly::term_type::key_type::value_type &max_deg)
+{
+    using cf_type = typename Poly::term_type::cf_type;
+    cf_type xi = std::min(kpoly_norm(a), kpoly_norm(b)) * 2 + 29;
+    Poly g, q;
+    for (int attempt = 0; attempt < 6; ++attempt) {
+        // Give up if the evaluations become too large.
+        if (integer(xi.nbits()) * max_deg > 100000) {
+            break;
+        }
+        const auto ea = kpoly_eval_var(a, idx, xi), eb = kpoly_eval_var(b, idx, xi);
+        if (!ea.empty() && !eb.empty() && kpoly_interpolate(g, kpoly_gcd(ea, eb), idx, xi, min_deg) && !g.empty()) {
+            g = kpoly_normalise(kpoly_divexact_cf(g, kpoly_content(g)));
+            if (kpoly_heap_divide(q, a, g) && kpoly_heap_divide(q, b, g)) {
+                out = std::move(g);
+                return true;
+            }
+        }
+        xi = xi * 73794 / 27011;
+    }
+    return false;
+}
+
+// Coefficients of p with respect to the variable at index idx, as polynomials in the remaining variables.
+template <typename Poly>
+inline std::map<typename Poly::term_type::key_type::value_type, Poly> kpoly_coefficients(const Poly &p,
+                                                                                          const symbol_idx &idx)
+{
+    using term_type = typename Poly::term_type;
+    using key_type = typename term_type::key_type;
+    using int_type = typename key_type::value_type;
+    const auto &ss = p.get_symbol_set();
+    const auto code_x = kpoly_var_code<Poly>(ss, idx);
+    std::map<int_type, Poly> retval;
+    for (const auto &t : p._container()) {
+        const auto e = t.m_key.unpack(ss)[static_cast<typename key_type::v_type::size_type>(idx)];
+        auto &c = retval[e];
+        if (c.empty()) {
+            c.set_symbol_set(ss);
+        }
+        c.insert(term_type(t.m_cf, key_type(static_cast<int_type>(t.m_key.get_int() - e * code_x))));
+    }
+    return retval;
+}
+
+// Multiply p by the e-th power of the variable at index idx.
+template <typename Poly>
+inline Poly kpoly_shift(const Poly &p, const symbol_idx &idx, const typename Poly::term_type::key_type::value_type &e)
+{
+    using term_type = typename Poly::term_type;
+    using key_type = typename term_type::key_type;
+    using int_type = typename key_type::value_type;
+    const auto code_x = kpoly_var_code<Poly>(p.get_symbol_set(), idx);
+    std::vector<term_type> terms;
+    for (const auto &t : p._container()) {
+        terms.emplace_back(t.m_cf, key_type(static_cast<int_type>(t.m_key.get_int() + e * code_x)));
+    }
+    Poly retval;
+    retval.set_symbol_set(p.get_symbol_set());
+    kpoly_unique_insert(retval, terms);
+    return retval;
+}
+
+// Primitive part of the nonzero polynomial p with respect to the variable at index idx, i.e., p divided
+// by the GCD of its coefficients in the remaining variables.
+template <typename Poly>
+inline Poly kpoly_pp_var(const Poly &p, const symbol_idx &idx, Poly *content = nullptr)
+{
+    Poly c;
+    for (const auto &pr : kpoly_coefficients(p, idx)) {
+        c = kpoly_gcd(c, pr.second);
+    }
+    Poly retval;
+    if (unlikely(!kpoly_heap_divide(retval, p, c))) {
+        piranha_throw(std::runtime_error, "the content of a polynomial does not divide the polynomial");
+    }
+    if (content) {
+        *content = std::move(c);
+    }
+    return retval;
+}
+
+// GCD of the nonzero primitive polynomials a and b via primitive polynomial remainder sequences in the variable at
+// index idx. This is the fallback in case the heuristic GCD fails.
+template <typename Poly>
+inline Poly kpoly_gcd_prs(const Poly &a, const Poly &b, const symbol_idx &idx)
+{
+    Poly ca, cb;
+    Poly pa = kpoly_pp_var(a, idx, &ca), pb = kpoly_pp_var(b, idx, &cb);
+    const auto c = kpoly_gcd(ca, cb);
+    if (kpoly_degree(pa, idx) < kpoly_degree(pb, idx)) {
+        std::swap(pa, pb);
+    }
+    while (true) {
+        const auto db = kpoly_degree(pb, idx);
+        if (db == 0) {
+            return c;
+        }
+        // Pseudo-remainder of pa by pb.
+        auto coeffs_b = kpoly_coefficients(pb, idx);
+        const auto &lc_b = coeffs_b.rbegin()->second;
+        auto r = pa;
+        while (!r.empty()) {
+            const auto dr = kpoly_degree(r, idx);
+            if (dr < db) {
+                break;
+            }
+            auto coeffs_r = kpoly_coefficients(r, idx);
+            r = r * lc_b - kpoly_shift(coeffs_r.rbegin()->second, idx, dr - db) * pb;
+        }
+        if (r.empty()) {
+            return c * pb;
+        }
+        pa = std::move(pb);
+        pb = kpoly_pp_var(r, idx);
+    }
+}
+
+// GCD of the nonzero polynomials a and b, with non-negative exponents.
+template <typename Poly>
+inline Poly kpoly_gcd_impl(const Poly &a, const Poly &b)
+{
+    using int_type = typename Poly::term_type::key_type::value_type;
+    const auto ca = kpoly_content(a), cb = kpoly_content(b);
+    typename Poly::term_type::cf_type c;
+    mppp::gcd(c, ca, cb);
+    const auto pa = kpoly_divexact_cf(a, ca), pb = kpoly_divexact_cf(b, cb);
+    std::vector<int_type> lo_a, hi_a, lo_b, hi_b;
+    kpoly_expo_bounds(pa, lo_a, hi_a);
+    kpoly_expo_bounds(pb, lo_b, hi_b);
+    // The degree of the GCD in each variable is bounded by the minimum of the degrees of the operands. We pick
+    // as main variable the one with the largest bound.
+    symbol_idx idx = 0u;
+    int_type min_deg = 0;
+    for (decltype(hi_a.size()) i = 0u; i < hi_a.size(); ++i) {
+        const auto d = std::min(hi_a[i], hi_b[i]);
+        if (d > min_deg) {
+            min_deg = d;
+            idx = static_cast<symbol_idx>(i);
+        }
+    }
+    Poly retval;
+    retval.set_symbol_set(a.get_symbol_set());
+    if (min_deg == 0) {
+        // The GCD does not depend on any variable.
+        retval.insert(typename Poly::term_type(std::move(c), typename Poly::term_type::key_type{}));
+        return retval;
+    }
+    const auto max_deg = std::max(hi_a[static_cast<decltype(hi_a.size())>(idx)],
+                                  hi_b[static_cast<decltype(hi_b.size())>(idx)]);
+    if (!kpoly_gcdheu(retval, pa, pb, idx, min_deg, max_deg)) {
+        retval = kpoly_gcd_prs(pa, pb, idx);
+    }
+    return retval * c;
+}
+
+// GCD of a and b, normalised to have a positive leading coefficient. The GCD of two zero polynomials is zero.
+template <typename Poly>
+inline Poly kpoly_gcd(const Poly &a, const Poly &b)
+{
+    if (a.empty()) {
+        return kpoly_normalise(b);
+    }
+    if (b.empty()) {
+        return kpoly_normalise(a);
+    }
+    return kpoly_normalise(kpoly_gcd_impl(a, b));
+}
+}
+}
+
+#endif
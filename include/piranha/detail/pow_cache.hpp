@@ -0,0 +1,280 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#ifndef PIRANHA_DETAIL_POW_CACHE_HPP
+#define PIRANHA_DETAIL_POW_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <piranha/integer.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Concurrent cache of the natural powers of series, used by piranha::series::pow().
+//
+// The cache associates a series (the base) to the vector of its natural powers computed so far. The entries are
+// distributed in a number of shards according to the hash of the base, each shard being protected by its own mutex,
+// which is held only for the lookup of the entry. The powers are then computed while holding the mutex of the entry,
+// so that the exponentiation of different bases can proceed in parallel. The cache keeps an estimate of its memory
+// footprint and, when this exceeds the budget set via piranha::settings::set_pow_cache_memory_budget(), it evicts the
+// least recently used entries which are not in use until the footprint is within the budget again.
+//
+// The powers are computed by default via repeated multiplications, so that all the powers up to the requested one
+// are stored in the entry. The caller can also supply a functor which may compute a power directly (e.g., via a
+// multinomial expansion): the powers computed in this way are stored separately in the entry.
+//
+// Lock ordering: the mutex of a shard is never held while waiting on the mutex of an entry.
+template <typename Series, typename Power>
+class pow_cache
+{
+    struct entry {
+        explicit entry(const Series &base, std::size_t hash) : m_base(base), m_hash(hash) {}
+        const Series m_base;
+        const std::size_t m_hash;
+        std::mutex m_mutex;
+        // NOTE: these are protected by m_mutex.
+        std::vector<Power> m_powers;
+        std::vector<std::pair<integer, Power>> m_direct;
+        unsigned long long m_cost = 0u;
+        bool m_evicted = false;
+        // Tick of the last use, read without locking by the eviction logic.
+        std::atomic_ullong m_last_use{0u};
+    };
+    using entry_ptr = std::shared_ptr<entry>;
+    struct shard {
+        std::mutex m_mutex;
+        std::unordered_multimap<std::size_t, entry_ptr> m_map;
+    };
+    static const std::size_t n_shards = 16u;
+    // Estimate of the memory used by a series: each term and each bucket of the table occupy roughly
+    // the space of a term plus a pointer.
+    // NOTE: this does not account for the dynamic memory used by the coefficients and the keys.
+    template <typename T>
+    static unsigned long long cost(const T &s)
+    {
+        return (static_cast<unsigned long long>(s.size()) + s.table_bucket_count())
+               * (sizeof(typename T::term_type) + sizeof(void *));
+    }
+    // Account for the addition of the cost c to the entry e.
+    // NOTE: this must be called with the mutex of e locked.
+    void add_cost(entry &e, unsigned long long c)
+    {
+        e.m_cost += c;
+        // If e was evicted while we were using it, its memory will be released as soon as we are done with it.
+        if (!e.m_evicted) {
+            m_total += c;
+        }
+    }
+    // Mark the entry e as evicted.
+    // NOTE: this must be called with the mutex of e locked.
+    void mark_evicted(entry &e)
+    {
+        if (!e.m_evicted) {
+            e.m_evicted = true;
+            m_total -= e.m_cost;
+        }
+    }
+    void evict(unsigned long long budget)
+    {
+        std::lock_guard<std::mutex> e_lock(m_evict_mutex);
+        if (m_total.load() <= budget) {
+            return;
+        }
+        // Collect all the entries, and sort them from the least to the most recently used.
+        std::vector<std::pair<unsigned long long, entry_ptr>> cands;
+        for (auto &sh : m_shards) {
+            std::lock_guard<std::mutex> lock(sh.m_mutex);
+            for (const auto &p : sh.m_map) {
+                cands.emplace_back(p.second->m_last_use.load(), p.second);
+            }
+        }
+        std::sort(cands.begin(), cands.end(),
+                  [](const std::pair<unsigned long long, entry_ptr> &a,
+                     const std::pair<unsigned long long, entry_ptr> &b) { return a.first < b.first; });
+        for (const auto &c : cands) {
+            if (m_total.load() <= budget) {
+                break;
+            }
+            auto &e = *c.second;
+            // Skip the entries which are being used by other threads.
+            std::unique_lock<std::mutex> lock(e.m_mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                continue;
+            }
+            {
+                auto &sh = m_shards[e.m_hash % n_shards];
+                std::lock_guard<std::mutex> s_lock(sh.m_mutex);
+                const auto r = sh.m_map.equal_range(e.m_hash);
+                for (auto it = r.first; it != r.second; ++it) {
+                    if (it->second == c.second) {
+                        sh.m_map.erase(it);
+                        break;
+                    }
+                }
+            }
+            mark_evicted(e);
+            ++base_settings<>::s_pow_cache_evictions;
+        }
+    }
+
+public:
+    // Functor that never computes powers directly.
+    struct no_direct {
+        bool operator()(const Series &, const integer &, Power &) const
+        {
+            return false;
+        }
+    };
+    // Get the n-th power of s, computing and caching the missing powers if needed. If the power is not
+    // in the cache, direct(base, n, out) is invoked first: if it returns true, out is the n-th power of base,
+    // otherwise the power is computed via repeated multiplications. The return value is constructed from the
+    // cached power while holding the lock on the entry.
+    template <typename Ret, typename F = no_direct>
+    Ret get(const Series &s, const integer &n, const F &direct = F{})
+    {
+        using term_type = typename Power::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        const auto h = s.hash();
+        entry_ptr e;
+        // Locate or create the entry.
+        {
+            auto &sh = m_shards[h % n_shards];
+            std::lock_guard<std::mutex> lock(sh.m_mutex);
+            const auto r = sh.m_map.equal_range(h);
+            for (auto it = r.first; it != r.second; ++it) {
+                if (it->second->m_base.is_identical(s)) {
+                    e = it->second;
+                    break;
+                }
+            }
+            if (!e) {
+                e = std::make_shared<entry>(s, h);
+                sh.m_map.emplace(h, e);
+            }
+        }
+        Ret retval = [this, &e, &n, &direct]() -> Ret {
+            std::lock_guard<std::mutex> lock(e->m_mutex);
+            e->m_last_use.store(++m_tick);
+            auto &v = e->m_powers;
+            using s_type = decltype(v.size());
+            if (v.size() > n) {
+                ++base_settings<>::s_pow_cache_hits;
+                return Ret(v[static_cast<s_type>(n)]);
+            }
+            for (const auto &p : e->m_direct) {
+                if (p.first == n) {
+                    ++base_settings<>::s_pow_cache_hits;
+                    return Ret(p.second);
+                }
+            }
+            ++base_settings<>::s_pow_cache_misses;
+            if (!e->m_cost) {
+                add_cost(*e, cost(e->m_base));
+            }
+            // Try the direct computation first.
+            Power tmp;
+            if (direct(e->m_base, n, tmp)) {
+                e->m_direct.emplace_back(n, std::move(tmp));
+                add_cost(*e, cost(e->m_direct.back().second));
+                return Ret(e->m_direct.back().second);
+            }
+            // Init the vector, if needed.
+            if (!v.size()) {
+                tmp = Power{};
+                tmp.insert(term_type(cf_type(1), key_type(symbol_fset{})));
+                v.push_back(std::move(tmp));
+                add_cost(*e, cost(v.back()));
+            }
+            // Fill in the missing powers.
+            while (v.size() <= n) {
+                // NOTE: for series it seems like it is better to run the dumb algorithm instead of, e.g.,
+                // exponentiation by squaring - the growth in number of terms seems to be slower.
+                v.push_back(v.back() * e->m_base);
+                add_cost(*e, cost(v.back()));
+            }
+            return Ret(v[static_cast<s_type>(n)]);
+        }();
+        const auto budget = base_settings<>::s_pow_cache_memory_budget.load();
+        if (budget && m_total.load() > budget) {
+            evict(budget);
+        }
+        return retval;
+    }
+    // Remove all the entries from the cache.
+    void clear()
+    {
+        std::lock_guard<std::mutex> e_lock(m_evict_mutex);
+        std::vector<entry_ptr> removed;
+        for (auto &sh : m_shards) {
+            std::lock_guard<std::mutex> lock(sh.m_mutex);
+            for (const auto &p : sh.m_map) {
+                removed.push_back(p.second);
+            }
+            sh.m_map.clear();
+        }
+        // NOTE: the mutexes of the entries are locked after releasing the mutexes of the shards.
+        for (const auto &e : removed) {
+            std::lock_guard<std::mutex> lock(e->m_mutex);
+            mark_evicted(*e);
+        }
+    }
+    // Estimate of the memory used by the cache, in bytes.
+    unsigned long long memory_usage() const
+    {
+        return m_total.load();
+    }
+
+private:
+    std::array<shard, n_shards> m_shards;
+    std::mutex m_evict_mutex;
+    std::atomic_ullong m_total{0u};
+    std::atomic_ullong m_tick{0u};
+};
+
+template <typename Series, typename Power>
+const std::size_t pow_cache<Series, Power>::n_shards;
+}
+}
+
+#endif
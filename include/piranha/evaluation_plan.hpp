@@ -0,0 +1,316 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#ifndef PIRANHA_EVALUATION_PLAN_HPP
+#define PIRANHA_EVALUATION_PLAN_HPP
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/series.hpp>
+#include <piranha/series_evaluator.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Type resulting from the evaluation of the coefficients of a series.
+template <typename Series, typename T>
+using eval_plan_cf_type = decltype(math::evaluate(std::declval<const typename Series::term_type::cf_type &>(),
+                                                  std::declval<const symbol_fmap<T> &>()));
+
+// Exponent type of the keys of a series.
+template <typename Series>
+using eval_plan_expo_type = typename se_key_expos<typename Series::term_type::key_type>::expo_type;
+
+// Type of the powers of the evaluation values (which is also the type resulting from the evaluation of the keys).
+template <typename Series, typename T>
+using eval_plan_power_type
+    = decltype(piranha::pow(std::declval<const T &>(), std::declval<const eval_plan_expo_type<Series> &>()));
+
+// Type resulting from the evaluation of the keys of a series.
+template <typename Series, typename T>
+using eval_plan_key_type = decltype(std::declval<const typename Series::term_type::key_type &>().evaluate(
+    std::declval<const std::vector<T> &>(), std::declval<const symbol_fset &>()));
+
+template <typename Series, typename T>
+using eval_plan_enabler = enable_if_t<
+    conjunction<std::is_same<math_series_evaluate_enabler<Series, T>, void>,
+                std::integral_constant<bool, se_key_expos<typename Series::term_type::key_type>::value>,
+                negation<is_series<typename Series::term_type::cf_type>>,
+                std::is_copy_constructible<eval_plan_cf_type<Series, T>>,
+                std::is_same<eval_plan_power_type<Series, T>, eval_plan_key_type<Series, T>>,
+                std::is_constructible<eval_plan_power_type<Series, T>, int>,
+                is_multipliable_in_place<eval_plan_power_type<Series, T>>,
+                std::is_copy_assignable<eval_plan_power_type<Series, T>>,
+                std::is_move_assignable<eval_plan_power_type<Series, T>>>::value>;
+
+// Detect if evaluation_plan can be used with Series and T.
+template <typename Series, typename T, typename = void>
+struct evaluation_plan_enabled : std::false_type {
+};
+
+template <typename Series, typename T>
+struct evaluation_plan_enabled<Series, T, eval_plan_enabler<Series, T>> : std::true_type {
+};
+} // namespace impl
+
+/// Evaluation plan for series.
+/**
+ * This class precomputes, from a series, a sequence of operations which evaluates the series with values of type
+ * \p T more efficiently than piranha::math::evaluate(). The plan is meant to be built once and then used
+ * for many evaluations (as done, e.g., by piranha::math::lambdified).
+ *
+ * Upon construction, the exponents of the keys are decoded and the terms are sorted in lexicographic order
+ * with respect to the exponents. The sorted exponent vectors are then organised in a prefix tree, whose nodes
+ * represent the products <tt>x_0**n_0 * x_1**n_1 * ... * x_i**n_i</tt> (the first <tt>i + 1</tt> factors
+ * of the evaluation of a key). Each prefix shared by multiple keys is thus computed only once. The result is stored
+ * as flat lists of operations:
+ * - the list of the distinct powers of the evaluation values needed by the keys,
+ * - the list of the nodes of the prefix tree, each node being computed as the product of its parent
+ *   and of a power of the evaluation value of the corresponding symbol,
+ * - the index, for each term, of the node representing its key.
+ *
+ * The coefficients are evaluated once during construction. During the evaluation, no hashing, decoding or
+ * memory allocation takes place (other than the one possibly performed by the arithmetic operations on
+ * the evaluation types). The operations are performed in the same order as in the evaluation of the key
+ * and the contributions of the terms are accumulated in the same order as in piranha::math::evaluate(),
+ * so that the result of the evaluation is identical to the output of piranha::math::evaluate().
+ *
+ * ## Type requirements ##
+ *
+ * - piranha::math::evaluate() must be enabled for \p Series and \p T,
+ * - the key type of \p Series must be piranha::kronecker_monomial or piranha::monomial with integral exponents,
+ * - the coefficient type of \p Series must not be a series and the type resulting from its evaluation must be
+ *   copy-constructible,
+ * - the type resulting from the evaluation of the keys must be constructible from \p int, multipliable in place,
+ *   and copy- and move-assignable.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Series, typename T>
+class evaluation_plan
+{
+    static_assert(evaluation_plan_enabled<Series, T>::value, "Invalid types.");
+    using key_type = typename Series::term_type::key_type;
+    using expo_type = typename se_key_expos<key_type>::expo_type;
+    using cf_eval_type = eval_plan_cf_type<Series, T>;
+    using value_type = eval_plan_power_type<Series, T>;
+
+public:
+    /// Evaluation type.
+    /**
+     * This is the type resulting from the evaluation of \p Series with values of type \p T
+     * via piranha::math::evaluate().
+     */
+    using eval_type = series_eval_type<Series, T>;
+    /// Size type.
+    using size_type = typename std::vector<value_type>::size_type;
+    /// Constructor.
+    /**
+     * @param s the series from which the plan will be built.
+     *
+     * @throws std::invalid_argument if the keys of \p s are inconsistent with its symbol set.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the copy constructor of the key type,
+     * - the evaluation of the coefficients,
+     * - piranha::kronecker_array::decode_range(),
+     * - the construction of objects of type piranha::evaluation_plan::eval_type from \p int.
+     */
+    explicit evaluation_plan(const Series &s) : m_symbol_set(s.get_symbol_set())
+    {
+        const auto m = static_cast<size_type>(m_symbol_set.size());
+        // Evaluate the coefficients and collect the keys, in the iteration order of the series.
+        const symbol_fmap<T> empty_dict;
+        std::vector<key_type> keys;
+        keys.reserve(s.size());
+        m_cfs.reserve(s.size());
+        for (const auto &t : s._container()) {
+            m_cfs.push_back(math::evaluate(t.m_cf, empty_dict));
+            keys.push_back(t.m_key);
+        }
+        const auto n = static_cast<size_type>(keys.size());
+        std::vector<expo_type> expos(static_cast<typename std::vector<expo_type>::size_type>(integer(n) * m));
+        se_key_expos<key_type>::unpack(expos.data(), keys, m_symbol_set);
+        // The distinct exponents of each symbol, and the corresponding indices into the list of powers.
+        std::vector<size_type> pidx(expos.size());
+        for (size_type i = 0u; i < m; ++i) {
+            std::vector<expo_type> col;
+            col.reserve(n);
+            for (size_type j = 0u; j < n; ++j) {
+                col.push_back(expos[j * m + i]);
+            }
+            std::sort(col.begin(), col.end());
+            col.erase(std::unique(col.begin(), col.end()), col.end());
+            const auto offset = m_powers_ops.size();
+            for (const auto &e : col) {
+                m_powers_ops.emplace_back(i, e);
+            }
+            for (size_type j = 0u; j < n; ++j) {
+                pidx[j * m + i] = offset
+                                  + static_cast<size_type>(std::lower_bound(col.begin(), col.end(), expos[j * m + i])
+                                                           - col.begin());
+            }
+        }
+        // Sort the terms according to their exponents.
+        std::vector<size_type> perm(n);
+        std::iota(perm.begin(), perm.end(), size_type(0));
+        std::sort(perm.begin(), perm.end(), [&expos, m](const size_type &a, const size_type &b) {
+            return std::lexicographical_compare(expos.begin() + a * m, expos.begin() + (a + 1u) * m,
+                                                expos.begin() + b * m, expos.begin() + (b + 1u) * m);
+        });
+        // Build the prefix tree. The node with index 0 is the root, representing the empty product. path[i]
+        // is the node representing the first i + 1 factors of the key being processed.
+        std::vector<size_type> path(m);
+        m_leaves.resize(n);
+        for (size_type k = 0u; k < n; ++k) {
+            const auto j = perm[k];
+            // Determine the length of the prefix shared with the previous key.
+            size_type d = 0u;
+            if (k) {
+                const auto prev = perm[k - 1u];
+                while (d < m && expos[j * m + d] == expos[prev * m + d]) {
+                    ++d;
+                }
+            }
+            for (; d < m; ++d) {
+                m_nodes_ops.emplace_back(d ? path[d - 1u] : size_type(0), pidx[j * m + d]);
+                path[d] = static_cast<size_type>(m_nodes_ops.size());
+            }
+            m_leaves[j] = m ? path[m - 1u] : size_type(0);
+        }
+        // Prepare the storage for the evaluation.
+        m_powers.resize(m_powers_ops.size(), value_type(1));
+        m_values.resize(m_nodes_ops.size() + 1u, value_type(1));
+    }
+    /// Evaluation.
+    /**
+     * @param values the evaluation values, in the order of the symbol set of the series used for construction.
+     *
+     * @return the result of the evaluation of the series with the values \p values.
+     *
+     * @throws std::invalid_argument if the size of \p values differs from the size of the symbol set of the series
+     * used for construction.
+     * @throws unspecified any exception thrown by:
+     * - piranha::pow(),
+     * - the arithmetic operations on the evaluation types.
+     */
+    eval_type operator()(const std::vector<T> &values)
+    {
+        if (unlikely(values.size() != m_symbol_set.size())) {
+            piranha_throw(std::invalid_argument, "invalid vector of values for the evaluation plan: the size of the "
+                                                 "vector of values ("
+                                                     + std::to_string(values.size())
+                                                     + ") differs from the size of the reference set of symbols ("
+                                                     + std::to_string(m_symbol_set.size()) + ")");
+        }
+        for (size_type i = 0u; i < m_powers_ops.size(); ++i) {
+            const auto &op = m_powers_ops[i];
+            m_powers[i] = piranha::pow(values[static_cast<typename std::vector<T>::size_type>(op.first)], op.second);
+        }
+        // NOTE: the nodes are stored after their parents. The children of the root are copies of the powers,
+        // as in the evaluation of the keys.
+        for (size_type i = 0u; i < m_nodes_ops.size(); ++i) {
+            const auto &op = m_nodes_ops[i];
+            auto &out = m_values[i + 1u];
+            out = op.first ? m_values[op.first] : m_powers[op.second];
+            if (op.first) {
+                out *= m_powers[op.second];
+            }
+        }
+        eval_type retval(0);
+        for (size_type j = 0u; j < m_leaves.size(); ++j) {
+            series_eval_multadd(retval, m_cfs[j], m_values[m_leaves[j]]);
+        }
+        return retval;
+    }
+    /// Symbol set.
+    /**
+     * @return a const reference to the symbol set of the series used for construction.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms of the series used for construction.
+     */
+    size_type size() const
+    {
+        return m_leaves.size();
+    }
+    /// Number of multiplications.
+    /**
+     * @return the number of multiplications (excluding the ones involving coefficients) performed during
+     * each evaluation.
+     */
+    size_type n_multiplications() const
+    {
+        return static_cast<size_type>(std::count_if(m_nodes_ops.begin(), m_nodes_ops.end(),
+                                                    [](const std::pair<size_type, size_type> &p) { return p.first; }));
+    }
+
+private:
+    symbol_fset m_symbol_set;
+    std::vector<cf_eval_type> m_cfs;
+    // Symbol index and exponent for each power.
+    std::vector<std::pair<size_type, expo_type>> m_powers_ops;
+    // Parent node and power index for each node.
+    std::vector<std::pair<size_type, size_type>> m_nodes_ops;
+    // Node representing the key of each term.
+    std::vector<size_type> m_leaves;
+    // Storage for the evaluation.
+    std::vector<value_type> m_powers;
+    std::vector<value_type> m_values;
+};
+} // namespace piranha
+
+#endif
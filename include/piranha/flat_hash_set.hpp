@@ -0,0 +1,1306 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FLAT_HASH_SET_HPP
+#define PIRANHA_FLAT_HASH_SET_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/debug_access.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Helpers for the control words of piranha::flat_hash_set. A control word packs the control bytes
+// of the 8 slots of a group, the byte of slot i being stored in bits [8 * i, 8 * i + 8). The control
+// byte of an empty slot is 0x80, the control byte of a full slot is the 7-bit tag of the stored element.
+// The bytes are probed all at once with SWAR arithmetic, which is portable to any architecture.
+constexpr std::uint64_t fhs_lsbs = 0x0101010101010101ull;
+constexpr std::uint64_t fhs_msbs = 0x8080808080808080ull;
+constexpr unsigned fhs_empty_byte = 0x80u;
+
+// Mask with bit 8 * i + 7 set for every slot i whose control byte may be equal to tag. There can be
+// false positives (to be filtered out via the equality predicate), but never on empty slots.
+inline std::uint64_t fhs_match(std::uint64_t ctrl, unsigned tag)
+{
+    const auto x = ctrl ^ (fhs_lsbs * tag);
+    return (x - fhs_lsbs) & ~x & fhs_msbs;
+}
+
+// Mask of the empty slots.
+inline std::uint64_t fhs_match_empty(std::uint64_t ctrl)
+{
+    return ctrl & fhs_msbs;
+}
+
+// Mask of the full slots.
+inline std::uint64_t fhs_match_full(std::uint64_t ctrl)
+{
+    return ~ctrl & fhs_msbs;
+}
+
+// Index of the lowest slot in a nonzero mask. The lowest set bit, 1 << (8 * i + 7), is isolated and shifted
+// down to 1 << (8 * i): the multiplication then moves the byte of the constant containing i to the top.
+inline unsigned fhs_lowest_slot(std::uint64_t mask)
+{
+    piranha_assert(mask);
+    return static_cast<unsigned>((((mask & (~mask + 1u)) >> 7) * 0x0001020304050607ull) >> 56);
+}
+
+// Set the control byte of slot i to b.
+inline std::uint64_t fhs_set_byte(std::uint64_t ctrl, unsigned i, unsigned b)
+{
+    piranha_assert(i < 8u && b <= fhs_empty_byte);
+    return (ctrl & ~(std::uint64_t(0xffu) << (8u * i))) | (std::uint64_t(b) << (8u * i));
+}
+}
+
+/// Open-addressing hash set.
+/**
+ * Hash set with the same interface as piranha::hash_set (including the low-level interface used by piranha::series
+ * and by the series multipliers), but with a flat memory layout. It can be selected as the terms container of a
+ * series type via piranha::series_container.
+ *
+ * Each bucket of the set is a group of 8 slots stored contiguously in the buckets array, together with a word of
+ * control bytes in the style of Swiss tables. The control byte of a full slot holds a 7-bit tag extracted from the
+ * hash value (the bits immediately above those used for the bucket index), so that a lookup compares the tag
+ * against all the slots of a group at once and invokes the equality predicate only on the (rare) tag matches.
+ * When a group is full, the elements destined to it are placed in overflow groups chained to it. That is, probing
+ * never leaves the destination bucket: this preserves the property, relied upon by the multi-threaded low-level
+ * routines in piranha, that concurrent operations on distinct buckets do not interfere with each other.
+ *
+ * With respect to piranha::hash_set, the main differences are the following:
+ *
+ * - the maximum load factor is 7 (i.e., the average number of elements per group is kept below 7/8 of
+ *   its capacity),
+ * - insertions and erasures do not invalidate iterators, pointers and references to the other elements
+ *   of the set (apart from the erasure of the last element of an overflow group, which invalidates the iterators
+ *   pointing past the erased element in the same bucket).
+ *
+ * Note that for performance reasons the implementation employs sizes that are powers of two. Hence, particular care
+ * should be taken that the hash function does not exhibit commensurabilities with powers of 2.
+ *
+ * ## Type requirements ##
+ *
+ * - \p T must satisfy piranha::is_container_element,
+ * - \p Hash must satisfy piranha::is_hash_function_object,
+ * - \p Pred must satisfy piranha::is_equality_function_object.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations apart from methods involving insertion,
+ * which provide the basic guarantee (after a failed insertion, the set will be left in an unspecified but valid state).
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object equivalent to an empty set whose hasher and
+ * equality predicate have been moved-from.
+ */
+template <typename T, typename Hash = std::hash<T>, typename Pred = std::equal_to<T>>
+class flat_hash_set
+{
+    PIRANHA_TT_CHECK(is_container_element, T);
+    PIRANHA_TT_CHECK(is_hash_function_object, Hash, T);
+    PIRANHA_TT_CHECK(is_equality_function_object, Pred, T);
+    // Make friend with debug access class.
+    template <typename U>
+    friend class debug_access;
+    // Number of slots in a group.
+    static const unsigned group_width = 8u;
+    // A group of slots. The groups in the buckets array are the heads of the chains of
+    // overflow groups, and they are the objects returned by _get_bucket_list().
+    struct group {
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+        // Iterator over the elements stored in a chain of groups.
+        template <typename U>
+        class iterator_impl : public boost::iterator_facade<iterator_impl<U>, U, boost::forward_traversal_tag>
+        {
+            typedef typename std::conditional<std::is_const<U>::value, group const *, group *>::type ptr_type;
+            template <typename V>
+            friend class iterator_impl;
+
+        public:
+            iterator_impl() : m_g(nullptr), m_idx(0u) {}
+            explicit iterator_impl(ptr_type g, unsigned idx) : m_g(g), m_idx(idx) {}
+            // Constructor from other iterator type.
+            template <typename V,
+                      enable_if_t<std::is_convertible<typename iterator_impl<V>::ptr_type, ptr_type>::value, int> = 0>
+            iterator_impl(const iterator_impl<V> &other) : m_g(other.m_g), m_idx(other.m_idx)
+            {
+            }
+            // Iterator to the first element in the chain starting at g.
+            static iterator_impl first(ptr_type g)
+            {
+                for (; g; g = g->m_next) {
+                    const auto m = fhs_match_full(g->m_ctrl);
+                    if (m) {
+                        return iterator_impl(g, fhs_lowest_slot(m));
+                    }
+                }
+                return iterator_impl{};
+            }
+
+        private:
+            friend class boost::iterator_core_access;
+            void increment()
+            {
+                piranha_assert(m_g && m_idx < group_width && ((fhs_match_full(m_g->m_ctrl) >> (8u * m_idx + 7u)) & 1u));
+                // Full slots past the current one. NOTE: for m_idx == 7 the shift wraps around
+                // to zero, and the mask becomes zero as well.
+                const auto m
+                    = fhs_match_full(m_g->m_ctrl) & ~((std::uint64_t(2u) << (8u * m_idx + 7u)) - std::uint64_t(1u));
+                if (m) {
+                    m_idx = fhs_lowest_slot(m);
+                } else {
+                    *this = first(m_g->m_next);
+                }
+            }
+            template <typename V>
+            bool equal(const iterator_impl<V> &other) const
+            {
+                return m_g == other.m_g && m_idx == other.m_idx;
+            }
+            U &dereference() const
+            {
+                piranha_assert(m_g && m_idx < group_width);
+                return *m_g->ptr(m_idx);
+            }
+
+        public:
+            ptr_type m_g;
+            unsigned m_idx;
+        };
+        typedef iterator_impl<T> iterator;
+        typedef iterator_impl<T const> const_iterator;
+        // Static checks on the iterator types.
+        PIRANHA_TT_CHECK(is_forward_iterator, iterator);
+        PIRANHA_TT_CHECK(is_forward_iterator, const_iterator);
+        group() : m_ctrl(fhs_lsbs * fhs_empty_byte), m_next(nullptr) {}
+        // The storage is managed by flat_hash_set, disable copy and move.
+        group(const group &) = delete;
+        group(group &&) = delete;
+        group &operator=(const group &) = delete;
+        group &operator=(group &&) = delete;
+        const T *ptr(unsigned i) const
+        {
+            return static_cast<const T *>(static_cast<const void *>(&m_slots[i]));
+        }
+        T *ptr(unsigned i)
+        {
+            return static_cast<T *>(static_cast<void *>(&m_slots[i]));
+        }
+        iterator begin()
+        {
+            return iterator::first(this);
+        }
+        iterator end()
+        {
+            return iterator{};
+        }
+        const_iterator begin() const
+        {
+            return const_iterator::first(this);
+        }
+        const_iterator end() const
+        {
+            return const_iterator{};
+        }
+        bool empty() const
+        {
+            return begin() == end();
+        }
+        // Destroy all the elements in the chain starting at this, and delete the overflow groups.
+        void destroy()
+        {
+            group *cur = this;
+            while (cur) {
+                for (auto m = fhs_match_full(cur->m_ctrl); m; m &= m - 1u) {
+                    cur->ptr(fhs_lowest_slot(m))->~T();
+                }
+                cur->m_ctrl = fhs_lsbs * fhs_empty_byte;
+                const auto next = cur->m_next;
+                cur->m_next = nullptr;
+                if (cur != this) {
+                    ::delete cur;
+                }
+                cur = next;
+            }
+        }
+        ~group()
+        {
+            destroy();
+        }
+        std::uint64_t m_ctrl;
+        group *m_next;
+        storage_type m_slots[group_width];
+    };
+    // Allocator type.
+    typedef std::allocator<group> allocator_type;
+
+public:
+    /// Functor type for the calculation of hash values.
+    using hasher = Hash;
+    /// Functor type for comparing the items in the set.
+    using key_equal = Pred;
+    /// Key type.
+    using key_type = T;
+    /// Size type.
+    /**
+     * Alias for \p std::size_t.
+     */
+    using size_type = std::size_t;
+
+private:
+    // The container is a pointer to an array of groups.
+    using ptr_type = group *;
+    // Internal pack type, as in hash_set.
+    using pack_type = std::tuple<ptr_type, hasher, key_equal, allocator_type>;
+    // A few handy accessors.
+    ptr_type &ptr()
+    {
+        return std::get<0u>(m_pack);
+    }
+    const ptr_type &ptr() const
+    {
+        return std::get<0u>(m_pack);
+    }
+    const hasher &hash() const
+    {
+        return std::get<1u>(m_pack);
+    }
+    const key_equal &k_equal() const
+    {
+        return std::get<2u>(m_pack);
+    }
+    allocator_type &allocator()
+    {
+        return std::get<3u>(m_pack);
+    }
+    const allocator_type &allocator() const
+    {
+        return std::get<3u>(m_pack);
+    }
+    // Definition of the iterator type for the set.
+    template <typename Key>
+    class iterator_impl : public boost::iterator_facade<iterator_impl<Key>, Key, boost::forward_traversal_tag>
+    {
+        friend class flat_hash_set;
+        typedef typename std::conditional<std::is_const<Key>::value, flat_hash_set const, flat_hash_set>::type set_type;
+        typedef typename std::conditional<std::is_const<Key>::value, typename group::const_iterator,
+                                          typename group::iterator>::type it_type;
+
+    public:
+        iterator_impl() : m_set(nullptr), m_idx(0u), m_it() {}
+        explicit iterator_impl(set_type *set, const size_type &idx, it_type it) : m_set(set), m_idx(idx), m_it(it) {}
+
+    private:
+        friend class boost::iterator_core_access;
+        void increment()
+        {
+            piranha_assert(m_set);
+            auto &container = m_set->ptr();
+            // Assert that the current iterator is valid.
+            piranha_assert(m_idx < m_set->bucket_count());
+            piranha_assert(m_it != container[m_idx].end());
+            ++m_it;
+            if (m_it == container[m_idx].end()) {
+                const size_type container_size = m_set->bucket_count();
+                while (true) {
+                    ++m_idx;
+                    if (m_idx == container_size) {
+                        m_it = it_type{};
+                        return;
+                    }
+                    m_it = container[m_idx].begin();
+                    if (m_it != container[m_idx].end()) {
+                        return;
+                    }
+                }
+            }
+        }
+        bool equal(const iterator_impl &other) const
+        {
+            piranha_assert(m_set && other.m_set);
+            return (m_idx == other.m_idx && m_it == other.m_it);
+        }
+        Key &dereference() const
+        {
+            piranha_assert(m_set && m_idx < m_set->bucket_count() && m_it != m_set->ptr()[m_idx].end());
+            return *m_it;
+        }
+
+    private:
+        set_type *m_set;
+        size_type m_idx;
+        it_type m_it;
+    };
+    void init_from_n_buckets(const size_type &n_buckets, unsigned n_threads)
+    {
+        piranha_assert(!ptr() && !m_log2_size && !m_n_elements);
+        if (unlikely(!n_threads)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+        // Proceed to actual construction only if the requested number of buckets is nonzero.
+        if (!n_buckets) {
+            return;
+        }
+        const size_type log2_size = get_log2_from_hint(n_buckets);
+        const size_type size = size_type(1u) << log2_size;
+        auto new_ptr = allocator().allocate(size);
+        if (unlikely(!new_ptr)) {
+            piranha_throw(std::bad_alloc, );
+        }
+        // NOTE: the construction of a group is a noexcept operation, no need to account for rolling back.
+        auto constructor = [this, new_ptr](const size_type &start, const size_type &end) {
+            for (size_type i = start; i != end; ++i) {
+                this->allocator().construct(&new_ptr[i]);
+            }
+        };
+        if (n_threads == 1u) {
+            constructor(size_type(0u), size);
+        } else {
+            // Construct the groups in parallel, so that the memory pages are first touched by the threads
+            // that will be operating on them.
+            using crs_type = std::vector<std::pair<size_type, size_type>>;
+            crs_type constructed_ranges(static_cast<typename crs_type::size_type>(n_threads),
+                                        std::make_pair(size_type(0u), size_type(0u)));
+            if (unlikely(constructed_ranges.size() != n_threads)) {
+                piranha_throw(std::bad_alloc, );
+            }
+            auto thread_function = [&constructor, &constructed_ranges](const size_type &start, const size_type &end,
+                                                                       const unsigned &thread_idx) {
+                constructor(start, end);
+                constructed_ranges[thread_idx] = std::make_pair(start, end);
+            };
+            const auto wpt = size / n_threads;
+            future_list<decltype(thread_function(0u, 0u, 0u))> f_list;
+            try {
+                for (unsigned i = 0u; i < n_threads; ++i) {
+                    const auto start = static_cast<size_type>(wpt * i),
+                               end = static_cast<size_type>((i == n_threads - 1u) ? size : wpt * (i + 1u));
+                    f_list.push_back(thread_pool::enqueue(i, thread_function, start, end, i));
+                }
+                f_list.wait_all();
+            } catch (...) {
+                f_list.wait_all();
+                for (const auto &r : constructed_ranges) {
+                    for (size_type i = r.first; i != r.second; ++i) {
+                        allocator().destroy(&new_ptr[i]);
+                    }
+                }
+                allocator().deallocate(new_ptr, size);
+                throw;
+            }
+        }
+        // Assign the members.
+        ptr() = new_ptr;
+        m_log2_size = log2_size;
+    }
+    // Destroy all elements and deallocate ptr().
+    void destroy_and_deallocate()
+    {
+        if (ptr()) {
+            const size_type size = size_type(1u) << m_log2_size;
+            for (size_type i = 0u; i < size; ++i) {
+                allocator().destroy(&ptr()[i]);
+            }
+            allocator().deallocate(ptr(), size);
+        } else {
+            piranha_assert(!m_log2_size && !m_n_elements);
+        }
+    }
+    // Tag of an element with hash value h: the 7 bits immediately above those determining the bucket.
+    unsigned tag_from_hash(const std::size_t &h) const
+    {
+        return static_cast<unsigned>((h >> m_log2_size) & 0x7fu);
+    }
+    // Enabler for insert().
+    template <typename U>
+    using insert_enabler = enable_if_t<std::is_same<key_type, uncvref_t<U>>::value, int>;
+    // Run a consistency check on the set, will return false if something is wrong.
+    bool sanity_check() const
+    {
+        size_type count = 0u;
+        for (size_type i = 0u; i < bucket_count(); ++i) {
+            for (auto g = &ptr()[i]; g; g = g->m_next) {
+                const auto full = fhs_match_full(g->m_ctrl);
+                // Overflow groups are never empty.
+                if (g != &ptr()[i] && !full) {
+                    return false;
+                }
+                for (auto m = full; m; m &= m - 1u) {
+                    const auto idx = fhs_lowest_slot(m);
+                    const auto &x = *g->ptr(idx);
+                    if (_bucket(x) != i || ((g->m_ctrl >> (8u * idx)) & 0xffu) != tag_from_hash(hash()(x))) {
+                        return false;
+                    }
+                    ++count;
+                }
+            }
+        }
+        if (count != m_n_elements) {
+            return false;
+        }
+        // m_log2_size must not be equal to or greater than the number of bits of size_type.
+        if (m_log2_size >= unsigned(std::numeric_limits<size_type>::digits)) {
+            return false;
+        }
+        // The container pointer must be consistent with the other members.
+        if (!ptr() && (m_log2_size || m_n_elements)) {
+            return false;
+        }
+        // Check size is consistent with number of iterator traversals.
+        count = 0u;
+        for (auto it = begin(); it != end(); ++it, ++count) {
+        }
+        if (count != m_n_elements) {
+            return false;
+        }
+        return true;
+    }
+    // The number of available nonzero sizes will be the number of bits in the size type.
+    static const size_type m_n_nonzero_sizes = static_cast<size_type>(std::numeric_limits<size_type>::digits);
+    // Get log2 of set size at least equal to hint. To be used only when hint is not zero.
+    static size_type get_log2_from_hint(const size_type &hint)
+    {
+        piranha_assert(hint);
+        for (size_type i = 0u; i < m_n_nonzero_sizes; ++i) {
+            if ((size_type(1u) << i) >= hint) {
+                return i;
+            }
+        }
+        piranha_throw(std::bad_alloc, );
+    }
+
+public:
+    /// Iterator type.
+    /**
+     * A read-only forward iterator.
+     */
+    using iterator = iterator_impl<key_type const>;
+
+private:
+    // Static checks on the iterator type.
+    PIRANHA_TT_CHECK(is_forward_iterator, iterator);
+
+public:
+    /// Const iterator type.
+    /**
+     * Equivalent to the iterator type.
+     */
+    using const_iterator = iterator;
+    /// Local iterator.
+    /**
+     * Const iterator that can be used to iterate through a single bucket.
+     */
+    using local_iterator = typename group::const_iterator;
+    /// Default constructor.
+    /**
+     * If not specified, it will default-initialise the hasher and the equality predicate. The resulting
+     * hash set will be empty.
+     *
+     * @param h hasher functor.
+     * @param k equality predicate.
+     *
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    flat_hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+    {
+    }
+    /// Constructor from number of buckets.
+    /**
+     * Will construct a set whose number of buckets is at least equal to \p n_buckets. If \p n_threads is not 1,
+     * then the first \p n_threads threads from piranha::thread_pool will be used concurrently for the initialisation
+     * of the set.
+     *
+     * @param n_buckets desired number of buckets.
+     * @param h hasher functor.
+     * @param k equality predicate.
+     * @param n_threads number of threads to use during initialisation.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum, or in
+     * case of memory errors.
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by:
+     * - the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>,
+     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back(), if \p n_threads is not 1.
+     */
+    explicit flat_hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{},
+                           unsigned n_threads = 1u)
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+    {
+        init_from_n_buckets(n_buckets, n_threads);
+    }
+    /// Copy constructor.
+    /**
+     * The hasher, the equality comparator and the allocator will also be copied.
+     *
+     * @param other piranha::flat_hash_set that will be copied into \p this.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors,
+     * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    flat_hash_set(const flat_hash_set &other)
+        : m_pack(nullptr, other.hash(), other.k_equal(), other.allocator()), m_log2_size(0u), m_n_elements(0u)
+    {
+        init_from_n_buckets(other.bucket_count(), 1u);
+        try {
+            for (size_type i = 0u; i < other.bucket_count(); ++i) {
+                for (const auto &x : other.ptr()[i]) {
+                    _unique_insert(x, i);
+                }
+            }
+        } catch (...) {
+            destroy_and_deallocate();
+            throw;
+        }
+        m_n_elements = other.m_n_elements;
+    }
+    /// Move constructor.
+    /**
+     * After the move, \p other will have zero buckets and zero elements, and its hasher and equality predicate
+     * will have been used to move-construct their counterparts in \p this.
+     *
+     * @param other set to be moved.
+     */
+    flat_hash_set(flat_hash_set &&other) noexcept
+        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements)
+    {
+        // Clear out the other one.
+        other.ptr() = nullptr;
+        other.m_log2_size = 0u;
+        other.m_n_elements = 0u;
+    }
+    /// Constructor from range.
+    /**
+     * Create a set with a copy of a range.
+     *
+     * @param begin begin of range.
+     * @param end end of range.
+     * @param n_buckets number of initial buckets.
+     * @param h hash functor.
+     * @param k key equality predicate.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>, or arising
+     * from calling insert() on the elements of the range.
+     */
+    template <typename InputIterator>
+    explicit flat_hash_set(const InputIterator &begin, const InputIterator &end, const size_type &n_buckets = 0u,
+                           const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+    {
+        init_from_n_buckets(n_buckets, 1u);
+        for (auto it = begin; it != end; ++it) {
+            insert(*it);
+        }
+    }
+    /// Constructor from initializer list.
+    /**
+     * Will insert() all the elements of the initializer list, ignoring the return value of the operation.
+     * Hash functor and equality predicate will be default-constructed.
+     *
+     * @param list initializer list of elements to be inserted.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+     * @throws unspecified any exception thrown by either insert() or of the default constructor of <tt>Hash</tt> or
+     * <tt>Pred</tt>.
+     */
+    template <typename U>
+    explicit flat_hash_set(std::initializer_list<U> list)
+        : m_pack(nullptr, hasher{}, key_equal{}, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+    {
+        for (const auto &x : list) {
+            insert(x);
+        }
+    }
+    /// Destructor.
+    /**
+     * No side effects.
+     */
+    ~flat_hash_set()
+    {
+        piranha_assert(sanity_check());
+        destroy_and_deallocate();
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other assignment argument.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    flat_hash_set &operator=(const flat_hash_set &other)
+    {
+        if (likely(this != &other)) {
+            flat_hash_set tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other set to be moved into \p this.
+     *
+     * @return reference to \p this.
+     */
+    flat_hash_set &operator=(flat_hash_set &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            destroy_and_deallocate();
+            m_pack = std::move(other.m_pack);
+            m_log2_size = other.m_log2_size;
+            m_n_elements = other.m_n_elements;
+            // Zero out other.
+            other.ptr() = nullptr;
+            other.m_log2_size = 0u;
+            other.m_n_elements = 0u;
+        }
+        return *this;
+    }
+    /// Const begin iterator.
+    /**
+     * @return flat_hash_set::const_iterator to the first element of the set, or end() if the set is empty.
+     */
+    const_iterator begin() const
+    {
+        const_iterator retval;
+        retval.m_set = this;
+        size_type idx = 0u;
+        const auto b_count = bucket_count();
+        for (; idx < b_count; ++idx) {
+            retval.m_it = ptr()[idx].begin();
+            if (retval.m_it != ptr()[idx].end()) {
+                break;
+            }
+        }
+        retval.m_idx = idx;
+        return retval;
+    }
+    /// Const end iterator.
+    /**
+     * @return flat_hash_set::const_iterator to the position past the last element of the set.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, bucket_count(), local_iterator{});
+    }
+    /// Begin iterator.
+    /**
+     * @return flat_hash_set::iterator to the first element of the set, or end() if the set is empty.
+     */
+    iterator begin()
+    {
+        return static_cast<flat_hash_set const *>(this)->begin();
+    }
+    /// End iterator.
+    /**
+     * @return flat_hash_set::iterator to the position past the last element of the set.
+     */
+    iterator end()
+    {
+        return static_cast<flat_hash_set const *>(this)->end();
+    }
+    /// Number of elements contained in the set.
+    /**
+     * @return number of elements in the set.
+     */
+    size_type size() const
+    {
+        return m_n_elements;
+    }
+    /// Test for empty set.
+    /**
+     * @return \p true if size() returns 0, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return !size();
+    }
+    /// Number of buckets.
+    /**
+     * @return number of buckets (i.e., of groups of slots) in the set.
+     */
+    size_type bucket_count() const
+    {
+        return (ptr()) ? (size_type(1u) << m_log2_size) : size_type(0u);
+    }
+    /// Load factor.
+    /**
+     * @return <tt>(double)size() / bucket_count()</tt>, or 0 if the set is empty.
+     */
+    double load_factor() const
+    {
+        const auto b_count = bucket_count();
+        return (b_count) ? static_cast<double>(size()) / static_cast<double>(b_count) : 0.;
+    }
+    /// Index of destination bucket.
+    /**
+     * Index to which \p k would belong, were it to be inserted into the set. The index of the
+     * destination bucket is the hash value reduced modulo the bucket count.
+     *
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k.
+     *
+     * @throws std::invalid_argument if bucket_count() returns zero.
+     * @throws unspecified any exception thrown by _bucket().
+     */
+    size_type bucket(const key_type &k) const
+    {
+        if (unlikely(!bucket_count())) {
+            piranha_throw(std::invalid_argument, "cannot calculate bucket index in an empty set");
+        }
+        return _bucket(k);
+    }
+    /// Find element.
+    /**
+     * @param k element to be located.
+     *
+     * @return flat_hash_set::const_iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by _find() or by _bucket().
+     */
+    const_iterator find(const key_type &k) const
+    {
+        if (unlikely(!bucket_count())) {
+            return end();
+        }
+        return _find(k, _bucket(k));
+    }
+    /// Find element.
+    /**
+     * @param k element to be located.
+     *
+     * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by _find().
+     */
+    iterator find(const key_type &k)
+    {
+        return static_cast<const flat_hash_set *>(this)->find(k);
+    }
+    /// Maximum load factor.
+    /**
+     * @return the maximum load factor allowed before a resize.
+     */
+    double max_load_factor() const
+    {
+        // 7/8 of the capacity of a group.
+        return static_cast<double>(group_width) * 7. / 8.;
+    }
+    /// Insert element.
+    /**
+     * \note
+     * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and
+     * references.
+     *
+     * If no other key equivalent to \p k exists in the set, the insertion is successful and returns the
+     * <tt>(it,true)</tt> pair - where \p it is the position in the set into which the object has been inserted.
+     * Otherwise, the return value will be <tt>(it,false)</tt> - where \p it is the position of the existing
+     * equivalent object.
+     *
+     * @param k object that will be inserted into the set.
+     *
+     * @return <tt>(flat_hash_set::iterator,bool)</tt> pair containing an iterator to the newly-inserted object (or its
+     * existing equivalent) and the result of the operation.
+     *
+     * @throws unspecified any exception thrown by:
+     * - flat_hash_set::key_type's copy constructor,
+     * - _find(),
+     * - _bucket().
+     * @throws std::overflow_error if a successful insertion would result in size() exceeding the maximum
+     * value representable by type piranha::flat_hash_set::size_type.
+     * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+     * maximum number of buckets.
+     */
+    template <typename U, insert_enabler<U> = 0>
+    std::pair<iterator, bool> insert(U &&k)
+    {
+        auto b_count = bucket_count();
+        // Handle the case of a set with no buckets.
+        if (unlikely(!b_count)) {
+            _increase_size();
+            b_count = 1u;
+        }
+        // Try to locate the element.
+        auto bucket_idx = _bucket(k);
+        const auto it = _find(k, bucket_idx);
+        if (it != end()) {
+            // Item already present, exit.
+            return std::make_pair(it, false);
+        }
+        if (unlikely(m_n_elements == std::numeric_limits<size_type>::max())) {
+            piranha_throw(std::overflow_error, "maximum number of elements reached");
+        }
+        // Item is new. Handle the case in which we need to rehash because of load factor.
+        if (unlikely(static_cast<double>(m_n_elements + size_type(1u)) / static_cast<double>(b_count)
+                     > max_load_factor())) {
+            _increase_size();
+            // We need a new bucket index in case of a rehash.
+            bucket_idx = _bucket(k);
+        }
+        const auto it_retval = _unique_insert(std::forward<U>(k), bucket_idx);
+        ++m_n_elements;
+        return std::make_pair(it_retval, true);
+    }
+    /// Erase element.
+    /**
+     * Erase the element to which \p it points. \p it must be a valid iterator
+     * pointing to an element of the set.
+     *
+     * After the operation has taken place, the size() of the set will be decreased by one.
+     *
+     * @param it iterator to the element of the set to be removed.
+     *
+     * @return iterator pointing to the element following \p it prior to the element being erased, or end() if
+     * no such element exists.
+     */
+    iterator erase(const_iterator it)
+    {
+        piranha_assert(!empty());
+        const auto b_it = _erase(it);
+        iterator retval;
+        retval.m_set = this;
+        const auto b_count = bucket_count();
+        if (b_it == ptr()[it.m_idx].end()) {
+            // Travel to the next non-empty bucket if the erased element was the last one in its bucket,
+            // without going past the end of the set.
+            auto idx = static_cast<size_type>(it.m_idx + 1u);
+            for (; idx < b_count; ++idx) {
+                retval.m_it = ptr()[idx].begin();
+                if (retval.m_it != ptr()[idx].end()) {
+                    break;
+                }
+            }
+            retval.m_idx = idx;
+        } else {
+            // Otherwise, just copy over the iterator returned by _erase().
+            retval.m_idx = it.m_idx;
+            retval.m_it = b_it;
+        }
+        piranha_assert(m_n_elements);
+        // Update the number of elements.
+        m_n_elements = static_cast<size_type>(m_n_elements - 1u);
+        return retval;
+    }
+    /// Remove all elements.
+    /**
+     * After this call, size() and bucket_count() will both return zero.
+     */
+    void clear()
+    {
+        destroy_and_deallocate();
+        // Reset the members.
+        ptr() = nullptr;
+        m_log2_size = 0u;
+        m_n_elements = 0u;
+    }
+    /// Swap content.
+    /**
+     * Will use \p std::swap to swap hasher and equality predicate.
+     *
+     * @param other swap argument.
+     *
+     * @throws unspecified any exception thrown by swapping hasher or equality predicate via \p std::swap.
+     */
+    void swap(flat_hash_set &other)
+    {
+        std::swap(m_pack, other.m_pack);
+        std::swap(m_log2_size, other.m_log2_size);
+        std::swap(m_n_elements, other.m_n_elements);
+    }
+    /// Rehash set.
+    /**
+     * Change the number of buckets in the set to at least \p new_size. No rehash is performed
+     * if rehashing would lead to exceeding the maximum load factor. If \p n_threads is not 1,
+     * then the first \p n_threads threads from piranha::thread_pool will be used concurrently during
+     * the rehash operation: the buckets of the new set are initialised in parallel and, if the number of buckets
+     * does not decrease, the elements are moved to the new set in parallel as well (each bucket of the new set
+     * receiving elements from exactly one bucket of the old set).
+     *
+     * @param new_size new desired number of buckets.
+     * @param n_threads number of threads to use.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by the constructor from number of buckets,
+     * _unique_insert(), _bucket(), piranha::thread_pool::enqueue() or piranha::future_list::push_back().
+     */
+    void rehash(const size_type &new_size, unsigned n_threads = 1u)
+    {
+        if (unlikely(!n_threads)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+        // If rehash is requested to zero, do something only if there are no items stored in the set.
+        if (!new_size) {
+            if (!size()) {
+                clear();
+            }
+            return;
+        }
+        // Do nothing if rehashing to the new size would lead to exceeding the max load factor.
+        if (static_cast<double>(size()) / static_cast<double>(new_size) > max_load_factor()) {
+            return;
+        }
+        // Create a new set with needed amount of buckets.
+        flat_hash_set new_set(new_size, hash(), k_equal(), n_threads);
+        // Move the elements in the buckets [start, end) of this into new_set.
+        auto mover = [this, &new_set](const size_type &start, const size_type &end) {
+            for (size_type i = start; i != end; ++i) {
+                for (auto &x : this->ptr()[i]) {
+                    const auto new_idx = new_set._bucket(x);
+                    new_set._unique_insert(std::move(x), new_idx);
+                }
+            }
+        };
+        const auto b_count = bucket_count();
+        if (b_count < n_threads) {
+            n_threads = static_cast<unsigned>(b_count ? b_count : 1u);
+        }
+        try {
+            if (n_threads == 1u || new_set.bucket_count() < b_count) {
+                mover(size_type(0u), b_count);
+            } else {
+                // NOTE: the sizes are powers of two, hence if the new set is not smaller than this the elements
+                // of distinct buckets of this end up in distinct buckets of new_set.
+                const auto wpt = b_count / n_threads;
+                future_list<decltype(mover(0u, 0u))> f_list;
+                try {
+                    for (unsigned i = 0u; i < n_threads; ++i) {
+                        const auto start = static_cast<size_type>(wpt * i),
+                                   end = static_cast<size_type>((i == n_threads - 1u) ? b_count : wpt * (i + 1u));
+                        f_list.push_back(thread_pool::enqueue(i, mover, start, end));
+                    }
+                    f_list.wait_all();
+                    f_list.get_all();
+                } catch (...) {
+                    f_list.wait_all();
+                    throw;
+                }
+            }
+        } catch (...) {
+            // Clear up both this and the new set upon any kind of error.
+            clear();
+            new_set.clear();
+            throw;
+        }
+        // Retain the number of elements.
+        new_set.m_n_elements = m_n_elements;
+        // Clear the old set.
+        clear();
+        // Assign the new set.
+        *this = std::move(new_set);
+    }
+    /// Get information on the sparsity of the set.
+    /**
+     * @return an <tt>std::map<size_type,size_type></tt> in which the key is the number of elements
+     * stored in a bucket and the mapped type the number of buckets containing those many elements.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    std::map<size_type, size_type> evaluate_sparsity() const
+    {
+        const auto it_f = ptr() + bucket_count();
+        std::map<size_type, size_type> retval;
+        size_type counter;
+        for (auto it = ptr(); it != it_f; ++it) {
+            counter = 0u;
+            for (auto l_it = it->begin(); l_it != it->end(); ++l_it) {
+                ++counter;
+            }
+            ++retval[counter];
+        }
+        return retval;
+    }
+    /** @name Low-level interface
+     * Low-level methods and types.
+     */
+    //@{
+    /// Mutable iterator.
+    /**
+     * This iterator type provides non-const access to the elements of the set. Please note that modifications
+     * to an existing element of the set might invalidate the relation between the element and its position in the set.
+     * After such modifications of one or more elements, the only valid operation is flat_hash_set::clear()
+     * (destruction of the set before calling flat_hash_set::clear() will lead to assertion failures in debug mode).
+     */
+    using _m_iterator = iterator_impl<key_type>;
+    /// Mutable begin iterator.
+    /**
+     * @return flat_hash_set::_m_iterator to the beginning of the set.
+     */
+    _m_iterator _m_begin()
+    {
+        _m_iterator retval;
+        retval.m_set = this;
+        size_type idx = 0u;
+        const auto b_count = bucket_count();
+        for (; idx < b_count; ++idx) {
+            retval.m_it = ptr()[idx].begin();
+            if (retval.m_it != ptr()[idx].end()) {
+                break;
+            }
+        }
+        retval.m_idx = idx;
+        return retval;
+    }
+    /// Mutable end iterator.
+    /**
+     * @return flat_hash_set::_m_iterator to the end of the set.
+     */
+    _m_iterator _m_end()
+    {
+        return _m_iterator(this, bucket_count(), typename group::iterator{});
+    }
+    /// Insert unique element (low-level).
+    /**
+     * \note
+     * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and
+     * references.
+     *
+     * The parameter \p bucket_idx is the index of the destination bucket for \p k and, for a
+     * set with a nonzero number of buckets, must be equal to the output
+     * of bucket() before the insertion.
+     *
+     * This method will not check if a key equivalent to \p k already exists in the set, it will not
+     * update the number of elements present in the set after the insertion, it will not resize
+     * the set in case the maximum load factor is exceeded, nor it will check
+     * if the value of \p bucket_idx is correct. The element is stored in the first free slot of the
+     * destination group, or in a new overflow group if all the groups of the bucket are full.
+     *
+     * @param k object that will be inserted into the set.
+     * @param bucket_idx destination bucket for \p k.
+     *
+     * @return iterator pointing to the newly-inserted element.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of flat_hash_set::key_type, by the
+     * call operator of the hasher or by memory allocation errors.
+     */
+    template <typename U, insert_enabler<U> = 0>
+    iterator _unique_insert(U &&k, const size_type &bucket_idx)
+    {
+        // Assert that key is not present already in the set.
+        piranha_assert(find(k) == end());
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k));
+        const auto tag = tag_from_hash(hash()(k));
+        group *g = &ptr()[bucket_idx];
+        while (true) {
+            const auto m = fhs_match_empty(g->m_ctrl);
+            if (m) {
+                const auto idx = fhs_lowest_slot(m);
+                ::new (static_cast<void *>(&g->m_slots[idx])) T(std::forward<U>(k));
+                g->m_ctrl = fhs_set_byte(g->m_ctrl, idx, tag);
+                return iterator(this, bucket_idx, local_iterator(g, idx));
+            }
+            if (!g->m_next) {
+                break;
+            }
+            g = g->m_next;
+        }
+        // All the groups in the bucket are full, append a new overflow group.
+        std::unique_ptr<group> new_g(::new group());
+        ::new (static_cast<void *>(&new_g->m_slots[0])) T(std::forward<U>(k));
+        new_g->m_ctrl = fhs_set_byte(new_g->m_ctrl, 0u, tag);
+        g->m_next = new_g.release();
+        return iterator(this, bucket_idx, local_iterator(g->m_next, 0u));
+    }
+    /// Find element (low-level).
+    /**
+     * Locate element in the set. The parameter \p bucket_idx is the index of the destination bucket for \p k and, for
+     * a set with a nonzero number of buckets, must be equal to the output
+     * of bucket() before the insertion. This method will not check if the value of \p bucket_idx is correct.
+     *
+     * @param k element to be located.
+     * @param bucket_idx index of the destination bucket for \p k.
+     *
+     * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by calling the hasher or the equality predicate.
+     */
+    const_iterator _find(const key_type &k, const size_type &bucket_idx) const
+    {
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k) && bucket_idx < bucket_count());
+        const auto tag = tag_from_hash(hash()(k));
+        for (const group *g = &ptr()[bucket_idx]; g; g = g->m_next) {
+            for (auto m = fhs_match(g->m_ctrl, tag); m; m &= m - 1u) {
+                const auto idx = fhs_lowest_slot(m);
+                if (k_equal()(*g->ptr(idx), k)) {
+                    return const_iterator(this, bucket_idx, local_iterator(g, idx));
+                }
+            }
+        }
+        return end();
+    }
+    /// Index of destination bucket from hash value.
+    /**
+     * Note that this method will not check if the number of buckets is zero.
+     *
+     * @param hash input hash value.
+     *
+     * @return index of the destination bucket for an object with hash value \p hash.
+     */
+    size_type _bucket_from_hash(const std::size_t &hash) const
+    {
+        piranha_assert(bucket_count());
+        return hash % (size_type(1u) << m_log2_size);
+    }
+    /// Index of destination bucket (low-level).
+    /**
+     * Equivalent to bucket(), with the exception that this method will not check
+     * if the number of buckets is zero.
+     *
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k.
+     *
+     * @throws unspecified any exception thrown by the call operator of the hasher.
+     */
+    size_type _bucket(const key_type &k) const
+    {
+        return _bucket_from_hash(hash()(k));
+    }
+    /// Force update of the number of elements.
+    /**
+     * After this call, size() will return \p new_size regardless of the true number of elements in the set.
+     *
+     * @param new_size new set size.
+     */
+    void _update_size(const size_type &new_size)
+    {
+        m_n_elements = new_size;
+    }
+    /// Increase bucket count.
+    /**
+     * Increase the number of buckets to the next implementation-defined value.
+     *
+     * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+     * maximum number of buckets.
+     * @throws unspecified any exception thrown by rehash().
+     */
+    void _increase_size()
+    {
+        if (unlikely(m_log2_size >= m_n_nonzero_sizes - 1u)) {
+            piranha_throw(std::bad_alloc, );
+        }
+        piranha_assert(ptr() || (!ptr() && !m_log2_size));
+        const auto new_log2_size = (ptr()) ? (m_log2_size + 1u) : 0u;
+        rehash(size_type(1u) << new_log2_size);
+    }
+    /// Const reference to a bucket.
+    /**
+     * The returned object is a range (with \p begin() and \p end() methods returning
+     * flat_hash_set::local_iterator) over the elements of the bucket.
+     *
+     * @param idx index of the bucket that will be returned.
+     *
+     * @return a const reference to the bucket positioned at index \p idx.
+     */
+    const group &_get_bucket_list(const size_type &idx) const
+    {
+        piranha_assert(idx < bucket_count());
+        return ptr()[idx];
+    }
+    /// Erase element.
+    /**
+     * Erase the element to which \p it points. \p it must be a valid iterator
+     * pointing to an element of the set.
+     *
+     * This method will not update the number of elements in the set, nor it will try to access elements
+     * outside the bucket to which \p it refers.
+     *
+     * @param it iterator to the element of the set to be removed.
+     *
+     * @return local iterator pointing to the element following \p it prior to the element being erased, or local end()
+     * if no such element exists.
+     */
+    local_iterator _erase(const_iterator it)
+    {
+        // Verify the iterator is valid.
+        piranha_assert(it.m_set == this);
+        piranha_assert(it.m_idx < bucket_count());
+        piranha_assert(it.m_it != ptr()[it.m_idx].end());
+        // Locate the group of the element, and its predecessor in the chain.
+        group *prev = nullptr, *g = &ptr()[it.m_idx];
+        while (g != it.m_it.m_g) {
+            prev = g;
+            g = g->m_next;
+            piranha_assert(g);
+        }
+        const auto idx = it.m_it.m_idx;
+        // Compute the return value before destroying the element.
+        auto retval = it.m_it;
+        ++retval;
+        g->ptr(idx)->~T();
+        g->m_ctrl = fhs_set_byte(g->m_ctrl, idx, fhs_empty_byte);
+        // Release the group if it is an overflow group which became empty. The return value
+        // cannot point into it.
+        if (prev && !fhs_match_full(g->m_ctrl)) {
+            prev->m_next = g->m_next;
+            g->m_next = nullptr;
+            ::delete g;
+        }
+        return retval;
+    }
+    //@}
+private:
+    pack_type m_pack;
+    size_type m_log2_size;
+    size_type m_n_elements;
+};
+
+template <typename T, typename Hash, typename Pred>
+const unsigned flat_hash_set<T, Hash, Pred>::group_width;
+
+template <typename T, typename Hash, typename Pred>
+const typename flat_hash_set<T, Hash, Pred>::size_type flat_hash_set<T, Hash, Pred>::m_n_nonzero_sizes;
+}
+
+#endif
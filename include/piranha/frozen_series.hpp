@@ -0,0 +1,587 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FROZEN_SERIES_HPP
+#define PIRANHA_FROZEN_SERIES_HPP
+
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/init.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/key/key_degree.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/degree.hpp>
+#include <piranha/math/is_zero.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+template <typename>
+class mapped_series;
+
+/// Frozen series.
+/**
+ * This class stores the terms of a series of type \p Series in structure-of-arrays form: the coefficients
+ * and the keys are kept in two separate contiguous vectors, in the same order. The representation is read-only
+ * with respect to the structure of the series (terms cannot be looked up or inserted), and it is meant for
+ * passes that stream over all the terms touching only one of the two components, such as evaluation, degree
+ * queries, filtering by coefficient and serialization. Such passes do not have to drag the unused component
+ * through the cache, and they do not have to chase the overflow nodes of the hash set.
+ *
+ * A frozen series can be built from a series in linear time (moving from an rvalue series will move the
+ * coefficients and the keys out of the terms), and it can be converted back to a series via thaw(), which
+ * skips all the checks performed by piranha::series::insert() as the terms are already known to be unique
+ * and compatible.
+ *
+ * \p Series must satisfy piranha::is_series, otherwise a compile-time error will be emitted.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless noted otherwise, this class provides the strong exception safety guarantee.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in a state equivalent to a
+ * default-constructed object.
+ */
+template <typename Series>
+class frozen_series
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+    // mapped_series fills the vectors directly when freezing.
+    template <typename>
+    friend class mapped_series;
+
+public:
+    /// Alias for the term type of \p Series.
+    using term_type = typename Series::term_type;
+    /// Alias for the coefficient type.
+    using cf_type = typename term_type::cf_type;
+    /// Alias for the key type.
+    using key_type = typename term_type::key_type;
+    /// Size type.
+    using size_type = typename std::vector<cf_type>::size_type;
+
+private:
+    // Total and partial degree types: the degree is available only if it depends on the keys alone.
+    template <typename K, typename T>
+    using degree_enabler
+        = enable_if_t<conjunction<is_key_degree_type<K>, negation<is_degree_type<const cf_type &>>>::value, T>;
+    // Keep only the terms at the indices for which mask is true, preserving the order.
+    void compact(const std::vector<char> &mask)
+    {
+        piranha_assert(mask.size() == size());
+        size_type j = 0u;
+        for (size_type i = 0u; i < mask.size(); ++i) {
+            if (mask[i]) {
+                if (i != j) {
+                    m_cfs[j] = std::move(m_cfs[i]);
+                    m_keys[j] = std::move(m_keys[i]);
+                }
+                ++j;
+            }
+        }
+        m_cfs.erase(m_cfs.begin() + static_cast<typename std::vector<cf_type>::difference_type>(j), m_cfs.end());
+        m_keys.erase(m_keys.begin() + static_cast<typename std::vector<key_type>::difference_type>(j), m_keys.end());
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The default constructor will initialise an empty frozen series with an empty symbol set.
+     */
+    frozen_series() = default;
+    /// Defaulted copy constructor.
+    frozen_series(const frozen_series &) = default;
+    /// Move constructor.
+    /**
+     * @param other the construction argument.
+     */
+    frozen_series(frozen_series &&other) noexcept
+        : m_symbol_set(std::move(other.m_symbol_set)), m_cfs(std::move(other.m_cfs)), m_keys(std::move(other.m_keys))
+    {
+        other.m_symbol_set = symbol_fset{};
+        other.m_cfs.clear();
+        other.m_keys.clear();
+    }
+    /// Constructor from series.
+    /**
+     * The terms of \p s are copied into the frozen series, in the iteration order of \p s.
+     *
+     * @param s the input series.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers or by
+     * the copy constructors of coefficient and key types.
+     */
+    explicit frozen_series(const Series &s) : m_symbol_set(s.get_symbol_set())
+    {
+        m_cfs.reserve(s.size());
+        m_keys.reserve(s.size());
+        for (const auto &t : s._container()) {
+            m_cfs.push_back(t.m_cf);
+            m_keys.push_back(t.m_key);
+        }
+    }
+    /// Constructor from series rvalue.
+    /**
+     * The coefficients and the keys of \p s are moved into the frozen series, in the iteration order of \p s.
+     * After the construction, \p s is left in a state equivalent to a default-constructed series.
+     *
+     * @param s the input series.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    explicit frozen_series(Series &&s) : m_symbol_set(s.get_symbol_set())
+    {
+        m_cfs.reserve(s.size());
+        m_keys.reserve(s.size());
+        // NOTE: the terms are left in a moved-from state in the container, which is cleared
+        // below without further access to them (apart from destruction).
+        auto &c = s._container();
+        const auto it_f = c._m_end();
+        for (auto it = c._m_begin(); it != it_f; ++it) {
+            m_cfs.push_back(std::move(it->m_cf));
+            m_keys.push_back(std::move(it->m_key));
+        }
+        s = Series{};
+    }
+    /// Defaulted destructor.
+    ~frozen_series() = default;
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    frozen_series &operator=(const frozen_series &other)
+    {
+        if (likely(this != &other)) {
+            *this = frozen_series(other);
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    frozen_series &operator=(frozen_series &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            m_symbol_set = std::move(other.m_symbol_set);
+            m_cfs = std::move(other.m_cfs);
+            m_keys = std::move(other.m_keys);
+            other.m_symbol_set = symbol_fset{};
+            other.m_cfs.clear();
+            other.m_keys.clear();
+        }
+        return *this;
+    }
+    /// Convert to series.
+    /**
+     * The returned series will have the same symbol set as \p this, and it will be constructed
+     * by inserting the terms directly in the (presized) terms container, bypassing the checks of
+     * piranha::series::insert().
+     *
+     * @return a series equal to the one represented by \p this.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::series and of its terms container,
+     * - the copy constructors of coefficient and key types,
+     * - <tt>boost::numeric_cast()</tt>.
+     */
+    Series thaw() const &
+    {
+        return thaw_impl(*this);
+    }
+    /// Convert to series (rvalue overload).
+    /**
+     * This overload will move the coefficients and the keys of \p this into the returned series.
+     * After the call, \p this is left in a state equivalent to a default-constructed object.
+     *
+     * @return a series equal to the one represented by \p this.
+     *
+     * @throws unspecified any exception thrown by the public interface of piranha::series and of its terms container,
+     * or by <tt>boost::numeric_cast()</tt>.
+     */
+    Series thaw() &&
+    {
+        auto retval = thaw_impl(std::move(*this));
+        *this = frozen_series{};
+        return retval;
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms in the frozen series.
+     */
+    size_type size() const
+    {
+        return m_cfs.size();
+    }
+    /// Emptiness test.
+    /**
+     * @return \p true if the frozen series has no terms, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return m_cfs.empty();
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Coefficients getter.
+    /**
+     * @return a const reference to the vector of coefficients.
+     */
+    const std::vector<cf_type> &cfs() const
+    {
+        return m_cfs;
+    }
+    /// Keys getter.
+    /**
+     * @return a const reference to the vector of keys, in the same order as cfs().
+     */
+    const std::vector<key_type> &keys() const
+    {
+        return m_keys;
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is enabled only if piranha::math::evaluate() is enabled for \p Series and \p T.
+     *
+     * The result is the same as calling piranha::math::evaluate() on the series represented by \p this.
+     *
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating \p this according to the evaluation dictionary \p dict.
+     *
+     * @throws std::invalid_argument if a symbol of \p this does not appear in \p dict.
+     * @throws unspecified any exception thrown by coefficient and key evaluation, by memory errors
+     * in standard containers or by arithmetic operations on the evaluation type.
+     */
+    template <typename T, typename S = Series, typename = math_series_evaluate_enabler<S, T>>
+    series_eval_type<S, T> evaluate(const symbol_fmap<T> &dict) const
+    {
+        const auto evec = series_evaluation_vector(m_symbol_set, dict);
+        series_eval_type<S, T> retval(0);
+        const auto s = size();
+        for (size_type i = 0u; i < s; ++i) {
+            series_eval_multadd(retval, math::evaluate(m_cfs[i], dict), m_keys[i].evaluate(evec, m_symbol_set));
+        }
+        return retval;
+    }
+    /// Total degree.
+    /**
+     * \note
+     * This method is enabled only if the key type satisfies piranha::is_key_degree_type
+     * and the coefficient type does not satisfy piranha::is_degree_type.
+     *
+     * Only the keys are accessed. If \p this is empty, zero will be returned.
+     *
+     * @return the maximum total degree of the keys.
+     *
+     * @throws unspecified any exception thrown by piranha::key_degree() or by the construction and comparison
+     * of the degree type.
+     */
+    template <typename K = const key_type &>
+    degree_enabler<K, total_key_degree_t<K>> degree() const
+    {
+        using ret_type = total_key_degree_t<K>;
+        if (m_keys.empty()) {
+            return ret_type(0);
+        }
+        auto retval = piranha::key_degree(m_keys[0], m_symbol_set);
+        for (size_type i = 1u; i < m_keys.size(); ++i) {
+            auto tmp = piranha::key_degree(m_keys[i], m_symbol_set);
+            if (retval < tmp) {
+                retval = std::move(tmp);
+            }
+        }
+        return retval;
+    }
+    /// Partial degree.
+    /**
+     * \note
+     * This method is enabled only if the key type satisfies piranha::is_key_degree_type
+     * and the coefficient type does not satisfy piranha::is_degree_type.
+     *
+     * Only the keys are accessed. If \p this is empty, zero will be returned.
+     *
+     * @param names names of the variables to be considered in the computation of the degree.
+     *
+     * @return the maximum partial degree of the keys.
+     *
+     * @throws unspecified any exception thrown by piranha::key_degree(), piranha::ss_intersect_idx()
+     * or by the construction and comparison of the degree type.
+     */
+    template <typename K = const key_type &>
+    degree_enabler<K, partial_key_degree_t<K>> degree(const symbol_fset &names) const
+    {
+        using ret_type = partial_key_degree_t<K>;
+        if (m_keys.empty()) {
+            return ret_type(0);
+        }
+        const auto idx = ss_intersect_idx(m_symbol_set, names);
+        auto retval = piranha::key_degree(m_keys[0], idx, m_symbol_set);
+        for (size_type i = 1u; i < m_keys.size(); ++i) {
+            auto tmp = piranha::key_degree(m_keys[i], idx, m_symbol_set);
+            if (retval < tmp) {
+                retval = std::move(tmp);
+            }
+        }
+        return retval;
+    }
+    /// Filter terms.
+    /**
+     * The terms for which \p func returns \p false are removed, preserving the order of the remaining ones.
+     * If \p func only inspects the coefficient (e.g., for truncation by magnitude), the keys are touched only
+     * when terms need to be moved.
+     *
+     * The basic exception safety guarantee is provided.
+     *
+     * @param func the filtering functor, which will be passed a coefficient and the corresponding key.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by \p func, by memory errors in standard containers or
+     * by the move assignment operators of coefficient and key types.
+     */
+    frozen_series &filter(const std::function<bool(const cf_type &, const key_type &)> &func)
+    {
+        std::vector<char> mask(size());
+        for (size_type i = 0u; i < mask.size(); ++i) {
+            mask[i] = static_cast<char>(func(m_cfs[i], m_keys[i]));
+        }
+        compact(mask);
+        return *this;
+    }
+    /// Negate in-place.
+    /**
+     * math::negate() is called on all the coefficients, and the terms whose coefficient becomes zero are removed.
+     * The keys are touched only if terms need to be removed.
+     *
+     * The basic exception safety guarantee is provided.
+     *
+     * @throws unspecified any exception thrown by math::negate(), piranha::is_zero(), memory errors
+     * in standard containers or by the move assignment operators of coefficient and key types.
+     */
+    void negate()
+    {
+        std::vector<char> mask(size());
+        bool need_compact = false;
+        for (size_type i = 0u; i < mask.size(); ++i) {
+            math::negate(m_cfs[i]);
+            mask[i] = static_cast<char>(!piranha::is_zero(m_cfs[i]));
+            need_compact = need_compact || !mask[i];
+        }
+        if (unlikely(need_compact)) {
+            compact(mask);
+        }
+    }
+
+private:
+    template <typename F>
+    static Series thaw_impl(F &&f)
+    {
+        using s_size_t = decltype(std::declval<const Series &>().size());
+        Series retval;
+        retval.set_symbol_set(f.m_symbol_set);
+        auto &c = retval._container();
+        if (f.empty()) {
+            return retval;
+        }
+        c.rehash(boost::numeric_cast<s_size_t>(std::ceil(static_cast<double>(f.size()) / c.max_load_factor())));
+        for (size_type i = 0u; i < f.size(); ++i) {
+            term_type t(std::forward<F>(f).cf_at(i), std::forward<F>(f).key_at(i));
+            const auto b = c._bucket(t);
+            c._unique_insert(std::move(t), b);
+        }
+        c._update_size(piranha::safe_cast<s_size_t>(f.size()));
+        return retval;
+    }
+    // Accessors used by thaw_impl() to copy or move out the components.
+    const cf_type &cf_at(size_type i) const &
+    {
+        return m_cfs[i];
+    }
+    cf_type &&cf_at(size_type i) &&
+    {
+        return std::move(m_cfs[i]);
+    }
+    const key_type &key_at(size_type i) const &
+    {
+        return m_keys[i];
+    }
+    key_type &&key_at(size_type i) &&
+    {
+        return std::move(m_keys[i]);
+    }
+
+private:
+    symbol_fset m_symbol_set;
+    std::vector<cf_type> m_cfs;
+    std::vector<key_type> m_keys;
+};
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+inline namespace impl
+{
+
+template <typename Archive, typename Series>
+using frozen_series_boost_save_enabler
+    = enable_if_t<conjunction<has_boost_save<Archive, decltype(symbol_fset{}.size())>,
+                              has_boost_save<Archive, const std::string &>,
+                              has_boost_save<Archive, typename frozen_series<Series>::size_type>,
+                              has_boost_save<Archive, typename Series::term_type::cf_type>,
+                              has_boost_save<Archive,
+                                             boost_s11n_key_wrapper<typename Series::term_type::key_type>>>::value>;
+} // namespace impl
+
+/// Specialisation of piranha::boost_save() for piranha::frozen_series.
+/**
+ * \note
+ * This specialisation is enabled only if the types involved in the serialization of a piranha::frozen_series
+ * satisfy piranha::has_boost_save.
+ *
+ * The archive layout is the same used for piranha::series, hence a frozen series can be deserialized
+ * directly into an object of type \p Series via piranha::boost_load().
+ */
+template <typename Archive, typename Series>
+struct boost_save_impl<Archive, frozen_series<Series>, frozen_series_boost_save_enabler<Archive, Series>> {
+    /// Call operator.
+    /**
+     * @param ar the target archive.
+     * @param fs the frozen series to be serialized.
+     *
+     * @throws unspecified any exception thrown by piranha::boost_save().
+     */
+    void operator()(Archive &ar, const frozen_series<Series> &fs) const
+    {
+        const auto &ss = fs.get_symbol_set();
+        boost_save(ar, ss.size());
+        for (const auto &sym : ss) {
+            boost_save(ar, sym);
+        }
+        // NOTE: the series size is stored with the size type of the series, in order
+        // to be loadable as a series.
+        boost_save(ar, piranha::safe_cast<decltype(std::declval<const Series &>().size())>(fs.size()));
+        const auto &cfs = fs.cfs();
+        const auto &keys = fs.keys();
+        for (decltype(cfs.size()) i = 0u; i < cfs.size(); ++i) {
+            boost_save(ar, cfs[i]);
+            boost_save(ar, boost_s11n_key_wrapper<typename Series::term_type::key_type>{keys[i], ss});
+        }
+    }
+};
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+inline namespace impl
+{
+
+template <typename Stream, typename Series>
+using frozen_series_msgpack_pack_enabler
+    = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, std::string>,
+                              has_msgpack_pack<Stream, typename Series::term_type::cf_type>,
+                              key_has_msgpack_pack<Stream, typename Series::term_type::key_type>>::value>;
+} // namespace impl
+
+/// Specialisation of piranha::msgpack_pack() for piranha::frozen_series.
+/**
+ * \note
+ * This specialisation is enabled only if:
+ * - \p Stream satisfies piranha::is_msgpack_stream,
+ * - the coefficient type and \p std::string satisfy piranha::has_msgpack_pack,
+ * - the key type satisfies piranha::key_has_msgpack_pack.
+ *
+ * The msgpack representation is the same used for piranha::series, hence a frozen series can be deserialized
+ * directly into an object of type \p Series via piranha::msgpack_convert().
+ */
+template <typename Stream, typename Series>
+struct msgpack_pack_impl<Stream, frozen_series<Series>, frozen_series_msgpack_pack_enabler<Stream, Series>> {
+    /// Call operator.
+    /**
+     * @param packer the target <tt>msgpack::packer</tt>.
+     * @param fs the input frozen series.
+     * @param f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::packer</tt>,
+     * - piranha::msgpack_pack(),
+     * - piranha::safe_cast(),
+     * - the <tt>%msgpack_pack()</tt> method of the key.
+     */
+    void operator()(msgpack::packer<Stream> &packer, const frozen_series<Series> &fs, msgpack_format f) const
+    {
+        packer.pack_array(2u);
+        const auto &ss = fs.get_symbol_set();
+        packer.pack_array(piranha::safe_cast<std::uint32_t>(ss.size()));
+        for (const auto &sym : ss) {
+            msgpack_pack(packer, sym, f);
+        }
+        const auto &cfs = fs.cfs();
+        const auto &keys = fs.keys();
+        packer.pack_array(piranha::safe_cast<std::uint32_t>(cfs.size()));
+        for (decltype(cfs.size()) i = 0u; i < cfs.size(); ++i) {
+            packer.pack_array(2u);
+            msgpack_pack(packer, cfs[i], f);
+            keys[i].msgpack_pack(packer, f, ss);
+        }
+    }
+};
+
+#endif
+} // namespace piranha
+
+#endif
@@ -0,0 +1,600 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_GRADED_SERIES_HPP
+#define PIRANHA_GRADED_SERIES_HPP
+
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/safe_integral_arith.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/key/key_degree.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+/// Graded series.
+/**
+ * This class stores the terms of a series of type \p Series in slices of homogeneous degree: each slice is a
+ * \p Series containing all the terms with a given degree. The degree is either the total degree or the
+ * partial degree with respect to a set of symbols chosen upon construction, and it is computed from the keys only.
+ * The representation is meant for truncated power series arithmetic:
+ * - the maximum and minimum degrees are available in constant time,
+ * - the truncation to a maximum degree consists in dropping the slices above the limit,
+ * - in the multiplication only the pairs of slices whose degrees sum to a value within the truncation
+ *   limit are multiplied, and each slice-by-slice product lands entirely in the slice of the result with
+ *   the summed degree, without any degree computation on the terms.
+ *
+ * The multiplication honours the automatic truncation of \p Series (see, e.g.,
+ * polynomial::set_auto_truncate_degree()) when the truncation is based on the same degree as the grading.
+ * A graded series with no terms has no slices, and no slice of a graded series is ever empty.
+ *
+ * \p Series must satisfy piranha::is_series, its key type must satisfy piranha::is_key_degree_type, and the total
+ * and partial degree types of the key must be the same. Otherwise, a compile-time error will be emitted.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless noted otherwise, this class provides the strong exception safety guarantee.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Series>
+class graded_series
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+    PIRANHA_TT_CHECK(is_key_degree_type, const typename Series::term_type::key_type &);
+
+public:
+    /// Alias for the term type of \p Series.
+    using term_type = typename Series::term_type;
+    /// Alias for the coefficient type.
+    using cf_type = typename term_type::cf_type;
+    /// Alias for the key type.
+    using key_type = typename term_type::key_type;
+    /// Degree type.
+    using degree_type = total_key_degree_t<const key_type &>;
+    /// Slices type.
+    /**
+     * The slices are stored in a map from the degree to a \p Series containing the terms of that degree.
+     */
+    using slices_type = std::map<degree_type, Series>;
+
+private:
+    PIRANHA_TT_CHECK(std::is_same, degree_type, partial_key_degree_t<const key_type &>);
+    // Detect the untruncated multiplication of Series.
+    template <typename S>
+    using um_t = decltype(S::untruncated_multiplication(std::declval<const S &>(), std::declval<const S &>()));
+    // Degree arithmetics, checked for overflow if the degree type is a C++ integral type.
+    template <typename T, enable_if_t<!std::is_integral<T>::value, int> = 0>
+    static T degree_add(const T &a, const T &b)
+    {
+        return a + b;
+    }
+    template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+    static T degree_add(const T &a, const T &b)
+    {
+        return detail::safe_int_add(a, b);
+    }
+    template <typename T, enable_if_t<!std::is_integral<T>::value, int> = 0>
+    static T degree_sub(const T &a, const T &b)
+    {
+        return a - b;
+    }
+    template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+    static T degree_sub(const T &a, const T &b)
+    {
+        return detail::safe_int_sub(a, b);
+    }
+    // Slice-by-slice multiplication. If the truncation limit has already been taken into account, the untruncated
+    // multiplication of Series is used (if available), otherwise the normal multiplication operator.
+    template <typename S = Series, enable_if_t<is_detected<um_t, S>::value, int> = 0>
+    static Series slice_mult(const Series &a, const Series &b, bool untruncated)
+    {
+        if (untruncated) {
+            return Series::untruncated_multiplication(a, b);
+        }
+        return a * b;
+    }
+    template <typename S = Series, enable_if_t<!is_detected<um_t, S>::value, int> = 0>
+    static Series slice_mult(const Series &a, const Series &b, bool)
+    {
+        return a * b;
+    }
+    // Determine the truncation limit from the automatic truncation settings of Series. The limit is used
+    // only if the truncation is based on the same degree as the grading of a.
+    template <typename S = Series, enable_if_t<detail::has_get_auto_truncate_degree<S>::value, int> = 0>
+    static std::pair<bool, degree_type> auto_truncation(const graded_series &a, bool &untruncated)
+    {
+        const auto t = S::get_auto_truncate_degree();
+        untruncated = true;
+        if (std::get<0u>(t) == 0) {
+            return std::make_pair(false, degree_type(0));
+        }
+        if ((std::get<0u>(t) == 1 && !a.m_partial)
+            || (std::get<0u>(t) == 2 && a.m_partial && std::get<2u>(t) == a.m_names)) {
+            return std::make_pair(true, piranha::safe_cast<degree_type>(std::get<1u>(t)));
+        }
+        // A different truncation is active: leave it to the multiplication of the slices.
+        untruncated = false;
+        return std::make_pair(false, degree_type(0));
+    }
+    template <typename S = Series, enable_if_t<!detail::has_get_auto_truncate_degree<S>::value, int> = 0>
+    static std::pair<bool, degree_type> auto_truncation(const graded_series &, bool &untruncated)
+    {
+        untruncated = true;
+        return std::make_pair(false, degree_type(0));
+    }
+    // Check that a and b are graded in the same way.
+    static void check_grading(const graded_series &a, const graded_series &b)
+    {
+        if (unlikely(a.m_partial != b.m_partial || a.m_names != b.m_names)) {
+            piranha_throw(std::invalid_argument, "cannot operate on graded series with different gradings");
+        }
+    }
+    // Bring the symbol set of this and of all the slices to ss (which must be a superset of the current symbol set).
+    void extend_symbol_set(const symbol_fset &ss)
+    {
+        if (ss == m_symbol_set) {
+            return;
+        }
+        Series tmp;
+        tmp.set_symbol_set(ss);
+        for (auto &p : m_slices) {
+            // NOTE: adding an empty series with a larger symbol set will merge the symbols.
+            p.second += tmp;
+        }
+        m_symbol_set = ss;
+    }
+    // Add (or subtract) other to this, slice by slice.
+    template <bool Sign>
+    graded_series &add_impl(const graded_series &other)
+    {
+        check_grading(*this, other);
+        const auto ss = std::get<0>(ss_merge(m_symbol_set, other.m_symbol_set));
+        // NOTE: work on a copy to provide the strong exception safety guarantee.
+        graded_series retval(*this);
+        retval.extend_symbol_set(ss);
+        Series tmp;
+        tmp.set_symbol_set(ss);
+        for (const auto &p : other.m_slices) {
+            auto res = retval.m_slices.emplace(p.first, tmp);
+            auto &slice = res.first->second;
+            if (Sign) {
+                slice += p.second;
+            } else {
+                slice -= p.second;
+            }
+            if (slice.empty()) {
+                retval.m_slices.erase(res.first);
+            }
+        }
+        *this = std::move(retval);
+        return *this;
+    }
+    // Multiplication. If limit.first is true, only the pairs of slices whose degrees sum up to at most limit.second
+    // are multiplied.
+    static graded_series mult_impl(const graded_series &a, const graded_series &b,
+                                   const std::pair<bool, degree_type> &limit, bool untruncated)
+    {
+        check_grading(a, b);
+        graded_series retval;
+        retval.m_symbol_set = std::get<0>(ss_merge(a.m_symbol_set, b.m_symbol_set));
+        retval.m_names = a.m_names;
+        retval.m_partial = a.m_partial;
+        // The slice-by-slice products, grouped by degree.
+        std::map<degree_type, std::vector<Series>> products;
+        for (const auto &pa : a.m_slices) {
+            const auto end_b
+                = limit.first ? b.m_slices.upper_bound(degree_sub(limit.second, pa.first)) : b.m_slices.end();
+            for (auto it = b.m_slices.begin(); it != end_b; ++it) {
+                auto p = slice_mult(pa.second, it->second, untruncated);
+                if (!p.empty()) {
+                    products[degree_add(pa.first, it->first)].push_back(std::move(p));
+                }
+            }
+        }
+        for (auto &p : products) {
+            auto s = (p.second.size() == 1u) ? std::move(p.second[0]) : piranha::sum(p.second);
+            if (!s.empty()) {
+                retval.m_slices.emplace(p.first, std::move(s));
+            }
+        }
+        return retval;
+    }
+    // Distribute the terms of s into the slices.
+    void distribute(const Series &s)
+    {
+        const auto idx = ss_intersect_idx(m_symbol_set, m_names);
+        Series tmp;
+        tmp.set_symbol_set(m_symbol_set);
+        for (const auto &t : s._container()) {
+            const degree_type d = m_partial ? piranha::key_degree(t.m_key, idx, m_symbol_set)
+                                            : piranha::key_degree(t.m_key, m_symbol_set);
+            m_slices.emplace(d, tmp).first->second.insert(t);
+        }
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The default constructor will initialise an empty graded series with an empty symbol set, graded
+     * by total degree.
+     */
+    graded_series() = default;
+    /// Defaulted copy constructor.
+    graded_series(const graded_series &) = default;
+    /// Defaulted move constructor.
+    graded_series(graded_series &&) = default;
+    /// Constructor from series (total degree).
+    /**
+     * The terms of \p s will be distributed into slices according to their total degree.
+     *
+     * @param s the input series.
+     *
+     * @throws unspecified any exception thrown by piranha::key_degree(), by memory errors in standard containers
+     * or by the public interface of piranha::series.
+     */
+    explicit graded_series(const Series &s) : m_symbol_set(s.get_symbol_set())
+    {
+        distribute(s);
+    }
+    /// Constructor from series (partial degree).
+    /**
+     * The terms of \p s will be distributed into slices according to their partial degree with respect to
+     * the symbols in \p names.
+     *
+     * @param s the input series.
+     * @param names the symbols that will be considered in the computation of the degree.
+     *
+     * @throws unspecified any exception thrown by piranha::key_degree(), piranha::ss_intersect_idx(),
+     * by memory errors in standard containers or by the public interface of piranha::series.
+     */
+    explicit graded_series(const Series &s, const symbol_fset &names)
+        : m_symbol_set(s.get_symbol_set()), m_names(names), m_partial(true)
+    {
+        distribute(s);
+    }
+    /// Defaulted destructor.
+    ~graded_series() = default;
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    graded_series &operator=(const graded_series &other)
+    {
+        if (likely(this != &other)) {
+            *this = graded_series(other);
+        }
+        return *this;
+    }
+    /// Defaulted move assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    graded_series &operator=(graded_series &&) = default;
+    /// Convert to series.
+    /**
+     * The terms of the slices are inserted directly in the (presized) terms container of the returned series,
+     * bypassing the checks of piranha::series::insert(), as they are already known to be unique and compatible.
+     *
+     * @return a series equal to the one represented by \p this.
+     *
+     * @throws unspecified any exception thrown by the public interface of piranha::series and of its terms container,
+     * by the copy constructors of coefficient and key types or by <tt>boost::numeric_cast()</tt>.
+     */
+    Series to_series() const
+    {
+        using s_size_t = decltype(std::declval<const Series &>().size());
+        Series retval;
+        retval.set_symbol_set(m_symbol_set);
+        if (m_slices.empty()) {
+            return retval;
+        }
+        const auto s = size();
+        auto &c = retval._container();
+        c.rehash(boost::numeric_cast<s_size_t>(std::ceil(static_cast<double>(s) / c.max_load_factor())));
+        // NOTE: if copying a term throws, the terms already inserted must be destroyed here, as the size
+        // of the container has not been updated yet.
+        try {
+            for (const auto &p : m_slices) {
+                for (const auto &t : p.second._container()) {
+                    const auto b = c._bucket(t);
+                    c._unique_insert(t, b);
+                }
+            }
+        } catch (...) {
+            c.clear();
+            throw;
+        }
+        c._update_size(s);
+        return retval;
+    }
+    /// Number of terms.
+    /**
+     * @return the total number of terms in the slices.
+     */
+    typename Series::size_type size() const
+    {
+        typename Series::size_type retval(0);
+        for (const auto &p : m_slices) {
+            retval = static_cast<typename Series::size_type>(retval + p.second.size());
+        }
+        return retval;
+    }
+    /// Emptiness test.
+    /**
+     * @return \p true if the graded series has no terms, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return m_slices.empty();
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Partial grading.
+    /**
+     * @return \p true if the slices are graded by the partial degree with respect to the symbols returned by
+     * get_names(), \p false if they are graded by the total degree.
+     */
+    bool is_partial() const
+    {
+        return m_partial;
+    }
+    /// Names getter.
+    /**
+     * @return a const reference to the symbols considered in the partial degree (empty for the total degree).
+     */
+    const symbol_fset &get_names() const
+    {
+        return m_names;
+    }
+    /// Slices getter.
+    /**
+     * @return a const reference to the map of the slices.
+     */
+    const slices_type &slices() const
+    {
+        return m_slices;
+    }
+    /// Degree.
+    /**
+     * The complexity of this method is constant.
+     *
+     * @return the maximum degree of the terms (either total or partial, according to the grading), or zero
+     * if \p this is empty.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of the degree type.
+     */
+    degree_type degree() const
+    {
+        return m_slices.empty() ? degree_type(0) : m_slices.rbegin()->first;
+    }
+    /// Low degree.
+    /**
+     * The complexity of this method is constant.
+     *
+     * @return the minimum degree of the terms (either total or partial, according to the grading), or zero
+     * if \p this is empty.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of the degree type.
+     */
+    degree_type ldegree() const
+    {
+        return m_slices.empty() ? degree_type(0) : m_slices.begin()->first;
+    }
+    /// Truncation.
+    /**
+     * The slices with degree greater than \p max_degree are dropped.
+     *
+     * @param max_degree the maximum degree.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by piranha::safe_cast() or by the comparison of degrees.
+     */
+    template <typename T>
+    graded_series &truncate_degree(const T &max_degree)
+    {
+        m_slices.erase(m_slices.upper_bound(piranha::safe_cast<degree_type>(max_degree)), m_slices.end());
+        return *this;
+    }
+    /// In-place addition.
+    /**
+     * The slices of \p other are added to the slices of \p this with the same degree. The symbol sets
+     * are merged if needed.
+     *
+     * @param other the argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::invalid_argument if \p this and \p other have different gradings.
+     * @throws unspecified any exception thrown by the public interface of piranha::series, by
+     * piranha::ss_merge() or by memory errors in standard containers.
+     */
+    graded_series &operator+=(const graded_series &other)
+    {
+        return add_impl<true>(other);
+    }
+    /// In-place subtraction.
+    /**
+     * @param other the argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by operator+=().
+     */
+    graded_series &operator-=(const graded_series &other)
+    {
+        return add_impl<false>(other);
+    }
+    /// In-place multiplication.
+    /**
+     * @param other the argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by operator*().
+     */
+    graded_series &operator*=(const graded_series &other)
+    {
+        return *this = *this * other;
+    }
+    /// Binary addition.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a + b</tt>.
+     *
+     * @throws unspecified any exception thrown by operator+=().
+     */
+    friend graded_series operator+(const graded_series &a, const graded_series &b)
+    {
+        auto retval(a);
+        retval += b;
+        return retval;
+    }
+    /// Binary subtraction.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a - b</tt>.
+     *
+     * @throws unspecified any exception thrown by operator-=().
+     */
+    friend graded_series operator-(const graded_series &a, const graded_series &b)
+    {
+        auto retval(a);
+        retval -= b;
+        return retval;
+    }
+    /// Binary multiplication.
+    /**
+     * The product is computed slice by slice. If the automatic truncation of \p Series is active and it is based on
+     * the same degree as the grading of the operands, only the pairs of slices within the truncation limit
+     * are multiplied (using the untruncated multiplication of \p Series, if available). If the automatic truncation
+     * is based on a different degree, it is applied in the multiplication of the slices.
+     *
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a * b</tt>.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different gradings.
+     * @throws unspecified any exception thrown by the multiplication and the public interface of \p Series,
+     * by piranha::sum(), by piranha::safe_cast(), by memory errors in standard containers or by the
+     * arithmetic operations on the degree type.
+     */
+    friend graded_series operator*(const graded_series &a, const graded_series &b)
+    {
+        bool untruncated;
+        const auto limit = auto_truncation(a, untruncated);
+        return mult_impl(a, b, limit, untruncated);
+    }
+    /// Truncated multiplication.
+    /**
+     * This method will return the product of \p a and \p b truncated to the degree \p max_degree (according
+     * to the grading of the operands), multiplying only the pairs of slices within the limit. The automatic
+     * truncation settings of \p Series are ignored if \p Series provides an untruncated multiplication method.
+     *
+     * @param a the first operand.
+     * @param b the second operand.
+     * @param max_degree the maximum degree in the result.
+     *
+     * @return the truncated product of \p a and \p b.
+     *
+     * @throws unspecified any exception thrown by operator*().
+     */
+    template <typename T>
+    static graded_series truncated_multiplication(const graded_series &a, const graded_series &b,
+                                                  const T &max_degree)
+    {
+        return mult_impl(a, b, std::make_pair(true, piranha::safe_cast<degree_type>(max_degree)), true);
+    }
+    /// Equality operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a and \p b have the same grading and the same slices, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by the comparison operator of \p Series.
+     */
+    friend bool operator==(const graded_series &a, const graded_series &b)
+    {
+        return a.m_partial == b.m_partial && a.m_names == b.m_names && a.m_slices == b.m_slices;
+    }
+    /// Inequality operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return the opposite of operator==().
+     *
+     * @throws unspecified any exception thrown by operator==().
+     */
+    friend bool operator!=(const graded_series &a, const graded_series &b)
+    {
+        return !(a == b);
+    }
+
+private:
+    symbol_fset m_symbol_set;
+    symbol_fset m_names;
+    bool m_partial = false;
+    slices_type m_slices;
+};
+}
+
+#endif
@@ -50,7 +50,9 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/config.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/node_arena.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/s11n.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/thread_pool.hpp>
@@ -72,7 +74,10 @@ namespace piranha
  *
  * The implementation employs a separate chaining strategy consisting of an array of buckets, each one a singly linked
  * list with the first node stored directly within the array (so that the first insertion in a bucket does not require
- * any heap allocation).
+ * any heap allocation). The other nodes are allocated from an arena owned by the set, in which each thread
+ * allocates from its own memory slabs (so that concurrent insertions in distinct buckets via the low-level interface
+ * do not contend for the system allocator). The arena is created at the first collision, so that sets without
+ * collisions never allocate it. The memory of the nodes is released in bulk when the set is cleared or destroyed.
  *
  * An additional set of low-level methods is provided: such methods are suitable for use in high-performance and
  * multi-threaded contexts, and, if misused, could lead to data corruption and other unpredictable errors.
@@ -167,6 +172,10 @@ class hash_set
         storage_type m_storage;
         node *m_next;
     };
+    // Arena for the overflow nodes of the buckets (i.e., all the nodes but the first one
+    // of each list, which is stored directly in the buckets array).
+    // NOTE: the arena is created on demand, at the first insertion of an overflow node.
+    using arena_type = detail::lazy_node_arena<sizeof(node), alignof(node)>;
     // List constituting the bucket.
     // NOTE: in this list implementation the m_next pointer is used as a flag to signal if the current node
     // stores an item: the pointer is not null if it does contain something. The value of m_next pointer in a node is
@@ -221,87 +230,63 @@ class hash_set
         PIRANHA_TT_CHECK(is_forward_iterator, iterator);
         PIRANHA_TT_CHECK(is_forward_iterator, const_iterator);
         list() : m_node() {}
-        list(list &&other) noexcept : m_node()
+        // The overflow nodes are owned by the arena of the hash_set, disable copy and move.
+        list(const list &) = delete;
+        list(list &&) = delete;
+        list &operator=(const list &) = delete;
+        list &operator=(list &&) = delete;
+        ~list()
         {
-            steal_from_rvalue(std::move(other));
+            destroy();
         }
-        list(const list &other) : m_node()
+        // Append copies of the items of other, preserving their order, using arena a for the new nodes.
+        void copy_from(const list &other, arena_type &a)
         {
-            try {
-                auto cur = &m_node;
-                auto other_cur = &other.m_node;
-                while (other_cur->m_next) {
-                    if (cur->m_next) {
-                        // This assert means we are operating on the last element
-                        // of the list, as we are doing back-insertions.
-                        piranha_assert(cur->m_next == &terminator);
-                        // Create a new node with content equal to other_cur
-                        // and linking forward to the terminator.
-                        std::unique_ptr<node> new_node(::new node());
+            piranha_assert(empty());
+            auto cur = &m_node;
+            for (auto other_cur = &other.m_node; other_cur->m_next; other_cur = other_cur->m_next) {
+                if (cur->m_next) {
+                    // This assert means we are operating on the last element
+                    // of the list, as we are doing back-insertions.
+                    piranha_assert(cur->m_next == &terminator);
+                    auto new_node = new_arena_node(a);
+                    try {
                         ::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
-                        new_node->m_next = &terminator;
-                        // Link the new node.
-                        cur->m_next = new_node.release();
-                        cur = cur->m_next;
-                    } else {
-                        // This means this is the first node.
-                        ::new (static_cast<void *>(&cur->m_storage)) T(*other_cur->ptr());
-                        cur->m_next = &terminator;
+                    } catch (...) {
+                        a.get().deallocate(new_node);
+                        throw;
                     }
-                    other_cur = other_cur->m_next;
+                    new_node->m_next = &terminator;
+                    // Link the new node.
+                    cur->m_next = new_node;
+                    cur = new_node;
+                } else {
+                    // This means this is the first node.
+                    ::new (static_cast<void *>(&cur->m_storage)) T(*other_cur->ptr());
+                    cur->m_next = &terminator;
                 }
-            } catch (...) {
-                destroy();
-                throw;
             }
         }
-        list &operator=(list &&other)
-        {
-            if (likely(this != &other)) {
-                // Destroy the content of this.
-                destroy();
-                steal_from_rvalue(std::move(other));
-            }
-            return *this;
-        }
-        list &operator=(const list &other)
-        {
-            if (likely(this != &other)) {
-                auto tmp = other;
-                *this = std::move(tmp);
-            }
-            return *this;
-        }
-        ~list()
-        {
-            destroy();
-        }
-        void steal_from_rvalue(list &&other)
+        static node *new_arena_node(arena_type &a)
         {
-            piranha_assert(empty());
-            // Do something only if there is content in the other.
-            if (other.m_node.m_next) {
-                // Move construct current first node with first node of other.
-                ::new (static_cast<void *>(&m_node.m_storage)) T(std::move(*other.m_node.ptr()));
-                // Link remaining content of other into this.
-                m_node.m_next = other.m_node.m_next;
-                // Destroy first node of other.
-                other.m_node.ptr()->~T();
-                other.m_node.m_next = nullptr;
-            }
-            piranha_assert(other.empty());
+            return ::new (a.get().allocate()) node();
         }
         template <typename U, enable_if_t<std::is_same<T, uncvref_t<U>>::value, int> = 0>
-        node *insert(U &&item)
+        node *insert(U &&item, arena_type &a)
         {
             // NOTE: optimize with likely/unlikely?
             if (m_node.m_next) {
-                // Create the new node and forward-link it to the second node.
-                std::unique_ptr<node> new_node(::new node());
-                ::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+                // Create the new node in the arena and forward-link it to the second node.
+                auto new_node = new_arena_node(a);
+                try {
+                    ::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+                } catch (...) {
+                    a.get().deallocate(new_node);
+                    throw;
+                }
                 new_node->m_next = m_node.m_next;
                 // Link first node to the new node.
-                m_node.m_next = new_node.release();
+                m_node.m_next = new_node;
                 return m_node.m_next;
             } else {
                 ::new (static_cast<void *>(&m_node.m_storage)) T(std::forward<U>(item));
@@ -329,6 +314,8 @@ class hash_set
         {
             return !m_node.m_next;
         }
+        // Destroy the payloads. The overflow nodes are not deallocated: their memory
+        // is released in bulk when the arena is destroyed.
         void destroy()
         {
             node *cur = &m_node;
@@ -340,10 +327,6 @@ class hash_set
                 // Destroy the old payload and erase connections.
                 old->ptr()->~T();
                 old->m_next = nullptr;
-                // If the old node was not the initial one, delete it.
-                if (old != &m_node) {
-                    ::delete old;
-                }
             }
             // After destruction, the list should be equivalent to a default-constructed one.
             piranha_assert(empty());
@@ -529,7 +512,7 @@ private:
         ptr() = new_ptr;
         m_log2_size = log2_size;
     }
-    // Destroy all elements and deallocate ptr().
+    // Destroy all elements, deallocate ptr() and release the memory of the overflow nodes.
     void destroy_and_deallocate()
     {
         // Proceed to destroy all elements and deallocate only if the set is actually storing something.
@@ -539,8 +522,10 @@ private:
                 allocator().destroy(&ptr()[i]);
             }
             allocator().deallocate(ptr(), size);
+            // NOTE: the arena must be destroyed after the lists, which still point to its memory.
+            m_arena.reset();
         } else {
-            piranha_assert(!m_log2_size && !m_n_elements);
+            piranha_assert(!m_log2_size && !m_n_elements && !m_arena.ptr());
         }
     }
 #if defined(PIRANHA_WITH_BOOST_S11N)
@@ -702,28 +687,18 @@ public:
     {
         // Proceed to actual copy only if other has some content.
         if (other.ptr()) {
-            const size_type size = size_type(1u) << other.m_log2_size;
-            auto new_ptr = allocator().allocate(size);
-            if (unlikely(!new_ptr)) {
-                piranha_throw(std::bad_alloc, );
-            }
-            size_type i = 0u;
+            init_from_n_buckets(other.bucket_count(), 1u);
+            piranha_assert(m_log2_size == other.m_log2_size);
             try {
-                // Copy-construct the elements of the array.
-                for (; i < size; ++i) {
-                    allocator().construct(&new_ptr[i], other.ptr()[i]);
+                // Copy the content of the lists.
+                const size_type size = bucket_count();
+                for (size_type i = 0u; i < size; ++i) {
+                    ptr()[i].copy_from(other.ptr()[i], m_arena);
                 }
             } catch (...) {
-                // Unwind the construction and deallocate, before re-throwing.
-                for (size_type j = 0u; j < i; ++j) {
-                    allocator().destroy(&new_ptr[j]);
-                }
-                allocator().deallocate(new_ptr, size);
+                destroy_and_deallocate();
                 throw;
             }
-            // Assign the members.
-            ptr() = new_ptr;
-            m_log2_size = other.m_log2_size;
             m_n_elements = other.m_n_elements;
         } else {
             piranha_assert(!other.m_log2_size && !other.m_n_elements);
@@ -737,7 +712,8 @@ public:
      * @param other set to be moved.
      */
     hash_set(hash_set &&other) noexcept
-        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements)
+        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements),
+          m_arena(std::move(other.m_arena))
     {
         // Clear out the other one.
         other.ptr() = nullptr;
@@ -828,6 +804,7 @@ public:
             m_pack = std::move(other.m_pack);
             m_log2_size = other.m_log2_size;
             m_n_elements = other.m_n_elements;
+            m_arena = std::move(other.m_arena);
             // Zero out other.
             other.ptr() = nullptr;
             other.m_log2_size = 0u;
@@ -1107,6 +1084,7 @@ public:
         std::swap(m_pack, other.m_pack);
         std::swap(m_log2_size, other.m_log2_size);
         std::swap(m_n_elements, other.m_n_elements);
+        m_arena.swap(other.m_arena);
     }
     /// Rehash set.
     /**
@@ -1138,6 +1116,7 @@ public:
         if (static_cast<double>(size()) / static_cast<double>(new_size) > max_load_factor()) {
             return;
         }
+        profiler::add_counter("hash_set.rehash");
         // Create a new set with needed amount of buckets.
         hash_set new_set(new_size, hash(), k_equal(), n_threads);
         try {
@@ -1255,7 +1234,7 @@ public:
         piranha_assert(find(std::forward<U>(k)) == end());
         // Assert bucket index is correct.
         piranha_assert(bucket_idx == _bucket(k));
-        auto p = ptr()[bucket_idx].insert(std::forward<U>(k));
+        auto p = ptr()[bucket_idx].insert(std::forward<U>(k), m_arena);
         return iterator(this, bucket_idx, local_iterator(p));
     }
     /// Find element (low-level).
@@ -1357,6 +1336,19 @@ public:
         piranha_assert(idx < bucket_count());
         return ptr()[idx];
     }
+    /// Statistics on the arena of the set.
+    /**
+     * All the nodes of the buckets but the first one are allocated from an arena owned by the set.
+     * This method is not thread-safe.
+     *
+     * @return a pair containing the number of nodes carved out of the arena (not counting the recycled ones)
+     * and the number of memory slabs allocated by the arena.
+     */
+    std::pair<size_type, size_type> _arena_stats() const
+    {
+        const auto a = m_arena.ptr();
+        return a ? a->stats() : std::make_pair(size_type(0u), size_type(0u));
+    }
     /// Erase element.
     /**
      * Erase the element to which \p it points. \p it must be a valid iterator
@@ -1396,7 +1388,7 @@ public:
                 // Move-construct from the second element, and then destroy it.
                 ::new (static_cast<void *>(&bucket.m_node.m_storage)) T(std::move(*bucket.m_node.m_next->ptr()));
                 bucket.m_node.m_next->ptr()->~T();
-                ::delete bucket.m_node.m_next;
+                m_arena.get().deallocate(bucket.m_node.m_next);
                 // Establish the new link.
                 bucket.m_node.m_next = tmp;
                 return bucket.begin();
@@ -1412,7 +1404,7 @@ public:
                     prev_b_it.m_ptr->m_next = b_it.m_ptr->m_next;
                     // Delete the current one.
                     b_it.m_ptr->ptr()->~T();
-                    ::delete b_it.m_ptr;
+                    m_arena.get().deallocate(b_it.m_ptr);
                     break;
                 };
             }
@@ -1430,6 +1422,7 @@ private:
     pack_type m_pack;
     size_type m_log2_size;
     size_type m_n_elements;
+    arena_type m_arena;
 };
 
 template <typename T, typename Hash, typename Pred>
@@ -32,7 +32,9 @@ see https://www.gnu.org/licenses/. */
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include <piranha/detail/bulk_subs.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/forwarding.hpp>
 #include <piranha/integer.hpp>
@@ -167,6 +169,39 @@ class ipow_substitutable_series : public Series, ipow_substitutable_series_tag
     // Enabler for the alternate overload.
     template <typename Int>
     using ipow_subs_int_enabler = enable_if_t<std::is_integral<Int>::value, int>;
+    // Bulk substitution, enabled when the substitution involves only the keys and the keys can be probed
+    // with formal variables (see detail::bulk_subs()).
+    template <typename T, typename Term = typename Series::term_type>
+    using bulk_ipow_subs_enabler = enable_if_t<
+        conjunction<std::integral_constant<bool, subs_term_score<Term, T>::value == 2u>,
+                    key_has_ipow_subs<typename Term::key_type, detail::subs_formal>,
+                    std::is_same<k_subs_type<detail::subs_formal, Term>, detail::subs_formal>,
+                    detail::bulk_subs_evaluable<k_subs_type<T, Term>, T>, is_series<ipow_subs_type<T>>>::value,
+        int>;
+    template <typename T, bulk_ipow_subs_enabler<T> = 0>
+    ipow_subs_type<T> ipow_subs_impl(const symbol_idx &idx, const std::string &, const integer &n, const T &x,
+                                     int) const
+    {
+        using key_type = typename Series::term_type::key_type;
+        using w_type = k_subs_type<T, typename Series::term_type>;
+        const auto f_x = detail::subs_formal::var(0u);
+        detail::subs_power_table<T> table(std::vector<const T *>{&x});
+        const auto &s_set = this->m_symbol_set;
+        return detail::bulk_subs<ipow_subs_type<T>, w_type>(
+            *static_cast<Derived const *>(this), table,
+            [&idx, &n, &f_x, &s_set](const key_type &k) { return k.ipow_subs(idx, n, f_x, s_set); },
+            [](const Derived &r, const w_type &v) { return r * v; });
+    }
+    template <typename T>
+    ipow_subs_type<T> ipow_subs_impl(const symbol_idx &idx, const std::string &name, const integer &n, const T &x,
+                                     long) const
+    {
+        ipow_subs_type<T> retval(0);
+        for (const auto &t : this->m_container) {
+            retval += subs_term_impl(t, idx, name, n, x, this->m_symbol_set);
+        }
+        return retval;
+    }
 
 public:
     /// Defaulted default constructor.
@@ -210,6 +245,10 @@ public:
      * This method will return an object resulting from the substitution of the integral power of the symbol called \p
      * name in \p this with the generic object \p x.
      *
+     * If the substitution involves only the keys, the terms of \p this are grouped according to the powers of \p x
+     * resulting from the substitution in their keys. The powers of \p x are then computed only once, and the result
+     * is obtained with one multiplication per group (rather than per term).
+     *
      * @param name name of the symbol to be substituted.
      * @param n integral power of the symbol to be substituted.
      * @param x object used for the substitution.
@@ -224,12 +263,7 @@ public:
     template <typename T>
     ipow_subs_type<T> ipow_subs(const std::string &name, const integer &n, const T &x) const
     {
-        const auto idx = ss_index_of(this->m_symbol_set, name);
-        ipow_subs_type<T> retval(0);
-        for (const auto &t : this->m_container) {
-            retval += subs_term_impl(t, idx, name, n, x, this->m_symbol_set);
-        }
-        return retval;
+        return ipow_subs_impl(ss_index_of(this->m_symbol_set, name), name, n, x, 0);
     }
     /// Substitution.
     /**
@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <numeric>
@@ -59,6 +60,78 @@ inline namespace impl
 // Type requirement for Kronecker array.
 template <typename T>
 using ka_type_reqs = conjunction<std::is_integral<T>, std::is_signed<T>>;
+
+#if defined(__SIZEOF_INT128__)
+
+__extension__ typedef unsigned __int128 ka_uint128;
+
+#endif
+
+// Unsigned type wide enough to hold the product of a nonnegative value of type T by
+// a multiplicative inverse (see ka_divisor below). void if no such type is available.
+template <typename T>
+using ka_wide_uint = typename std::conditional<(std::numeric_limits<T>::digits <= 31), std::uint_least64_t,
+#if defined(__SIZEOF_INT128__)
+                                               typename std::conditional<(std::numeric_limits<T>::digits <= 63),
+                                                                         ka_uint128, void>::type
+#else
+                                               void
+#endif
+                                               >::type;
+
+// Division of nonnegative values of the signed integral type T by a positive invariant divisor. The
+// default implementation uses the division operator.
+template <typename T, typename = void>
+class ka_divisor
+{
+public:
+    explicit ka_divisor(const T &d) : m_d(d)
+    {
+        piranha_assert(d > 0);
+    }
+    T div(const T &n) const
+    {
+        piranha_assert(n >= 0);
+        return static_cast<T>(n / m_d);
+    }
+
+private:
+    T m_d;
+};
+
+// If a wide enough unsigned type is available, the division is replaced by a multiplication by a
+// precomputed inverse followed by a shift. See theorem 4.2 in:
+// Granlund, Montgomery - Division by invariant integers using multiplication (1994).
+// With N the number of value bits of T and l = ceil(log2(d)), the inverse m = ceil(2**(N+l) / d)
+// is less than 2**(N+1), and floor(m * n / 2**(N+l)) == floor(n / d) for all 0 <= n < 2**N.
+template <typename T>
+class ka_divisor<T, enable_if_t<!std::is_same<ka_wide_uint<T>, void>::value>>
+{
+    using wide_t = ka_wide_uint<T>;
+    static const unsigned nbits = static_cast<unsigned>(std::numeric_limits<T>::digits);
+
+public:
+    explicit ka_divisor(const T &d)
+    {
+        piranha_assert(d > 0);
+        const auto wd = static_cast<wide_t>(d);
+        unsigned l = 0u;
+        while ((wide_t(1) << l) < wd) {
+            ++l;
+        }
+        m_shift = nbits + l;
+        m_inv = static_cast<wide_t>(((wide_t(1) << m_shift) + wd - 1u) / wd);
+    }
+    T div(const T &n) const
+    {
+        piranha_assert(n >= 0);
+        return static_cast<T>((static_cast<wide_t>(n) * m_inv) >> m_shift);
+    }
+
+private:
+    wide_t m_inv;
+    unsigned m_shift;
+};
 }
 
 /// Kronecker array.
@@ -84,8 +157,6 @@ using ka_type_reqs = conjunction<std::is_integral<T>, std::is_signed<T>>;
  *
  * This class does not have any non-static data members, hence it has trivial move semantics.
  */
-// NOTE: we should optimise the decodification with only one element, there should be no need to do divisions
-// and modulo operations.
 template <typename SignedInteger>
 class kronecker_array
 {
@@ -350,17 +421,132 @@ public:
         // NOTE: the static_cast here is useful when working with int_type == char. In that case,
         // the binary operation on the RHS produces an int (due to integer promotion rules), which gets
         // assigned back to char causing the compiler to complain about potentially lossy conversion.
-        const int_type code = static_cast<int_type>(n - hmin);
+        // NOTE: with a single component, the code is the component itself (h_min is -minmax_vec[0]).
+        if (m == 1u) {
+            retval[0u] = piranha::safe_cast<v_type>(n);
+            return;
+        }
+        int_type code = static_cast<int_type>(n - hmin);
         piranha_assert(code >= 0);
-        piranha_assert(minmax_vec[0u] > 0);
-        int_type mod_arg = static_cast<int_type>(2 * minmax_vec[0u] + 1);
-        // Do the first value manually.
-        retval[0u] = piranha::safe_cast<v_type>((code % mod_arg) - minmax_vec[0u]);
-        for (min_int<typename Vector::size_type, decltype(minmax_vec.size())> i = 1u; i < m; ++i) {
+        // Peel off the components one at a time: each component is the remainder of the division of the code
+        // by its width, and the quotient is the code of the remaining components.
+        for (min_int<typename Vector::size_type, decltype(minmax_vec.size())> i = 0u; i < m - 1u; ++i) {
             piranha_assert(minmax_vec[i] > 0);
-            retval[i]
-                = piranha::safe_cast<v_type>((code % (mod_arg * (2 * minmax_vec[i] + 1))) / mod_arg - minmax_vec[i]);
-            mod_arg = static_cast<int_type>(mod_arg * (2 * minmax_vec[i] + 1));
+            const auto w = static_cast<int_type>(2 * minmax_vec[i] + 1);
+            const auto q = static_cast<int_type>(code / w);
+            retval[i] = piranha::safe_cast<v_type>(code - q * w - minmax_vec[i]);
+            code = q;
+        }
+        // The last component does not need the remainder, as the code is always less than h_max - h_min + 1.
+        piranha_assert(code < 2 * minmax_vec[m - 1u] + 1);
+        retval[m - 1u] = piranha::safe_cast<v_type>(code - minmax_vec[m - 1u]);
+    }
+    /// Encode several vectors.
+    /**
+     * This method will encode \p n vectors of size \p m, stored contiguously one after the other in the array
+     * starting at \p v, writing the \p n resulting codes into the array starting at \p retval. The
+     * coding vector is computed once for all the input vectors, hence this method is faster than calling
+     * encode() repeatedly.
+     *
+     * In case of exceptions, the content of \p retval is unspecified.
+     *
+     * @param retval pointer to the output codes.
+     * @param v pointer to the components of the input vectors.
+     * @param n number of vectors to be encoded.
+     * @param m size of the vectors to be encoded.
+     *
+     * @throws std::invalid_argument if any of these conditions hold:
+     * - \p m is equal to or greater than the size of the output of get_limits(),
+     * - one of the components of the input vectors is outside the bounds reported by get_limits().
+     */
+    static void encode_range(int_type *retval, const int_type *v, const size_type &n, const size_type &m)
+    {
+        if (unlikely(m >= m_limits.size())) {
+            piranha_throw(std::invalid_argument, "size of vector to be encoded is too large");
+        }
+        if (unlikely(!m)) {
+            std::fill(retval, retval + n, int_type(0));
+            return;
+        }
+        const auto &limit = m_limits[m];
+        const auto &minmax_vec = std::get<0u>(limit);
+        const auto hmin = std::get<1u>(limit);
+        // Build the coding vector.
+        std::vector<int_type> c_vec(static_cast<typename std::vector<int_type>::size_type>(m));
+        c_vec[0u] = int_type(1);
+        for (size_type i = 1u; i < m; ++i) {
+            c_vec[i] = static_cast<int_type>(c_vec[i - 1u] * (2 * minmax_vec[i - 1u] + 1));
+        }
+        for (size_type j = 0u; j < n; ++j, v += m) {
+            int_type code = hmin;
+            for (size_type i = 0u; i < m; ++i) {
+                if (unlikely(v[i] < -minmax_vec[i] || v[i] > minmax_vec[i])) {
+                    piranha_throw(std::invalid_argument, "a component of the vector to be encoded is out of bounds");
+                }
+                code = static_cast<int_type>(code + (v[i] + minmax_vec[i]) * c_vec[i]);
+            }
+            retval[j] = code;
+        }
+    }
+    /// Decode several codes.
+    /**
+     * This method will decode the \p n codes stored in the array starting at \p codes into vectors of size \p m,
+     * writing the components of the decoded vectors contiguously one after the other in the array starting at
+     * \p retval (which must thus be able to hold <tt>n * m</tt> values).
+     *
+     * The divisions needed by the decodification are replaced, when a wide enough unsigned integral
+     * type is available, by multiplications by inverses computed once for all the codes,
+     * hence this method is faster than calling decode() repeatedly.
+     *
+     * In case of exceptions, the content of \p retval is unspecified.
+     *
+     * @param retval pointer to the output components.
+     * @param codes pointer to the input codes.
+     * @param n number of codes to be decoded.
+     * @param m size of the vectors to be decoded.
+     *
+     * @throws std::invalid_argument if any of these conditions hold:
+     * - \p m is equal to or greater than the size of the output of get_limits(),
+     * - \p m is zero and one of the codes is not zero,
+     * - one of the codes is out of the allowed bounds reported by get_limits().
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    static void decode_range(int_type *retval, const int_type *codes, const size_type &n, const size_type &m)
+    {
+        if (unlikely(m >= m_limits.size())) {
+            piranha_throw(std::invalid_argument, "size of vector to be decoded is too large");
+        }
+        if (unlikely(!m)) {
+            if (unlikely(std::any_of(codes, codes + n, [](const int_type &c) { return c != 0; }))) {
+                piranha_throw(std::invalid_argument, "a vector of size 0 must always be encoded as 0");
+            }
+            return;
+        }
+        const auto &limit = m_limits[m];
+        const auto &minmax_vec = std::get<0u>(limit);
+        const auto hmin = std::get<1u>(limit), hmax = std::get<2u>(limit);
+        // Widths and divisors for all components but the last one.
+        std::vector<int_type> widths;
+        std::vector<ka_divisor<int_type>> divs;
+        widths.reserve(static_cast<typename std::vector<int_type>::size_type>(m - 1u));
+        divs.reserve(static_cast<typename std::vector<ka_divisor<int_type>>::size_type>(m - 1u));
+        for (size_type i = 0u; i < m - 1u; ++i) {
+            widths.push_back(static_cast<int_type>(2 * minmax_vec[i] + 1));
+            divs.emplace_back(widths.back());
+        }
+        const int_type last_M = minmax_vec[m - 1u];
+        for (size_type j = 0u; j < n; ++j) {
+            const int_type c = codes[j];
+            if (unlikely(c < hmin || c > hmax)) {
+                piranha_throw(std::invalid_argument, "the integer to be decoded is out of bounds");
+            }
+            int_type code = static_cast<int_type>(c - hmin);
+            for (size_type i = 0u; i < m - 1u; ++i) {
+                const auto q = divs[i].div(code);
+                *retval++ = static_cast<int_type>(code - q * widths[i] - minmax_vec[i]);
+                code = q;
+            }
+            *retval++ = static_cast<int_type>(code - last_M);
         }
     }
 };
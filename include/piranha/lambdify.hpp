@@ -43,8 +43,11 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/detail/init.hpp>
 #include <piranha/detail/sfinae_types.hpp>
+#include <piranha/evaluation_plan.hpp>
 #include <piranha/exceptions.hpp>
 #include <piranha/math.hpp>
+#include <piranha/series.hpp>
+#include <piranha/series_evaluator.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/type_traits.hpp>
 
@@ -58,6 +61,41 @@ namespace detail
 template <typename T, typename U>
 using math_lambdified_reqs = std::integral_constant<
     bool, conjunction<is_evaluable<T, U>, std::is_copy_constructible<T>, std::is_move_constructible<T>>::value>;
+
+// Batch evaluation of lambdified objects. For series types supporting series_evaluator::batch(),
+// the evaluator is stored in the lambdified object.
+template <typename T, typename U>
+using lambdified_batch_t = decltype(
+    std::declval<const series_evaluator<T> &>().batch(std::declval<const symbol_fmap<std::vector<U>> &>()));
+
+struct lambdified_unsupported {
+};
+
+// Evaluation plan of lambdified objects, built upon construction for the series types supported
+// by evaluation_plan.
+template <typename T, typename U, typename = void>
+struct lambdified_plan {
+    static const bool value = false;
+    using plan_type = lambdified_unsupported;
+};
+
+template <typename T, typename U>
+struct lambdified_plan<T, U, enable_if_t<evaluation_plan_enabled<T, U>::value>> {
+    static const bool value = true;
+    using plan_type = evaluation_plan<T, U>;
+};
+
+template <typename T, typename U, typename = void>
+struct lambdified_batch {
+    static const bool value = false;
+    using evaluator_type = lambdified_unsupported;
+};
+
+template <typename T, typename U>
+struct lambdified_batch<T, U, enable_if_t<is_series<T>::value>> {
+    static const bool value = is_detected<lambdified_batch_t, T, U>::value;
+    using evaluator_type = typename std::conditional<value, series_evaluator<T>, lambdified_unsupported>::type;
+};
 }
 
 namespace math
@@ -71,6 +109,10 @@ namespace math
  *
  * The convenience function piranha::math::lambdify() can be used to easily construct objects of this class.
  *
+ * If \p T is a series type supported by piranha::evaluation_plan for evaluation with objects of type \p U,
+ * an evaluation plan is built upon construction and used by operator()() in place of piranha::math::evaluate().
+ * The results are identical, but the evaluation reuses the products shared by the keys of the series.
+ *
  * ## Type requirements ##
  *
  * - \p T and \p U must be the same as their decay types,
@@ -119,6 +161,40 @@ class lambdified
             piranha_assert(ret.second);
             m_ptrs.push_back(std::addressof(ret.first->second));
         }
+        build_plan(plan_tag{});
+    }
+    // Evaluation plan.
+    using plan_tag = std::integral_constant<bool, detail::lambdified_plan<T, U>::value>;
+    using plan_type = typename detail::lambdified_plan<T, U>::plan_type;
+    void build_plan(const std::false_type &)
+    {
+    }
+    void build_plan(const std::true_type &)
+    {
+        // NOTE: if a symbol of the series is not in the evaluation dictionary, the plan is not built
+        // and the error will be raised by math::evaluate() when operator()() is called.
+        for (const auto &s : m_x.get_symbol_set()) {
+            if (m_eval_dict.find(s) == m_eval_dict.end()) {
+                return;
+            }
+        }
+        m_plan.reset(::new plan_type(m_x));
+        m_plan_values.resize(m_x.get_symbol_set().size());
+        reconstruct_plan_ptrs(plan_tag{});
+    }
+    void reconstruct_plan_ptrs(const std::false_type &)
+    {
+    }
+    void reconstruct_plan_ptrs(const std::true_type &)
+    {
+        piranha_assert(m_plan_ptrs.empty());
+        if (!m_plan) {
+            return;
+        }
+        for (const auto &s : m_plan->get_symbol_set()) {
+            piranha_assert(m_eval_dict.count(s) == 1u);
+            m_plan_ptrs.push_back(std::addressof(m_eval_dict.find(s)->second));
+        }
     }
     // Reconstruct the vector of pointers following copy or move construction.
     void reconstruct_ptrs()
@@ -140,6 +216,8 @@ class lambdified
         }
         // Make sure the sizes are consistent.
         piranha_assert(m_ptrs.size() == static_cast<decltype(m_ptrs.size())>(m_names.size()) + m_extra_map.size());
+        // The pointers of the evaluation plan.
+        reconstruct_plan_ptrs(plan_tag{});
     }
 
 public:
@@ -183,7 +261,8 @@ public:
      * - memory errors in standard containers,
      * - the public interface of std::unordered_map,
      * - the copy constructor of \p T,
-     * - the construction of objects of type \p U.
+     * - the construction of objects of type \p U,
+     * - the constructor of piranha::evaluation_plan.
      */
     explicit lambdified(const T &x, const std::vector<std::string> &names, extra_map_type extra_map = {})
         : m_x(x), m_names(names), m_extra_map(extra_map)
@@ -205,7 +284,8 @@ public:
      * - memory errors in standard containers,
      * - the public interface of std::unordered_map,
      * - the move constructor of \p T,
-     * - the construction of objects of type \p U.
+     * - the construction of objects of type \p U,
+     * - the constructor of piranha::evaluation_plan.
      */
     explicit lambdified(T &&x, const std::vector<std::string> &names, extra_map_type extra_map = {})
         : m_x(std::move(x)), m_names(names), m_extra_map(extra_map)
@@ -219,7 +299,8 @@ public:
      * @throws unspecified any exception thrown by the copy constructor of the internal members.
      */
     lambdified(const lambdified &other)
-        : m_x(other.m_x), m_names(other.m_names), m_eval_dict(other.m_eval_dict), m_extra_map(other.m_extra_map)
+        : m_x(other.m_x), m_names(other.m_names), m_eval_dict(other.m_eval_dict), m_extra_map(other.m_extra_map),
+          m_plan(other.m_plan ? ::new plan_type(*other.m_plan) : nullptr), m_plan_values(other.m_plan_values)
     {
         reconstruct_ptrs();
     }
@@ -231,7 +312,8 @@ public:
      */
     lambdified(lambdified &&other)
         : m_x(std::move(other.m_x)), m_names(std::move(other.m_names)), m_eval_dict(std::move(other.m_eval_dict)),
-          m_extra_map(std::move(other.m_extra_map))
+          m_extra_map(std::move(other.m_extra_map)), m_batch_ev(std::move(other.m_batch_ev)),
+          m_plan(std::move(other.m_plan)), m_plan_values(std::move(other.m_plan_values))
     {
         // NOTE: it looks like we cannot be sure the moved-in pointers are still valid.
         // Let's just make sure.
@@ -253,6 +335,9 @@ public:
      * If a non-empty \p extra_map parameter was used during construction, the symbols in it are evaluated according
      * to the mapped functions before being passed down in the evaluation dictionary to piranha::math::evaluate().
      *
+     * If an evaluation plan was built upon construction (see the class documentation), it is used instead of
+     * piranha::math::evaluate().
+     *
      * Note that this function needs to modify the internal state of the object, and thus it is not const and it is
      * not thread-safe.
      *
@@ -265,6 +350,7 @@ public:
      * @throws unspecified any exception raised by:
      * - the copy-assignment operator of \p U,
      * - math::evaluate(),
+     * - the call operator of piranha::evaluation_plan,
      * - the call operator of the mapped functions in the \p extra_map parameter used during construction.
      */
     eval_type operator()(const std::vector<U> &values)
@@ -294,8 +380,47 @@ public:
             *ptr = p.second(values);
             ++i;
         }
-        // NOTE: of course, this will have to be fixed in the rewrite.
-        return math::evaluate(m_x, symbol_fmap<U>{m_eval_dict.begin(), m_eval_dict.end()});
+        return evaluate_impl(plan_tag{});
+    }
+    /// Batch evaluation.
+    /**
+     * This method will evaluate the stored object at multiple points. Each element of \p points is a vector
+     * of values which is interpreted as the argument of operator()(), and the <tt>i</tt>-th element of the
+     * return value is the same as the output of operator()() called with the <tt>i</tt>-th element of \p points.
+     *
+     * If \p T is a series type supporting piranha::series_evaluator::batch() with objects of type \p U,
+     * the evaluation values (including those of the symbols in the \p extra_map parameter used during construction)
+     * are first collected for all the points, and the evaluation is then performed by
+     * piranha::series_evaluator::batch() in a single pass over the terms of the series. The piranha::series_evaluator
+     * is created on the first invocation of this method, and it is reused by subsequent invocations. Note that
+     * piranha::series_evaluator stores an internal copy of the series.
+     *
+     * Otherwise, this method is equivalent to calling operator()() on each element of \p points.
+     *
+     * Like operator()(), this method is not thread-safe.
+     *
+     * @param points the evaluation points.
+     *
+     * @return the results of the evaluation at each point in \p points.
+     *
+     * @throws std::invalid_argument if the size of any element of \p points is not equal to the size of the vector
+     * of names used during construction.
+     * @throws unspecified any exception raised by:
+     * - operator()(),
+     * - memory errors in standard containers,
+     * - the copy constructor of \p U,
+     * - the constructor and the batch evaluation method of piranha::series_evaluator,
+     * - the call operator of the mapped functions in the \p extra_map parameter used during construction.
+     */
+    std::vector<eval_type> batch(const std::vector<std::vector<U>> &points)
+    {
+        for (const auto &v : points) {
+            if (unlikely(v.size() != m_names.size())) {
+                piranha_throw(std::invalid_argument, "the size of the vector of evaluation values does not "
+                                                     "match the size of the symbol list used during construction");
+            }
+        }
+        return batch_impl(points, std::integral_constant<bool, detail::lambdified_batch<T, U>::value>{});
     }
     /// Get evaluation object.
     /**
@@ -329,11 +454,75 @@ public:
     }
 
 private:
+    eval_type evaluate_impl(const std::false_type &) const
+    {
+        // NOTE: of course, this will have to be fixed in the rewrite.
+        return math::evaluate(m_x, symbol_fmap<U>{m_eval_dict.begin(), m_eval_dict.end()});
+    }
+    eval_type evaluate_impl(const std::true_type &)
+    {
+        if (!m_plan) {
+            return evaluate_impl(std::false_type{});
+        }
+        for (decltype(m_plan_ptrs.size()) i = 0u; i < m_plan_ptrs.size(); ++i) {
+            m_plan_values[i] = *m_plan_ptrs[i];
+        }
+        return (*m_plan)(m_plan_values);
+    }
+    std::vector<eval_type> batch_impl(const std::vector<std::vector<U>> &points, const std::false_type &)
+    {
+        std::vector<eval_type> retval;
+        retval.reserve(points.size());
+        for (const auto &v : points) {
+            retval.push_back((*this)(v));
+        }
+        return retval;
+    }
+    std::vector<eval_type> batch_impl(const std::vector<std::vector<U>> &points, const std::true_type &)
+    {
+        // NOTE: series_evaluator::batch() needs a non-empty dictionary in order to determine
+        // the number of points.
+        if (m_eval_dict.empty() || points.empty()) {
+            return batch_impl(points, std::false_type{});
+        }
+        // Collect the values of each symbol at all points.
+        std::vector<std::pair<std::string, std::vector<U>>> cols;
+        cols.reserve(m_eval_dict.size());
+        for (decltype(m_names.size()) i = 0u; i < m_names.size(); ++i) {
+            cols.emplace_back(m_names[i], std::vector<U>{});
+            auto &col = cols.back().second;
+            col.reserve(points.size());
+            for (const auto &v : points) {
+                col.push_back(v[i]);
+            }
+        }
+        for (const auto &p : m_extra_map) {
+            cols.emplace_back(p.first, std::vector<U>{});
+            auto &col = cols.back().second;
+            col.reserve(points.size());
+            for (const auto &v : points) {
+                col.push_back(p.second(v));
+            }
+        }
+        const symbol_fmap<std::vector<U>> dict(std::make_move_iterator(cols.begin()),
+                                               std::make_move_iterator(cols.end()));
+        if (!m_batch_ev) {
+            m_batch_ev.reset(::new batch_evaluator_type(m_x));
+        }
+        return m_batch_ev->batch(dict);
+    }
+
+private:
+    using batch_evaluator_type = typename detail::lambdified_batch<T, U>::evaluator_type;
     T m_x;
     std::vector<std::string> m_names;
     std::unordered_map<std::string, U> m_eval_dict;
     std::vector<U *> m_ptrs;
     extra_map_type m_extra_map;
+    std::unique_ptr<batch_evaluator_type> m_batch_ev;
+    std::unique_ptr<plan_type> m_plan;
+    std::vector<const U *> m_plan_ptrs;
+    std::vector<U> m_plan_values;
 };
 }
 
@@ -0,0 +1,736 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_MAPPED_SERIES_HPP
+#define PIRANHA_MAPPED_SERIES_HPP
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/demangle.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/frozen_series.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/key/key_degree.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/degree.hpp>
+#include <piranha/profiler.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Raw representation of the coefficients and keys in the mapped format. The raw type
+// must be trivially copyable, so that arrays of raw objects can be written to disk and
+// read back by reinterpreting the mapped memory.
+template <typename T, typename = void>
+struct mapped_raw {
+};
+
+template <typename T>
+struct mapped_raw<T, enable_if_t<std::is_trivially_copyable<T>::value>> {
+    using type = T;
+    static const T &to_raw(const T &x)
+    {
+        return x;
+    }
+    static const T &from_raw(const T &x)
+    {
+        return x;
+    }
+};
+
+// NOTE: Kronecker monomials are not trivially copyable (they have a user-provided destructor),
+// but they are fully described by their integral code.
+template <typename T>
+struct mapped_raw<kronecker_monomial<T>> {
+    using type = T;
+    static T to_raw(const kronecker_monomial<T> &k)
+    {
+        return k.get_int();
+    }
+    static kronecker_monomial<T> from_raw(const T &n)
+    {
+        return kronecker_monomial<T>(n);
+    }
+};
+
+template <typename T, typename = void>
+struct has_mapped_raw : std::false_type {
+};
+
+template <typename T>
+struct has_mapped_raw<T, enable_if_t<std::is_trivially_copyable<typename mapped_raw<T>::type>::value>>
+    : std::true_type {
+};
+
+// Enabler for the mapped format.
+template <typename Series>
+using mapped_series_enabler = enable_if_t<
+    conjunction<is_series<Series>, has_mapped_raw<typename Series::term_type::cf_type>,
+                has_mapped_raw<typename Series::term_type::key_type>>::value,
+    int>;
+
+// Header of the mapped format. All the fields are stored in native byte order, and the
+// header is followed by the type name of the series, by the symbols (each prefixed by its length)
+// and, at the offsets recorded in the header, by the arrays of raw coefficients and keys.
+struct mapped_header {
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t endian;
+    std::uint64_t cf_size;
+    std::uint64_t key_size;
+    std::uint64_t name_size;
+    std::uint64_t n_symbols;
+    std::uint64_t n_terms;
+    std::uint64_t cf_offset;
+    std::uint64_t key_offset;
+    std::uint64_t file_size;
+};
+
+static_assert(std::is_trivially_copyable<mapped_header>::value, "Invalid mapped header type.");
+
+template <typename = void>
+struct mapped_constants {
+    static const char magic[8];
+    static const std::uint64_t version = 1u;
+    static const std::uint64_t endian = 0x0102030405060708ull;
+    // Alignment of the coefficient and key arrays within the file.
+    static const std::uint64_t alignment = 64u;
+};
+
+template <typename T>
+const char mapped_constants<T>::magic[8] = {'p', 'i', 'r', 'a', 'n', 'h', 'a', 'M'};
+
+template <typename T>
+const std::uint64_t mapped_constants<T>::version;
+
+template <typename T>
+const std::uint64_t mapped_constants<T>::endian;
+
+template <typename T>
+const std::uint64_t mapped_constants<T>::alignment;
+
+inline std::uint64_t mapped_align(std::uint64_t n)
+{
+    const auto a = mapped_constants<>::alignment;
+    if (unlikely(n > std::numeric_limits<std::uint64_t>::max() - a)) {
+        piranha_throw(std::overflow_error, "overflow in the computation of an offset in the mapped format");
+    }
+    return (n + a - 1u) / a * a;
+}
+
+inline std::uint64_t mapped_add(std::uint64_t a, std::uint64_t b)
+{
+    if (unlikely(a > std::numeric_limits<std::uint64_t>::max() - b)) {
+        piranha_throw(std::overflow_error, "overflow in the computation of an offset in the mapped format");
+    }
+    return a + b;
+}
+
+inline std::uint64_t mapped_mul(std::uint64_t a, std::uint64_t b)
+{
+    if (unlikely(b && a > std::numeric_limits<std::uint64_t>::max() / b)) {
+        piranha_throw(std::overflow_error, "overflow in the computation of an offset in the mapped format");
+    }
+    return a * b;
+}
+
+inline void mapped_write_padding(std::ofstream &ofile, std::uint64_t cur, std::uint64_t target)
+{
+    piranha_assert(target >= cur);
+    const std::vector<char> pad(safe_cast<std::vector<char>::size_type>(target - cur), 0);
+    ofile.write(pad.data(), safe_cast<std::streamsize>(pad.size()));
+}
+
+template <typename Series, typename Cfs, typename Keys>
+inline void save_mapped_file_impl(const symbol_fset &ss, const Cfs &cfs, const Keys &keys, const std::string &filename)
+{
+    using cf_raw = mapped_raw<typename Series::term_type::cf_type>;
+    using key_raw = mapped_raw<typename Series::term_type::key_type>;
+    using raw_cf_type = typename cf_raw::type;
+    using raw_key_type = typename key_raw::type;
+    profiler::scope prof("s11n.save_mapped_file");
+    piranha_assert(cfs.size() == keys.size());
+    const auto name = demangle<Series>();
+    // Assemble the header.
+    mapped_header h;
+    std::memcpy(h.magic, mapped_constants<>::magic, sizeof(h.magic));
+    h.version = mapped_constants<>::version;
+    h.endian = mapped_constants<>::endian;
+    h.cf_size = sizeof(raw_cf_type);
+    h.key_size = sizeof(raw_key_type);
+    h.name_size = safe_cast<std::uint64_t>(name.size());
+    h.n_symbols = safe_cast<std::uint64_t>(ss.size());
+    h.n_terms = safe_cast<std::uint64_t>(cfs.size());
+    std::uint64_t cur = mapped_add(sizeof(mapped_header), h.name_size);
+    for (const auto &s : ss) {
+        cur = mapped_add(cur, mapped_add(sizeof(std::uint64_t), safe_cast<std::uint64_t>(s.size())));
+    }
+    h.cf_offset = mapped_align(cur);
+    h.key_offset = mapped_align(mapped_add(h.cf_offset, mapped_mul(h.n_terms, h.cf_size)));
+    h.file_size = mapped_add(h.key_offset, mapped_mul(h.n_terms, h.key_size));
+    // Write everything out.
+    std::ofstream ofile(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+    }
+    ofile.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    ofile.write(name.data(), safe_cast<std::streamsize>(name.size()));
+    for (const auto &s : ss) {
+        const auto s_size = safe_cast<std::uint64_t>(s.size());
+        ofile.write(reinterpret_cast<const char *>(&s_size), sizeof(s_size));
+        ofile.write(s.data(), safe_cast<std::streamsize>(s.size()));
+    }
+    mapped_write_padding(ofile, cur, h.cf_offset);
+    // The arrays are written in blocks, converting to the raw representation on the fly.
+    constexpr std::size_t block_size = 4096u;
+    std::vector<raw_cf_type> cf_block;
+    cf_block.reserve(block_size);
+    for (decltype(cfs.size()) i = 0u; i < cfs.size(); ++i) {
+        cf_block.push_back(cf_raw::to_raw(cfs[i]));
+        if (cf_block.size() == block_size || i + 1u == cfs.size()) {
+            ofile.write(reinterpret_cast<const char *>(cf_block.data()),
+                        safe_cast<std::streamsize>(cf_block.size() * sizeof(raw_cf_type)));
+            cf_block.clear();
+        }
+    }
+    mapped_write_padding(ofile, mapped_add(h.cf_offset, mapped_mul(h.n_terms, h.cf_size)), h.key_offset);
+    std::vector<raw_key_type> key_block;
+    key_block.reserve(block_size);
+    for (decltype(keys.size()) i = 0u; i < keys.size(); ++i) {
+        key_block.push_back(key_raw::to_raw(keys[i]));
+        if (key_block.size() == block_size || i + 1u == keys.size()) {
+            ofile.write(reinterpret_cast<const char *>(key_block.data()),
+                        safe_cast<std::streamsize>(key_block.size() * sizeof(raw_key_type)));
+            key_block.clear();
+        }
+    }
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "an error occurred while writing the file '" + filename + "'");
+    }
+}
+} // namespace impl
+
+/// Save a series in the mapped format.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series and if both its coefficient and key
+ * types have a bitwise representation in the mapped format. At the moment, this is the case for trivially
+ * copyable types (e.g., floating-point and integral coefficients) and for piranha::kronecker_monomial.
+ *
+ * The terms of \p s are written to the file \p filename in structure-of-arrays form, together with the symbol set
+ * and a type tag. The resulting file can be opened by piranha::mapped_series, which maps it in memory and accesses
+ * the terms in-place. The data is stored in the native byte order and with the native sizes of the coefficient
+ * and key types, hence the format is not portable across architectures.
+ *
+ * @param s the series to be saved.
+ * @param filename the name of the target file.
+ *
+ * @throws std::runtime_error if the file cannot be opened or written.
+ * @throws std::overflow_error if the size of the file overflows 64-bit unsigned integers.
+ * @throws unspecified any exception thrown by memory errors in standard containers or by piranha::safe_cast().
+ */
+template <typename Series, mapped_series_enabler<Series> = 0>
+inline void save_mapped_file(const Series &s, const std::string &filename)
+{
+    // NOTE: go through a temporary frozen series in order to write the arrays sequentially.
+    const frozen_series<Series> fs(s);
+    save_mapped_file_impl<Series>(fs.get_symbol_set(), fs.cfs(), fs.keys(), filename);
+}
+
+/// Save a frozen series in the mapped format.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies the requirements of
+ * piranha::save_mapped_file(const Series &, const std::string &).
+ *
+ * The terms are written in the order in which they are stored in \p fs.
+ *
+ * @param fs the frozen series to be saved.
+ * @param filename the name of the target file.
+ *
+ * @throws unspecified any exception thrown by piranha::save_mapped_file(const Series &, const std::string &).
+ */
+template <typename Series, mapped_series_enabler<Series> = 0>
+inline void save_mapped_file(const frozen_series<Series> &fs, const std::string &filename)
+{
+    save_mapped_file_impl<Series>(fs.get_symbol_set(), fs.cfs(), fs.keys(), filename);
+}
+
+/// Memory-mapped series.
+/**
+ * This class provides read-only access to a series stored on disk by piranha::save_mapped_file(). The file is mapped
+ * in memory on construction and the coefficients and keys are accessed in-place, in their raw representation,
+ * without any deserialization step: opening a file has a cost independent of the number of terms, and the
+ * operating system will page in only the parts of the file that are actually touched. Passes that stream over
+ * the terms (evaluation, degree queries) can be run directly on the mapped data, while a regular series can be
+ * rehydrated, in parallel, via thaw() when needed. freeze() copies the terms into a piranha::frozen_series.
+ *
+ * \p Series must satisfy the requirements of piranha::save_mapped_file(), otherwise a compile-time error will be
+ * emitted. The contents of the file must not be modified while the file is mapped.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will transfer the mapping, leaving the moved-from object in a state
+ * equivalent to an empty series.
+ */
+template <typename Series>
+class mapped_series
+{
+    static_assert(std::is_same<mapped_series_enabler<Series>, int>::value, "Invalid series type.");
+    using cf_raw = mapped_raw<typename Series::term_type::cf_type>;
+    using key_raw = mapped_raw<typename Series::term_type::key_type>;
+    using series_cf_type = typename Series::term_type::cf_type;
+    // Total degree type: the degree is available only if it depends on the keys alone.
+    template <typename K, typename T>
+    using degree_enabler
+        = enable_if_t<conjunction<is_key_degree_type<K>, negation<is_degree_type<const series_cf_type &>>>::value, T>;
+
+public:
+    /// Alias for the term type of \p Series.
+    using term_type = typename Series::term_type;
+    /// Alias for the coefficient type.
+    using cf_type = typename term_type::cf_type;
+    /// Alias for the key type.
+    using key_type = typename term_type::key_type;
+    /// Raw coefficient type, as stored in the file.
+    using raw_cf_type = typename cf_raw::type;
+    /// Raw key type, as stored in the file.
+    using raw_key_type = typename key_raw::type;
+    /// Size type.
+    using size_type = std::size_t;
+    /// Constructor from file.
+    /**
+     * The file \p filename is mapped read-only in memory and its header is validated.
+     *
+     * @param filename the name of the file to be mapped.
+     *
+     * @throws std::invalid_argument if the file was not produced by piranha::save_mapped_file() for the series
+     * type \p Series on an architecture compatible with the current one, or if it is truncated.
+     * @throws unspecified any exception thrown by the Boost.Interprocess mapping classes, or by memory errors in
+     * standard containers.
+     */
+    explicit mapped_series(const std::string &filename)
+    {
+        profiler::scope prof("s11n.map_file");
+        try {
+            m_file = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+            m_region = boost::interprocess::mapped_region(m_file, boost::interprocess::read_only);
+        } catch (const boost::interprocess::interprocess_exception &ie) {
+            piranha_throw(std::runtime_error,
+                          "the file '" + filename + "' could not be mapped in memory: " + std::string(ie.what()));
+        }
+        const auto base = static_cast<const char *>(m_region.get_address());
+        const auto f_size = static_cast<std::uint64_t>(m_region.get_size());
+        const auto error = [&filename](const std::string &msg) {
+            piranha_throw(std::invalid_argument, "invalid mapped series file '" + filename + "': " + msg);
+        };
+        mapped_header h;
+        if (f_size < sizeof(h)) {
+            error("the file is too small");
+        }
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, mapped_constants<>::magic, sizeof(h.magic))) {
+            error("the file signature is not valid");
+        }
+        if (h.version != mapped_constants<>::version) {
+            error("unsupported format version " + std::to_string(h.version));
+        }
+        if (h.endian != mapped_constants<>::endian) {
+            error("the file was created on an architecture with a different byte order");
+        }
+        if (h.cf_size != sizeof(raw_cf_type) || h.key_size != sizeof(raw_key_type)) {
+            error("the sizes of the coefficient and key types do not match");
+        }
+        if (h.file_size != f_size) {
+            error("the file size does not match the size recorded in the header");
+        }
+        std::uint64_t cur = sizeof(h);
+        const auto name = demangle<Series>();
+        if (h.name_size != name.size() || h.name_size > f_size - cur
+            || std::memcmp(base + cur, name.data(), name.size())) {
+            error("the file does not contain a series of type '" + name + "'");
+        }
+        cur += h.name_size;
+        for (std::uint64_t i = 0u; i < h.n_symbols; ++i) {
+            std::uint64_t s_size;
+            if (f_size - cur < sizeof(s_size)) {
+                error("the symbol set is truncated");
+            }
+            std::memcpy(&s_size, base + cur, sizeof(s_size));
+            cur += sizeof(s_size);
+            if (f_size - cur < s_size) {
+                error("the symbol set is truncated");
+            }
+            m_symbol_set.insert(m_symbol_set.end(), std::string(base + cur, safe_cast<std::size_t>(s_size)));
+            cur += s_size;
+        }
+        if (m_symbol_set.size() != h.n_symbols) {
+            error("the symbol set contains duplicate symbols");
+        }
+        // Validate the placement of the arrays.
+        if (h.cf_offset % mapped_constants<>::alignment || h.key_offset % mapped_constants<>::alignment
+            || h.cf_offset < cur || h.cf_offset > f_size || mapped_mul(h.n_terms, h.cf_size) > f_size - h.cf_offset
+            || h.key_offset < h.cf_offset + h.n_terms * h.cf_size || h.key_offset > f_size
+            || mapped_mul(h.n_terms, h.key_size) > f_size - h.key_offset) {
+            error("the term arrays are not correctly placed");
+        }
+        // NOTE: the mapped region starts at a page boundary, and the offsets are multiples of the alignment.
+        m_cfs = reinterpret_cast<const raw_cf_type *>(base + h.cf_offset);
+        m_keys = reinterpret_cast<const raw_key_type *>(base + h.key_offset);
+        m_size = safe_cast<size_type>(h.n_terms);
+    }
+    /// Deleted copy constructor.
+    mapped_series(const mapped_series &) = delete;
+    /// Move constructor.
+    /**
+     * @param other the construction argument.
+     */
+    mapped_series(mapped_series &&other) noexcept
+        : m_file(std::move(other.m_file)), m_region(std::move(other.m_region)),
+          m_symbol_set(std::move(other.m_symbol_set)), m_cfs(other.m_cfs), m_keys(other.m_keys), m_size(other.m_size)
+    {
+        other.clear();
+    }
+    /// Deleted copy assignment operator.
+    mapped_series &operator=(const mapped_series &) = delete;
+    /// Move assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    mapped_series &operator=(mapped_series &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            m_file = std::move(other.m_file);
+            m_region = std::move(other.m_region);
+            m_symbol_set = std::move(other.m_symbol_set);
+            m_cfs = other.m_cfs;
+            m_keys = other.m_keys;
+            m_size = other.m_size;
+            other.clear();
+        }
+        return *this;
+    }
+    /// Defaulted destructor.
+    /**
+     * The file will be unmapped.
+     */
+    ~mapped_series() = default;
+    /// Number of terms.
+    /**
+     * @return the number of terms in the mapped series.
+     */
+    size_type size() const
+    {
+        return m_size;
+    }
+    /// Emptiness test.
+    /**
+     * @return \p true if the mapped series has no terms, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return !m_size;
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Raw coefficients.
+    /**
+     * @return a pointer to the array of raw coefficients in the mapped memory, or \p nullptr if \p this is empty.
+     */
+    const raw_cf_type *cf_data() const
+    {
+        return m_size ? m_cfs : nullptr;
+    }
+    /// Raw keys.
+    /**
+     * @return a pointer to the array of raw keys in the mapped memory (in the same order as cf_data()),
+     * or \p nullptr if \p this is empty.
+     */
+    const raw_key_type *key_data() const
+    {
+        return m_size ? m_keys : nullptr;
+    }
+    /// Coefficient at index.
+    /**
+     * @param i the index of the term.
+     *
+     * @return the coefficient of the term at index \p i.
+     */
+    cf_type cf(size_type i) const
+    {
+        piranha_assert(i < m_size);
+        return cf_raw::from_raw(m_cfs[i]);
+    }
+    /// Key at index.
+    /**
+     * @param i the index of the term.
+     *
+     * @return the key of the term at index \p i.
+     */
+    key_type key(size_type i) const
+    {
+        piranha_assert(i < m_size);
+        return key_raw::from_raw(m_keys[i]);
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is enabled only if piranha::math::evaluate() is enabled for \p Series and \p T.
+     *
+     * The result is the same as calling piranha::math::evaluate() on the series represented by \p this.
+     *
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating \p this according to the evaluation dictionary \p dict.
+     *
+     * @throws std::invalid_argument if a symbol of \p this does not appear in \p dict.
+     * @throws unspecified any exception thrown by coefficient and key evaluation, by memory errors
+     * in standard containers or by arithmetic operations on the evaluation type.
+     */
+    template <typename T, typename S = Series, typename = math_series_evaluate_enabler<S, T>>
+    series_eval_type<S, T> evaluate(const symbol_fmap<T> &dict) const
+    {
+        const auto evec = series_evaluation_vector(m_symbol_set, dict);
+        series_eval_type<S, T> retval(0);
+        for (size_type i = 0u; i < m_size; ++i) {
+            series_eval_multadd(retval, math::evaluate(cf(i), dict), key(i).evaluate(evec, m_symbol_set));
+        }
+        return retval;
+    }
+    /// Total degree.
+    /**
+     * \note
+     * This method is enabled only if the key type satisfies piranha::is_key_degree_type
+     * and the coefficient type does not satisfy piranha::is_degree_type.
+     *
+     * Only the keys are accessed. If \p this is empty, zero will be returned.
+     *
+     * @return the maximum total degree of the keys.
+     *
+     * @throws unspecified any exception thrown by piranha::key_degree() or by the construction and comparison
+     * of the degree type.
+     */
+    template <typename K = const key_type &>
+    degree_enabler<K, total_key_degree_t<K>> degree() const
+    {
+        using ret_type = total_key_degree_t<K>;
+        if (!m_size) {
+            return ret_type(0);
+        }
+        auto retval = piranha::key_degree(key(0u), m_symbol_set);
+        for (size_type i = 1u; i < m_size; ++i) {
+            auto tmp = piranha::key_degree(key(i), m_symbol_set);
+            if (retval < tmp) {
+                retval = std::move(tmp);
+            }
+        }
+        return retval;
+    }
+    /// Convert to frozen series.
+    /**
+     * @return a piranha::frozen_series containing the terms of \p this, in the same order.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers or by
+     * the public interface of piranha::frozen_series.
+     */
+    frozen_series<Series> freeze() const
+    {
+        frozen_series<Series> retval;
+        retval.m_symbol_set = m_symbol_set;
+        retval.m_cfs.reserve(m_size);
+        retval.m_keys.reserve(m_size);
+        for (size_type i = 0u; i < m_size; ++i) {
+            retval.m_cfs.push_back(cf(i));
+            retval.m_keys.push_back(key(i));
+        }
+        return retval;
+    }
+    /// Convert to series.
+    /**
+     * The terms are inserted directly in the (presized) terms container of the returned series, bypassing
+     * piranha::series::insert(). Since the file is not trusted, each term is still checked for compatibility with
+     * the symbol set, for a nonzero coefficient and for uniqueness. If \p n_threads is greater than one, the
+     * rehydration is run in parallel: the bucket of each term is first computed (and the term checked) in parallel,
+     * then each thread inserts the terms falling in a contiguous range of buckets.
+     *
+     * @param n_threads the number of threads to be used. If zero, the number of threads will be determined
+     * by thread_pool::use_threads().
+     *
+     * @return a series equal to the one stored in the mapped file.
+     *
+     * @throws std::invalid_argument if the file contains terms which are incompatible with the symbol set, terms
+     * with a zero coefficient or duplicate terms.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::series and of its terms container,
+     * - thread_pool::use_threads() and thread_pool::parallel_for(),
+     * - memory errors in standard containers,
+     * - <tt>boost::numeric_cast()</tt>.
+     */
+    Series thaw(unsigned n_threads = 0u) const
+    {
+        using s_size_t = decltype(std::declval<const Series &>().size());
+        profiler::scope prof("s11n.mapped_thaw");
+        Series retval;
+        retval.set_symbol_set(m_symbol_set);
+        if (!m_size) {
+            return retval;
+        }
+        if (!n_threads) {
+            n_threads = thread_pool::use_threads(integer(m_size), integer(settings::get_min_work_per_thread()));
+        }
+        auto &c = retval._container();
+        c.rehash(boost::numeric_cast<s_size_t>(std::ceil(static_cast<double>(m_size) / c.max_load_factor())),
+                 tuning::get_parallel_memory_set() ? n_threads : 1u);
+        const auto check_term = [this](const term_type &t) {
+            if (unlikely(!t.is_compatible(m_symbol_set))) {
+                piranha_throw(std::invalid_argument,
+                              "invalid mapped series: a term is not compatible with the symbol set");
+            }
+            if (unlikely(t.is_zero(m_symbol_set))) {
+                piranha_throw(std::invalid_argument, "invalid mapped series: a term has a zero coefficient");
+            }
+        };
+        const auto dup_error
+            = []() { piranha_throw(std::invalid_argument, "invalid mapped series: duplicate terms were found"); };
+        // NOTE: if an error is found, the terms already inserted must be destroyed before retval, as the
+        // size of the container has not been updated yet.
+        try {
+            if (n_threads == 1u) {
+                for (size_type i = 0u; i < m_size; ++i) {
+                    term_type t(cf(i), key(i));
+                    check_term(t);
+                    const auto b = c._bucket(t);
+                    if (unlikely(c._find(t, b) != c.end())) {
+                        dup_error();
+                    }
+                    c._unique_insert(std::move(t), b);
+                }
+            } else {
+                using bucket_size_type = typename std::decay<decltype(c.bucket_count())>::type;
+                // Check the terms and compute the destination bucket of each of them.
+                std::vector<bucket_size_type> b_idx(
+                    safe_cast<typename std::vector<bucket_size_type>::size_type>(m_size));
+                thread_pool::parallel_for(n_threads, m_size, 4096u,
+                                          [this, &c, &b_idx, &check_term](const unsigned &, const size_type &b,
+                                                                          const size_type &e) {
+                                              for (auto i = b; i != e; ++i) {
+                                                  const term_type t(cf(i), key(i));
+                                                  check_term(t);
+                                                  b_idx[i] = c._bucket(t);
+                                              }
+                                          });
+                // Each thread inserts the terms belonging to its range of buckets. Every thread scans the
+                // whole vector of bucket indices, which is cheap with respect to the insertions.
+                const auto b_count = c.bucket_count();
+                const auto n_ranges = static_cast<size_type>(n_threads);
+                thread_pool::parallel_for(
+                    n_threads, n_ranges, 1u, [this, &c, &b_idx, &dup_error, b_count, n_ranges](
+                                                 const unsigned &, const size_type &b, const size_type &e) {
+                        for (auto r = b; r != e; ++r) {
+                            const auto start = static_cast<bucket_size_type>(b_count / n_ranges * r),
+                                       end = (r + 1u == n_ranges)
+                                                 ? b_count
+                                                 : static_cast<bucket_size_type>(b_count / n_ranges * (r + 1u));
+                            for (size_type i = 0u; i < m_size; ++i) {
+                                if (b_idx[i] >= start && b_idx[i] < end) {
+                                    term_type t(cf(i), key(i));
+                                    if (unlikely(c._find(t, b_idx[i]) != c.end())) {
+                                        dup_error();
+                                    }
+                                    c._unique_insert(std::move(t), b_idx[i]);
+                                }
+                            }
+                        }
+                    });
+            }
+        } catch (...) {
+            c.clear();
+            throw;
+        }
+        c._update_size(piranha::safe_cast<s_size_t>(m_size));
+        return retval;
+    }
+
+private:
+    void clear()
+    {
+        m_symbol_set = symbol_fset{};
+        m_cfs = nullptr;
+        m_keys = nullptr;
+        m_size = 0u;
+    }
+
+private:
+    boost::interprocess::file_mapping m_file;
+    boost::interprocess::mapped_region m_region;
+    symbol_fset m_symbol_set;
+    const raw_cf_type *m_cfs = nullptr;
+    const raw_key_type *m_keys = nullptr;
+    size_type m_size = 0u;
+};
+} // namespace piranha
+
+#endif
@@ -268,22 +268,19 @@ inline bool alignment_check(const std::size_t &alignment)
  * @param size size of the array.
  * @param n_threads number of threads to use.
  *
- * @throws std::bad_alloc in case of memory allocation errors in multithreaded mode.
  * @throws unspecified any exception thrown by:
  * - the value initialisation of instances of type \p T,
- * - piranha::thread_pool::enqueue() and piranha::future_list::push_back(), only in multithreaded mode.
+ * - piranha::thread_pool::parallel_for(), only in multithreaded mode.
  */
 template <typename T, typename = typename std::enable_if<is_container_element<T>::value>::type>
 inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned &n_threads)
 {
-    using ranges_vector = std::vector<std::pair<T *, T *>>;
-    using rv_size_type = typename ranges_vector::size_type;
     if (unlikely(ptr == nullptr)) {
         piranha_assert(!size);
         return;
     }
     // Initing functor.
-    auto init_function = [](T *start, T *end, const unsigned &thread_idx, ranges_vector *rv) {
+    auto init_function = [](T *start, T *end) {
         auto orig_start = start;
         try {
             for (; start != end; ++start) {
@@ -297,37 +294,37 @@ inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned
             // Re-throw.
             throw;
         }
-        // If the init was successful and we are in multithreaded mode, record
-        // the range that was inited.
-        if (rv != nullptr) {
-            (*rv)[static_cast<rv_size_type>(thread_idx)].first = orig_start;
-            (*rv)[static_cast<rv_size_type>(thread_idx)].second = end;
-        }
     };
     if (n_threads <= 1) {
-        init_function(ptr, ptr + size, 0u, nullptr);
+        init_function(ptr, ptr + size);
     } else {
-        // Init the ranges vector with (ptr,ptr) pairs, so they are empty ranges.
-        ranges_vector inited_ranges(static_cast<rv_size_type>(n_threads), std::make_pair(ptr, ptr));
-        if (unlikely(inited_ranges.size() != n_threads)) {
-            piranha_throw(std::bad_alloc, );
-        }
-        // Work per thread.
-        const auto wpt = static_cast<std::size_t>(size / n_threads);
-        future_list<decltype(init_function(ptr, ptr, 0u, &inited_ranges))> f_list;
+        // The array is split in chunks of about the size of a memory page, which are distributed among
+        // the threads by thread_pool::parallel_for(). Each thread starts from a contiguous part of the array, so that,
+        // on NUMA machines, most of the pages will be placed close to the thread that first touches them.
+        const std::size_t chunk_size = (sizeof(T) >= 4096u) ? 1u : 4096u / sizeof(T);
+        const std::size_t n_chunks = size / chunk_size + static_cast<std::size_t>(size % chunk_size != 0u);
+        // End of the c-th chunk.
+        auto chunk_end = [ptr, size, chunk_size](const std::size_t &c) {
+            return (size - c * chunk_size > chunk_size) ? ptr + (c + 1u) * chunk_size : ptr + size;
+        };
+        // Flags to mark the chunks which were successfully inited.
+        std::vector<char> inited(n_chunks, 0);
         try {
-            for (auto i = 0u; i < n_threads; ++i) {
-                auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
-                f_list.push_back(thread_pool::enqueue(i, init_function, start, end, i, &inited_ranges));
-            }
-            f_list.wait_all();
-            f_list.get_all();
+            thread_pool::parallel_for(n_threads, n_chunks, 1u,
+                                      [ptr, chunk_size, &chunk_end, &inited, &init_function](
+                                          const unsigned &, const std::size_t &begin, const std::size_t &end) {
+                                          for (auto c = begin; c != end; ++c) {
+                                              init_function(ptr + c * chunk_size, chunk_end(c));
+                                              inited[c] = 1;
+                                          }
+                                      });
         } catch (...) {
-            f_list.wait_all();
-            // Rollback the ranges that were inited.
-            for (const auto &p : inited_ranges) {
-                for (auto start = p.first; start != p.second; ++start) {
-                    start->~T();
+            // Rollback the chunks that were inited.
+            for (std::size_t c = 0u; c < n_chunks; ++c) {
+                if (inited[c]) {
+                    for (auto start = ptr + c * chunk_size; start != chunk_end(c); ++start) {
+                        start->~T();
+                    }
                 }
             }
             throw;
@@ -147,12 +147,17 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/array_key.hpp>
 #include <piranha/base_series_multiplier.hpp>
 #include <piranha/cache_aligning_allocator.hpp>
+#include <piranha/chunked_file.hpp>
 #include <piranha/config.hpp>
 #include <piranha/convert_to.hpp>
 #include <piranha/divisor.hpp>
 #include <piranha/divisor_series.hpp>
 #include <piranha/dynamic_aligning_allocator.hpp>
+#include <piranha/evaluation_plan.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/flat_hash_set.hpp>
+#include <piranha/frozen_series.hpp>
+#include <piranha/graded_series.hpp>
 #include <piranha/hash_set.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/invert.hpp>
@@ -168,6 +173,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/kronecker_array.hpp>
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/lambdify.hpp>
+#include <piranha/mapped_series.hpp>
 #include <piranha/math.hpp>
 #include <piranha/math/binomial.hpp>
 #include <piranha/math/cos.hpp>
@@ -186,6 +192,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/power_series.hpp>
 #include <piranha/print_coefficient.hpp>
 #include <piranha/print_tex_coefficient.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/rational.hpp>
 #if defined(MPPP_WITH_MPFR)
 #include <piranha/real.hpp>
@@ -196,7 +203,9 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/safe_cast.hpp>
 #include <piranha/safe_convert.hpp>
 #include <piranha/series.hpp>
+#include <piranha/series_evaluator.hpp>
 #include <piranha/series_multiplier.hpp>
+#include <piranha/series_stream.hpp>
 #include <piranha/settings.hpp>
 #include <piranha/small_vector.hpp>
 #include <piranha/static_vector.hpp>
@@ -30,6 +30,7 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_POLYNOMIAL_HPP
 
 #include <algorithm>
+#include <chrono>
 #include <cmath> // For std::ceil.
 #include <cstddef>
 #include <functional>
@@ -48,17 +49,18 @@ see https://www.gnu.org/licenses/. */
 
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <mp++/integer.hpp>
 #include <mp++/rational.hpp>
 
 #include <piranha/base_series_multiplier.hpp>
 #include <piranha/config.hpp>
-#include <piranha/detail/atomic_flag_array.hpp>
 #include <piranha/detail/cf_mult_impl.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/divisor_series_fwd.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/detail/parallel_vector_transform.hpp>
 #include <piranha/detail/poisson_series_fwd.hpp>
+#include <piranha/detail/polynomial_division.hpp>
 #include <piranha/detail/polynomial_fwd.hpp>
 #include <piranha/detail/safe_integral_arith.hpp>
 #include <piranha/detail/sfinae_types.hpp>
@@ -74,11 +76,16 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/kronecker_array.hpp>
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/math.hpp>
+#include <piranha/math/binomial.hpp>
 #include <piranha/math/degree.hpp>
+#include <piranha/math/gcd.hpp>
 #include <piranha/math/is_zero.hpp>
 #include <piranha/math/pow.hpp>
+#include <piranha/memory.hpp>
 #include <piranha/monomial.hpp>
 #include <piranha/power_series.hpp>
+#include <piranha/profiler.hpp>
+#include <piranha/rational.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/series.hpp>
 #include <piranha/series_multiplier.hpp>
@@ -117,6 +124,33 @@ struct is_polynomial_key<monomial<T, U>> {
     static const bool value = true;
 };
 
+// Identification of key types for dispatching in the multiplier.
+template <typename T>
+struct is_kronecker_monomial {
+    static const bool value = false;
+};
+
+template <typename T>
+struct is_kronecker_monomial<kronecker_monomial<T>> {
+    static const bool value = true;
+};
+
+// Detect polynomials supporting exact division and GCD: integer coefficients and Kronecker monomials.
+template <typename T>
+struct has_kpoly_division {
+    static const bool value = mppp::is_integer<typename T::term_type::cf_type>::value
+                              && is_kronecker_monomial<typename T::term_type::key_type>::value;
+};
+
+// Detect exact coefficient types: integers, rationals and series with exact coefficients.
+template <typename T, typename = void>
+struct is_exact_cf : std::integral_constant<bool, mppp::is_integer<T>::value || mppp::is_rational<T>::value> {
+};
+
+template <typename T>
+struct is_exact_cf<T, enable_if_t<is_series<T>::value>> : is_exact_cf<typename T::term_type::cf_type> {
+};
+
 // Implementation detail to check if the monomial key supports the is_linear() method.
 template <typename Key>
 struct key_has_is_linear {
@@ -438,6 +472,430 @@ class polynomial
                                     && is_safely_castable<const U &, degree_type<T>>::value
                                     && true_tt<at_degree_enabler<T>>::value,
                                 int>::type;
+    // Enabler for exact division and GCD.
+    template <typename T>
+    using div_enabler = typename std::enable_if<detail::has_kpoly_division<T>::value, int>::type;
+    // Power strategies.
+    // Vector of exponents used in the multinomial expansion.
+    using pow_expo_vector = std::vector<integer>;
+    // Enabler for the multinomial expansion: the product of two polynomials must be a polynomial, the coefficients
+    // must be multipliable by coefficients and integers, and the exponents must be extracted and injected
+    // in integral form.
+    template <typename T>
+    using pow_multinomial_enabler = enable_if_t<
+        conjunction<std::is_same<T, decltype(std::declval<const T &>() * std::declval<const T &>())>,
+                    is_multipliable_in_place<typename T::term_type::cf_type>,
+                    is_multipliable_in_place<typename T::term_type::cf_type, integer>,
+                    std::is_constructible<typename T::term_type::key_type, typename pow_expo_vector::const_iterator,
+                                          typename pow_expo_vector::const_iterator, const symbol_fset &>,
+                    is_safely_castable<addlref_t<const decltype(piranha::key_degree(
+                                           std::declval<const typename T::term_type::key_type &>(),
+                                           std::declval<const symbol_idx_fset &>(),
+                                           std::declval<const symbol_fset &>()))>,
+                                       integer>>::value,
+        int>;
+    // Enabler for Miller's recurrence: on top of the closure of multiplication, polynomials must be addable
+    // and multipliable by integers, divisible by coefficients, and the (partial) degrees of the terms must
+    // be castable to integer.
+    template <typename T>
+    using pow_miller_enabler = enable_if_t<
+        conjunction<std::is_same<T, decltype(std::declval<const T &>() * std::declval<const T &>())>,
+                    is_addable_in_place<T>, is_multipliable_in_place<T, integer>,
+                    is_divisible_in_place<T, typename T::term_type::cf_type>,
+                    is_multipliable_in_place<typename T::term_type::cf_type>,
+                    is_multipliable_in_place<typename T::term_type::cf_type, integer>,
+                    is_safely_castable<addlref_t<const ps_degree_type_<T>>, integer>,
+                    is_safely_castable<addlref_t<const ps_pdegree_type_<T>>, integer>>::value,
+        int>;
+    // Auto-truncation settings for the power strategies. The return value is the truncation mode
+    // (as in get_auto_truncate_degree()), max_degree is set to the maximum degree and integral to false
+    // if the maximum degree is not an integral value.
+    template <typename T = polynomial>
+    static auto pow_truncation(int, integer &max_degree, bool &integral, symbol_fset &names)
+        -> decltype(T::get_auto_truncate_degree(), int())
+    {
+        const auto t = T::get_auto_truncate_degree();
+        if (std::get<0u>(t)) {
+            try {
+                max_degree = piranha::safe_cast<integer>(std::get<1u>(t));
+            } catch (const safe_cast_failure &) {
+                integral = false;
+            }
+            names = std::get<2u>(t);
+        }
+        return std::get<0u>(t);
+    }
+    template <typename T = polynomial>
+    static int pow_truncation(long, integer &, bool &, symbol_fset &)
+    {
+        return 0;
+    }
+    // Exponents of the terms of p, in integral form.
+    template <typename T = polynomial>
+    static std::vector<pow_expo_vector> pow_exponents(const polynomial &p)
+    {
+        const auto &ss = p.m_symbol_set;
+        std::vector<pow_expo_vector> retval;
+        for (const auto &t : p.m_container) {
+            pow_expo_vector tmp;
+            for (symbol_idx i = 0u; i < ss.size(); ++i) {
+                tmp.push_back(piranha::safe_cast<integer>(piranha::key_degree(t.m_key, symbol_idx_fset{i}, ss)));
+            }
+            retval.push_back(std::move(tmp));
+        }
+        return retval;
+    }
+    // Check if the exponent vectors are affinely independent, that is, if all the term-by-term products
+    // in the multinomial expansion of any power of the polynomial produce distinct monomials.
+    static bool pow_affinely_independent(const std::vector<pow_expo_vector> &expos)
+    {
+        if (expos.size() < 2u) {
+            return true;
+        }
+        const auto n_cols = expos[0].size();
+        if (expos.size() - 1u > n_cols) {
+            return false;
+        }
+        // Gaussian elimination on the differences with respect to the first vector.
+        std::vector<std::vector<rational>> rows;
+        for (decltype(expos.size()) i = 1u; i < expos.size(); ++i) {
+            rows.emplace_back();
+            for (decltype(expos[i].size()) j = 0u; j < n_cols; ++j) {
+                rows.back().emplace_back(expos[i][j] - expos[0][j]);
+            }
+        }
+        decltype(rows.size()) rank = 0u;
+        for (decltype(expos[0].size()) j = 0u; j < n_cols && rank < rows.size(); ++j) {
+            auto pivot = rank;
+            for (; pivot < rows.size() && piranha::is_zero(rows[pivot][j]); ++pivot) {
+            }
+            if (pivot == rows.size()) {
+                continue;
+            }
+            std::swap(rows[rank], rows[pivot]);
+            for (auto i = rank + 1u; i < rows.size(); ++i) {
+                if (piranha::is_zero(rows[i][j])) {
+                    continue;
+                }
+                const rational f = rows[i][j] / rows[rank][j];
+                for (auto k = j; k < n_cols; ++k) {
+                    rows[i][k] -= f * rows[rank][k];
+                }
+            }
+            ++rank;
+        }
+        return rank == rows.size();
+    }
+    // State of the multinomial expansion. cfs[i] and expos[i] are the coefficient and the exponents accumulated
+    // before processing the i-th term of the base.
+    template <typename T = polynomial>
+    struct pow_mn_state {
+        using cf_type = typename T::term_type::cf_type;
+        const std::vector<pow_expo_vector> &m_base_expos;
+        const std::vector<std::vector<cf_type>> &m_cf_pows;
+        std::vector<cf_type> m_cfs;
+        std::vector<pow_expo_vector> m_expos;
+        polynomial &m_retval;
+    };
+    // Recursive step of the multinomial expansion: distribute the remaining exponent r among the terms of the
+    // base from the i-th onwards.
+    template <typename T = polynomial>
+    static void pow_multinomial_step(pow_mn_state<T> &st, std::size_t i, std::size_t r)
+    {
+        using term_type = typename base::term_type;
+        using key_type = typename term_type::key_type;
+        const auto n_terms = st.m_base_expos.size();
+        const auto n_vars = st.m_base_expos[i].size();
+        auto &e = st.m_expos[i + 1u];
+        // The last term takes all the remaining exponent.
+        const std::size_t k_min = (i + 1u == n_terms) ? r : 0u;
+        // The multinomial coefficient is built as a product of binomial coefficients.
+        integer bin(1);
+        for (std::size_t k = 0u; k <= r; ++k) {
+            if (k >= k_min) {
+                auto &cf = st.m_cfs[i + 1u];
+                cf = st.m_cfs[i];
+                cf *= bin;
+                cf *= st.m_cf_pows[i][k];
+                for (decltype(e.size()) j = 0u; j < n_vars; ++j) {
+                    e[j] = st.m_expos[i][j] + st.m_base_expos[i][j] * k;
+                }
+                if (i + 1u == n_terms) {
+                    st.m_retval.insert(term_type(cf, key_type(e.begin(), e.end(), st.m_retval.m_symbol_set)));
+                } else {
+                    pow_multinomial_step(st, i + 1u, r - k);
+                }
+            }
+            bin *= r - k;
+            bin /= k + 1u;
+        }
+    }
+    // Multinomial expansion of p**n.
+    template <typename T = polynomial>
+    static polynomial pow_multinomial(const polynomial &p, const integer &n)
+    {
+        using cf_type = typename base::term_type::cf_type;
+        using bucket_size_type = typename base::size_type;
+        polynomial retval;
+        retval.set_symbol_set(p.m_symbol_set);
+        if (p.empty()) {
+            if (n.is_zero()) {
+                retval.insert(typename base::term_type(cf_type(1), Key(p.m_symbol_set)));
+            }
+            return retval;
+        }
+        const auto nn = piranha::safe_cast<std::size_t>(n);
+        const auto base_expos = pow_exponents(p);
+        const auto n_terms = base_expos.size();
+        // The powers of the coefficients.
+        std::vector<std::vector<cf_type>> cf_pows;
+        for (const auto &t : p.m_container) {
+            cf_pows.emplace_back();
+            auto &v = cf_pows.back();
+            v.reserve(nn + 1u);
+            v.emplace_back(1);
+            for (std::size_t k = 0u; k < nn; ++k) {
+                v.push_back(v.back());
+                v.back() *= t.m_cf;
+            }
+        }
+        // Pre-size the table: there are binomial(n + n_terms - 1, n_terms - 1) term-by-term products.
+        const double n_buckets = static_cast<double>(piranha::binomial(n + (n_terms - 1u), integer(n_terms - 1u)))
+                                 / retval.m_container.max_load_factor();
+        if (n_buckets < static_cast<double>(std::numeric_limits<bucket_size_type>::max() / 2u)) {
+            retval.m_container.rehash(static_cast<bucket_size_type>(n_buckets) + 1u);
+        }
+        pow_mn_state<T> st{base_expos, cf_pows, std::vector<cf_type>(n_terms + 1u, cf_type(1)),
+                           std::vector<pow_expo_vector>(n_terms + 1u, pow_expo_vector(p.m_symbol_set.size())),
+                           retval};
+        pow_multinomial_step(st, 0u, nn);
+        return retval;
+    }
+    template <typename T = polynomial, pow_multinomial_enabler<T> = 0>
+    static bool pow_try_multinomial(int, const polynomial &p, const integer &n, polynomial &out)
+    {
+        // NOTE: the exponents might not be integral (e.g., with rational monomials), in which case
+        // we fall back to the other strategies.
+        try {
+            if (!pow_affinely_independent(pow_exponents(p))) {
+                return false;
+            }
+        } catch (const safe_cast_failure &) {
+            return false;
+        }
+        out = pow_multinomial(p, n);
+        return true;
+    }
+    template <typename T = polynomial>
+    static bool pow_try_multinomial(long, const polynomial &, const integer &, polynomial &)
+    {
+        return false;
+    }
+    // J.C.P. Miller's recurrence. The polynomial p is graded by the total degree (mode 0 or 1) or the partial
+    // degree in names (mode 2) of its terms, p = p_0 + p_1 + ... + p_g. If p_0 is a single term with unitary key
+    // c0, the homogeneous components of p**n satisfy
+    // q_0 = c0**n, q_k = 1 / (k * c0) * sum_{i=1}^{min(k, g)} ((n + 1) * i - k) * p_i * q_{k - i},
+    // which follows from the identity p * D(p**n) = n * D(p) * p**n, where D is the derivation multiplying each
+    // term by its grade. The components are computed via Kronecker multiplications of the (small) homogeneous
+    // components of p by the previous components of the result. Only the components up to max_degree are computed
+    // if mode is not zero. The return value is false if p does not satisfy the requirements above, or if the
+    // grades of p are sparse (in which case the other strategies are preferable).
+    template <typename T = polynomial, pow_miller_enabler<T> = 0>
+    static bool pow_try_miller(int, const polynomial &p, const integer &n, int mode, const integer &max_degree,
+                               const symbol_fset &names, polynomial &out)
+    {
+        using term_type = typename base::term_type;
+        using cf_type = typename term_type::cf_type;
+        const auto &ss = p.m_symbol_set;
+        const auto idx = ss_intersect_idx(ss, names);
+        // Split p in homogeneous components.
+        std::map<integer, polynomial> comps;
+        try {
+            for (const auto &t : p.m_container) {
+                const auto g = (mode == 2) ? piranha::safe_cast<integer>(ps_get_degree(t, names, idx, ss))
+                                           : piranha::safe_cast<integer>(ps_get_degree(t, ss));
+                if (g.sgn() < 0) {
+                    return false;
+                }
+                auto &c = comps[g];
+                c.set_symbol_set(ss);
+                c.insert(t);
+            }
+        } catch (const safe_cast_failure &) {
+            return false;
+        }
+        if (comps.empty()) {
+            return false;
+        }
+        const auto p0 = comps.begin();
+        if (p0->first.sgn() != 0 || p0->second.size() != 1u
+            || !piranha::key_is_one(p0->second._container().begin()->m_key, ss)) {
+            return false;
+        }
+        const auto g_max = comps.rbegin()->first;
+        // Require the grades to be dense.
+        if (integer(comps.size()) * 2 < g_max + 1) {
+            return false;
+        }
+        const cf_type c0 = p0->second._container().begin()->m_cf;
+        // Maximum grade of the result.
+        integer k_max = n * g_max;
+        if (mode && max_degree < k_max) {
+            k_max = max_degree;
+        }
+        out = polynomial{};
+        out.set_symbol_set(ss);
+        if (k_max.sgn() < 0) {
+            return true;
+        }
+        std::size_t kk_max, gg_max;
+        try {
+            kk_max = piranha::safe_cast<std::size_t>(k_max);
+            gg_max = piranha::safe_cast<std::size_t>(g_max);
+        } catch (const safe_cast_failure &) {
+            return false;
+        }
+        std::vector<std::pair<std::size_t, const polynomial *>> p_comps;
+        for (const auto &c : comps) {
+            if (c.first.sgn()) {
+                p_comps.emplace_back(static_cast<std::size_t>(c.first), &c.second);
+            }
+        }
+        // q_0 = c0**n, computed by squaring.
+        cf_type q0_cf(1), sq(c0);
+        for (integer m(n); !m.is_zero();) {
+            if (m.odd_p()) {
+                q0_cf *= sq;
+            }
+            m /= 2;
+            if (!m.is_zero()) {
+                sq *= cf_type(sq);
+            }
+        }
+        // NOTE: only the last g_max components are needed by the recurrence: keep them in a circular buffer.
+        std::vector<polynomial> q(gg_max + 1u);
+        q[0].set_symbol_set(ss);
+        q[0].insert(term_type(q0_cf, Key(ss)));
+        out += q[0];
+        for (std::size_t k = 1u; k <= kk_max; ++k) {
+            polynomial acc;
+            acc.set_symbol_set(ss);
+            for (const auto &pc : p_comps) {
+                if (pc.first > k) {
+                    break;
+                }
+                const auto &prev = q[(k - pc.first) % (gg_max + 1u)];
+                const integer f = (n + 1) * pc.first - k;
+                if (prev.empty() || f.is_zero()) {
+                    continue;
+                }
+                auto tmp = *pc.second * prev;
+                tmp *= f;
+                acc += tmp;
+            }
+            cf_type div(c0);
+            div *= integer(k);
+            acc /= div;
+            out += acc;
+            q[k % (gg_max + 1u)] = std::move(acc);
+        }
+        return true;
+    }
+    template <typename T = polynomial>
+    static bool pow_try_miller(long, const polynomial &, const integer &, int, const integer &, const symbol_fset &,
+                               polynomial &)
+    {
+        return false;
+    }
+    // Exponentiation by squaring. If auto-truncation is active, all the intermediate products are truncated.
+    template <typename T = polynomial>
+    static polynomial pow_squaring(const polynomial &p, const integer &n)
+    {
+        if (n.is_zero()) {
+            polynomial retval;
+            retval.set_symbol_set(p.m_symbol_set);
+            retval.insert(typename base::term_type(typename base::term_type::cf_type(1), Key(p.m_symbol_set)));
+            return retval;
+        }
+        polynomial retval, sq(p);
+        bool first = true;
+        for (integer m(n);;) {
+            if (m.odd_p()) {
+                retval = first ? sq : retval * sq;
+                first = false;
+            }
+            m /= 2;
+            if (m.is_zero()) {
+                break;
+            }
+            sq = sq * sq;
+        }
+        return retval;
+    }
+    // Automatic selection of the power strategy, used in pow() to compute directly the powers which are not
+    // in the cache. The return value is false if the power should be computed via repeated multiplications.
+    // The selection logic is:
+    // - if auto-truncation is active, Miller's recurrence (which computes only the components of the result below
+    //   the truncation limit) or, if this is not applicable, exponentiation by squaring (so that the truncation
+    //   prunes the intermediate results);
+    // - otherwise, the multinomial expansion if the exponents of p are affinely independent (so that the number
+    //   of term-by-term products is equal to the number of terms of the result), then Miller's recurrence, and
+    //   finally repeated multiplications. The first two are selected only for exact coefficient types: with
+    //   floating-point coefficients they would round differently from the repeated multiplications.
+    template <typename T = polynomial>
+    static bool pow_direct(const polynomial &p, const integer &n, polynomial &out)
+    {
+        profiler::scope prof("polynomial.pow_direct");
+        integer max_degree;
+        bool integral = true;
+        symbol_fset names;
+        const int mode = pow_truncation<T>(0, max_degree, integral, names);
+        if (mode) {
+            if (integral && pow_try_miller<T>(0, p, n, mode, max_degree, names, out)) {
+                prof.count("miller", 1u);
+                return true;
+            }
+            out = pow_squaring(p, n);
+            prof.count("squaring", 1u);
+            return true;
+        }
+        if (!detail::is_exact_cf<typename base::term_type::cf_type>::value) {
+            return false;
+        }
+        if (pow_try_multinomial<T>(0, p, n, out)) {
+            prof.count("multinomial", 1u);
+            return true;
+        }
+        if (pow_try_miller<T>(0, p, n, 0, max_degree, names, out)) {
+            prof.count("miller", 1u);
+            return true;
+        }
+        return false;
+    }
+    // Exponentiation of polynomials with at least two terms to a natural power, via the pow cache.
+    template <typename Ret, typename T, typename U = polynomial, um_enabler<U> = 0>
+    Ret pow_impl(const T &x, int) const
+    {
+        if (this->size() >= 2u) {
+            integer n;
+            bool natural = true;
+            try {
+                n = piranha::safe_cast<integer>(x);
+            } catch (const safe_cast_failure &) {
+                natural = false;
+            }
+            if (natural && n >= 2) {
+                return this->template cached_pow<Ret>(
+                    n, [](const polynomial &p, const integer &m, polynomial &out) { return pow_direct(p, m, out); });
+            }
+        }
+        return static_cast<series<Cf, Key, polynomial<Cf, Key>> const *>(this)->pow(x);
+    }
+    template <typename Ret, typename T>
+    Ret pow_impl(const T &x, long) const
+    {
+        return static_cast<series<Cf, Key, polynomial<Cf, Key>> const *>(this)->pow(x);
+    }
     // Common bits for truncated/untruncated multiplication. Will do the usual merging of the symbol sets
     // before calling the runner functor, which performs the actual multiplication.
     template <typename Functor>
@@ -522,8 +980,20 @@ public:
      *
      * This exponentiation override will check if the polynomial consists of a single-term with non-unitary
      * key. In that case, the return polynomial will consist of a single term with coefficient computed via
-     * piranha::pow() and key computed via the monomial exponentiation method. Otherwise, the base
-     * (i.e., default) exponentiation method will be used.
+     * piranha::pow() and key computed via the monomial exponentiation method.
+     *
+     * If the polynomial has at least two terms, \p x represents a natural number greater than one and the product
+     * of two polynomials is a polynomial, the algorithm used to compute the powers missing from the cache
+     * of natural powers (see piranha::series::pow()) is selected automatically:
+     * - if auto-truncation is active, _pow_miller() is used, or _pow_squaring() if Miller's recurrence
+     *   cannot be applied;
+     * - otherwise, _pow_multinomial() is used if the exponent vectors of the polynomial are affinely independent,
+     *   then _pow_miller() if applicable, and finally repeated multiplications. _pow_multinomial() and _pow_miller()
+     *   are selected only if the coefficients are exact (i.e., piranha::integer, piranha::rational or series
+     *   with exact coefficients), so that for other coefficient types (e.g., floating-point) the result
+     *   is the same as with repeated multiplications.
+     *
+     * In all the other cases, the base (i.e., default) exponentiation method will be used.
      *
      * @param x exponent.
      *
@@ -533,7 +1003,8 @@ public:
      * - piranha::key_is_one() and the exponentiation methods of the key type,
      * - piranha::pow(),
      * - construction of coefficient, key and term,
-     * - piranha::series::insert() , piranha::series::set_symbol_set() and piranha::series::pow().
+     * - piranha::series::insert() , piranha::series::set_symbol_set() and piranha::series::pow(),
+     * - the exponentiation algorithms listed above.
      */
     template <typename T>
     pow_ret_type<T> pow(const T &x) const
@@ -550,7 +1021,109 @@ public:
             retval.insert(term_type(std::move(cf), std::move(key)));
             return retval;
         }
-        return static_cast<series<Cf, Key, polynomial<Cf, Key>> const *>(this)->pow(x);
+        return pow_impl<ret_type>(x, 0);
+    }
+    /// Exponentiation via multinomial expansion.
+    /**
+     * \note
+     * This method is enabled only if the product of two polynomials is a polynomial, the coefficients can be
+     * multiplied in-place by coefficients and by piranha::integer, and the exponents of the monomials can be
+     * extracted and injected in integral form.
+     *
+     * The power is computed by enumerating the terms of the multinomial expansion of \p this. This is the
+     * algorithm selected automatically by pow() (for exponents greater than one, and in absence of
+     * auto-truncation) when the exponent vectors of \p this are affinely independent, as in this case all the
+     * term-by-term products produce distinct monomials. Auto-truncation is not applied.
+     *
+     * @param n the exponent.
+     *
+     * @return \p this raised to the power of \p n.
+     *
+     * @throws std::invalid_argument if \p n is negative.
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - the extraction of the exponents of the monomials and the construction of monomials and terms,
+     * - arithmetic operations on the coefficients and on piranha::integer,
+     * - piranha::series::insert(),
+     * - memory errors in standard containers.
+     */
+    template <typename T = polynomial, pow_multinomial_enabler<T> = 0>
+    polynomial _pow_multinomial(const integer &n) const
+    {
+        if (unlikely(n.sgn() < 0)) {
+            piranha_throw(std::invalid_argument, "invalid argument for polynomial exponentiation: negative exponent");
+        }
+        return pow_multinomial(*this, n);
+    }
+    /// Exponentiation via Miller's recurrence.
+    /**
+     * \note
+     * This method is enabled only if the product of two polynomials is a polynomial, polynomials can be added
+     * in-place, multiplied in-place by piranha::integer and divided in-place by coefficients, the coefficients
+     * can be multiplied in-place by coefficients and by piranha::integer, and the total and partial degrees
+     * of the terms can be cast to piranha::integer.
+     *
+     * The homogeneous components of the power (with respect to the total degree or, if partial-degree
+     * auto-truncation is active, the partial degree) are computed via J.C.P. Miller's recurrence,
+     * which requires the lowest component of \p this to be a nonzero constant. If auto-truncation is active,
+     * only the components up to the truncation limit are computed. This is the algorithm selected automatically
+     * by pow() when the exponents of \p this are not affinely independent, or when auto-truncation is active.
+     *
+     * @param n the exponent.
+     *
+     * @return \p this raised to the power of \p n.
+     *
+     * @throws std::invalid_argument if \p n is negative, or if \p this does not satisfy the requirements of the
+     * algorithm (i.e., its grades must be non-negative integers, its component of grade zero must be a single
+     * constant term and at least half of the grades must be populated).
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - the computation of the degree of the terms,
+     * - the arithmetic operations on polynomials, coefficients and piranha::integer,
+     * - get_auto_truncate_degree(),
+     * - memory errors in standard containers.
+     */
+    template <typename T = polynomial, pow_miller_enabler<T> = 0>
+    polynomial _pow_miller(const integer &n) const
+    {
+        if (unlikely(n.sgn() < 0)) {
+            piranha_throw(std::invalid_argument, "invalid argument for polynomial exponentiation: negative exponent");
+        }
+        integer max_degree;
+        bool integral = true;
+        symbol_fset names;
+        const int mode = pow_truncation<T>(0, max_degree, integral, names);
+        polynomial retval;
+        if (unlikely(!integral || !pow_try_miller<T>(0, *this, n, mode, max_degree, names, retval))) {
+            piranha_throw(std::invalid_argument, "Miller's recurrence cannot be used to compute the power of this "
+                                                 "polynomial");
+        }
+        return retval;
+    }
+    /// Exponentiation by squaring.
+    /**
+     * \note
+     * This method is enabled only if the product of two polynomials is a polynomial.
+     *
+     * The power is computed by repeated squaring. If auto-truncation is active, all the intermediate products
+     * are truncated, so that the terms which cannot contribute to the result are pruned early. This is the
+     * algorithm selected automatically by pow() when auto-truncation is active and Miller's recurrence cannot be
+     * used.
+     *
+     * @param n the exponent.
+     *
+     * @return \p this raised to the power of \p n.
+     *
+     * @throws std::invalid_argument if \p n is negative.
+     * @throws unspecified any exception thrown by polynomial multiplication or by the construction of terms.
+     */
+    template <typename T = polynomial, um_enabler<T> = 0>
+    polynomial _pow_squaring(const integer &n) const
+    {
+        if (unlikely(n.sgn() < 0)) {
+            piranha_throw(std::invalid_argument, "invalid argument for polynomial exponentiation: negative exponent");
+        }
+        return pow_squaring(*this, n);
     }
     /// Inversion.
     /**
@@ -699,7 +1272,8 @@ public:
      * \note
      * This method is available only if the requisites outlined in piranha::polynomial are satisfied.
      *
-     * Disable the degree-based auto-truncation mechanism.
+     * Disable the degree-based auto-truncation mechanism. If auto-truncation was active, the natural power cache
+     * defined in piranha::series will be cleared.
      *
      * @throws unspecified any exception thrown by:
      * - threading primitives,
@@ -712,6 +1286,8 @@ public:
         degree_type<T> new_degree(0);
         auto &at_dm = get_at_degree_max();
         std::lock_guard<std::mutex> lock(s_at_degree_mutex);
+        // NOTE: the powers computed under truncation must not be returned by the cache once the truncation is lifted.
+        truncation_clear_pow_cache(0, new_degree, symbol_fset{});
         s_at_degree_mode = 0;
         at_dm = std::move(new_degree);
         s_at_degree_names.clear();
@@ -894,6 +1470,86 @@ public:
         };
         return um_tm_implementation(p1, p2, runner);
     }
+    /// Exact division.
+    /**
+     * \note
+     * This function template is enabled only if the coefficient type is an mp++ integer and the key type is
+     * piranha::kronecker_monomial.
+     *
+     * This function will return the quotient of the exact division of \p n by \p d. The division is performed
+     * with a heap-based algorithm operating on the Kronecker codes of the monomials, which produces the terms of the
+     * quotient in decreasing monomial order and requires working memory proportional to the size of the quotient.
+     * Negative exponents are allowed.
+     *
+     * @param n the dividend.
+     * @param d the divisor.
+     *
+     * @return the quotient of \p n divided by \p d.
+     *
+     * @throws mppp::zero_division_error if \p d is zero.
+     * @throws std::invalid_argument if \p d does not divide \p n exactly.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::symbol_fset, piranha::series and piranha::hash_set,
+     * - the public interface of piranha::kronecker_array,
+     * - arithmetic operations on the coefficient type.
+     */
+    template <typename T = polynomial, div_enabler<T> = 0>
+    static polynomial divexact(const polynomial &n, const polynomial &d)
+    {
+        auto runner = [](const polynomial &a, const polynomial &b) {
+            if (unlikely(b.empty())) {
+                piranha_throw(mppp::zero_division_error, "cannot divide a polynomial by zero");
+            }
+            polynomial retval;
+            if (unlikely(!detail::kpoly_heap_divide(retval, a, b))) {
+                piranha_throw(std::invalid_argument, "the division of the polynomials is not exact");
+            }
+            return retval;
+        };
+        return series_merge_f(n, d, runner);
+    }
+    /// Greatest common divisor.
+    /**
+     * \note
+     * This function template is enabled only if the coefficient type is an mp++ integer and the key type is
+     * piranha::kronecker_monomial.
+     *
+     * This function will return the GCD of \p a and \p b, normalised so that the coefficient of its leading term
+     * (i.e., the term with the largest Kronecker code) is positive. The GCD is computed with the heuristic algorithm
+     * of Char, Geddes and Gonnet, which reduces the problem to the GCD of polynomials in fewer variables by
+     * evaluation at large integer points. If the heuristic fails, the GCD is computed via primitive polynomial
+     * remainder sequences. The GCD of two zero polynomials is zero.
+     *
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return the GCD of \p a and \p b.
+     *
+     * @throws std::invalid_argument if any of the operands has negative exponents.
+     * @throws unspecified any exception thrown by:
+     * - divexact(),
+     * - polynomial arithmetics.
+     */
+    template <typename T = polynomial, div_enabler<T> = 0>
+    static polynomial gcd(const polynomial &a, const polynomial &b)
+    {
+        auto runner = [](const polynomial &x, const polynomial &y) {
+            auto check_expos = [](const polynomial &p) {
+                for (const auto &t : p._container()) {
+                    const auto tmp = t.m_key.unpack(p.get_symbol_set());
+                    if (unlikely(std::any_of(tmp.begin(), tmp.end(),
+                                             [](const typename Key::value_type &e) { return e < 0; }))) {
+                        piranha_throw(std::invalid_argument,
+                                      "cannot compute the GCD of polynomials with negative exponents");
+                    }
+                }
+            };
+            check_expos(x);
+            check_expos(y);
+            return detail::kpoly_gcd(x, y);
+        };
+        return series_merge_f(a, b, runner);
+    }
 
 private:
     // Static data for auto_truncate_degree.
@@ -915,17 +1571,6 @@ symbol_fset polynomial<Cf, Key>::s_at_degree_names;
 namespace detail
 {
 
-// Identification of key types for dispatching in the multiplier.
-template <typename T>
-struct is_kronecker_monomial {
-    static const bool value = false;
-};
-
-template <typename T>
-struct is_kronecker_monomial<kronecker_monomial<T>> {
-    static const bool value = true;
-};
-
 template <typename T>
 struct is_monomial {
     static const bool value = false;
@@ -1139,20 +1784,30 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
                 piranha_assert(this->m_n_threads > 1u);
                 return;
             }
-            mm_vec minmax_values;
-            // Tmp vector for unpacking, inited with the first element in the range.
             // NOTE: we need to check that the exponents of the monomials in the result do not
             // go outside the bounds of the Kronecker codification. We need to unpack all monomials
             // in the operands and examine them, we cannot operate on the codes for this.
-            auto tmp_vec = (*start)->m_key.unpack(this->m_ss);
-            // Init the mimnax.
-            std::transform(tmp_vec.begin(), tmp_vec.end(), std::back_inserter(minmax_values),
-                           [](const value_type &v) { return std::make_pair(v, v); });
-            ++start;
-            for (; start != end; ++start) {
-                tmp_vec = (*start)->m_key.unpack(this->m_ss);
-                std::transform(minmax_values.begin(), minmax_values.end(), tmp_vec.begin(), minmax_values.begin(),
-                               update_minmax{});
+            // The codes are gathered in blocks and decoded in one go via ka::decode_range(), which computes
+            // the decoding constants only once per block.
+            const auto m = static_cast<typename ka::size_type>(this->m_ss.size());
+            mm_vec minmax_values(static_cast<typename mm_vec::size_type>(m),
+                                 std::make_pair(std::numeric_limits<value_type>::max(),
+                                                std::numeric_limits<value_type>::min()));
+            const typename ka::size_type block_size_dec = 256u;
+            std::vector<value_type> codes, tmp_vec(static_cast<typename std::vector<value_type>::size_type>(
+                                                block_size_dec * m));
+            codes.reserve(static_cast<typename std::vector<value_type>::size_type>(block_size_dec));
+            while (start != end) {
+                codes.clear();
+                for (; start != end && codes.size() < block_size_dec; ++start) {
+                    codes.push_back((*start)->m_key.get_int());
+                }
+                ka::decode_range(tmp_vec.data(), codes.data(), codes.size(), m);
+                auto ptr = tmp_vec.data();
+                for (decltype(codes.size()) j = 0u; j < codes.size(); ++j, ptr += m) {
+                    std::transform(minmax_values.begin(), minmax_values.end(), ptr, minmax_values.begin(),
+                                   update_minmax{});
+                }
             }
             if (this->m_n_threads == 1u) {
                 piranha_assert(mmv->empty());
@@ -1191,6 +1846,13 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
                 piranha_throw(std::overflow_error, "Kronecker monomial components are out of bounds");
             }
         }
+        // Store the bounds of the operands, they will be used to establish if the dense
+        // multiplication can be used.
+        auto to_integer = [](const std::pair<value_type, value_type> &p) {
+            return std::make_pair(integer(p.first), integer(p.second));
+        };
+        std::transform(minmax_values1.begin(), minmax_values1.end(), std::back_inserter(m_kbounds1), to_integer);
+        std::transform(minmax_values2.begin(), minmax_values2.end(), std::back_inserter(m_kbounds2), to_integer);
     }
     // Implementation detail of the bound checking logic. This is common enough to be shared.
     template <typename MmVec, typename Func>
@@ -1294,6 +1956,7 @@ public:
         if (unlikely(this->m_v1.empty() || this->m_v2.empty() || this->m_ss.size() == 0u)) {
             return;
         }
+        profiler::scope prof("multiplication.bounds");
         check_bounds();
     }
     /// Perform multiplication.
@@ -1387,6 +2050,13 @@ public:
      * - a piranha::symbol_idx_fset referring to the positions of the variables of the first argument
      *   in the merged symbol set of the two operands.
      *
+     * If the key type is piranha::kronecker_monomial, the multiplication is performed with Kronecker codes:
+     * if the sum of the maximum degrees of the operands does not exceed \p max_degree, the untruncated
+     * multiplication algorithms are used, otherwise the terms of the second series are grouped by degree and
+     * each term of the first series is multiplied only by the groups within the truncation limit (as established
+     * by _get_skip_limits()). For other key types, base_series_multiplier::plain_multiplication() is used
+     * with the limits computed by _get_skip_limits().
+     *
      * @param max_degree the maximum degree of the result of the multiplication.
      * @param args either an empty argument, or a pair of arguments as described above.
      *
@@ -1397,55 +2067,19 @@ public:
      * - piranha::safe_cast(),
      * - arithmetic and other operations on the degree type,
      * - base_series_multiplier::plain_multiplication(),
+     * - base_series_multiplier::estimate_final_series_size(),
+     * - _untruncated_multiplication(),
      * - _get_skip_limits().
      */
     template <typename T, typename... Args>
     Series _truncated_multiplication(const T &max_degree, const Args &... args) const
     {
-        // NOTE: a possible optimisation here is the following: if the sum degrees of the arguments is less than
-        // or equal to the max truncation degree, just do the normal multiplication - which can also then take
-        // advantage of faster Kronecker multiplication, if the series are suitable.
         using term_type = typename Series::term_type;
         // NOTE: degree type is the same in total and partial.
         using degree_type = decltype(ps_get_degree(term_type{}, this->m_ss));
-        using size_type = typename base::size_type;
-        namespace sph = std::placeholders;
         static_assert(std::is_same<T, degree_type>::value, "Invalid degree type");
         static_assert(detail::has_get_auto_truncate_degree<Series>::value, "Invalid series type");
-        // First let's create two vectors with the degrees of the terms in the two series.
-        using d_size_type = typename std::vector<degree_type>::size_type;
-        std::vector<degree_type> v_d1(piranha::safe_cast<d_size_type>(this->m_v1.size())),
-            v_d2(piranha::safe_cast<d_size_type>(this->m_v2.size()));
-        detail::parallel_vector_transform(
-            this->m_n_threads, this->m_v1, v_d1,
-            std::bind(term_degree_getter{}, sph::_1, std::cref(this->m_ss), std::cref(args)...));
-        detail::parallel_vector_transform(
-            this->m_n_threads, this->m_v2, v_d2,
-            std::bind(term_degree_getter{}, sph::_1, std::cref(this->m_ss), std::cref(args)...));
-        // Next we need to order the terms in the second series, and also the corresponding degree vector.
-        // First we create a vector of indices and we fill it.
-        std::vector<size_type> idx_vector(
-            piranha::safe_cast<typename std::vector<size_type>::size_type>(this->m_v2.size()));
-        std::iota(idx_vector.begin(), idx_vector.end(), size_type(0u));
-        // Second, we sort the vector of indices according to the degrees in the second series.
-        std::stable_sort(idx_vector.begin(), idx_vector.end(), [&v_d2](const size_type &i1, const size_type &i2) {
-            return v_d2[static_cast<d_size_type>(i1)] < v_d2[static_cast<d_size_type>(i2)];
-        });
-        // Finally, we apply the permutation to v_d2 and m_v2.
-        decltype(this->m_v2) v2_copy(this->m_v2.size());
-        decltype(v_d2) v_d2_copy(v_d2.size());
-        std::transform(idx_vector.begin(), idx_vector.end(), v2_copy.begin(),
-                       [this](const size_type &i) { return this->m_v2[i]; });
-        std::transform(idx_vector.begin(), idx_vector.end(), v_d2_copy.begin(),
-                       [&v_d2](const size_type &i) { return v_d2[static_cast<d_size_type>(i)]; });
-        this->m_v2 = std::move(v2_copy);
-        v_d2 = std::move(v_d2_copy);
-        // Now get the skip limits and we build the limits functor.
-        const auto sl = _get_skip_limits(v_d1, v_d2, max_degree);
-        auto lf = [&sl](const size_type &idx1) {
-            return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
-        };
-        return this->plain_multiplication(lf);
+        return tm_impl(max_degree, args...);
     }
     /// Establish skip limits for truncated multiplication.
     /**
@@ -1529,6 +2163,258 @@ public:
         piranha_assert(retval_checker());
         return retval;
     }
+    /// Dense multiplication selection.
+    /**
+     * This method will return \p true if the untruncated multiplication of the operands would be performed
+     * with the dense Kronecker algorithm, given the estimate \p est of the number of terms in the result.
+     *
+     * The dense algorithm accumulates the term-by-term products into a flat array of coefficients, indexed by a
+     * codification of the monomials of the result which is built from the exponent bounds determined at construction
+     * time. The dense algorithm is selected if the key type is piranha::kronecker_monomial and the size of the flat array
+     * is not greater than \p est multiplied by tuning::get_dense_multiplication_ratio(). If a memory budget has been set
+     * via tuning::set_multiplication_memory_budget(), the memory occupied by the flat array must also fit in the budget.
+     *
+     * @param est the estimated number of terms in the result of the multiplication.
+     *
+     * @return \p true if the dense multiplication algorithm would be selected, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by arithmetic operations on piranha::integer.
+     */
+    bool _use_dense_multiplication(const typename base::bucket_size_type &est) const
+    {
+        const auto ratio = tuning::get_dense_multiplication_ratio();
+        // NOTE: the bounds are computed only for Kronecker monomials with nonzero
+        // number of variables and non-empty operands.
+        if (!ratio || m_kbounds1.empty()) {
+            return false;
+        }
+        piranha_assert(m_kbounds1.size() == m_kbounds2.size());
+        integer range(1);
+        for (decltype(m_kbounds1.size()) i = 0u; i < m_kbounds1.size(); ++i) {
+            range *= m_kbounds1[i].second - m_kbounds1[i].first + m_kbounds2[i].second - m_kbounds2[i].first + 1;
+        }
+        // Respect the memory budget, if set.
+        const auto budget = tuning::get_multiplication_memory_budget();
+        if (budget && range * sizeof(typename Series::term_type::cf_type) > budget) {
+            return false;
+        }
+        return range <= integer(est) * ratio && range <= std::numeric_limits<std::size_t>::max();
+    }
+    /// Heap multiplication selection.
+    /**
+     * This method will return \p true if the untruncated multiplication of the operands would be performed
+     * with the heap-based Kronecker algorithm, given the estimate \p est of the number of terms in the result.
+     *
+     * The heap-based algorithm produces the terms of the result in increasing monomial order by merging the
+     * term-by-term products through a binary heap, thus requiring an amount of working memory proportional
+     * to the size of the operands. The heap-based algorithm is selected if a memory budget has been set via
+     * tuning::set_multiplication_memory_budget(), and the memory estimated to be required by the hash table
+     * of the result exceeds such budget.
+     *
+     * @param est the estimated number of terms in the result of the multiplication.
+     *
+     * @return \p true if the heap-based multiplication algorithm would be selected, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by arithmetic operations on piranha::integer.
+     */
+    bool _use_heap_multiplication(const typename base::bucket_size_type &est) const
+    {
+        const auto budget = tuning::get_multiplication_memory_budget();
+        if (!budget) {
+            return false;
+        }
+        // NOTE: each bucket of the table stores a term and a pointer to the next node of the bucket.
+        return integer(est) * (sizeof(typename Series::term_type) + sizeof(void *)) > budget;
+    }
+    /// Load balance of the parallel sparse multiplication.
+    /**
+     * The multithreaded sparse Kronecker algorithm subdivides the table of the result into zones which are
+     * consumed by the threads in parallel. The zones are sized according to the number of term-by-term
+     * multiplications they contain, and the threads which run out of zones steal them from the other threads.
+     *
+     * This method returns the busy and idle times (in seconds) of each thread during the last multiplication performed
+     * by this multiplier with the multithreaded sparse Kronecker algorithm. The busy time of a thread is the time
+     * spent in consuming zones, the idle time is the difference between the duration of the multiplication
+     * and the busy time. If no such multiplication was performed, the returned vector is empty.
+     *
+     * @return a vector of (busy time, idle time) pairs, one per thread.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of \p std::vector.
+     */
+    std::vector<std::pair<double, double>> _get_load_balance() const
+    {
+        return m_load_balance;
+    }
+    /// Out-of-core multiplication.
+    /**
+     * \note
+     * This method can be used only if operator()() can be called and the key type is piranha::kronecker_monomial.
+     *
+     * This method computes the untruncated product of the operands in partitions, so that the result never needs
+     * to be held in memory as a whole. The Kronecker codes of the result are split into contiguous ranges, each
+     * containing approximately the same number of term-by-term multiplications. The ranges are processed in rounds
+     * of one range per thread: each thread locates, via binary search, the terms of the second operand which
+     * produce codes in its range, and accumulates the products into its own table. At the end of each round, the
+     * partitions of the result are passed in range order to \p sink, which is called with an rvalue reference to a
+     * \p Series. The partitions have the symbol set of the operands, and they contain no duplicate monomials.
+     *
+     * The number of partitions is chosen so that the memory estimated to be required by the tables of a round does
+     * not exceed \p budget bytes. If \p budget is zero, the value returned by
+     * tuning::get_multiplication_memory_budget() is used and, if this is also zero, the result is computed in
+     * a single round. The number of partitions never exceeds the number of term-by-term multiplications, nor the
+     * number of Kronecker codes in the range of the result, so that the last round might contain fewer than
+     * one partition per thread.
+     *
+     * @param sink the functor that will be called with each partition of the result.
+     * @param budget the memory budget, in bytes.
+     *
+     * @throws unspecified any exception thrown by:
+     * - \p sink,
+     * - piranha::base_series_multiplier::estimate_final_series_size(),
+     * - piranha::base_series_multiplier::sanitise_series(),
+     * - piranha::base_series_multiplier::finalise_series(),
+     * - the public interface of piranha::hash_set,
+     * - thread_pool::parallel_for(),
+     * - piranha::safe_cast() and <tt>boost::numeric_cast()</tt>,
+     * - memory errors in standard containers,
+     * - arithmetic operations on the coefficients and on piranha::integer.
+     */
+    template <typename Sink, typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    void _out_of_core_multiplication(Sink &&sink, unsigned long long budget = 0u) const
+    {
+        profiler::scope prof("multiplication.out_of_core");
+        using bucket_size_type = typename base::bucket_size_type;
+        using term_type = typename Series::term_type;
+        using int_type = typename term_type::key_type::value_type;
+        using c_vector = std::vector<int_type>;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size(), size2 = v2.size();
+        if (unlikely(!size1 || !size2)) {
+            return;
+        }
+        const unsigned n_threads = this->m_n_threads;
+        if (!budget) {
+            budget = tuning::get_multiplication_memory_budget();
+        }
+        // Estimate the size of the result, and derive from it the number of partitions. Each round
+        // computes n_threads partitions at the same time.
+        const auto est
+            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
+        integer n_rounds(1);
+        if (budget) {
+            // NOTE: each bucket of the table stores a term and a pointer to the next node of the bucket.
+            const integer mem = integer(est) * (sizeof(term_type) + sizeof(void *));
+            n_rounds = std::max(integer(1), (mem + budget - 1) / budget);
+        }
+        // Sort the operands according to their codes.
+        auto code_cmp
+            = [](term_type const *p1, term_type const *p2) { return p1->m_key.get_int() < p2->m_key.get_int(); };
+        std::sort(v1.begin(), v1.end(), code_cmp);
+        std::sort(v2.begin(), v2.end(), code_cmp);
+        c_vector c1(piranha::safe_cast<typename c_vector::size_type>(size1)),
+            c2(piranha::safe_cast<typename c_vector::size_type>(size2));
+        auto get_code = [](term_type const *p) { return p->m_key.get_int(); };
+        std::transform(v1.begin(), v1.end(), c1.begin(), get_code);
+        std::transform(v2.begin(), v2.end(), c2.begin(), get_code);
+        // Lower bound in code space: the first index in c2 such that the code of the product of
+        // the i-th term of the first operand by the term of the second operand is not less than (if strict
+        // is true) or greater than (if strict is false) x.
+        // NOTE: the sums of codes never overflow, as they are codes of the result (see check_bounds()).
+        auto l_bound = [&c1, &c2](typename c_vector::size_type i, int_type x, bool strict) {
+            const auto c = c1[i];
+            return static_cast<typename c_vector::size_type>(
+                std::partition_point(c2.begin(), c2.end(),
+                                     [c, x, strict](const int_type &n) {
+                                         const auto code = static_cast<int_type>(c + n);
+                                         return strict ? code < x : code <= x;
+                                     })
+                - c2.begin());
+        };
+        const auto lo = static_cast<int_type>(c1.front() + c2.front()),
+                   hi = static_cast<int_type>(c1.back() + c2.back());
+        const integer tot = integer(size1) * size2;
+        // NOTE: there cannot be more non-empty partitions than codes in the range of the result or than
+        // term-by-term multiplications, so cap the number of partitions accordingly. This also ensures
+        // that a huge estimate does not produce a number of partitions which does not fit in std::size_t.
+        const auto n_parts = static_cast<std::size_t>(
+            std::min(std::min(n_rounds * n_threads, integer(hi) - lo + 1), tot));
+        prof.count("partitions", n_parts);
+        std::vector<int_type> ubs;
+        std::vector<integer> counts;
+        product_count_bounds(c1, c2, n_parts, n_threads, ubs, counts);
+        // Compute the partition of index k.
+        auto compute_part = [this, &v1, &v2, &c1, &c2, &ubs, &counts, &l_bound, size1, lo, est,
+                             &tot](std::size_t k, Series &part) {
+            part.set_symbol_set(this->m_ss);
+            if (k && ubs[k] == ubs[k - 1u]) {
+                // Empty range.
+                return;
+            }
+            const auto a = k ? static_cast<int_type>(ubs[k - 1u] + 1) : lo, b = ubs[k];
+            auto &container = part._container();
+            // The expected number of terms is proportional to the number of products in the partition.
+            const integer n_prods = counts[k] - (k ? counts[k - 1u] : integer(0));
+            const double p_est
+                = static_cast<double>(est) * static_cast<double>(n_prods) / static_cast<double>(tot);
+            container.rehash(boost::numeric_cast<bucket_size_type>(
+                std::ceil(std::max(p_est, 1.) / container.max_load_factor())));
+            bucket_size_type count = 0u;
+            term_type tmp_term;
+            try {
+                for (typename c_vector::size_type i = 0u; i < size1; ++i) {
+                    const auto &t1 = *v1[i];
+                    const auto j_end = l_bound(i, b, false);
+                    for (auto j = l_bound(i, a, true); j < j_end; ++j) {
+                        const auto &t2 = *v2[j];
+                        tmp_term.m_key.set_int(static_cast<int_type>(c1[i] + c2[j]));
+                        auto bucket_idx = container._bucket(tmp_term);
+                        const auto it = container._find(tmp_term, bucket_idx);
+                        if (it == container.end()) {
+                            if (unlikely(count == std::numeric_limits<bucket_size_type>::max())) {
+                                piranha_throw(std::overflow_error, "overflow error in the number of terms of a series");
+                            }
+                            if (unlikely(static_cast<double>(count + 1u) / static_cast<double>(container.bucket_count())
+                                         > container.max_load_factor())) {
+                                container._update_size(count);
+                                container._increase_size();
+                                bucket_idx = container._bucket(tmp_term);
+                            }
+                            cf_mult_impl(tmp_term.m_cf, t1.m_cf, t2.m_cf);
+                            container._unique_insert(tmp_term, bucket_idx);
+                            count = static_cast<bucket_size_type>(count + 1u);
+                        } else {
+                            this->fma_wrap(it->m_cf, t1.m_cf, t2.m_cf);
+                        }
+                    }
+                }
+                this->sanitise_series(part, 1u);
+            } catch (...) {
+                container.clear();
+                throw;
+            }
+        };
+        // Process the partitions in rounds. The last round might contain fewer than n_threads partitions.
+        std::vector<Series> parts(n_threads);
+        for (std::size_t r = 0u; r < n_parts; r += n_threads) {
+            const auto n_cur = std::min<std::size_t>(n_threads, n_parts - r);
+            thread_pool::parallel_for(n_threads, n_cur, 1u,
+                                      [&parts, &compute_part, r](const unsigned &, const std::size_t &begin,
+                                                                 const std::size_t &end) {
+                                          for (auto k = begin; k != end; ++k) {
+                                              parts[k] = Series{};
+                                              compute_part(r + k, parts[k]);
+                                          }
+                                      });
+            for (std::size_t k = 0u; k < n_cur; ++k) {
+                this->finalise_series(parts[k]);
+                sink(std::move(parts[k]));
+                parts[k] = Series{};
+            }
+        }
+    }
     //@}
 private:
     // NOTE: wrapper to multadd that treats specially rational coefficients. We need to decide in the future
@@ -1591,6 +2477,150 @@ private:
             return ps_get_degree(*p, args..., ss);
         }
     };
+    // Setup for truncated multiplication: compute the degrees of the terms of the operands into v_d1 and v_d2,
+    // sort the terms of the second series (and v_d2) by degree and return the skip limits.
+    template <typename T, typename... Args>
+    std::vector<typename base::size_type> truncation_setup(std::vector<T> &v_d1, std::vector<T> &v_d2,
+                                                           const T &max_degree, const Args &... args) const
+    {
+        using size_type = typename base::size_type;
+        using d_size_type = typename std::vector<T>::size_type;
+        namespace sph = std::placeholders;
+        // First let's fill the two vectors with the degrees of the terms in the two series.
+        v_d1.resize(piranha::safe_cast<d_size_type>(this->m_v1.size()));
+        v_d2.resize(piranha::safe_cast<d_size_type>(this->m_v2.size()));
+        detail::parallel_vector_transform(
+            this->m_n_threads, this->m_v1, v_d1,
+            std::bind(term_degree_getter{}, sph::_1, std::cref(this->m_ss), std::cref(args)...));
+        detail::parallel_vector_transform(
+            this->m_n_threads, this->m_v2, v_d2,
+            std::bind(term_degree_getter{}, sph::_1, std::cref(this->m_ss), std::cref(args)...));
+        // Next we need to order the terms in the second series, and also the corresponding degree vector.
+        // First we create a vector of indices and we fill it.
+        std::vector<size_type> idx_vector(
+            piranha::safe_cast<typename std::vector<size_type>::size_type>(this->m_v2.size()));
+        std::iota(idx_vector.begin(), idx_vector.end(), size_type(0u));
+        // Second, we sort the vector of indices according to the degrees in the second series.
+        std::stable_sort(idx_vector.begin(), idx_vector.end(), [&v_d2](const size_type &i1, const size_type &i2) {
+            return v_d2[static_cast<d_size_type>(i1)] < v_d2[static_cast<d_size_type>(i2)];
+        });
+        // Finally, we apply the permutation to v_d2 and m_v2.
+        decltype(this->m_v2) v2_copy(this->m_v2.size());
+        std::vector<T> v_d2_copy(v_d2.size());
+        std::transform(idx_vector.begin(), idx_vector.end(), v2_copy.begin(),
+                       [this](const size_type &i) { return this->m_v2[i]; });
+        std::transform(idx_vector.begin(), idx_vector.end(), v_d2_copy.begin(),
+                       [&v_d2](const size_type &i) { return v_d2[static_cast<d_size_type>(i)]; });
+        this->m_v2 = std::move(v2_copy);
+        v_d2 = std::move(v_d2_copy);
+        // Now get the skip limits.
+        return _get_skip_limits(v_d1, v_d2, max_degree);
+    }
+    // Dispatch of truncated multiplication.
+    // Case 1: not a Kronecker monomial, do the plain multiplication with the skip limits.
+    template <typename T, typename... Args, typename U = Series,
+              typename std::enable_if<!detail::is_kronecker_monomial<typename U::term_type::key_type>::value,
+                                      int>::type
+              = 0>
+    Series tm_impl(const T &max_degree, const Args &... args) const
+    {
+        using size_type = typename base::size_type;
+        std::vector<T> v_d1, v_d2;
+        const auto sl = truncation_setup(v_d1, v_d2, max_degree, args...);
+        auto lf = [&sl](const size_type &idx1) {
+            return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
+        };
+        return this->plain_multiplication(lf);
+    }
+    // Case 2: Kronecker monomial.
+    template <typename T, typename... Args, typename U = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename U::term_type::key_type>::value,
+                                      int>::type
+              = 0>
+    Series tm_impl(const T &max_degree, const Args &... args) const
+    {
+        using size_type = typename base::size_type;
+        using sl_size_type = typename std::vector<size_type>::size_type;
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (unlikely(!size1 || !size2)) {
+            return retval;
+        }
+        std::vector<T> v_d1, v_d2;
+        auto sl = truncation_setup(v_d1, v_d2, max_degree, args...);
+        // If no term-by-term multiplication can exceed the truncation limit, the truncation is a no-op
+        // and we can run the untruncated Kronecker multiplication.
+        if (!(v_d2.back() > degree_sub(max_degree, *std::max_element(v_d1.begin(), v_d1.end())))) {
+            return untruncated_kronecker_mult();
+        }
+        auto lf = [&sl](const size_type &idx1) { return sl[static_cast<sl_size_type>(idx1)]; };
+        // Count the term-by-term multiplications which will actually be performed. As in the untruncated
+        // case, if there are few of them and we are in single-threaded mode, the plain multiplication
+        // (which does not need the estimation of the size of the result) is used.
+        const auto n_products = std::accumulate(sl.begin(), sl.end(), integer(0));
+        if (n_products.is_zero()) {
+            return retval;
+        }
+        const auto e_thr = tuning::get_estimate_threshold();
+        if (n_products < integer(e_thr) * e_thr && this->m_n_threads == 1u) {
+            return this->plain_multiplication(lf);
+        }
+        const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? this->m_n_threads : 1u;
+        const auto est
+            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>(lf);
+        retval._container().rehash(boost::numeric_cast<typename Series::size_type>(
+                                       std::ceil(static_cast<double>(est) / retval._container().max_load_factor())),
+                                   n_threads_rehash);
+        piranha_assert(retval._container().bucket_count());
+        // Sort the terms of the first series according to their bucket positions in retval, permuting
+        // the skip limits accordingly, and the terms of the second series according to their bucket positions
+        // within each group of terms with the same degree.
+        std::vector<size_type> ranges;
+        {
+            profiler::scope prof("multiplication.sort");
+            auto &container = retval._container();
+            auto r_bucket = [&container](const typename Series::term_type *p) {
+                return container._bucket_from_hash(p->hash());
+            };
+            std::vector<size_type> idx_vector(piranha::safe_cast<sl_size_type>(size1));
+            std::iota(idx_vector.begin(), idx_vector.end(), size_type(0u));
+            std::stable_sort(idx_vector.begin(), idx_vector.end(), [this, &r_bucket](const size_type &i1,
+                                                                                     const size_type &i2) {
+                return r_bucket(this->m_v1[i1]) < r_bucket(this->m_v1[i2]);
+            });
+            decltype(this->m_v1) v1_copy(size1);
+            std::vector<size_type> sl_copy(sl.size());
+            std::transform(idx_vector.begin(), idx_vector.end(), v1_copy.begin(),
+                           [this](const size_type &i) { return this->m_v1[i]; });
+            std::transform(idx_vector.begin(), idx_vector.end(), sl_copy.begin(),
+                           [&sl](const size_type &i) { return sl[static_cast<sl_size_type>(i)]; });
+            this->m_v1 = std::move(v1_copy);
+            sl = std::move(sl_copy);
+            // The boundaries of the groups of terms with the same degree in the second series. The skip
+            // limits always coincide with one of these boundaries.
+            ranges.push_back(0u);
+            for (size_type i = 1u; i < size2; ++i) {
+                if (v_d2[static_cast<typename std::vector<T>::size_type>(i - 1u)]
+                    < v_d2[static_cast<typename std::vector<T>::size_type>(i)]) {
+                    ranges.push_back(i);
+                }
+            }
+            ranges.push_back(static_cast<size_type>(size2));
+            for (decltype(ranges.size()) k = 1u; k < ranges.size(); ++k) {
+                std::stable_sort(this->m_v2.data() + ranges[k - 1u], this->m_v2.data() + ranges[k],
+                                 [&r_bucket](const typename Series::term_type *p1,
+                                             const typename Series::term_type *p2) {
+                                     return r_bucket(p1) < r_bucket(p2);
+                                 });
+            }
+        }
+        piranha_assert(std::all_of(sl.begin(), sl.end(), [&ranges](const size_type &l) {
+            return std::binary_search(ranges.begin(), ranges.end(), l);
+        }));
+        sparse_kronecker_multiplication_impl(retval, ranges, lf);
+        return retval;
+    }
     // execute() is the top level dispatch for the actual multiplication.
     // Case 1: not a Kronecker monomial, do the plain mult.
     template <typename T = Series,
@@ -1615,7 +2645,7 @@ private:
         return false;
     }
     // Case 2: Kronecker mult, do the special multiplication unless a truncation is active. In that case, run the
-    // plain mult.
+    // truncated multiplication via the wrapper.
     template <typename T = Series,
               typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
               = 0>
@@ -1640,13 +2670,6 @@ private:
         if (integer(size1) * size2 < integer(e_thr) * e_thr && this->m_n_threads == 1u) {
             estimate = false;
         }
-        // If estimation is not worth it, we go with the plain multiplication.
-        // NOTE: this is probably not optimal, but we have to do like this as the sparse
-        // Kronecker multiplication below requires estimation. Maybe in the future we can
-        // have a version without estimation.
-        if (!estimate) {
-            return this->plain_multiplication();
-        }
         // Setup the return value.
         Series retval;
         retval.set_symbol_set(this->m_ss);
@@ -1654,6 +2677,12 @@ private:
         if (unlikely(!size1 || !size2)) {
             return retval;
         }
+        // If estimation is not worth it, we go with the Kronecker multiplication
+        // that grows the output table incrementally.
+        if (!estimate) {
+            incremental_kronecker_multiplication(retval);
+            return retval;
+        }
         // Rehash the retun value's container accordingly. Check the tuning flag to see if we want to use
         // multiple threads for initing the return value.
         // NOTE: it is important here that we use the same n_threads for multiplication and memset as
@@ -1662,6 +2691,16 @@ private:
         // Use the plain functor in normal mode for the estimation.
         const auto est
             = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
+        // Check if the result is dense enough to use the flat array accumulator.
+        if (_use_dense_multiplication(est)) {
+            dense_kronecker_multiplication(retval);
+            return retval;
+        }
+        // If the table of the result would not fit in the memory budget, use the heap-based algorithm.
+        if (_use_heap_multiplication(est)) {
+            heap_kronecker_multiplication(retval, est);
+            return retval;
+        }
         // NOTE: if something goes wrong here, no big deal as retval is still empty.
         retval._container().rehash(boost::numeric_cast<typename Series::size_type>(
                                        std::ceil(static_cast<double>(est) / retval._container().max_load_factor())),
@@ -1670,11 +2709,537 @@ private:
         sparse_kronecker_multiplication(retval);
         return retval;
     }
+    // Single-threaded Kronecker multiplication which does not require the estimation of the size of the result.
+    // The output table is initially sized according to the largest operand and it is then grown as needed
+    // during the multiplication, as the normal insertion routine of hash_set does. Compared to the plain
+    // multiplication, we avoid the key multiplication and the insertion checks of series::insert(), and we
+    // can use multiply-accumulate on the coefficients.
+    void incremental_kronecker_multiplication(Series &retval) const
+    {
+        profiler::scope prof("multiplication.incremental");
+        using bucket_size_type = typename base::bucket_size_type;
+        using size_type = typename base::size_type;
+        using term_type = typename Series::term_type;
+        piranha_assert(this->m_n_threads == 1u);
+        const auto &v1 = this->m_v1;
+        const auto &v2 = this->m_v2;
+        const size_type size1 = v1.size(), size2 = v2.size();
+        piranha_assert(size1 && size2);
+        auto &container = retval._container();
+        // NOTE: the result of a multiplication has at least as many terms as the largest operand (barring
+        // cancellations), so this is a safe lower bound for the initial size of the table.
+        container.rehash(boost::numeric_cast<bucket_size_type>(
+            std::ceil(static_cast<double>(std::max(size1, size2)) / container.max_load_factor())));
+        piranha_assert(container.bucket_count());
+        // The number of terms inserted so far.
+        bucket_size_type count = 0u;
+        // Temporary term used to compute the term-by-term products.
+        term_type tmp_term;
+        // NOTE: these will have to be adapted for kd_monomial.
+        using int_type = decltype(tmp_term.m_key.get_int());
+        auto mf = [&v1, &v2, &container, &count, &tmp_term, this](const size_type &i, const size_type &j) {
+            const auto &t1 = *v1[i];
+            const auto &t2 = *v2[j];
+            tmp_term.m_key.set_int(static_cast<int_type>(t1.m_key.get_int() + t2.m_key.get_int()));
+            auto bucket_idx = container._bucket(tmp_term);
+            const auto it = container._find(tmp_term, bucket_idx);
+            if (it == container.end()) {
+                if (unlikely(count == std::numeric_limits<bucket_size_type>::max())) {
+                    piranha_throw(std::overflow_error, "overflow error in the number of terms of a series");
+                }
+                // Grow the table if we would exceed the max load factor. The size of the container must be
+                // up to date before rehashing, as rehash() refuses to shrink below the current load factor.
+                if (unlikely(static_cast<double>(count + 1u) / static_cast<double>(container.bucket_count())
+                             > container.max_load_factor())) {
+                    container._update_size(count);
+                    container._increase_size();
+                    bucket_idx = container._bucket(tmp_term);
+                }
+                cf_mult_impl(tmp_term.m_cf, t1.m_cf, t2.m_cf);
+                container._unique_insert(tmp_term, bucket_idx);
+                count = static_cast<bucket_size_type>(count + 1u);
+            } else {
+                this->fma_wrap(it->m_cf, t1.m_cf, t2.m_cf);
+            }
+        };
+        try {
+            this->blocked_multiplication(mf, 0u, size1);
+            this->sanitise_series(retval, 1u);
+            this->finalise_series(retval);
+        } catch (...) {
+            retval._container().clear();
+            throw;
+        }
+    }
+    // Dense Kronecker multiplication. The monomials of the result are mapped to a dense codification
+    // in which each variable is assigned a radix equal to the width of its exponent range in the result, as
+    // computed by check_bounds(). The term-by-term products are accumulated in a flat array of coefficients indexed
+    // by the dense code, which is then compacted back into retval. In multithreaded mode each thread owns a contiguous
+    // range of dense codes, so no synchronisation is needed during the accumulation.
+    void dense_kronecker_multiplication(Series &retval) const
+    {
+        profiler::scope prof("multiplication.dense");
+        using bucket_size_type = typename base::bucket_size_type;
+        using size_type = typename base::size_type;
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using value_type = typename term_type::key_type::value_type;
+        using ka = kronecker_array<value_type>;
+        using code_type = std::size_t;
+        using c_vector = std::vector<code_type>;
+        using c_size_type = typename c_vector::size_type;
+        const auto &v1 = this->m_v1;
+        const auto &v2 = this->m_v2;
+        const size_type size1 = v1.size(), size2 = v2.size();
+        const unsigned n_threads = this->m_n_threads;
+        const auto n_vars = static_cast<c_size_type>(m_kbounds1.size());
+        piranha_assert(size1 && size2 && n_vars == this->m_ss.size() && n_vars == m_kbounds2.size());
+        // Offsets for the two operands, radices and strides of the dense codification.
+        std::vector<value_type> lo1(n_vars), lo2(n_vars);
+        c_vector radices(n_vars), strides(n_vars);
+        code_type range = 1u;
+        for (c_size_type i = 0u; i < n_vars; ++i) {
+            lo1[i] = static_cast<value_type>(m_kbounds1[i].first);
+            lo2[i] = static_cast<value_type>(m_kbounds2[i].first);
+            radices[i] = static_cast<code_type>(m_kbounds1[i].second - m_kbounds1[i].first + m_kbounds2[i].second
+                                                - m_kbounds2[i].first + 1);
+            strides[i] = range;
+            range = static_cast<code_type>(integer(range) * radices[i]);
+        }
+        // Compute the dense codes of the operands. The dense code of a product is the sum of the dense codes
+        // of the factors, as no component can overflow its radix.
+        auto dense_code = [this, n_vars, &strides](const term_type *t, const std::vector<value_type> &lo) {
+            const auto tmp = t->m_key.unpack(this->m_ss);
+            code_type retval = 0u;
+            for (c_size_type i = 0u; i < n_vars; ++i) {
+                const auto c = static_cast<code_type>(tmp[static_cast<decltype(tmp.size())>(i)] - lo[i]);
+                retval = static_cast<code_type>(retval + c * strides[i]);
+            }
+            return retval;
+        };
+        c_vector dc1(piranha::safe_cast<c_size_type>(size1)), dc2(piranha::safe_cast<c_size_type>(size2));
+        detail::parallel_vector_transform(n_threads, v1, dc1,
+                                          [&dense_code, &lo1](const term_type *t) { return dense_code(t, lo1); });
+        detail::parallel_vector_transform(n_threads, v2, dc2,
+                                          [&dense_code, &lo2](const term_type *t) { return dense_code(t, lo2); });
+        // Sort the second operand according to the dense codes, so that each thread can locate via binary search
+        // the terms whose products fall into its range of codes.
+        std::vector<size_type> idx2(piranha::safe_cast<typename std::vector<size_type>::size_type>(size2));
+        std::iota(idx2.begin(), idx2.end(), size_type(0u));
+        std::sort(idx2.begin(), idx2.end(), [&dc2](const size_type &a, const size_type &b) {
+            return dc2[static_cast<c_size_type>(a)] < dc2[static_cast<c_size_type>(b)];
+        });
+        c_vector sdc2(dc2.size());
+        std::transform(idx2.begin(), idx2.end(), sdc2.begin(),
+                       [&dc2](const size_type &i) { return dc2[static_cast<c_size_type>(i)]; });
+        // The flat array of coefficients. It is initialised with the same threads that will be writing into it.
+        auto arr = make_parallel_array<cf_type>(range, tuning::get_parallel_memory_set() ? n_threads : 1u);
+        // Accumulate into the [a,b[ range of dense codes.
+        auto mult_func = [&arr, &v1, &v2, &dc1, &sdc2, &idx2, size1, this](const code_type &a, const code_type &b) {
+            for (size_type i = 0u; i < size1; ++i) {
+                const auto c1 = dc1[static_cast<c_size_type>(i)];
+                if (c1 >= b) {
+                    continue;
+                }
+                // Range of codes in the second operand producing codes in [a,b[.
+                const code_type l = a > c1 ? static_cast<code_type>(a - c1) : code_type(0u),
+                                u = static_cast<code_type>(b - c1);
+                const auto it_b = std::lower_bound(sdc2.begin(), sdc2.end(), l),
+                           it_e = std::lower_bound(it_b, sdc2.end(), u);
+                const auto &cf1 = v1[i]->m_cf;
+                for (auto it = it_b; it != it_e; ++it) {
+                    this->fma_wrap(arr[static_cast<code_type>(c1 + *it)], cf1,
+                                   v2[idx2[static_cast<c_size_type>(it - sdc2.begin())]]->m_cf);
+                }
+            }
+        };
+        // Compact the [a,b[ range of dense codes into a vector of terms.
+        auto compact_func = [&arr, &lo1, &lo2, &radices, n_vars](const code_type &a, const code_type &b,
+                                                                  std::vector<term_type> &out) {
+            std::vector<value_type> tmp(n_vars);
+            for (code_type k = a; k != b; ++k) {
+                if (piranha::is_zero(arr[k])) {
+                    continue;
+                }
+                // Decode the dense code into the exponents of the result.
+                code_type rem = k;
+                for (c_size_type i = 0u; i < n_vars; ++i) {
+                    tmp[i] = static_cast<value_type>(lo1[i] + lo2[i] + static_cast<value_type>(rem % radices[i]));
+                    rem = static_cast<code_type>(rem / radices[i]);
+                }
+                out.emplace_back();
+                out.back().m_key.set_int(ka::encode(tmp));
+                out.back().m_cf = std::move(arr[k]);
+            }
+        };
+        using tv_type = std::vector<std::vector<term_type>>;
+        tv_type terms(piranha::safe_cast<typename tv_type::size_type>(n_threads));
+        auto &container = retval._container();
+        try {
+            if (n_threads == 1u) {
+                mult_func(0u, range);
+                compact_func(0u, range, terms[0u]);
+            } else {
+                // Codes per thread.
+                const auto cpt = static_cast<code_type>(range / n_threads);
+                auto thread_func = [cpt, range, n_threads, &mult_func, &compact_func, &terms](const unsigned &t_idx) {
+                    const auto a = static_cast<code_type>(cpt * t_idx),
+                               b = (t_idx == n_threads - 1u) ? range : static_cast<code_type>(cpt * (t_idx + 1u));
+                    mult_func(a, b);
+                    compact_func(a, b, terms[static_cast<typename tv_type::size_type>(t_idx)]);
+                };
+                future_list<decltype(thread_func(0u))> ff_list;
+                try {
+                    for (unsigned i = 0u; i < n_threads; ++i) {
+                        ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
+                    }
+                    // First let's wait for everything to finish.
+                    ff_list.wait_all();
+                    // Then, let's handle the exceptions.
+                    ff_list.get_all();
+                } catch (...) {
+                    ff_list.wait_all();
+                    throw;
+                }
+            }
+            // Release the flat array before inserting the terms into retval.
+            arr.reset();
+            integer count(0);
+            for (const auto &v : terms) {
+                count += v.size();
+            }
+            const auto n_terms = static_cast<bucket_size_type>(count);
+            if (n_terms) {
+                container.rehash(boost::numeric_cast<bucket_size_type>(
+                                     std::ceil(static_cast<double>(n_terms) / container.max_load_factor())),
+                                 tuning::get_parallel_memory_set() ? n_threads : 1u);
+            }
+            // NOTE: the dense codes are unique, hence there is no need to look for existing terms. The insertion
+            // is done serially, as it is cheap with respect to the accumulation.
+            for (auto &v : terms) {
+                for (auto &t : v) {
+                    const auto b_idx = container._bucket(t);
+                    container._unique_insert(std::move(t), b_idx);
+                }
+            }
+            container._update_size(n_terms);
+            this->finalise_series(retval);
+        } catch (...) {
+            retval._container().clear();
+            throw;
+        }
+    }
+    // Split the codes of the term-by-term products of two operands, whose sorted codes are c1 and c2, into n_parts
+    // contiguous ranges containing approximately the same number of products. On output, ubs contains the upper
+    // bounds (inclusive) of the ranges, so that the k-th bound is the smallest code x such that the number of
+    // products with codes not greater than x reaches k + 1 parts of the total, and counts contains the number
+    // of products with codes not greater than each bound. The bounds are independent of each other and they are
+    // located in parallel via bisection.
+    template <typename Int>
+    static void product_count_bounds(const std::vector<Int> &c1, const std::vector<Int> &c2, std::size_t n_parts,
+                                     unsigned n_threads, std::vector<Int> &ubs, std::vector<integer> &counts)
+    {
+        using int_type = Int;
+        using u_type = typename std::make_unsigned<int_type>::type;
+        piranha_assert(c1.size() && c2.size() && n_parts);
+        // Number of term-by-term multiplications producing codes not greater than x.
+        // NOTE: the sums of codes never overflow, as they are codes of the result (see check_bounds()).
+        auto n_products = [&c1, &c2](int_type x) {
+            integer retval(0);
+            for (const auto &c : c1) {
+                retval += std::partition_point(c2.begin(), c2.end(),
+                                               [c, x](const int_type &n) { return static_cast<int_type>(c + n) <= x; })
+                          - c2.begin();
+            }
+            return retval;
+        };
+        const auto lo = static_cast<int_type>(c1.front() + c2.front()),
+                   hi = static_cast<int_type>(c1.back() + c2.back());
+        const integer tot = integer(c1.size()) * c2.size();
+        ubs.assign(n_parts, hi);
+        counts.assign(n_parts, tot);
+        if (n_parts > 1u) {
+            thread_pool::parallel_for(
+                n_threads, n_parts - 1u, 1u,
+                [&ubs, &counts, &n_products, &tot, n_parts, lo, hi](const unsigned &, const std::size_t &begin,
+                                                                   const std::size_t &end) {
+                    for (auto k = begin; k != end; ++k) {
+                        const integer target = tot * (k + 1u) / n_parts;
+                        int_type a = lo, b = hi;
+                        while (a < b) {
+                            // NOTE: compute the midpoint in unsigned arithmetic, as b - a might overflow.
+                            const auto mid = static_cast<int_type>(
+                                a + static_cast<int_type>(
+                                        static_cast<u_type>(static_cast<u_type>(b) - static_cast<u_type>(a)) / 2u));
+                            if (n_products(mid) >= target) {
+                                b = mid;
+                            } else {
+                                a = static_cast<int_type>(mid + 1);
+                            }
+                        }
+                        ubs[k] = a;
+                        counts[k] = n_products(a);
+                    }
+                });
+        }
+    }
+    // Merge via a binary heap the term-by-term products whose codes fall in the closed range [a,b], passing
+    // the terms of the result to sink() in increasing code order. c1 and c2 are the sorted codes of the first and
+    // second operand, respectively. The heap contains at most one entry per term of the second operand.
+    template <typename Int, typename Sink>
+    void heap_merge(const std::vector<Int> &c1, const std::vector<Int> &c2, const Int &a, const Int &b,
+                    Sink &sink) const
+    {
+        using int_type = Int;
+        using c_size_type = typename std::vector<int_type>::size_type;
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        // Heap entry: the code of the product, the index of the term in the second operand
+        // and the index of the term in the first operand.
+        struct heap_entry {
+            int_type m_code;
+            c_size_type m_i;
+            c_size_type m_j;
+        };
+        auto cmp = [](const heap_entry &e1, const heap_entry &e2) { return e1.m_code > e2.m_code; };
+        std::vector<heap_entry> heap;
+        heap.reserve(c2.size());
+        // One past the last index in the first operand for each term of the second operand.
+        std::vector<c_size_type> ends(c2.size());
+        for (c_size_type i = 0u; i < c2.size(); ++i) {
+            const auto r = c2[i];
+            // NOTE: the sums of the codes are always valid codes, as checked in check_bounds().
+            const auto it_b = std::lower_bound(c1.begin(), c1.end(), a, [r](const int_type &c, const int_type &x) {
+                return static_cast<int_type>(r + c) < x;
+            });
+            const auto it_e = std::upper_bound(it_b, c1.end(), b, [r](const int_type &x, const int_type &c) {
+                return x < static_cast<int_type>(r + c);
+            });
+            if (it_b != it_e) {
+                heap.push_back(heap_entry{static_cast<int_type>(r + *it_b), i,
+                                          static_cast<c_size_type>(it_b - c1.begin())});
+                ends[i] = static_cast<c_size_type>(it_e - c1.begin());
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), cmp);
+        // The term being accumulated.
+        term_type cur;
+        bool active = false;
+        const auto &v1 = this->m_v1;
+        const auto &v2 = this->m_v2;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            auto &e = heap.back();
+            const auto &cf1 = v1[static_cast<typename base::size_type>(e.m_j)]->m_cf;
+            const auto &cf2 = v2[static_cast<typename base::size_type>(e.m_i)]->m_cf;
+            if (active && e.m_code == cur.m_key.get_int()) {
+                fma_wrap(cur.m_cf, cf1, cf2);
+            } else {
+                if (active && !piranha::is_zero(cur.m_cf)) {
+                    sink(cur);
+                    // NOTE: the sink moves out the coefficient, reset it to a known state.
+                    cur.m_cf = cf_type{};
+                }
+                cur.m_key.set_int(e.m_code);
+                cf_mult_impl(cur.m_cf, cf1, cf2);
+                active = true;
+            }
+            // Move to the next term of the first operand, if any.
+            if (++e.m_j != ends[e.m_i]) {
+                e.m_code = static_cast<int_type>(c2[e.m_i] + c1[e.m_j]);
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            } else {
+                heap.pop_back();
+            }
+        }
+        if (active && !piranha::is_zero(cur.m_cf)) {
+            sink(cur);
+        }
+    }
+    // Heap-based Kronecker multiplication (Johnson's algorithm). The operands are sorted according to their codes,
+    // and the term-by-term products are generated in increasing code order by heap_merge(). Equal monomials
+    // are thus produced consecutively and accumulated in a single coefficient, so that the working memory is
+    // proportional to the size of the operands rather than to the (estimated) size of the result. In multithreaded
+    // mode the range of codes of the result is split into parts containing approximately the same number of
+    // products, which are processed in rounds of one part per thread: the threads merge their parts into local
+    // buffers, which are then inserted concurrently into the table of the result (presized according to the
+    // estimate est), each thread taking care of a contiguous zone of buckets. The buffers thus hold only the
+    // terms of one round at a time.
+    void heap_kronecker_multiplication(Series &retval, const typename base::bucket_size_type &est) const
+    {
+        profiler::scope prof("multiplication.heap");
+        using bucket_size_type = typename base::bucket_size_type;
+        using term_type = typename Series::term_type;
+        using int_type = typename term_type::key_type::value_type;
+        using c_vector = std::vector<int_type>;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const unsigned n_threads = this->m_n_threads;
+        piranha_assert(v1.size() && v2.size());
+        auto code_cmp
+            = [](term_type const *p1, term_type const *p2) { return p1->m_key.get_int() < p2->m_key.get_int(); };
+        std::sort(v1.begin(), v1.end(), code_cmp);
+        std::sort(v2.begin(), v2.end(), code_cmp);
+        c_vector c1(piranha::safe_cast<typename c_vector::size_type>(v1.size())),
+            c2(piranha::safe_cast<typename c_vector::size_type>(v2.size()));
+        auto get_code = [](term_type const *p) { return p->m_key.get_int(); };
+        std::transform(v1.begin(), v1.end(), c1.begin(), get_code);
+        std::transform(v2.begin(), v2.end(), c2.begin(), get_code);
+        // Range of codes of the result.
+        const auto lo = static_cast<int_type>(c1.front() + c2.front()),
+                   hi = static_cast<int_type>(c1.back() + c2.back());
+        auto &container = retval._container();
+        try {
+            if (n_threads == 1u) {
+                // Insert directly into retval, growing the table as needed.
+                container.rehash(boost::numeric_cast<bucket_size_type>(
+                    std::ceil(static_cast<double>(v1.size()) / container.max_load_factor())));
+                bucket_size_type count = 0u;
+                auto sink = [&container, &count](term_type &t) {
+                    if (unlikely(count == std::numeric_limits<bucket_size_type>::max())) {
+                        piranha_throw(std::overflow_error, "overflow error in the number of terms of a series");
+                    }
+                    if (unlikely(static_cast<double>(count + 1u) / static_cast<double>(container.bucket_count())
+                                 > container.max_load_factor())) {
+                        container._update_size(count);
+                        container._increase_size();
+                    }
+                    const auto b_idx = container._bucket(t);
+                    container._unique_insert(std::move(t), b_idx);
+                    count = static_cast<bucket_size_type>(count + 1u);
+                };
+                heap_merge(c1, c2, lo, hi, sink);
+                container._update_size(count);
+            } else {
+                // NOTE: use a few rounds, so that the buffers hold only a fraction of the result at a time. The
+                // number of parts is capped as in _out_of_core_multiplication().
+                const unsigned n_rounds = 8u;
+                const auto n_parts = static_cast<std::size_t>(std::min(
+                    std::min(integer(n_rounds) * n_threads, integer(hi) - lo + 1), integer(c1.size()) * c2.size()));
+                std::vector<int_type> ubs;
+                std::vector<integer> counts;
+                product_count_bounds(c1, c2, n_parts, n_threads, ubs, counts);
+                const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? n_threads : 1u;
+                container.rehash(boost::numeric_cast<bucket_size_type>(
+                                     std::ceil(std::max(static_cast<double>(est), 1.) / container.max_load_factor())),
+                                 n_threads_rehash);
+                using tv_type = std::vector<std::vector<term_type>>;
+                using bv_type = std::vector<std::vector<bucket_size_type>>;
+                tv_type terms(piranha::safe_cast<typename tv_type::size_type>(n_threads));
+                bv_type b_idx(piranha::safe_cast<typename bv_type::size_type>(n_threads));
+                bucket_size_type count = 0u;
+                for (std::size_t r = 0u; r < n_parts; r += n_threads) {
+                    const auto n_cur = std::min<std::size_t>(n_threads, n_parts - r);
+                    // Merge the parts of the round into the buffers.
+                    thread_pool::parallel_for(
+                        n_threads, n_cur, 1u,
+                        [this, &c1, &c2, &ubs, &terms, r, lo](const unsigned &, const std::size_t &begin,
+                                                              const std::size_t &end) {
+                            for (auto k = begin; k != end; ++k) {
+                                auto &out = terms[k];
+                                out.clear();
+                                const auto idx = r + k;
+                                if (idx && ubs[idx] == ubs[idx - 1u]) {
+                                    // Empty range.
+                                    continue;
+                                }
+                                auto sink = [&out](term_type &t) { out.push_back(std::move(t)); };
+                                this->heap_merge(c1, c2, idx ? static_cast<int_type>(ubs[idx - 1u] + 1) : lo,
+                                                 ubs[idx], sink);
+                            }
+                        });
+                    integer new_count(count);
+                    for (std::size_t k = 0u; k < n_cur; ++k) {
+                        new_count += terms[k].size();
+                    }
+                    if (unlikely(new_count > std::numeric_limits<bucket_size_type>::max())) {
+                        piranha_throw(std::overflow_error, "overflow error in the number of terms of a series");
+                    }
+                    // Grow the table if the estimate was too small.
+                    if (unlikely(static_cast<double>(new_count) / static_cast<double>(container.bucket_count())
+                                 > container.max_load_factor())) {
+                        container._update_size(count);
+                        container.rehash(boost::numeric_cast<bucket_size_type>(std::ceil(
+                                             2. * static_cast<double>(new_count) / container.max_load_factor())),
+                                         n_threads_rehash);
+                    }
+                    // Insert the buffers concurrently, each thread taking care of a contiguous zone of buckets.
+                    // NOTE: the parts are disjoint ranges of codes, hence the terms are unique.
+                    thread_pool::parallel_for(n_threads, n_cur, 1u,
+                                              [&container, &terms, &b_idx](const unsigned &, const std::size_t &begin,
+                                                                           const std::size_t &end) {
+                                                  for (auto k = begin; k != end; ++k) {
+                                                      b_idx[k].resize(terms[k].size());
+                                                      for (decltype(terms[k].size()) j = 0u; j < terms[k].size();
+                                                           ++j) {
+                                                          b_idx[k][j] = container._bucket(terms[k][j]);
+                                                      }
+                                                  }
+                                              });
+                    const auto b_count = container.bucket_count();
+                    const std::size_t n_zones = n_threads;
+                    thread_pool::parallel_for(
+                        n_threads, n_zones, 1u,
+                        [&container, &terms, &b_idx, n_cur, b_count, n_zones](
+                            const unsigned &, const std::size_t &begin, const std::size_t &end) {
+                            for (auto z = begin; z != end; ++z) {
+                                const auto start = static_cast<bucket_size_type>(b_count / n_zones * z),
+                                           stop = (z + 1u == n_zones)
+                                                      ? b_count
+                                                      : static_cast<bucket_size_type>(b_count / n_zones * (z + 1u));
+                                for (std::size_t k = 0u; k < n_cur; ++k) {
+                                    for (decltype(terms[k].size()) j = 0u; j < terms[k].size(); ++j) {
+                                        const auto idx = b_idx[k][j];
+                                        if (idx >= start && idx < stop) {
+                                            container._unique_insert(std::move(terms[k][j]), idx);
+                                        }
+                                    }
+                                }
+                            }
+                        });
+                    count = static_cast<bucket_size_type>(new_count);
+                }
+                container._update_size(count);
+            }
+            this->finalise_series(retval);
+        } catch (...) {
+            retval._container().clear();
+            throw;
+        }
+    }
     void sparse_kronecker_multiplication(Series &retval) const
+    {
+        using size_type = typename base::size_type;
+        using term_type = typename Series::term_type;
+        auto &container = retval._container();
+        // Sort input terms according to bucket positions in retval.
+        auto term_cmp = [&container](term_type const *p1, term_type const *p2) {
+            return container._bucket_from_hash(p1->hash()) < container._bucket_from_hash(p2->hash());
+        };
+        {
+            profiler::scope prof("multiplication.sort");
+            std::stable_sort(this->m_v1.begin(), this->m_v1.end(), term_cmp);
+            std::stable_sort(this->m_v2.begin(), this->m_v2.end(), term_cmp);
+        }
+        const auto size2 = static_cast<size_type>(this->m_v2.size());
+        sparse_kronecker_multiplication_impl(retval, std::vector<size_type>{0u, size2},
+                                             [size2](const size_type &) { return size2; });
+    }
+    // Implementation of the sparse Kronecker multiplication. The terms of the first series must be sorted according to
+    // their bucket positions in retval. The terms of the second series are partitioned in ranges (whose boundaries
+    // are given in the sorted vector ranges, from 0 to the size of the second series), and the terms within each range
+    // must be sorted according to their bucket positions in retval. The i-th term of the first series is multiplied
+    // by the terms in the ranges below lf(i), which must be one of the boundaries.
+    template <typename LimitFunctor>
+    void sparse_kronecker_multiplication_impl(Series &retval, const std::vector<typename base::size_type> &ranges,
+                                              const LimitFunctor &lf) const
     {
         using bucket_size_type = typename base::bucket_size_type;
         using size_type = typename base::size_type;
         using term_type = typename Series::term_type;
+        piranha_assert(ranges.size() >= 2u && ranges.front() == 0u && ranges.back() == this->m_v2.size());
+        // Reset the load balance statistics.
+        m_load_balance.clear();
         // Type representing multiplication tasks:
         // - the current term index from s1,
         // - the first term index in s2,
@@ -1684,15 +3249,16 @@ private:
         auto &v1 = this->m_v1;
         auto &v2 = this->m_v2;
         const auto size1 = v1.size();
-        const auto size2 = v2.size();
+        const auto n_ranges = ranges.size() - 1u;
         auto &container = retval._container();
         // A convenience functor to compute the destination bucket
         // of a term into retval.
         auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
-        // Sort input terms according to bucket positions in retval.
-        auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2) { return r_bucket(p1) < r_bucket(p2); };
-        std::stable_sort(v1.begin(), v1.end(), term_cmp);
-        std::stable_sort(v2.begin(), v2.end(), term_cmp);
+        // Total number of term-by-term multiplications.
+        unsigned long long n_products = 0u;
+        for (size_type i = 0u; i < size1; ++i) {
+            n_products += lf(i);
+        }
         // Task comparator. It will compare the bucket index of the terms resulting from
         // the multiplication of the term in the first series by the first term in the block
         // of the second series. This is essentially the first bucket index of retval in which the task
@@ -1762,12 +3328,17 @@ private:
                 // Single threaded case.
                 // Create the vector of tasks.
                 std::vector<task_type> tasks;
-                for (decltype(v1.size()) i = 0u; i < size1; ++i) {
-                    task_split(std::make_tuple(i, size_type(0u), size2), tasks);
+                for (size_type i = 0u; i < size1; ++i) {
+                    const size_type limit = lf(i);
+                    for (decltype(ranges.size()) k = 0u; k < n_ranges && ranges[k + 1u] <= limit; ++k) {
+                        task_split(std::make_tuple(i, ranges[k], ranges[k + 1u]), tasks);
+                    }
                 }
                 // Sort the tasks.
                 std::stable_sort(tasks.begin(), tasks.end(), task_cmp);
                 // Iterate over the tasks and run the multiplication.
+                profiler::scope prof("multiplication.multiply");
+                prof.count("products", n_products);
                 term_type tmp_term;
                 for (const auto &t : tasks) {
                     task_consume(t, tmp_term);
@@ -1782,16 +3353,30 @@ private:
         }
         // Number of buckets in retval.
         const bucket_size_type bucket_count = container.bucket_count();
-        // Compute the number of zones in which the output container will be subdivided,
+        // Compute the number of zones in which the output container will be initially subdivided,
         // a multiple of the number of threads.
         // NOTE: zm is a tuning parameter.
         const unsigned zm = 10u;
         const bucket_size_type n_zones = static_cast<bucket_size_type>(integer(this->m_n_threads) * zm);
         // Number of buckets per zone (can be zero).
         const bucket_size_type bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
-        // For each zone, we need to define a vector of tasks that will write only into that zone.
-        std::vector<std::vector<task_type>> task_table;
-        task_table.resize(piranha::safe_cast<decltype(task_table.size())>(n_zones));
+        // A zone is a range of buckets [a,b[ in the output container, together with the vector of tasks
+        // that will write only into that zone and the number of term-by-term multiplications in the tasks.
+        // NOTE: the weight is a floating-point value as it is used only for load balancing purposes,
+        // and the total number of term-by-term multiplications might overflow integral types.
+        struct zone_type {
+            bucket_size_type a;
+            bucket_size_type b;
+            std::vector<task_type> tasks;
+            double weight;
+        };
+        std::vector<zone_type> zones;
+        zones.resize(piranha::safe_cast<decltype(zones.size())>(n_zones));
+        for (decltype(zones.size()) z = 0u; z < zones.size(); ++z) {
+            zones[z].a = static_cast<bucket_size_type>(bpz * z);
+            // Special casing if this is the last zone in the container.
+            zones[z].b = (z == zones.size() - 1u) ? bucket_count : static_cast<bucket_size_type>(zones[z].a + bpz);
+        }
         // Lower bound implementation. Adapted from:
         // http://en.cppreference.com/w/cpp/algorithm/lower_bound
         // Given the [first,last[ index range in v2, find the first index idx in the v2 range such that the i-th
@@ -1803,7 +3388,7 @@ private:
             bucket_size_type ib = r_bucket(v1[i]);
             // Avoid zb - ib below wrapping around.
             if (zb < ib) {
-                return 0u;
+                return first;
             }
             const auto cmp = static_cast<bucket_size_type>(zb - ib);
             size_type idx, step, count = static_cast<size_type>(last - first);
@@ -1824,79 +3409,136 @@ private:
             }
             return first;
         };
-        // Fill the task table.
-        auto table_filler = [&task_table, bpz, this, bucket_count, size1, size2, &l_bound, &task_split,
-                             &task_cmp](const unsigned &thread_idx) {
-            for (unsigned n = 0u; n < zm; ++n) {
-                std::vector<task_type> cur_tasks;
-                // [a,b[ is the container zone.
-                bucket_size_type a = static_cast<bucket_size_type>(thread_idx * bpz * zm + n * bpz);
-                bucket_size_type b;
-                if (n == zm - 1u && thread_idx == this->m_n_threads - 1u) {
-                    // Special casing if this is the last zone in the container.
-                    b = bucket_count;
-                } else {
-                    b = static_cast<bucket_size_type>(a + bpz);
+        // Fill the tasks and the weight of a zone.
+        // Append to out the tasks writing into the [a,b[ bucket range (without wrapping around). Returns false if
+        // no term of the second series multiplied by the i-th term of the first series (or by any of the following
+        // terms, as they are sorted by bucket) would be written below b.
+        auto range_tasks = [n_ranges, &ranges, &lf, &l_bound, &task_split](
+                               size_type i, bucket_size_type a, bucket_size_type b, std::vector<task_type> &out) {
+            const size_type limit = lf(i);
+            bool retval = false;
+            for (decltype(ranges.size()) k = 0u; k < n_ranges; ++k) {
+                auto t = std::make_tuple(i, l_bound(ranges[k], ranges[k + 1u], a, i),
+                                         l_bound(ranges[k], ranges[k + 1u], b, i));
+                if (std::get<1u>(t) != ranges[k] || std::get<2u>(t) != ranges[k]) {
+                    retval = true;
                 }
-                // First batch of tasks.
-                for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, a, i), l_bound(0u, size2, b, i));
-                    if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
-                        // This means that all the next tasks we will compute will be empty,
-                        // no sense in calculating them.
-                        break;
-                    }
-                    task_split(t, cur_tasks);
+                if (ranges[k + 1u] <= limit) {
+                    task_split(t, out);
                 }
-                // Second batch of tasks.
-                // Note: we can always compute a,b + bucket_count because of the limits on the maximum value of
-                // bucket_count.
-                for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, static_cast<bucket_size_type>(a + bucket_count), i),
-                                             l_bound(0u, size2, static_cast<bucket_size_type>(b + bucket_count), i));
-                    if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
-                        break;
-                    }
-                    task_split(t, cur_tasks);
+            }
+            return retval;
+        };
+        auto zone_filler = [size1, bucket_count, &range_tasks, &task_cmp](zone_type &zone) {
+            const bucket_size_type a = zone.a, b = zone.b;
+            auto &cur_tasks = zone.tasks;
+            cur_tasks.clear();
+            // First batch of tasks.
+            for (size_type i = 0u; i < size1; ++i) {
+                if (!range_tasks(i, a, b, cur_tasks)) {
+                    // This means that all the next tasks we will compute will be empty,
+                    // no sense in calculating them.
+                    break;
+                }
+            }
+            // Second batch of tasks.
+            // Note: we can always compute a,b + bucket_count because of the limits on the maximum value of
+            // bucket_count.
+            for (size_type i = 0u; i < size1; ++i) {
+                if (!range_tasks(i, static_cast<bucket_size_type>(a + bucket_count),
+                                 static_cast<bucket_size_type>(b + bucket_count), cur_tasks)) {
+                    break;
                 }
-                // Sort the task vector.
-                std::stable_sort(cur_tasks.begin(), cur_tasks.end(), task_cmp);
-                // Move the vector of tasks in the table.
-                task_table[static_cast<decltype(task_table.size())>(thread_idx * zm + n)] = std::move(cur_tasks);
+            }
+            // Sort the task vector.
+            std::stable_sort(cur_tasks.begin(), cur_tasks.end(), task_cmp);
+            // Count the term-by-term multiplications.
+            zone.weight = 0.;
+            for (const auto &t : cur_tasks) {
+                zone.weight += static_cast<double>(std::get<2u>(t) - std::get<1u>(t));
             }
         };
-        // Go with the threads to fill the task table.
-        future_list<decltype(table_filler(0u))> ff_list;
-        try {
-            for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                ff_list.push_back(thread_pool::enqueue(i, table_filler, i));
+        {
+            profiler::scope prof("multiplication.task_table");
+            // Go with the threads to fill the initial zones.
+            thread_pool::parallel_for(this->m_n_threads, piranha::safe_cast<std::size_t>(zones.size()), 1u,
+                                      [&zones, &zone_filler](const unsigned &, const std::size_t &begin,
+                                                             const std::size_t &end) {
+                                          for (auto z = begin; z != end; ++z) {
+                                              zone_filler(zones[static_cast<decltype(zones.size())>(z)]);
+                                          }
+                                      });
+            // The workload of the zones can be very unbalanced (e.g., when the monomials of the result are
+            // clustered in a few regions of the output container). The zones whose weight exceeds twice the average
+            // weight are split by bisection of their bucket ranges, until the weight of each subzone does not exceed
+            // the average weight (or the subzone consists of a single bucket).
+            const double avg_weight = static_cast<double>(n_products) / static_cast<double>(n_zones);
+            std::vector<decltype(zones.size())> heavy;
+            for (decltype(zones.size()) z = 0u; z < zones.size(); ++z) {
+                if (zones[z].weight > 2. * avg_weight && zones[z].b - zones[z].a > 1u) {
+                    heavy.push_back(z);
+                }
             }
-            // First let's wait for everything to finish.
-            ff_list.wait_all();
-            // Then, let's handle the exceptions.
-            ff_list.get_all();
-        } catch (...) {
-            ff_list.wait_all();
-            throw;
+            if (!heavy.empty()) {
+                // The subzones of each heavy zone, in bucket order.
+                std::vector<std::vector<zone_type>> splits(heavy.size());
+                auto splitter = [&zones, &heavy, &splits, &zone_filler, avg_weight](
+                                    const unsigned &, const std::size_t &begin, const std::size_t &end) {
+                    for (auto h = begin; h != end; ++h) {
+                        auto &out = splits[static_cast<decltype(splits.size())>(h)];
+                        // Stack of the zones to be examined. The left half of a split zone is pushed last,
+                        // so that the subzones are appended to out in bucket order.
+                        std::vector<zone_type> stack;
+                        stack.push_back(std::move(zones[heavy[static_cast<decltype(heavy.size())>(h)]]));
+                        while (!stack.empty()) {
+                            zone_type cur = std::move(stack.back());
+                            stack.pop_back();
+                            if (cur.weight <= avg_weight || cur.b - cur.a < 2u) {
+                                out.push_back(std::move(cur));
+                                continue;
+                            }
+                            const auto mid = static_cast<bucket_size_type>(cur.a + (cur.b - cur.a) / 2u);
+                            zone_type left{cur.a, mid, std::vector<task_type>{}, 0.},
+                                right{mid, cur.b, std::move(cur.tasks), 0.};
+                            zone_filler(left);
+                            zone_filler(right);
+                            stack.push_back(std::move(right));
+                            stack.push_back(std::move(left));
+                        }
+                    }
+                };
+                thread_pool::parallel_for(this->m_n_threads, piranha::safe_cast<std::size_t>(heavy.size()), 1u,
+                                          splitter);
+                // Rebuild the vector of zones, replacing the heavy zones with their subzones.
+                std::vector<zone_type> new_zones;
+                decltype(heavy.size()) h = 0u;
+                for (decltype(zones.size()) z = 0u; z < zones.size(); ++z) {
+                    if (h < heavy.size() && heavy[h] == z) {
+                        std::move(splits[h].begin(), splits[h].end(), std::back_inserter(new_zones));
+                        ++h;
+                    } else {
+                        new_zones.push_back(std::move(zones[z]));
+                    }
+                }
+                zones = std::move(new_zones);
+            }
+            prof.count("zones", zones.size());
         }
         // Check the consistency of the table for debug purposes.
-        auto table_checker = [&task_table, size1, size2, &r_bucket, bpz, bucket_count, &v1, &v2]() -> bool {
+        auto table_checker = [&zones, n_products, &r_bucket, bucket_count, &v1, &v2]() -> bool {
             // Total number of term-by-term multiplications. Needs to be equal
-            // to size1 * size2 at the end.
+            // to n_products at the end.
             integer tot_n(0);
             // Tmp term for multiplications.
             term_type tmp_term;
-            for (decltype(task_table.size()) i = 0u; i < task_table.size(); ++i) {
-                const auto &v = task_table[i];
+            for (decltype(zones.size()) i = 0u; i < zones.size(); ++i) {
                 // Bucket limits of each zone.
-                bucket_size_type a = static_cast<bucket_size_type>(bpz * i), b;
-                // Special casing for the last zone in the table.
-                if (i == task_table.size() - 1u) {
-                    b = bucket_count;
-                } else {
-                    b = static_cast<bucket_size_type>(a + bpz);
+                const bucket_size_type a = zones[i].a, b = zones[i].b;
+                // The zones must cover the container without gaps.
+                if (a != (i ? zones[i - 1u].b : 0u) || (i == zones.size() - 1u && b != bucket_count)) {
+                    return false;
                 }
-                for (const auto &t : v) {
+                for (const auto &t : zones[i].tasks) {
                     auto idx1 = std::get<0u>(t), start2 = std::get<1u>(t), end2 = std::get<2u>(t);
                     using int_type = decltype(v1[idx1]->m_key.get_int());
                     piranha_assert(start2 <= end2);
@@ -1911,60 +3553,78 @@ private:
                     }
                 }
             }
-            return tot_n == integer(size1) * size2;
+            return tot_n == n_products;
         };
         (void)table_checker;
         piranha_assert(table_checker());
-        // Init the vector of atomic flags.
-        detail::atomic_flag_array af(piranha::safe_cast<std::size_t>(task_table.size()));
-        // Thread functor.
-        auto thread_functor = [&task_table, &af, &task_consume](const unsigned &thread_idx) {
-            using t_size_type = decltype(task_table.size());
-            // Temporary term_type for caching.
-            term_type tmp_term;
-            // The starting index in the task table.
-            auto t_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm);
-            const auto start_t_idx = t_idx;
-            while (true) {
-                // If this returns false, it means that the tasks still need to be consumed;
-                if (!af[static_cast<std::size_t>(t_idx)].test_and_set()) {
-                    // Current vector of tasks.
-                    const auto &cur_tasks = task_table[t_idx];
-                    for (const auto &t : cur_tasks) {
-                        task_consume(t, tmp_term);
-                    }
-                }
-                // Update the index, wrapping around if necessary.
-                t_idx = static_cast<t_size_type>(t_idx + 1u);
-                if (t_idx == task_table.size()) {
-                    t_idx = 0u;
-                }
-                // If we got back to the original index, get out.
-                if (t_idx == start_t_idx) {
-                    break;
+        // Temporary terms for caching and busy times, one per thread.
+        std::vector<term_type> tmp_terms(static_cast<typename std::vector<term_type>::size_type>(this->m_n_threads));
+        std::vector<double> busy(static_cast<std::vector<double>::size_type>(this->m_n_threads), 0.);
+        // Thread functor. It will consume the tasks of the zones in the [begin, end) range. Each zone is
+        // processed by a single thread, and the tasks of a zone write only into the buckets of the zone.
+        auto thread_functor = [&zones, &tmp_terms, &busy, &task_consume](const unsigned &thread_idx,
+                                                                         const std::size_t &begin,
+                                                                         const std::size_t &end) {
+            const auto start = std::chrono::steady_clock::now();
+            auto &tmp_term = tmp_terms[thread_idx];
+            for (auto z = begin; z != end; ++z) {
+                for (const auto &t : zones[static_cast<decltype(zones.size())>(z)].tasks) {
+                    task_consume(t, tmp_term);
                 }
             }
+            busy[thread_idx] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         };
-        // Go with the multiplication threads.
-        future_list<decltype(thread_functor(0u))> ft_list;
+        // Go with the multiplication threads. The zones are initially assigned to the threads in contiguous
+        // blocks, and threads which run out of zones steal from the others.
         try {
-            for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                ft_list.push_back(thread_pool::enqueue(i, thread_functor, i));
+            const auto start = std::chrono::steady_clock::now();
+            {
+                profiler::scope prof("multiplication.multiply");
+                prof.count("products", n_products);
+                thread_pool::parallel_for(this->m_n_threads, piranha::safe_cast<std::size_t>(zones.size()), 1u,
+                                          thread_functor);
+            }
+            const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            // Record the load balance.
+            for (const auto &t : busy) {
+                m_load_balance.emplace_back(t, wall > t ? wall - t : 0.);
             }
-            // First let's wait for everything to finish.
-            ft_list.wait_all();
-            // Then, let's handle the exceptions.
-            ft_list.get_all();
             // Finally, fix and finalise the series.
             this->sanitise_series(retval, this->m_n_threads);
             this->finalise_series(retval);
         } catch (...) {
-            ft_list.wait_all();
             // Clean up and re-throw.
             retval._container().clear();
             throw;
         }
     }
+
+private:
+    // Exponent bounds of the two operands, as determined by check_bounds(). These are
+    // computed only for Kronecker monomials.
+    mutable std::vector<std::pair<integer, integer>> m_kbounds1;
+    mutable std::vector<std::pair<integer, integer>> m_kbounds2;
+    // Busy and idle times of the threads in the last parallel sparse Kronecker multiplication.
+    mutable std::vector<std::pair<double, double>> m_load_balance;
+};
+
+// Specialisation of the implementation of piranha::gcd() for polynomials with integer coefficients
+// and Kronecker monomials.
+#if defined(PIRANHA_HAVE_CONCEPTS)
+template <typename Cf, typename Key>
+requires detail::has_kpoly_division<polynomial<Cf, Key>>::value class gcd_impl<polynomial<Cf, Key>, polynomial<Cf, Key>>
+#else
+template <typename Cf, typename Key>
+class gcd_impl<polynomial<Cf, Key>, polynomial<Cf, Key>,
+               enable_if_t<detail::has_kpoly_division<polynomial<Cf, Key>>::value>>
+#endif
+{
+public:
+    // Call operator.
+    polynomial<Cf, Key> operator()(const polynomial<Cf, Key> &a, const polynomial<Cf, Key> &b) const
+    {
+        return polynomial<Cf, Key>::gcd(a, b);
+    }
 };
 }
 
@@ -0,0 +1,390 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_PROFILER_HPP
+#define PIRANHA_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// An event recorded by the profiler.
+struct profiler_event {
+    std::string name;
+    unsigned thread;
+    double start;
+    double wall;
+    double cpu;
+    std::vector<std::pair<std::string, unsigned long long>> counts;
+};
+
+template <typename = int>
+struct base_profiler {
+    static std::atomic<bool> s_enabled;
+    static std::mutex s_mutex;
+    static std::vector<profiler_event> s_events;
+    static std::map<std::string, unsigned long long> s_counters;
+    static std::map<std::thread::id, unsigned> s_thread_ids;
+    static const std::chrono::steady_clock::time_point s_origin;
+};
+
+template <typename T>
+std::atomic<bool> base_profiler<T>::s_enabled(false);
+
+template <typename T>
+std::mutex base_profiler<T>::s_mutex;
+
+template <typename T>
+std::vector<profiler_event> base_profiler<T>::s_events;
+
+template <typename T>
+std::map<std::string, unsigned long long> base_profiler<T>::s_counters;
+
+template <typename T>
+std::map<std::thread::id, unsigned> base_profiler<T>::s_thread_ids;
+
+template <typename T>
+const std::chrono::steady_clock::time_point base_profiler<T>::s_origin = std::chrono::steady_clock::now();
+}
+
+/// Profiler.
+/**
+ * This class provides an opt-in instrumentation layer which records the time spent in the main phases of the
+ * operations on series (e.g., the size estimation, the bounds checking, the construction of the task table
+ * and the term-by-term multiplications in series multiplication, series arithmetic, exponentiation, substitution
+ * and serialization).
+ *
+ * The profiler is disabled by default. When disabled, the cost of the instrumentation is a relaxed atomic load per
+ * instrumented section. When enabled, each instrumented section records an event consisting of:
+ * - the name of the section,
+ * - an index identifying the thread in which the section was executed (the threads are numbered sequentially
+ *   in the order in which they record their first event),
+ * - the start time (in seconds from program startup),
+ * - the wall-clock duration (in seconds),
+ * - the processor time consumed by the process during the section (in seconds, as measured by \p std::clock(),
+ *   thus including the processor time of all the threads),
+ * - a list of named counts attached to the section (e.g., the number of terms of the operands).
+ *
+ * In addition to the events, the profiler maintains a set of global counters (e.g., the number of rehash
+ * operations in the hash sets).
+ *
+ * The recorded data can be retrieved via get_events() and get_counters(), or exported in the JSON trace event
+ * format understood by the trace viewer of the Chrome browser (\p chrome://tracing) and by other tools.
+ *
+ * All the methods in this class are thread-safe.
+ */
+class profiler : private detail::base_profiler<>
+{
+public:
+    /// Event type.
+    using event = detail::profiler_event;
+    /// Instrumented section.
+    /**
+     * An object of this class records an event upon destruction if the profiler was enabled at construction time.
+     */
+    class scope
+    {
+    public:
+        /// Constructor.
+        /**
+         * @param name the name of the section (it must be a string literal or, in general, a string which
+         * outlives this object).
+         */
+        explicit scope(const char *name) : m_name(name), m_active(profiler::is_enabled())
+        {
+            if (m_active) {
+                m_cpu = std::clock();
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        /// Deleted copy constructor.
+        scope(const scope &) = delete;
+        /// Deleted move constructor.
+        scope(scope &&) = delete;
+        /// Deleted copy assignment operator.
+        scope &operator=(const scope &) = delete;
+        /// Deleted move assignment operator.
+        scope &operator=(scope &&) = delete;
+        /// Destructor.
+        /**
+         * If the profiler was enabled at construction time, the event will be recorded. Any error
+         * raised while recording the event will be ignored.
+         */
+        ~scope()
+        {
+            if (!m_active) {
+                return;
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const auto cpu = std::clock();
+            try {
+                event ev;
+                ev.name = m_name;
+                ev.start = std::chrono::duration<double>(m_start - s_origin).count();
+                ev.wall = std::chrono::duration<double>(end - m_start).count();
+                ev.cpu = (m_cpu == std::clock_t(-1) || cpu == std::clock_t(-1))
+                             ? 0.
+                             : static_cast<double>(cpu - m_cpu) / CLOCKS_PER_SEC;
+                ev.counts = std::move(m_counts);
+                profiler::record(std::move(ev));
+            } catch (...) {
+            }
+        }
+        /// Check if the section is being recorded.
+        /**
+         * @return \p true if the profiler was enabled when this object was constructed, \p false otherwise.
+         */
+        bool active() const
+        {
+            return m_active;
+        }
+        /// Attach a count to the section.
+        /**
+         * If the section is being recorded, the count \p n with name \p name will be attached to the event,
+         * otherwise this method is a no-op.
+         *
+         * @param name the name of the count.
+         * @param n the value of the count.
+         *
+         * @throws unspecified any exception thrown by memory allocation errors.
+         */
+        void count(const char *name, unsigned long long n)
+        {
+            if (m_active) {
+                m_counts.emplace_back(name, n);
+            }
+        }
+
+    private:
+        const char *m_name;
+        const bool m_active;
+        std::clock_t m_cpu;
+        std::chrono::steady_clock::time_point m_start;
+        std::vector<std::pair<std::string, unsigned long long>> m_counts;
+    };
+    /// Enable the profiler.
+    static void enable()
+    {
+        s_enabled.store(true);
+    }
+    /// Disable the profiler.
+    /**
+     * The data recorded so far will be preserved.
+     */
+    static void disable()
+    {
+        s_enabled.store(false);
+    }
+    /// Check if the profiler is enabled.
+    /**
+     * @return \p true if the profiler is enabled, \p false otherwise.
+     */
+    static bool is_enabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    /// Clear the recorded data.
+    /**
+     * This method will erase all the recorded events and counters.
+     */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_events.clear();
+        s_counters.clear();
+    }
+    /// Increase a global counter.
+    /**
+     * If the profiler is enabled, the global counter called \p name will be increased by \p n (a counter
+     * which does not exist yet is created with an initial value of zero). Otherwise, this method is a no-op.
+     *
+     * @param name the name of the counter.
+     * @param n the increment.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors or by threading primitives.
+     */
+    static void add_counter(const char *name, unsigned long long n = 1u)
+    {
+        if (!is_enabled()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_counters[name] += n;
+    }
+    /// Get the recorded events.
+    /**
+     * @return the events recorded so far, in the order in which they were completed.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors or by threading primitives.
+     */
+    static std::vector<event> get_events()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_events;
+    }
+    /// Get the global counters.
+    /**
+     * @return the global counters.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors or by threading primitives.
+     */
+    static std::map<std::string, unsigned long long> get_counters()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_counters;
+    }
+    /// Export the recorded data as a Chrome trace.
+    /**
+     * This method will return a string containing the recorded data in the JSON trace event format. Each event is
+     * exported as a complete event (with phase <tt>"X"</tt>), whose arguments contain the processor time
+     * (<tt>"cpu"</tt>, in seconds) and the counts attached to the event. The global counters, if any, are exported
+     * as a single counter event (with phase <tt>"C"</tt>) at the end of the trace.
+     *
+     * @return a JSON representation of the recorded data.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors, by threading primitives
+     * or by the public interface of \p std::ostringstream.
+     */
+    static std::string to_chrome_trace()
+    {
+        std::ostringstream oss;
+        oss.precision(17);
+        oss << "{\"traceEvents\":[";
+        std::lock_guard<std::mutex> lock(s_mutex);
+        double last = 0.;
+        bool first = true;
+        for (const auto &ev : s_events) {
+            if (!first) {
+                oss << ',';
+            }
+            first = false;
+            oss << "{\"name\":" << json_string(ev.name) << ",\"cat\":\"piranha\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+                << ev.thread << ",\"ts\":" << ev.start * 1E6 << ",\"dur\":" << ev.wall * 1E6
+                << ",\"args\":{\"cpu\":" << ev.cpu;
+            for (const auto &p : ev.counts) {
+                oss << ',' << json_string(p.first) << ':' << p.second;
+            }
+            oss << "}}";
+            if (ev.start + ev.wall > last) {
+                last = ev.start + ev.wall;
+            }
+        }
+        if (!s_counters.empty()) {
+            if (!first) {
+                oss << ',';
+            }
+            oss << "{\"name\":\"counters\",\"cat\":\"piranha\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":" << last * 1E6
+                << ",\"args\":{";
+            bool first_counter = true;
+            for (const auto &p : s_counters) {
+                if (!first_counter) {
+                    oss << ',';
+                }
+                first_counter = false;
+                oss << json_string(p.first) << ':' << p.second;
+            }
+            oss << "}}";
+        }
+        oss << "],\"displayTimeUnit\":\"ms\"}";
+        return oss.str();
+    }
+    /// Save the recorded data as a Chrome trace.
+    /**
+     * This method will write the output of to_chrome_trace() into the file called \p filename.
+     *
+     * @param filename the name of the output file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or written.
+     * @throws unspecified any exception thrown by to_chrome_trace() or by the public interface of
+     * \p std::ofstream.
+     */
+    static void save_chrome_trace(const std::string &filename)
+    {
+        const auto trace = to_chrome_trace();
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+        ofile << trace;
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "error while writing the file '" + filename + "'");
+        }
+    }
+
+private:
+    // Store an event, assigning the thread index.
+    static void record(event &&ev)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const auto it = s_thread_ids.emplace(std::this_thread::get_id(), static_cast<unsigned>(s_thread_ids.size()));
+        ev.thread = it.first->second;
+        s_events.push_back(std::move(ev));
+    }
+    // Quote and escape a string for JSON output.
+    static std::string json_string(const std::string &s)
+    {
+        std::string retval("\"");
+        for (const char c : s) {
+            if (c == '"' || c == '\\') {
+                retval += '\\';
+                retval += c;
+            } else if (static_cast<unsigned char>(c) < 0x20u) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                retval += buffer;
+            } else {
+                retval += c;
+            }
+        }
+        retval += '"';
+        return retval;
+    }
+};
+}
+
+#endif
@@ -40,6 +40,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/config.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/type_traits.hpp>
 
 namespace piranha
@@ -1242,6 +1243,19 @@ const bool key_has_msgpack_convert<Key>::value;
 
 #endif
 
+#if defined(PIRANHA_WITH_ZSTD)
+
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#define PIRANHA_ZSTD_CONDITIONAL(expr) expr
+
+#else
+
+#define PIRANHA_ZSTD_CONDITIONAL(expr) piranha_throw(not_implemented_error, "zstd support is not enabled")
+
+#endif
+
 namespace piranha
 {
 
@@ -1292,7 +1306,9 @@ enum class compression {
     /// gzip compression.
     gzip,
     /// zlib compression.
-    zlib
+    zlib,
+    /// zstd compression.
+    zstd
 };
 
 inline namespace impl
@@ -1300,7 +1316,7 @@ inline namespace impl
 
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
-#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
 
 template <typename CompressionFilter, typename T>
 inline void save_file_boost_compress_impl(const T &x, std::ofstream &ofile, data_format f)
@@ -1366,6 +1382,9 @@ inline void save_file_boost_impl(const T &x, const std::string &filename, data_f
         case compression::zlib:
             PIRANHA_ZLIB_CONDITIONAL(save_file_boost_compress_impl<boost::iostreams::zlib_compressor>(x, ofile, f));
             break;
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(save_file_boost_compress_impl<boost::iostreams::zstd_compressor>(x, ofile, f));
+            break;
         case compression::none:
             if (f == data_format::boost_binary) {
                 boost::archive::binary_oarchive oa(ofile);
@@ -1404,6 +1423,9 @@ inline void load_file_boost_impl(T &x, const std::string &filename, data_format
         case compression::zlib:
             PIRANHA_ZLIB_CONDITIONAL(load_file_boost_compress_impl<boost::iostreams::zlib_decompressor>(x, ifile, f));
             break;
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(load_file_boost_compress_impl<boost::iostreams::zstd_decompressor>(x, ifile, f));
+            break;
         case compression::none:
             if (f == data_format::boost_binary) {
                 boost::archive::binary_iarchive ia(ifile);
@@ -1442,7 +1464,7 @@ inline void load_file_boost_impl(T &, const std::string &, data_format, compress
 
 #if defined(PIRANHA_WITH_MSGPACK)
 
-#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
 
 // Compressed load/save for msgpack.
 template <typename CompressionFilter, typename T>
@@ -1476,7 +1498,7 @@ inline void load_file_msgpack_compress_impl(T &x, const std::string &filename, m
 // Main msgpack load/save functions.
 template <typename T,
           enable_if_t<conjunction<has_msgpack_pack<msgpack_stream_wrapper<std::ofstream>, T>
-#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
                                   ,
                                   has_msgpack_pack<msgpack_stream_wrapper<boost::iostreams::filtering_ostream>, T>
 #endif
@@ -1500,6 +1522,9 @@ inline void save_file_msgpack_impl(const T &x, const std::string &filename, data
         case compression::zlib:
             PIRANHA_ZLIB_CONDITIONAL(save_file_msgpack_compress_impl<boost::iostreams::zlib_compressor>(x, ofile, mf));
             break;
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(save_file_msgpack_compress_impl<boost::iostreams::zstd_compressor>(x, ofile, mf));
+            break;
         case compression::none: {
             msgpack::packer<decltype(ofile)> packer(ofile);
             msgpack_pack(packer, x, mf);
@@ -1510,7 +1535,7 @@ inline void save_file_msgpack_impl(const T &x, const std::string &filename, data
 template <
     typename T,
     enable_if_t<disjunction<negation<has_msgpack_pack<msgpack_stream_wrapper<std::ofstream>, T>>
-#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
                             ,
                             negation<has_msgpack_pack<msgpack_stream_wrapper<boost::iostreams::filtering_ostream>, T>>
 #endif
@@ -1538,6 +1563,10 @@ inline void load_file_msgpack_impl(T &x, const std::string &filename, data_forma
             PIRANHA_ZLIB_CONDITIONAL(
                 load_file_msgpack_compress_impl<boost::iostreams::zlib_decompressor>(x, filename, mf));
             break;
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(
+                load_file_msgpack_compress_impl<boost::iostreams::zstd_decompressor>(x, filename, mf));
+            break;
         case compression::none: {
             std::ifstream ifile(filename, std::ios::in | std::ios::binary);
             if (unlikely(!ifile.good())) {
@@ -1593,6 +1622,9 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
     } else if (boost::ends_with(filename, ".zip")) {
         c = compression::zlib;
         filename.erase(filename.end() - 4, filename.end());
+    } else if (boost::ends_with(filename, ".zst")) {
+        c = compression::zstd;
+        filename.erase(filename.end() - 4, filename.end());
     }
     data_format f;
     if (boost::ends_with(filename, ".boostb")) {
@@ -1607,7 +1639,7 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
         piranha_throw(std::invalid_argument,
                       "unable to deduce the data format from the filename '" + orig_fname
                           + "'. The filename must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
-                            "optionally followed by one of ['.bz2','gz','zip'].");
+                            "optionally followed by one of ['.bz2','gz','zip','zst'].");
     }
     return std::make_pair(c, f);
 }
@@ -1641,6 +1673,7 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
 template <typename T>
 inline void save_file(const T &x, const std::string &filename, data_format f, compression c)
 {
+    profiler::scope prof("s11n.save_file");
     if (f == data_format::boost_binary || f == data_format::boost_portable) {
         save_file_boost_impl(x, filename, f, c);
     } else if (f == data_format::msgpack_binary || f == data_format::msgpack_portable) {
@@ -1652,10 +1685,10 @@ inline void save_file(const T &x, const std::string &filename, data_format f, co
 /**
  * This is a convenience function that will invoke the other overload of piranha::save_file() trying to guess
  * the data and compression formats from the filename. The heuristic is as follows:
- * - if \p filename ends in one of the suffixes <tt>.bz2</tt>, <tt>.gz</tt> or <tt>.zip</tt> then the suffix is removed
- *   for further considerations from \p filename, and the corresponding
- *   piranha::compression format is assumed (respectively, piranha::compression::bzip2, piranha::compression::gzip
- *   and piranha::compression::zlib). Otherwise, piranha::compression::none is assumed;
+ * - if \p filename ends in one of the suffixes <tt>.bz2</tt>, <tt>.gz</tt>, <tt>.zip</tt> or <tt>.zst</tt> then the
+ *   suffix is removed for further considerations from \p filename, and the corresponding
+ *   piranha::compression format is assumed (respectively, piranha::compression::bzip2, piranha::compression::gzip,
+ *   piranha::compression::zlib and piranha::compression::zstd). Otherwise, piranha::compression::none is assumed;
  * - after the removal of any compression suffix, the extension of \p filename is examined again: if the extension is
  *   one of <tt>.boostp</tt>, <tt>.boostb</tt>, <tt>.mpackp</tt> and <tt>.mpackb</tt>, then the corresponding data
  *   format is selected (respectively, piranha::data_format::boost_portable, piranha::data_format::boost_binary,
@@ -1714,6 +1747,7 @@ inline void save_file(const T &x, const std::string &filename)
 template <typename T, load_file_enabler<T> = 0>
 inline void load_file(T &x, const std::string &filename, data_format f, compression c)
 {
+    profiler::scope prof("s11n.load_file");
     if (f == data_format::boost_binary || f == data_format::boost_portable) {
         load_file_boost_impl(x, filename, f, c);
     } else if (f == data_format::msgpack_binary || f == data_format::msgpack_portable) {
@@ -46,6 +46,7 @@ see https://www.gnu.org/licenses/. */
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -61,6 +62,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/convert_to.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/pow_cache.hpp>
 #include <piranha/detail/series_fwd.hpp>
 #include <piranha/detail/sfinae_types.hpp>
 #include <piranha/exceptions.hpp>
@@ -77,12 +79,15 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math/sin.hpp>
 #include <piranha/print_coefficient.hpp>
 #include <piranha/print_tex_coefficient.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/s11n.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/series_multiplier.hpp>
 #include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/term.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 namespace piranha
@@ -91,9 +96,11 @@ namespace piranha
 inline namespace impl
 {
 
-// Fwd declaration.
+// Fwd declarations.
 template <typename S1, typename S2, typename F>
 auto series_merge_f(S1 &&s1, S2 &&s2, const F &f) -> decltype(f(std::forward<S1>(s1), std::forward<S2>(s2)));
+
+struct series_nary_ops;
 } // namespace impl
 
 namespace detail
@@ -556,6 +563,9 @@ class series_operators
         using ret_type = series_common_type<T, U, 0>;
         static_assert(std::is_same<typename std::decay<T>::type, ret_type>::value, "Invalid type.");
         static_assert(std::is_same<typename std::decay<U>::type, ret_type>::value, "Invalid type.");
+        profiler::scope prof(Sign ? "series.add" : "series.sub");
+        prof.count("terms1", x.size());
+        prof.count("terms2", y.size());
         // Init the return value from the first operand.
         // NOTE: this is always possible to do, a series is always copy/move-constructible.
         ret_type retval(std::forward<T>(x));
@@ -739,6 +749,9 @@ class series_operators
         template <typename T, typename U>
         series_common_type<T, U, 2> operator()(T &&x, U &&y) const
         {
+            profiler::scope prof("series.mul");
+            prof.count("terms1", x.size());
+            prof.count("terms2", y.size());
             return series_multiplier<series_common_type<T, U, 2>>(std::forward<T>(x), std::forward<U>(y))();
         }
     };
@@ -1244,6 +1257,21 @@ public:
     }
 };
 
+/// Terms container of a series type.
+/**
+ * The member alias template \p type, applied to the term type of the series type \p Series, determines the container
+ * used to store the terms of \p Series. The default implementation selects piranha::hash_set. This class can be
+ * specialised for a specific series type in order to select a different container (e.g., piranha::flat_hash_set),
+ * which must provide the interface of piranha::hash_set (including its low-level interface). The specialisation must
+ * be visible before the series type is instantiated.
+ */
+template <typename Series>
+struct series_container {
+    /// Container type.
+    template <typename Term>
+    using type = hash_set<Term>;
+};
+
 /// Series class.
 /**
  * This class contains the arithmetic and comparison operator overloads for piranha::series instances
@@ -1297,10 +1325,15 @@ private:
     template <typename S1, typename S2, typename F>
     friend auto impl::series_merge_f(S1 &&s1, S2 &&s2, const F &f)
         -> decltype(f(std::forward<S1>(s1), std::forward<S2>(s2)));
+    // Friendship with the implementation of piranha::sum() and piranha::product().
+    friend struct impl::series_nary_ops;
 
 protected:
     /// Container type for terms.
-    using container_type = hash_set<term_type>;
+    /**
+     * The container type is selected via piranha::series_container, and it defaults to piranha::hash_set.
+     */
+    using container_type = typename series_container<Derived>::template type<term_type>;
 
 private:
     typedef decltype(std::declval<container_type>().evaluate_sparsity()) sparsity_info_type;
@@ -1435,11 +1468,149 @@ private:
             merge_terms_impl1<Sign>(std::forward<T>(s));
         }
     }
+    // Parallel merging of terms
+    // =========================
+    // Forward a term from the source container of a merge: copy from const terms, move from mutable ones.
+    static const term_type &merge_fwd(const term_type &t)
+    {
+        return t;
+    }
+    static term_type &&merge_fwd(term_type &t)
+    {
+        return std::move(t);
+    }
+    // Number of threads to be used for merging n terms into this series. A value of 1 selects the serial
+    // implementation.
+    static unsigned merge_n_threads(const size_type &n)
+    {
+        if (!n || n < tuning::get_parallel_merge_threshold()) {
+            return 1u;
+        }
+        return thread_pool::use_threads(integer(n), integer(settings::get_min_work_per_thread()));
+    }
+    // Multithreaded merge of the terms pointed to by the elements of src into this. The table is first grown
+    // so that no rehashing is needed during the merge. The buckets of the table are then split into n_threads
+    // contiguous zones (as done in sanitise_series()), each thread inserting the terms whose destination
+    // bucket falls in its zone. Since the zones are disjoint, no synchronisation is needed apart from the
+    // final update of the number of terms.
+    template <bool Sign, typename Ptr>
+    void parallel_merge_terms(const std::vector<Ptr> &src, unsigned n_threads)
+    {
+        piranha_assert(n_threads > 1u);
+        // Make room for all the terms, in the worst case.
+        const auto max_size = integer(m_container.size()) + src.size();
+        const auto n_buckets
+            = boost::numeric_cast<size_type>(std::ceil(static_cast<double>(max_size) / m_container.max_load_factor()));
+        if (m_container.bucket_count() < n_buckets) {
+            m_container.rehash(n_buckets, tuning::get_parallel_memory_set() ? n_threads : 1u);
+        }
+        const auto b_count = m_container.bucket_count();
+        piranha_assert(b_count);
+        // Each zone must contain at least one bucket.
+        if (b_count < n_threads) {
+            n_threads = static_cast<unsigned>(b_count);
+        }
+        // Zone of a bucket index.
+        const auto zone_size = static_cast<size_type>(b_count / n_threads);
+        auto zone = [zone_size, n_threads](const size_type &idx) {
+            return static_cast<unsigned>(std::min(static_cast<size_type>(idx / zone_size), size_type(n_threads - 1u)));
+        };
+        // Distribution of the source terms into the zones: dist[t][z] contains the terms processed by thread t in
+        // the first phase which belong to zone z, together with their destination bucket.
+        using dist_vector = std::vector<std::pair<Ptr, size_type>>;
+        std::vector<std::vector<dist_vector>> dist(n_threads, std::vector<dist_vector>(n_threads));
+        auto run_threads = [n_threads](const std::function<void(unsigned)> &f) {
+            future_list<void> f_list;
+            try {
+                for (unsigned i = 0u; i < n_threads; ++i) {
+                    f_list.push_back(thread_pool::enqueue(i, f, i));
+                }
+                // First let's wait for everything to finish.
+                f_list.wait_all();
+                // Then, let's handle the exceptions.
+                f_list.get_all();
+            } catch (...) {
+                f_list.wait_all();
+                throw;
+            }
+        };
+        const auto src_size = src.size();
+        auto distributor = [this, &src, &dist, &zone, src_size, n_threads](unsigned t) {
+            const auto start = (src_size / n_threads) * t,
+                       end = (t == n_threads - 1u) ? src_size : (src_size / n_threads) * (t + 1u);
+            auto &d = dist[t];
+            for (auto i = start; i != end; ++i) {
+                const auto b_idx = m_container._bucket(*src[i]);
+                d[zone(b_idx)].emplace_back(src[i], b_idx);
+            }
+        };
+        std::mutex m;
+        integer global_count(m_container.size());
+        const auto &args = m_symbol_set;
+        auto merger = [this, &dist, &m, &global_count, &args, n_threads](unsigned z) {
+            // Number of terms inserted into and erased from the zone.
+            size_type n_ins = 0u, n_del = 0u;
+            for (unsigned t = 0u; t < n_threads; ++t) {
+                for (const auto &p : dist[t][z]) {
+                    auto &term = *p.first;
+                    if (unlikely(!term.is_compatible(args))) {
+                        piranha_throw(std::invalid_argument, "cannot insert incompatible term");
+                    }
+                    if (unlikely(term.is_zero(args))) {
+                        continue;
+                    }
+                    const auto it = m_container._find(term, p.second);
+                    if (it == m_container.end()) {
+                        const auto new_it = m_container._unique_insert(merge_fwd(term), p.second);
+                        ++n_ins;
+                        if (!Sign) {
+                            math::negate(new_it->m_cf);
+                            if (unlikely(new_it->is_zero(args))) {
+                                // NOTE: must use _erase to avoid concurrent modifications
+                                // to the number of elements in the table.
+                                m_container._erase(new_it);
+                                ++n_del;
+                            }
+                        }
+                    } else {
+                        insertion_cf_arithmetics<Sign>(it, merge_fwd(term));
+                        if (unlikely(it->is_zero(args))) {
+                            m_container._erase(it);
+                            ++n_del;
+                        }
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(m);
+            global_count += n_ins;
+            global_count -= n_del;
+        };
+        try {
+            run_threads(distributor);
+            run_threads(merger);
+        } catch (...) {
+            // In case of errors, zero out this series.
+            m_container.clear();
+            throw;
+        }
+        // Final update of the total count.
+        m_container._update_size(static_cast<size_type>(global_count));
+    }
     // Overload if we cannot move objects from series.
     template <bool Sign, typename T>
     void merge_terms_impl1(T &&s, typename std::enable_if<!is_nonconst_rvalue_ref<T &&>::value>::type * = nullptr)
     {
         const auto it_f = s.m_container.end();
+        const auto n_threads = merge_n_threads(s.m_container.size());
+        if (n_threads > 1u) {
+            std::vector<term_type const *> src;
+            src.reserve(s.m_container.size());
+            for (auto it = s.m_container.begin(); it != it_f; ++it) {
+                src.push_back(&*it);
+            }
+            parallel_merge_terms<Sign>(src, n_threads);
+            return;
+        }
         try {
             for (auto it = s.m_container.begin(); it != it_f; ++it) {
                 insert<Sign>(*it);
@@ -1488,6 +1659,23 @@ private:
     template <bool Sign, typename T>
     void merge_terms_impl1(T &&s, typename std::enable_if<is_nonconst_rvalue_ref<T &&>::value>::type * = nullptr)
     {
+        const auto n_threads = merge_n_threads(s.m_container.size());
+        if (n_threads > 1u) {
+            std::vector<term_type *> src;
+            src.reserve(s.m_container.size());
+            const auto it_f = s.m_container._m_end();
+            for (auto it = s.m_container._m_begin(); it != it_f; ++it) {
+                src.push_back(&*it);
+            }
+            try {
+                parallel_merge_terms<Sign>(src, n_threads);
+            } catch (...) {
+                s.m_container.clear();
+                throw;
+            }
+            s.m_container.clear();
+            return;
+        }
         bool swap = false;
         // Try to steal memory from other.
         swap_for_merge(std::move(m_container), std::move(s.m_container), swap);
@@ -1933,31 +2121,14 @@ private:
     // Common checks on the exponent.
     template <typename T>
     using pow_expo_checks = conjunction<is_is_zero_type<const T &>, is_safely_castable<const T &, integer>>;
-    // Hashing utils for series.
-    struct series_hasher {
-        template <typename T>
-        std::size_t operator()(const T &s) const
-        {
-            return s.hash();
-        }
-    };
-    struct series_equal_to {
-        template <typename T>
-        bool operator()(const T &a, const T &b) const
-        {
-            return a.is_identical(b);
-        }
-    };
-    template <typename Series>
-    using pow_map_type = std::unordered_map<Series, std::vector<pow_m_type<Series>>, series_hasher, series_equal_to>;
     // NOTE: here, as in the custom derivative machinery, we need to pass through a static function
     // to get the cache because Derived is an incomplete type and we cannot thus use a static data member
     // involving Derived in series. Also, we need the Series template argument to inhibit the instantiation
     // of the function for series types that do not support exponentiation.
     template <typename Series = Derived>
-    static pow_map_type<Series> &get_pow_cache()
+    static detail::pow_cache<Series, pow_m_type<Series>> &get_pow_cache()
     {
-        static pow_map_type<Series> s_pow_cache;
+        static detail::pow_cache<Series, pow_m_type<Series>> s_pow_cache;
         return s_pow_cache;
     }
     // Empty for sfinae.
@@ -2311,7 +2482,9 @@ public:
      * - otherwise, an exception will be raised.
      *
      * An internal thread-safe cache of natural powers of series is maintained in order to improve performance during,
-     * e.g., substitution operations. This cache can be cleared with clear_pow_cache().
+     * e.g., substitution operations. Different series can be exponentiated concurrently, and the memory used by the
+     * cache is bounded by piranha::settings::get_pow_cache_memory_budget() (the least recently used entries are
+     * evicted when the budget is exceeded). This cache can be cleared with clear_pow_cache().
      *
      * @param x exponent.
      *
@@ -2335,16 +2508,14 @@ public:
         // NOTE: there are 3 types involved here:
         // - Derived,
         // - the return type (which is Derived or a rebound type from Derived),
-        // - the type of Derived * Derived.
+        // - the type of Derived * Derived (the type of the powers stored in the cache).
         using ret_type = pow_ret_type<T, U>;
         using r_term_type = typename ret_type::term_type;
         using r_cf_type = typename r_term_type::cf_type;
         using cf_type = typename term_type::cf_type;
         using key_type = typename term_type::key_type;
-        using m_type = pow_m_type<Derived>;
-        using m_term_type = typename m_type::term_type;
-        using m_cf_type = typename m_term_type::cf_type;
-        using m_key_type = typename m_term_type::key_type;
+        profiler::scope prof("series.pow");
+        prof.count("terms", size());
         // Handle the case of single coefficient series.
         if (is_single_coefficient()) {
             ret_type retval;
@@ -2372,23 +2543,7 @@ public:
         if (n.sgn() < 0) {
             piranha_throw(std::invalid_argument, "invalid argument for series exponentiation: negative integral value");
         }
-        // Lock the cache for the rest of the method.
-        std::lock_guard<std::mutex> lock(s_pow_mutex);
-        auto &v = get_pow_cache()[*static_cast<Derived const *>(this)];
-        using s_type = decltype(v.size());
-        // Init the vector, if needed.
-        if (!v.size()) {
-            m_type tmp;
-            tmp.insert(m_term_type(m_cf_type(1), m_key_type(symbol_fset{})));
-            v.push_back(std::move(tmp));
-        }
-        // Fill in the missing powers.
-        while (v.size() <= n) {
-            // NOTE: for series it seems like it is better to run the dumb algorithm instead of, e.g.,
-            // exponentiation by squaring - the growth in number of terms seems to be slower.
-            v.push_back(v.back() * (*static_cast<Derived const *>(this)));
-        }
-        return ret_type(v[static_cast<s_type>(n)]);
+        return get_pow_cache().template get<ret_type>(*static_cast<Derived const *>(this), n);
     }
     /// Clear the internal cache of natural powers.
     /**
@@ -2399,7 +2554,6 @@ public:
     template <typename T = Derived, is_identical_enabler<T> = 0>
     static void clear_pow_cache()
     {
-        std::lock_guard<std::mutex> lock(s_pow_mutex);
         get_pow_cache().clear();
     }
     /// Partial derivative.
@@ -2828,6 +2982,29 @@ public:
     }
     //@}
 protected:
+    /// Cached exponentiation.
+    /**
+     * \note
+     * This method can be used only if the type of the product of two \p Derived instances is \p Derived.
+     *
+     * This method returns the <tt>n</tt>-th power of \p this, looked up in (or added to) the cache of natural powers
+     * maintained by pow(). If the power is not in the cache, <tt>direct(b, n, out)</tt> is called first,
+     * where \p b is a copy of \p this: if \p direct returns \p true, then \p out must contain the <tt>n</tt>-th
+     * power of \p b, otherwise the power is computed via repeated multiplications. This allows derived series to
+     * supply faster exponentiation algorithms, without giving up the caching of the results.
+     *
+     * @param n the exponent (which must be non-negative).
+     * @param direct the functor for the direct computation of the power.
+     *
+     * @return \p this raised to the power of \p n, converted to \p Ret.
+     *
+     * @throws unspecified any exception thrown by \p direct, by pow() or by the construction of \p Ret.
+     */
+    template <typename Ret, typename F>
+    Ret cached_pow(const integer &n, const F &direct) const
+    {
+        return get_pow_cache().template get<Ret>(*static_cast<Derived const *>(this), n, direct);
+    }
     /// Symbol set.
     symbol_fset m_symbol_set;
     /// Terms container.
@@ -2836,16 +3013,11 @@ protected:
 private:
     // Custom derivatives machinery.
     static std::mutex s_cp_mutex;
-    // Pow cache machinery;
-    static std::mutex s_pow_mutex;
 };
 
 template <typename Cf, typename Key, typename Derived>
 std::mutex series<Cf, Key, Derived>::s_cp_mutex;
 
-template <typename Cf, typename Key, typename Derived>
-std::mutex series<Cf, Key, Derived>::s_pow_mutex;
-
 inline namespace impl
 {
 
@@ -2891,8 +3063,208 @@ inline auto series_merge_f(S1 &&s1, S2 &&s2, const F &f) -> decltype(f(std::forw
     return f(s1.merge_arguments(std::get<0>(merge), std::get<1>(merge)),
              s2.merge_arguments(std::get<0>(merge), std::get<2>(merge)));
 }
+
+// Implementation of the n-ary sum and product of series.
+struct series_nary_ops {
+    // Union of the symbol sets of the series in [begin, end).
+    template <typename It>
+    static symbol_fset merged_symbol_set(It begin, It end)
+    {
+        symbol_fset retval;
+        for (auto it = begin; it != end; ++it) {
+            retval.insert(it->get_symbol_set().begin(), it->get_symbol_set().end());
+        }
+        return retval;
+    }
+    // Copy of s with its symbol set extended to ss (which must be a superset of the symbol set of s).
+    template <typename S>
+    static S extend_symbol_set(const S &s, const symbol_fset &ss)
+    {
+        return s.merge_arguments(ss, std::get<1>(ss_merge(s.get_symbol_set(), ss)));
+    }
+    template <typename It>
+    static uncvref_t<decltype(*std::declval<const It &>())> sum(It begin, It end)
+    {
+        using s_type = uncvref_t<decltype(*std::declval<const It &>())>;
+        using size_type = typename s_type::size_type;
+        s_type retval;
+        if (begin == end) {
+            return retval;
+        }
+        const auto ss = merged_symbol_set(begin, end);
+        retval.set_symbol_set(ss);
+        // Reserve space in the table for the largest possible number of terms, so that
+        // no rehashing will be needed.
+        integer n_terms(0);
+        for (auto it = begin; it != end; ++it) {
+            n_terms += it->size();
+        }
+        auto &container = retval._container();
+        container.rehash(boost::numeric_cast<size_type>(
+            std::ceil(static_cast<double>(n_terms) / container.max_load_factor())));
+        for (auto it = begin; it != end; ++it) {
+            if (it->get_symbol_set() == ss) {
+                retval.template merge_terms<true>(*it);
+            } else {
+                retval.template merge_terms<true>(extend_symbol_set(*it, ss));
+            }
+        }
+        return retval;
+    }
+    template <typename It>
+    static uncvref_t<decltype(*std::declval<const It &>())> product(It begin, It end)
+    {
+        using s_type = uncvref_t<decltype(*std::declval<const It &>())>;
+        if (begin == end) {
+            return s_type(1);
+        }
+        const auto ss = merged_symbol_set(begin, end);
+        // Storage for the factors whose symbol sets must be extended, and for the intermediate products.
+        std::list<s_type> owned;
+        // A factor: pointer to the series and, if the series is in owned, its position.
+        using factor = std::pair<const s_type *, typename std::list<s_type>::iterator>;
+        std::vector<factor> heap;
+        for (auto it = begin; it != end; ++it) {
+            if (it->get_symbol_set() == ss) {
+                heap.emplace_back(&*it, owned.end());
+            } else {
+                owned.push_back(extend_symbol_set(*it, ss));
+                heap.emplace_back(&owned.back(), std::prev(owned.end()));
+            }
+            if (heap.back().first->empty()) {
+                // Zero factor.
+                s_type retval;
+                retval.set_symbol_set(ss);
+                return retval;
+            }
+        }
+        // Multiply the two smallest factors at each step, in order to keep the intermediate
+        // products as small as possible.
+        auto cmp = [](const factor &f1, const factor &f2) { return f1.first->size() > f2.first->size(); };
+        std::make_heap(heap.begin(), heap.end(), cmp);
+        auto pop = [&heap, &cmp]() {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            const auto retval = heap.back();
+            heap.pop_back();
+            return retval;
+        };
+        while (heap.size() > 1u) {
+            const auto f1 = pop(), f2 = pop();
+            owned.push_back(*f1.first * *f2.first);
+            // Free the memory of the factors which are not needed any more.
+            for (const auto &f : {f1, f2}) {
+                if (f.second != owned.end()) {
+                    owned.erase(f.second);
+                }
+            }
+            heap.emplace_back(&owned.back(), std::prev(owned.end()));
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+        if (heap.back().second != owned.end()) {
+            return std::move(*heap.back().second);
+        }
+        return *heap.back().first;
+    }
+};
+
+template <typename It>
+using series_nary_enabler = enable_if_t<is_series<uncvref_t<decltype(*std::declval<const It &>())>>::value, int>;
+
+template <typename Range>
+using series_range_enabler = series_nary_enabler<decltype(std::begin(std::declval<const Range &>()))>;
 } // namespace impl
 
+/// Sum of a range of series.
+/**
+ * \note
+ * This function is enabled only if the value type of \p It is an instance of piranha::series.
+ *
+ * This function will return the sum of the series in the range [\p begin, \p end). The symbol sets of the series
+ * are merged once, and the table of terms of the return value is sized in advance so that it can contain the terms
+ * of all the series without rehashing. The sum of an empty range is zero.
+ *
+ * @param begin the beginning of the range.
+ * @param end the end of the range.
+ *
+ * @return the sum of the series in the range.
+ *
+ * @throws unspecified any exception thrown by:
+ * - the public interface of piranha::hash_set and piranha::symbol_fset,
+ * - piranha::ss_merge(),
+ * - the addition of the series' terms,
+ * - \p boost::numeric_cast().
+ */
+template <typename It, series_nary_enabler<It> = 0>
+inline uncvref_t<decltype(*std::declval<const It &>())> sum(It begin, It end)
+{
+    return series_nary_ops::sum(begin, end);
+}
+
+/// Sum of a range of series.
+/**
+ * \note
+ * This function is enabled only if the value type of \p Range is an instance of piranha::series.
+ *
+ * Equivalent to <tt>piranha::sum(std::begin(r), std::end(r))</tt>.
+ *
+ * @param r the input range.
+ *
+ * @return the sum of the series in \p r.
+ *
+ * @throws unspecified any exception thrown by the iterator overload of piranha::sum().
+ */
+template <typename Range, series_range_enabler<Range> = 0>
+inline auto sum(const Range &r) -> decltype(piranha::sum(std::begin(r), std::end(r)))
+{
+    return piranha::sum(std::begin(r), std::end(r));
+}
+
+/// Product of a range of series.
+/**
+ * \note
+ * This function is enabled only if the value type of \p It is an instance of piranha::series.
+ *
+ * This function will return the product of the series in the range [\p begin, \p end). The symbol sets of the
+ * series are merged once, and the multiplications are performed pairing up at each step the two factors with the
+ * smallest number of terms, so that the intermediate products are kept as small as possible. Intermediate
+ * products are released as soon as they are consumed. The product of an empty range is one.
+ *
+ * @param begin the beginning of the range.
+ * @param end the end of the range.
+ *
+ * @return the product of the series in the range.
+ *
+ * @throws unspecified any exception thrown by:
+ * - the public interface of piranha::symbol_fset,
+ * - piranha::ss_merge(),
+ * - series multiplication,
+ * - memory errors in standard containers.
+ */
+template <typename It, series_nary_enabler<It> = 0>
+inline uncvref_t<decltype(*std::declval<const It &>())> product(It begin, It end)
+{
+    return series_nary_ops::product(begin, end);
+}
+
+/// Product of a range of series.
+/**
+ * \note
+ * This function is enabled only if the value type of \p Range is an instance of piranha::series.
+ *
+ * Equivalent to <tt>piranha::product(std::begin(r), std::end(r))</tt>.
+ *
+ * @param r the input range.
+ *
+ * @return the product of the series in \p r.
+ *
+ * @throws unspecified any exception thrown by the iterator overload of piranha::product().
+ */
+template <typename Range, series_range_enabler<Range> = 0>
+inline auto product(const Range &r) -> decltype(piranha::product(std::begin(r), std::end(r)))
+{
+    return piranha::product(std::begin(r), std::end(r));
+}
+
 /// Specialisation of piranha::print_coefficient_impl for series.
 /**
  * This specialisation is enabled if \p Series is an instance of piranha::series.
@@ -3426,6 +3798,7 @@ struct integrate_impl<Series, detail::series_integrate_enabler<Series>> {
         return s.integrate(name);
     }
 };
+} // namespace math
 
 inline namespace impl
 {
@@ -3438,6 +3811,55 @@ using series_eval_type = decltype(
     * std::declval<const typename Series::term_type::key_type &>().evaluate(std::declval<const std::vector<T> &>(),
                                                                             std::declval<const symbol_fset &>()));
 
+// Build the vector of values to be used for the evaluation of the keys of a series with symbol set ss,
+// picking the values from dict.
+template <typename T>
+inline std::vector<T> series_evaluation_vector(const symbol_fset &ss, const symbol_fmap<T> &dict)
+{
+    std::vector<T> evec;
+    evec.reserve(piranha::safe_cast<typename std::vector<T>::size_type>(ss.size()));
+
+    auto it_dict = dict.begin();
+    const auto it_dict_f = dict.end();
+    for (const auto &sym : ss) {
+        // Try to locate the current sym in the
+        // [it_dict, it_dict_f) range. Store the result in it_dict.
+        it_dict = std::lower_bound(
+            it_dict, it_dict_f, sym,
+            [](const std::pair<std::string, T> &p, const std::string &str) { return p.first < str; });
+        // NOTE: if it_dict != it_dict_f, we found a value in the dict range which is >= sym,
+        // but we still need to check it is really the same.
+        if (unlikely(it_dict == it_dict_f || it_dict->first != sym)) {
+            // The it_ss value was not found: we cannot evaluate.
+            piranha_throw(std::invalid_argument, "cannot evaluate series: the symbol '" + sym
+                                                     + "' is missing from the series evaluation dictionary'");
+        }
+        // Append the value mapped to the current ss symbol to the vector.
+        evec.push_back(it_dict->second);
+        // NOTE: we increase it_dict at the end of the iteration because, if we
+        // get there, it means we identified a symbol of ss in dict. For the next
+        // iteration of the for loop we want to start looking for the next ss symbol
+        // right *after* the element in dict we just found.
+        ++it_dict;
+    }
+    piranha_assert(evec.size() == ss.size());
+    return evec;
+}
+
+// Accumulate the product of the evaluations of coefficient and key into retval, either via
+// math::multiply_accumulate(), if supported, or just plain math operators.
+template <typename E, enable_if_t<has_multiply_accumulate<E>::value, int> = 0>
+inline void series_eval_multadd(E &retval, const E &a, const E &b)
+{
+    math::multiply_accumulate(retval, a, b);
+}
+
+template <typename E1, typename E2, typename E3>
+inline void series_eval_multadd(E1 &retval, const E2 &a, const E3 &b)
+{
+    retval += a * b;
+}
+
 template <typename Series, typename T>
 using math_series_evaluate_enabler = enable_if_t<
     conjunction<is_series<Series>, is_addable_in_place<series_eval_type<Series, T>>,
@@ -3445,6 +3867,9 @@ using math_series_evaluate_enabler = enable_if_t<
                 std::is_destructible<T>, std::is_copy_constructible<T>, std::is_move_constructible<T>>::value>;
 } // namespace impl
 
+namespace math
+{
+
 /// Specialisation of the implementation of piranha::math::evaluate() for series types.
 /**
  * This specialisation is activated when all the following conditions hold:
@@ -3459,18 +3884,6 @@ template <typename Series, typename T>
 class evaluate_impl<Series, T, math_series_evaluate_enabler<Series, T>>
 {
     using eval_type = series_eval_type<Series, T>;
-    // Wrapper to do multadd either via math::multiply_accumulate(), if supported, or just
-    // plain math operators.
-    template <typename E, enable_if_t<has_multiply_accumulate<E>::value, int> = 0>
-    static void multadd(E &retval, const E &a, const E &b)
-    {
-        math::multiply_accumulate(retval, a, b);
-    }
-    template <typename E1, typename E2, typename E3>
-    static void multadd(E1 &retval, const E2 &a, const E3 &b)
-    {
-        retval += a * b;
-    }
 
 public:
     /// Call operator.
@@ -3503,38 +3916,12 @@ public:
         const auto &ss = s.get_symbol_set();
 
         // Init the vector that will be used for key evaluation.
-        std::vector<T> evec;
-        evec.reserve(piranha::safe_cast<decltype(evec.size())>(ss.size()));
-
-        auto it_dict = dict.begin();
-        const auto it_dict_f = dict.end();
-        for (const auto &sym : ss) {
-            // Try to locate the current sym in the
-            // [it_dict, it_dict_f) range. Store the result in it_dict.
-            it_dict = std::lower_bound(
-                it_dict, it_dict_f, sym,
-                [](const std::pair<std::string, T> &p, const std::string &str) { return p.first < str; });
-            // NOTE: if it_dict != it_dict_f, we found a value in the dict range which is >= sym,
-            // but we still need to check it is really the same.
-            if (unlikely(it_dict == it_dict_f || it_dict->first != sym)) {
-                // The it_ss value was not found: we cannot evaluate.
-                piranha_throw(std::invalid_argument, "cannot evaluate series: the symbol '" + sym
-                                                         + "' is missing from the series evaluation dictionary'");
-            }
-            // Append the value mapped to the current ss symbol to the vector.
-            evec.push_back(it_dict->second);
-            // NOTE: we increase it_dict at the end of the iteration because, if we
-            // get there, it means we identified a symbol of ss in dict. For the next
-            // iteration of the for loop we want to start looking for the next ss symbol
-            // right *after* the element in dict we just found.
-            ++it_dict;
-        }
-        piranha_assert(evec.size() == ss.size());
+        const auto evec = series_evaluation_vector(ss, dict);
 
         // Init the return value and accumulate it.
         eval_type retval(0);
         for (const auto &t : s._container()) {
-            multadd(retval, math::evaluate(t.m_cf, dict), t.m_key.evaluate(evec, ss));
+            series_eval_multadd(retval, math::evaluate(t.m_cf, dict), t.m_key.evaluate(evec, ss));
         }
         return retval;
     }
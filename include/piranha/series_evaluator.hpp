@@ -0,0 +1,551 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_SERIES_EVALUATOR_HPP
+#define PIRANHA_SERIES_EVALUATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/init.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/frozen_series.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_array.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Extraction of the exponents of monomial-like keys. The default implementation marks
+// the key as not supported: the evaluation of these keys will go through their evaluate() method.
+template <typename Key, typename = void>
+struct se_key_expos {
+    static const bool value = false;
+};
+
+// Kronecker monomials: the codes are decoded in one go via kronecker_array::decode_range().
+template <typename T>
+struct se_key_expos<kronecker_monomial<T>> {
+    static const bool value = true;
+    using expo_type = T;
+    static void unpack(expo_type *out, const std::vector<kronecker_monomial<T>> &keys, const symbol_fset &ss)
+    {
+        using ka = kronecker_array<T>;
+        const auto m = static_cast<typename ka::size_type>(ss.size());
+        if (unlikely(m >= ka::get_limits().size())) {
+            piranha_throw(std::invalid_argument, "the size of the symbol set is too large for Kronecker decoding");
+        }
+        std::vector<T> codes;
+        codes.reserve(keys.size());
+        for (const auto &k : keys) {
+            codes.push_back(k.get_int());
+        }
+        ka::decode_range(out, codes.data(), codes.size(), m);
+    }
+};
+
+// Monomials with integral exponents.
+template <typename T, typename S>
+struct se_key_expos<monomial<T, S>, enable_if_t<std::is_integral<T>::value>> {
+    static const bool value = true;
+    using expo_type = T;
+    static void unpack(expo_type *out, const std::vector<monomial<T, S>> &keys, const symbol_fset &ss)
+    {
+        for (const auto &k : keys) {
+            if (unlikely(k.size() != ss.size())) {
+                piranha_throw(std::invalid_argument, "cannot evaluate monomial: the size of the symbol set ("
+                                                         + std::to_string(ss.size())
+                                                         + ") differs from the size of the monomial ("
+                                                         + std::to_string(k.size()) + ")");
+            }
+            out = std::copy(k.begin(), k.end(), out);
+        }
+    }
+};
+} // namespace impl
+
+/// Series evaluator.
+/**
+ * This class is meant for the repeated evaluation of the same series with different evaluation
+ * dictionaries (e.g., the evaluation of a time series at many epochs). The results of the evaluation are
+ * the same as those of piranha::math::evaluate(), up to the order in which the contributions of the terms
+ * are accumulated.
+ *
+ * Upon construction, the terms of the series are stored in a piranha::frozen_series. If the key type is
+ * piranha::kronecker_monomial or piranha::monomial with integral exponents, the exponents of all the keys are
+ * also decoded once and for all, and the range of the exponents of each symbol is recorded. Each evaluation
+ * will then:
+ * - compute via piranha::pow() a table of the powers of each value of the evaluation dictionary,
+ *   spanning the exponent range of the corresponding symbol,
+ * - split the terms among the threads of piranha::thread_pool, each thread accumulating a partial sum
+ *   in which the evaluation of each key is computed by multiplying entries from the power tables,
+ * - sum the partial results.
+ *
+ * For other key types, the keys are evaluated via their <tt>evaluate()</tt> method.
+ *
+ * \p Series must satisfy piranha::is_series, otherwise a compile-time error will be emitted.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Series>
+class series_evaluator
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+    using key_type = typename Series::term_type::key_type;
+    using size_type = typename frozen_series<Series>::size_type;
+    // Storage for the exponents, if supported by the key type.
+    template <typename K, typename = void>
+    struct expo_storage {
+        void init(const frozen_series<Series> &)
+        {
+        }
+    };
+    template <typename K>
+    struct expo_storage<K, enable_if_t<se_key_expos<K>::value>> {
+        using expo_type = typename se_key_expos<K>::expo_type;
+        void init(const frozen_series<Series> &fs)
+        {
+            const auto &ss = fs.get_symbol_set();
+            const auto m = ss.size();
+            m_expos.resize(static_cast<typename std::vector<expo_type>::size_type>(integer(fs.size()) * m));
+            se_key_expos<K>::unpack(m_expos.data(), fs.keys(), ss);
+            // Determine the range of the exponents of each symbol.
+            m_bounds.clear();
+            if (!fs.size()) {
+                return;
+            }
+            for (decltype(ss.size()) i = 0u; i < m; ++i) {
+                m_bounds.emplace_back(m_expos[i], m_expos[i]);
+            }
+            for (size_type j = 1u; j < fs.size(); ++j) {
+                const auto ptr = m_expos.data() + j * m;
+                for (decltype(ss.size()) i = 0u; i < m; ++i) {
+                    m_bounds[i].first = std::min(m_bounds[i].first, ptr[i]);
+                    m_bounds[i].second = std::max(m_bounds[i].second, ptr[i]);
+                }
+            }
+        }
+        std::vector<expo_type> m_expos;
+        std::vector<std::pair<expo_type, expo_type>> m_bounds;
+    };
+    // Type resulting from the evaluation of a key.
+    template <typename T>
+    using key_eval_type = decltype(std::declval<const key_type &>().evaluate(std::declval<const std::vector<T> &>(),
+                                                                            std::declval<const symbol_fset &>()));
+    // Enabler for the call operator.
+    template <typename T>
+    using eval_enabler = enable_if_t<conjunction<std::is_same<math_series_evaluate_enabler<Series, T>, void>,
+                                                 is_returnable<key_eval_type<T>>,
+                                                 std::is_copy_constructible<series_eval_type<Series, T>>>::value,
+                                     int>;
+
+public:
+    /// Constructor.
+    /**
+     * @param s the series that will be evaluated.
+     *
+     * @throws std::invalid_argument if the keys of \p s are inconsistent with its symbol set.
+     * @throws unspecified any exception thrown by:
+     * - the constructor of piranha::frozen_series,
+     * - memory errors in standard containers,
+     * - piranha::kronecker_array::decode_range(),
+     * - piranha::safe_cast().
+     */
+    explicit series_evaluator(const Series &s) : m_fs(s)
+    {
+        m_expo_storage.init(m_fs);
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This operator is enabled only if piranha::math::evaluate() is enabled for \p Series and \p T.
+     *
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating the series according to the evaluation dictionary \p dict.
+     *
+     * @throws std::invalid_argument if a symbol of the series does not appear in \p dict.
+     * @throws unspecified any exception thrown by:
+     * - coefficient and key evaluation,
+     * - piranha::pow(),
+     * - memory errors in standard containers,
+     * - arithmetic operations on the evaluation type,
+     * - threading primitives and thread_pool::use_threads().
+     */
+    template <typename T, eval_enabler<T> = 0>
+    series_eval_type<Series, T> operator()(const symbol_fmap<T> &dict) const
+    {
+        using eval_type = series_eval_type<Series, T>;
+        const auto evec = series_evaluation_vector(m_fs.get_symbol_set(), dict);
+        const auto size = m_fs.size();
+        if (!size) {
+            return eval_type(0);
+        }
+        // Build the power tables (if supported by the key type).
+        const auto tables = build_tables<key_type>(evec);
+        const unsigned n_threads
+            = thread_pool::use_threads(integer(size), integer(settings::get_min_work_per_thread()));
+        // Evaluate the terms in the [begin, end) range, accumulating into retval.
+        auto eval_range = [this, &dict, &evec, &tables](size_type begin, size_type end, eval_type &retval) {
+            const auto &cfs = this->m_fs.cfs();
+            for (; begin != end; ++begin) {
+                series_eval_multadd(retval, math::evaluate(cfs[begin], dict),
+                                    this->template key_eval<key_type>(begin, evec, tables));
+            }
+        };
+        if (n_threads == 1u) {
+            eval_type retval(0);
+            eval_range(0u, size, retval);
+            return retval;
+        }
+        // Per-thread partial sums.
+        std::vector<eval_type> partials(n_threads, eval_type(0));
+        const auto block_size = size / n_threads;
+        auto thread_func = [&eval_range, &partials, block_size, size, n_threads](unsigned t_idx) {
+            const auto begin = static_cast<size_type>(t_idx * block_size),
+                       end = (t_idx == n_threads - 1u) ? size : static_cast<size_type>((t_idx + 1u) * block_size);
+            eval_range(begin, end, partials[t_idx]);
+        };
+        future_list<void> f_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                f_list.push_back(thread_pool::enqueue(i, thread_func, i));
+            }
+            // First let's wait for everything to finish.
+            f_list.wait_all();
+            // Then, let's handle the exceptions.
+            f_list.get_all();
+        } catch (...) {
+            f_list.wait_all();
+            throw;
+        }
+        // Reduce the partial sums, in thread order.
+        eval_type retval(std::move(partials[0u]));
+        for (unsigned i = 1u; i < n_threads; ++i) {
+            retval += partials[i];
+        }
+        return retval;
+    }
+    /// Batch evaluation.
+    /**
+     * \note
+     * This method is enabled only if piranha::math::evaluate() is enabled for \p Series and \p T.
+     *
+     * This method will evaluate the series at multiple points. The dictionary \p dict associates to each symbol
+     * the vector of its values at the evaluation points: the <tt>i</tt>-th element of the return value
+     * is the result of the evaluation of the series with each symbol replaced by the <tt>i</tt>-th element of
+     * the associated vector.
+     *
+     * If the key type supports the decoding of the exponents (see the class documentation) and the coefficient
+     * type is not a series, the coefficients are evaluated only once, and the evaluation is performed in a single
+     * pass over the terms for blocks of evaluation points. The power tables are laid out so that the work on each
+     * term is a sequence of loops over the points of the block on contiguous memory, which, for floating-point
+     * types, the compiler can vectorise. The blocks of points are split among the threads of
+     * piranha::thread_pool. The result for each point is the same as the one computed by
+     * piranha::math::evaluate(), as the contributions of the terms are accumulated in the same order.
+     *
+     * Otherwise, the series is evaluated separately at each point via operator()().
+     *
+     * @param dict the dictionary of the evaluation values.
+     *
+     * @return the results of the evaluation of the series at each point.
+     *
+     * @throws std::invalid_argument if \p dict is empty, if the vectors in \p dict do not all have the same size,
+     * or if a symbol of the series does not appear in \p dict.
+     * @throws unspecified any exception thrown by:
+     * - operator()(),
+     * - coefficient evaluation,
+     * - piranha::pow(),
+     * - memory errors in standard containers,
+     * - arithmetic operations on the evaluation type,
+     * - threading primitives and thread_pool::use_threads().
+     */
+    template <typename T, eval_enabler<T> = 0>
+    std::vector<series_eval_type<Series, T>> batch(const symbol_fmap<std::vector<T>> &dict) const
+    {
+        if (unlikely(dict.empty())) {
+            piranha_throw(std::invalid_argument,
+                          "cannot determine the number of evaluation points from an empty dictionary");
+        }
+        const auto n_points = dict.begin()->second.size();
+        for (const auto &p : dict) {
+            if (unlikely(p.second.size() != n_points)) {
+                piranha_throw(std::invalid_argument, "inconsistent number of evaluation points in batch evaluation: "
+                                                     "the symbol '"
+                                                         + p.first + "' is associated to "
+                                                         + std::to_string(p.second.size()) + " values instead of "
+                                                         + std::to_string(n_points));
+            }
+        }
+        return batch_impl(dict, n_points, batch_tag{});
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms in the evaluated series.
+     */
+    size_type size() const
+    {
+        return m_fs.size();
+    }
+
+private:
+    // Power tables: for each symbol, the powers of the evaluation value spanning the exponent range of the symbol.
+    // If the range is wider than the number of terms, the table would cost more than computing the powers
+    // on the fly: in such case the table of the symbol is left empty.
+    template <typename T>
+    using table_type = std::vector<std::vector<key_eval_type<T>>>;
+    template <typename K, typename T, enable_if_t<se_key_expos<K>::value, int> = 0>
+    table_type<T> build_tables(const std::vector<T> &evec) const
+    {
+        const auto &bounds = m_expo_storage.m_bounds;
+        piranha_assert(bounds.size() == evec.size());
+        table_type<T> retval(evec.size());
+        for (decltype(evec.size()) i = 0u; i < evec.size(); ++i) {
+            if (integer(bounds[i].second) - integer(bounds[i].first) >= integer(m_fs.size())) {
+                continue;
+            }
+            for (auto e = bounds[i].first;; ++e) {
+                retval[i].emplace_back(piranha::pow(evec[i], e));
+                if (e == bounds[i].second) {
+                    break;
+                }
+            }
+        }
+        return retval;
+    }
+    template <typename K, typename T, enable_if_t<!se_key_expos<K>::value, int> = 0>
+    table_type<T> build_tables(const std::vector<T> &) const
+    {
+        return table_type<T>{};
+    }
+    // Evaluation of the key at index idx.
+    template <typename K, typename T, enable_if_t<se_key_expos<K>::value, int> = 0>
+    key_eval_type<T> key_eval(const size_type &idx, const std::vector<T> &evec, const table_type<T> &tables) const
+    {
+        const auto m = tables.size();
+        if (!m) {
+            return key_eval_type<T>(1);
+        }
+        const auto &bounds = m_expo_storage.m_bounds;
+        const auto ptr = m_expo_storage.m_expos.data() + idx * m;
+        using t_size_type = typename table_type<T>::value_type::size_type;
+        // NOTE: the order of the multiplications is the same as in the evaluate() method of the key.
+        key_eval_type<T> retval(tables[0u].empty()
+                                    ? key_eval_type<T>(piranha::pow(evec[0u], ptr[0u]))
+                                    : tables[0u][static_cast<t_size_type>(ptr[0u] - bounds[0u].first)]);
+        for (decltype(tables.size()) i = 1u; i < m; ++i) {
+            if (tables[i].empty()) {
+                retval *= piranha::pow(evec[i], ptr[i]);
+            } else {
+                retval *= tables[i][static_cast<t_size_type>(ptr[i] - bounds[i].first)];
+            }
+        }
+        return retval;
+    }
+    template <typename K, typename T, enable_if_t<!se_key_expos<K>::value, int> = 0>
+    key_eval_type<T> key_eval(const size_type &idx, const std::vector<T> &evec, const table_type<T> &) const
+    {
+        return m_fs.keys()[idx].evaluate(evec, m_fs.get_symbol_set());
+    }
+    // Batch evaluation. The single-pass implementation requires the decoding of the exponents and coefficients
+    // whose evaluation does not depend on the evaluation dictionary.
+    using batch_tag = std::integral_constant<
+        bool, se_key_expos<key_type>::value && !is_series<typename Series::term_type::cf_type>::value>;
+    template <typename T, typename V>
+    std::vector<series_eval_type<Series, T>> batch_impl(const symbol_fmap<std::vector<T>> &dict, const V &n_points,
+                                                        const std::false_type &) const
+    {
+        std::vector<series_eval_type<Series, T>> retval;
+        retval.reserve(n_points);
+        symbol_fmap<T> point_dict;
+        for (const auto &p : dict) {
+            point_dict.emplace_hint(point_dict.end(), p.first, T{});
+        }
+        for (V i = 0u; i < n_points; ++i) {
+            auto it = point_dict.begin();
+            for (const auto &p : dict) {
+                it->second = p.second[i];
+                ++it;
+            }
+            retval.push_back((*this)(point_dict));
+        }
+        return retval;
+    }
+    template <typename T, typename V>
+    std::vector<series_eval_type<Series, T>> batch_impl(const symbol_fmap<std::vector<T>> &dict, const V &n_points,
+                                                        const std::true_type &) const
+    {
+        using eval_type = series_eval_type<Series, T>;
+        using k_eval_type = key_eval_type<T>;
+        using cf_eval_type = decltype(math::evaluate(std::declval<const typename Series::term_type::cf_type &>(),
+                                                     std::declval<const symbol_fmap<T> &>()));
+        // The vectors of values, in the order of the symbol set of the series.
+        const auto cols = series_evaluation_vector(m_fs.get_symbol_set(), dict);
+        std::vector<eval_type> retval(n_points, eval_type(0));
+        const auto size = m_fs.size();
+        if (!size || !n_points) {
+            return retval;
+        }
+        // The coefficients are not series, hence their evaluation does not depend on the dictionary.
+        std::vector<cf_eval_type> cf_vals;
+        cf_vals.reserve(size);
+        const symbol_fmap<T> empty_dict;
+        for (const auto &cf : m_fs.cfs()) {
+            cf_vals.push_back(math::evaluate(cf, empty_dict));
+        }
+        const auto m = cols.size();
+        const auto &bounds = m_expo_storage.m_bounds;
+        const auto &expos = m_expo_storage.m_expos;
+        piranha_assert(bounds.size() == m);
+        // Same criterion as in build_tables().
+        std::vector<char> use_table(m);
+        for (decltype(cols.size()) i = 0u; i < m; ++i) {
+            use_table[i] = integer(bounds[i].second) - integer(bounds[i].first) < integer(size);
+        }
+        // The points are processed in blocks: for each block, the power tables and the temporary values
+        // of the keys fit comfortably in cache.
+        const V block_size = 64u, n_blocks = (n_points - 1u) / block_size + 1u;
+        const unsigned n_threads = static_cast<unsigned>(
+            std::min(integer(thread_pool::use_threads(integer(size) * n_points,
+                                                      integer(settings::get_min_work_per_thread()))),
+                     integer(n_blocks)));
+        auto thread_func = [&](unsigned t_idx) {
+            using t_size_type = typename std::vector<k_eval_type>::size_type;
+            std::vector<std::vector<k_eval_type>> tables(m);
+            std::vector<k_eval_type> tmp;
+            const auto b_begin = static_cast<V>(integer(n_blocks) * t_idx / n_threads),
+                       b_end = static_cast<V>(integer(n_blocks) * (t_idx + 1u) / n_threads);
+            for (auto b = b_begin; b != b_end; ++b) {
+                const auto begin = b * block_size, len = std::min(block_size, n_points - begin);
+                // Tables of powers, in exponent-major order.
+                for (decltype(cols.size()) i = 0u; i < m; ++i) {
+                    if (!use_table[i]) {
+                        continue;
+                    }
+                    tables[i].clear();
+                    for (auto e = bounds[i].first;; ++e) {
+                        for (V p = 0u; p < len; ++p) {
+                            tables[i].emplace_back(piranha::pow(cols[i][begin + p], e));
+                        }
+                        if (e == bounds[i].second) {
+                            break;
+                        }
+                    }
+                }
+                // NOTE: if the series has no symbols, the values of the keys are all 1 and tmp
+                // is never overwritten.
+                tmp.resize(static_cast<t_size_type>(len), k_eval_type(1));
+                const auto out = retval.data() + begin;
+                for (size_type j = 0u; j < size; ++j) {
+                    const auto ptr = expos.data() + j * m;
+                    // NOTE: the order of the multiplications is the same as in the evaluate() method of the key.
+                    for (decltype(cols.size()) i = 0u; i < m; ++i) {
+                        const auto col = cols[i].data() + begin;
+                        if (use_table[i]) {
+                            const auto tab
+                                = tables[i].data() + static_cast<t_size_type>(ptr[i] - bounds[i].first) * len;
+                            if (i) {
+                                for (V p = 0u; p < len; ++p) {
+                                    tmp[p] *= tab[p];
+                                }
+                            } else {
+                                for (V p = 0u; p < len; ++p) {
+                                    tmp[p] = tab[p];
+                                }
+                            }
+                        } else {
+                            if (i) {
+                                for (V p = 0u; p < len; ++p) {
+                                    tmp[p] *= piranha::pow(col[p], ptr[i]);
+                                }
+                            } else {
+                                for (V p = 0u; p < len; ++p) {
+                                    tmp[p] = piranha::pow(col[p], ptr[i]);
+                                }
+                            }
+                        }
+                    }
+                    const auto &cf_val = cf_vals[j];
+                    for (V p = 0u; p < len; ++p) {
+                        series_eval_multadd(out[p], cf_val, tmp[p]);
+                    }
+                }
+            }
+        };
+        if (n_threads == 1u) {
+            thread_func(0u);
+            return retval;
+        }
+        future_list<void> f_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                f_list.push_back(thread_pool::enqueue(i, thread_func, i));
+            }
+            // First let's wait for everything to finish.
+            f_list.wait_all();
+            // Then, let's handle the exceptions.
+            f_list.get_all();
+        } catch (...) {
+            f_list.wait_all();
+            throw;
+        }
+        return retval;
+    }
+
+private:
+    frozen_series<Series> m_fs;
+    expo_storage<key_type> m_expo_storage;
+};
+} // namespace piranha
+
+#endif
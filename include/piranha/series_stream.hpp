@@ -0,0 +1,854 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#ifndef PIRANHA_SERIES_STREAM_HPP
+#define PIRANHA_SERIES_STREAM_HPP
+
+#include <piranha/config.hpp>
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/detail/demangle.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/math.hpp>
+#include <piranha/power_series.hpp>
+#include <piranha/profiler.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/series_multiplier.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+#endif
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Requirements on the series types supported by the streaming classes.
+template <typename Series>
+using series_stream_enabler
+    = enable_if_t<conjunction<is_series<Series>, has_msgpack_pack<msgpack_stream_wrapper<std::ofstream>, Series>,
+                              has_msgpack_convert<Series>>::value,
+                  int>;
+
+// The streams are implemented on top of the msgpack representation of a series.
+inline msgpack_format stream_msgpack_format(data_format f)
+{
+    if (unlikely(f != data_format::msgpack_binary && f != data_format::msgpack_portable)) {
+        piranha_throw(not_implemented_error, "series streams support only the msgpack data formats");
+    }
+    return (f == data_format::msgpack_binary) ? msgpack_format::binary : msgpack_format::portable;
+}
+
+// Check that the compression format c is available.
+inline compression stream_check_compression(compression c)
+{
+    switch (c) {
+        case compression::bzip2:
+            PIRANHA_BZIP2_CONDITIONAL(break);
+        case compression::gzip:
+        case compression::zlib:
+            PIRANHA_ZLIB_CONDITIONAL(break);
+        case compression::zstd:
+            PIRANHA_ZSTD_CONDITIONAL(break);
+        case compression::none:
+            break;
+    }
+    return c;
+}
+
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+
+// Compress the content of the file in into the file out.
+template <typename CompressionFilter>
+inline void stream_compress_file(const std::string &in, const std::string &out)
+{
+    std::ifstream ifile(in, std::ios::in | std::ios::binary);
+    std::ofstream ofile(out, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (unlikely(!ifile.good() || !ofile.good())) {
+        piranha_throw(std::runtime_error, "file '" + out + "' could not be opened for saving");
+    }
+    {
+        boost::iostreams::filtering_ostream os;
+        os.push(CompressionFilter{});
+        os.push(ofile);
+        os << ifile.rdbuf();
+        // NOTE: the filters are flushed when the stream is destroyed.
+    }
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "an error occurred while writing the file '" + out + "'");
+    }
+}
+
+#endif
+} // namespace impl
+
+/// Streaming series reader.
+/**
+ * This class reads, one at a time, the terms of a series saved in one of the msgpack data formats (e.g., via
+ * piranha::save_file()), without materialising the series in memory. The file is read in blocks, and the memory
+ * used by the reader is independent of the number of terms in the file. The symbol set and the number of terms
+ * are read on construction, the terms are then extracted via next() in the order in which they were stored.
+ *
+ * Together with piranha::series_writer, this class allows to process series which do not fit in memory (see, e.g.,
+ * piranha::stream_filter(), piranha::stream_truncate_degree(), piranha::stream_evaluate() and
+ * piranha::stream_multiply()).
+ *
+ * \p Series must satisfy piranha::is_series and it must support msgpack serialization, otherwise a compile-time
+ * error will be emitted.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * If an exception is thrown while reading a term, the reader is left in an unspecified state.
+ *
+ * ## Move semantics ##
+ *
+ * This class is not copyable or movable.
+ */
+template <typename Series>
+class series_reader
+{
+    static_assert(std::is_same<series_stream_enabler<Series>, int>::value, "Invalid series type.");
+    // Size of the blocks read from the file.
+    static const std::size_t block_size = 65536u;
+
+public:
+    /// Alias for the term type of \p Series.
+    using term_type = typename Series::term_type;
+    /// Alias for the coefficient type.
+    using cf_type = typename term_type::cf_type;
+    /// Alias for the key type.
+    using key_type = typename term_type::key_type;
+    /// Size type.
+    using size_type = std::size_t;
+    /// Constructor.
+    /**
+     * The file \p filename is opened and the symbol set and the number of terms are read from it.
+     *
+     * @param filename the name of the input file.
+     * @param f the data format.
+     * @param c the compression format.
+     *
+     * @throws piranha::not_implemented_error if \p f is not a msgpack data format, or if the compression
+     * format \p c is not available.
+     * @throws std::runtime_error if the file cannot be opened.
+     * @throws std::invalid_argument if the file does not contain a series in the msgpack format \p f.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of the msgpack and Boost iostreams libraries,
+     * - piranha::msgpack_convert(),
+     * - memory errors in standard containers.
+     */
+    series_reader(const std::string &filename, data_format f, compression c)
+        : m_filename(filename), m_mf(stream_msgpack_format(f)), m_file(filename, std::ios::in | std::ios::binary),
+          m_in(&m_file), m_offset(0u), m_size(0u), m_read(0u)
+    {
+        if (unlikely(!m_file.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        switch (c) {
+            case compression::bzip2:
+                PIRANHA_BZIP2_CONDITIONAL(push_filter<boost::iostreams::bzip2_decompressor>());
+                break;
+            case compression::gzip:
+                PIRANHA_ZLIB_CONDITIONAL(push_filter<boost::iostreams::gzip_decompressor>());
+                break;
+            case compression::zlib:
+                PIRANHA_ZLIB_CONDITIONAL(push_filter<boost::iostreams::zlib_decompressor>());
+                break;
+            case compression::zstd:
+                PIRANHA_ZSTD_CONDITIONAL(push_filter<boost::iostreams::zstd_decompressor>());
+                break;
+            case compression::none:
+                break;
+        }
+        // A series is an array made of the symbol set and of the array of terms.
+        if (unlikely(read_array_header() != 2u)) {
+            error("a series must be represented as an array of 2 elements");
+        }
+        const auto n_symbols = read_array_header();
+        std::vector<std::string> v_str;
+        for (std::uint32_t i = 0u; i < n_symbols; ++i) {
+            const auto oh = read_object();
+            std::string tmp_str;
+            msgpack_convert(tmp_str, oh.get(), m_mf);
+            v_str.push_back(std::move(tmp_str));
+        }
+        m_symbol_set = symbol_fset(v_str.begin(), v_str.end());
+        m_size = read_array_header();
+    }
+    /// Constructor from file name.
+    /**
+     * The data and compression formats are deduced from the extension of \p filename, as explained in
+     * piranha::load_file().
+     *
+     * @param filename the name of the input file.
+     *
+     * @throws unspecified any exception thrown by the other constructor, or by the deduction of the formats
+     * from \p filename.
+     */
+    explicit series_reader(const std::string &filename)
+        : series_reader(filename, get_cdf_from_filename(filename).second, get_cdf_from_filename(filename).first)
+    {
+    }
+    /// Deleted copy constructor.
+    series_reader(const series_reader &) = delete;
+    /// Deleted move constructor.
+    series_reader(series_reader &&) = delete;
+    /// Deleted copy assignment operator.
+    series_reader &operator=(const series_reader &) = delete;
+    /// Deleted move assignment operator.
+    series_reader &operator=(series_reader &&) = delete;
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set of the series stored in the file.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Number of terms.
+    /**
+     * @return the total number of terms stored in the file.
+     */
+    size_type size() const
+    {
+        return m_size;
+    }
+    /// Read the next term.
+    /**
+     * If all the terms have already been read, \p t is not modified and \p false is returned.
+     *
+     * @param t the output term.
+     *
+     * @return \p true if a term was read into \p t, \p false otherwise.
+     *
+     * @throws std::invalid_argument if the file is truncated or malformed.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of the msgpack and Boost iostreams libraries,
+     * - piranha::msgpack_convert(),
+     * - the <tt>%msgpack_convert()</tt> method of the key,
+     * - the constructor of the term type,
+     * - memory errors in standard containers.
+     */
+    bool next(term_type &t)
+    {
+        if (m_read == m_size) {
+            return false;
+        }
+        const auto oh = read_object();
+        std::array<msgpack::object, 2> tmp_term;
+        oh.get().convert(tmp_term);
+        cf_type tmp_cf;
+        key_type tmp_key;
+        msgpack_convert(tmp_cf, tmp_term[0], m_mf);
+        tmp_key.msgpack_convert(tmp_term[1], m_mf, m_symbol_set);
+        t = term_type{std::move(tmp_cf), std::move(tmp_key)};
+        ++m_read;
+        return true;
+    }
+
+private:
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+    template <typename DecompressionFilter>
+    void push_filter()
+    {
+        m_fis.push(DecompressionFilter{});
+        m_fis.push(m_file);
+        m_in = &m_fis;
+    }
+#endif
+    [[noreturn]] void error(const std::string &msg) const
+    {
+        piranha_throw(std::invalid_argument, "invalid series stream '" + m_filename + "': " + msg);
+    }
+    // Read a new block from the file, discarding the data already consumed. Returns false
+    // if the end of the file was reached.
+    bool fill()
+    {
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_offset));
+        m_offset = 0u;
+        const auto old_size = m_buffer.size();
+        m_buffer.resize(old_size + block_size);
+        m_in->read(m_buffer.data() + old_size, static_cast<std::streamsize>(block_size));
+        const auto n = static_cast<std::size_t>(m_in->gcount());
+        m_buffer.resize(old_size + n);
+        return n != 0u;
+    }
+    // Make sure that at least n bytes are available in the buffer.
+    void require(std::size_t n)
+    {
+        while (m_buffer.size() - m_offset < n) {
+            if (unlikely(!fill())) {
+                error("the file is truncated");
+            }
+        }
+    }
+    // Read the header of a msgpack array, returning the number of elements. The body of the array is
+    // left in the stream, so that its elements can be read one at a time.
+    std::uint32_t read_array_header()
+    {
+        require(1u);
+        const auto tag = static_cast<unsigned char>(m_buffer[m_offset]);
+        if (tag >= 0x90u && tag <= 0x9fu) {
+            // fixarray.
+            ++m_offset;
+            return tag & 0x0fu;
+        }
+        std::size_t n_bytes = 0u;
+        if (tag == 0xdcu) {
+            // array 16.
+            n_bytes = 2u;
+        } else if (tag == 0xddu) {
+            // array 32.
+            n_bytes = 4u;
+        } else {
+            error("an array was expected");
+        }
+        require(n_bytes + 1u);
+        std::uint32_t retval = 0u;
+        for (std::size_t i = 1u; i <= n_bytes; ++i) {
+            retval = (retval << 8) | static_cast<unsigned char>(m_buffer[m_offset + i]);
+        }
+        m_offset += n_bytes + 1u;
+        return retval;
+    }
+    // Read a complete msgpack object.
+    // NOTE: the returned handle owns its data, as no reference function is passed to msgpack::unpack().
+    msgpack::object_handle read_object()
+    {
+        while (true) {
+            if (m_offset != m_buffer.size()) {
+                auto off = m_offset;
+                try {
+                    auto oh = msgpack::unpack(m_buffer.data(), m_buffer.size(), off);
+                    m_offset = off;
+                    return oh;
+                } catch (const msgpack::insufficient_bytes &) {
+                }
+            }
+            if (unlikely(!fill())) {
+                error("the file is truncated");
+            }
+        }
+    }
+
+private:
+    std::string m_filename;
+    msgpack_format m_mf;
+    std::ifstream m_file;
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB) || defined(PIRANHA_WITH_ZSTD)
+    boost::iostreams::filtering_istream m_fis;
+#endif
+    std::istream *m_in;
+    std::vector<char> m_buffer;
+    std::size_t m_offset;
+    symbol_fset m_symbol_set;
+    size_type m_size;
+    size_type m_read;
+};
+
+template <typename Series>
+const std::size_t series_reader<Series>::block_size;
+
+/// Streaming series writer.
+/**
+ * This class writes a series to a file one term at a time, without materialising the series in memory. The output
+ * is a series in one of the msgpack data formats, and it can be read back either via piranha::series_reader
+ * or via piranha::load_file(). If a compression format is selected, the terms are first written to an uncompressed
+ * temporary file (named as the output file plus the <tt>.part</tt> suffix), which is compressed into the output file
+ * and removed by close().
+ *
+ * The terms are written as they are passed to write(), and no check for duplicate keys is performed: when the file
+ * is loaded into a series, terms with equal keys are merged.
+ *
+ * \p Series must satisfy piranha::is_series and it must support msgpack serialization, otherwise a compile-time
+ * error will be emitted.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * If an exception is thrown while writing, the content of the output file is unspecified.
+ *
+ * ## Move semantics ##
+ *
+ * This class is not copyable or movable.
+ */
+template <typename Series>
+class series_writer
+{
+    static_assert(std::is_same<series_stream_enabler<Series>, int>::value, "Invalid series type.");
+    using stream_type = msgpack_stream_wrapper<std::ofstream>;
+
+public:
+    /// Alias for the term type of \p Series.
+    using term_type = typename Series::term_type;
+    /// Size type.
+    using size_type = std::size_t;
+    /// Constructor.
+    /**
+     * The output file is created and the symbol set \p ss is written to it.
+     *
+     * @param filename the name of the output file.
+     * @param ss the symbol set of the terms that will be written.
+     * @param f the data format.
+     * @param c the compression format.
+     *
+     * @throws piranha::not_implemented_error if \p f is not a msgpack data format, or if the compression
+     * format \p c is not available.
+     * @throws std::runtime_error if the file cannot be opened.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of the msgpack library,
+     * - piranha::msgpack_pack(),
+     * - piranha::safe_cast(),
+     * - memory errors in standard containers.
+     */
+    series_writer(const std::string &filename, const symbol_fset &ss, data_format f, compression c)
+        : m_filename(filename), m_mf(stream_msgpack_format(f)), m_c(stream_check_compression(c)),
+          m_tmp_filename(c == compression::none ? filename : filename + ".part"), m_symbol_set(ss),
+          m_file(m_tmp_filename, std::ios::out | std::ios::binary | std::ios::trunc), m_packer(m_file), m_size(0u),
+          m_closed(false)
+    {
+        if (unlikely(!m_file.good())) {
+            piranha_throw(std::runtime_error, "file '" + m_tmp_filename + "' could not be opened for saving");
+        }
+        m_packer.pack_array(2u);
+        m_packer.pack_array(safe_cast<std::uint32_t>(m_symbol_set.size()));
+        for (const auto &sym : m_symbol_set) {
+            msgpack_pack(m_packer, sym, m_mf);
+        }
+        // The number of terms is not known yet: write the header of a 32-bit array
+        // with a placeholder size, which will be filled in by close().
+        m_size_pos = m_file.tellp();
+        const char header[5] = {static_cast<char>(0xdd), 0, 0, 0, 0};
+        m_file.write(header, 5u);
+    }
+    /// Constructor from file name.
+    /**
+     * The data and compression formats are deduced from the extension of \p filename, as explained in
+     * piranha::save_file().
+     *
+     * @param filename the name of the output file.
+     * @param ss the symbol set of the terms that will be written.
+     *
+     * @throws unspecified any exception thrown by the other constructor, or by the deduction of the formats
+     * from \p filename.
+     */
+    series_writer(const std::string &filename, const symbol_fset &ss)
+        : series_writer(filename, ss, get_cdf_from_filename(filename).second, get_cdf_from_filename(filename).first)
+    {
+    }
+    /// Deleted copy constructor.
+    series_writer(const series_writer &) = delete;
+    /// Deleted move constructor.
+    series_writer(series_writer &&) = delete;
+    /// Deleted copy assignment operator.
+    series_writer &operator=(const series_writer &) = delete;
+    /// Deleted move assignment operator.
+    series_writer &operator=(series_writer &&) = delete;
+    /// Destructor.
+    /**
+     * The destructor will call close(), ignoring any error. close() should be called explicitly
+     * in order to be notified of errors.
+     */
+    ~series_writer()
+    {
+        if (!m_closed) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set of the output series.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms written so far.
+     */
+    size_type size() const
+    {
+        return m_size;
+    }
+    /// Write a term.
+    /**
+     * Terms which are zero are skipped.
+     *
+     * @param t the term to be written.
+     *
+     * @throws std::invalid_argument if the writer has been closed, or if \p t is not compatible with
+     * the symbol set of the writer.
+     * @throws std::overflow_error if the number of terms would exceed the limit of the msgpack format.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of the msgpack library,
+     * - piranha::msgpack_pack(),
+     * - the <tt>%msgpack_pack()</tt> method of the key.
+     */
+    void write(const term_type &t)
+    {
+        if (unlikely(m_closed)) {
+            piranha_throw(std::invalid_argument, "cannot write to a closed series stream");
+        }
+        if (unlikely(!t.is_compatible(m_symbol_set))) {
+            piranha_throw(std::invalid_argument, "cannot write an incompatible term to a series stream");
+        }
+        if (t.is_zero(m_symbol_set)) {
+            return;
+        }
+        if (unlikely(m_size == std::numeric_limits<std::uint32_t>::max())) {
+            piranha_throw(std::overflow_error, "too many terms in a series stream");
+        }
+        m_packer.pack_array(2u);
+        msgpack_pack(m_packer, t.m_cf, m_mf);
+        t.m_key.msgpack_pack(m_packer, m_mf, m_symbol_set);
+        ++m_size;
+    }
+    /// Write all the terms of a series.
+    /**
+     * @param s the series whose terms will be written.
+     *
+     * @throws std::invalid_argument if the symbol set of \p s differs from the symbol set of the writer.
+     * @throws unspecified any exception thrown by the other overload of write().
+     */
+    void write(const Series &s)
+    {
+        if (unlikely(s.get_symbol_set() != m_symbol_set)) {
+            piranha_throw(std::invalid_argument,
+                          "cannot write to a series stream a series with a different symbol set");
+        }
+        for (const auto &t : s._container()) {
+            write(t);
+        }
+    }
+    /// Close the writer.
+    /**
+     * The number of terms is recorded in the file, and the file is compressed, if requested. After the writer has
+     * been closed, no more terms can be written. Calling this method on a closed writer has no effect.
+     *
+     * @throws std::runtime_error if an error occurs while writing the output file.
+     * @throws unspecified any exception thrown by the public interface of the Boost iostreams library.
+     */
+    void close()
+    {
+        if (m_closed) {
+            return;
+        }
+        m_closed = true;
+        profiler::scope prof("s11n.stream_close");
+        char size_bytes[4];
+        for (auto i = 0u; i < 4u; ++i) {
+            size_bytes[i] = static_cast<char>(static_cast<unsigned char>((m_size >> (8u * (3u - i))) & 0xffu));
+        }
+        m_file.seekp(m_size_pos + std::streamoff(1));
+        m_file.write(size_bytes, 4u);
+        m_file.close();
+        if (unlikely(!m_file)) {
+            piranha_throw(std::runtime_error, "an error occurred while writing the file '" + m_tmp_filename + "'");
+        }
+        switch (m_c) {
+            case compression::bzip2:
+                PIRANHA_BZIP2_CONDITIONAL(
+                    stream_compress_file<boost::iostreams::bzip2_compressor>(m_tmp_filename, m_filename));
+                break;
+            case compression::gzip:
+                PIRANHA_ZLIB_CONDITIONAL(
+                    stream_compress_file<boost::iostreams::gzip_compressor>(m_tmp_filename, m_filename));
+                break;
+            case compression::zlib:
+                PIRANHA_ZLIB_CONDITIONAL(
+                    stream_compress_file<boost::iostreams::zlib_compressor>(m_tmp_filename, m_filename));
+                break;
+            case compression::zstd:
+                PIRANHA_ZSTD_CONDITIONAL(
+                    stream_compress_file<boost::iostreams::zstd_compressor>(m_tmp_filename, m_filename));
+                break;
+            case compression::none:
+                return;
+        }
+        std::remove(m_tmp_filename.c_str());
+    }
+
+private:
+    std::string m_filename;
+    msgpack_format m_mf;
+    compression m_c;
+    std::string m_tmp_filename;
+    symbol_fset m_symbol_set;
+    stream_type m_file;
+    msgpack::packer<stream_type> m_packer;
+    std::streampos m_size_pos;
+    size_type m_size;
+    bool m_closed;
+};
+
+inline namespace impl
+{
+
+template <typename Series>
+inline void stream_check_symbol_sets(const series_reader<Series> &r, const series_writer<Series> &w)
+{
+    if (unlikely(r.get_symbol_set() != w.get_symbol_set())) {
+        piranha_throw(std::invalid_argument, "the symbol sets of the input and output series streams differ");
+    }
+}
+
+template <typename Series, typename T>
+using stream_truncate_t = decltype(ps_truncate_term(std::declval<const typename Series::term_type &>(),
+                                                    std::declval<const T &>(), std::declval<const symbol_fset &>()));
+
+template <typename Series, typename T>
+using stream_ptruncate_t = decltype(
+    ps_truncate_term(std::declval<const typename Series::term_type &>(), std::declval<const T &>(),
+                     std::declval<const symbol_fset &>(), std::declval<const symbol_idx_fset &>(),
+                     std::declval<const symbol_fset &>()));
+
+// Sink for the partitions of an out-of-core multiplication.
+template <typename Series>
+struct stream_multiply_sink {
+    void operator()(Series &&s) const
+    {
+        m_w->write(s);
+    }
+    series_writer<Series> *m_w;
+};
+
+template <typename Series>
+using stream_multiply_t = decltype(std::declval<const series_multiplier<Series> &>()._out_of_core_multiplication(
+    std::declval<stream_multiply_sink<Series>>(), std::declval<unsigned long long>()));
+} // namespace impl
+
+/// Filter a series stream.
+/**
+ * The terms read from \p r for which \p func returns \p true are written to \p w. The reader and the writer
+ * must have the same symbol set.
+ *
+ * @param r the input stream.
+ * @param w the output stream.
+ * @param func the filtering functor, which will be passed the coefficient and the key of each term.
+ *
+ * @return the number of terms written to \p w.
+ *
+ * @throws std::invalid_argument if the symbol sets of \p r and \p w differ.
+ * @throws unspecified any exception thrown by \p func, series_reader::next() and series_writer::write().
+ */
+template <typename Series>
+inline std::size_t
+stream_filter(series_reader<Series> &r, series_writer<Series> &w,
+              const std::function<bool(const typename Series::term_type::cf_type &,
+                                       const typename Series::term_type::key_type &)> &func)
+{
+    profiler::scope prof("s11n.stream_filter");
+    stream_check_symbol_sets(r, w);
+    const auto old_size = w.size();
+    typename Series::term_type t;
+    while (r.next(t)) {
+        if (func(t.m_cf, t.m_key)) {
+            w.write(t);
+        }
+    }
+    return w.size() - old_size;
+}
+
+/// Truncate a series stream by total degree.
+/**
+ * \note
+ * This function is enabled only if the terms of \p Series support truncation by total degree, as explained in
+ * piranha::power_series.
+ *
+ * The terms read from \p r are truncated with the same logic of piranha::power_series::truncate_degree(),
+ * and the surviving terms are written to \p w. The reader and the writer must have the same symbol set.
+ *
+ * @param r the input stream.
+ * @param w the output stream.
+ * @param max_degree the maximum total degree.
+ *
+ * @return the number of terms written to \p w.
+ *
+ * @throws std::invalid_argument if the symbol sets of \p r and \p w differ.
+ * @throws unspecified any exception thrown by the truncation of the terms, series_reader::next() and
+ * series_writer::write().
+ */
+template <typename Series, typename T, enable_if_t<is_detected<stream_truncate_t, Series, T>::value, int> = 0>
+inline std::size_t stream_truncate_degree(series_reader<Series> &r, series_writer<Series> &w, const T &max_degree)
+{
+    profiler::scope prof("s11n.stream_truncate_degree");
+    stream_check_symbol_sets(r, w);
+    const auto old_size = w.size();
+    const auto &ss = r.get_symbol_set();
+    typename Series::term_type t;
+    while (r.next(t)) {
+        const auto tmp = ps_truncate_term(t, max_degree, ss);
+        if (tmp.first) {
+            w.write(tmp.second);
+        }
+    }
+    return w.size() - old_size;
+}
+
+/// Truncate a series stream by partial degree.
+/**
+ * \note
+ * This function is enabled only if the terms of \p Series support truncation by partial degree, as explained in
+ * piranha::power_series.
+ *
+ * This function is equivalent to the other overload, the only difference being that the partial degree with
+ * respect to the symbols in \p names is considered.
+ *
+ * @param r the input stream.
+ * @param w the output stream.
+ * @param max_degree the maximum partial degree.
+ * @param names the names of the variables to be considered in the computation of the partial degree.
+ *
+ * @return the number of terms written to \p w.
+ *
+ * @throws std::invalid_argument if the symbol sets of \p r and \p w differ.
+ * @throws unspecified any exception thrown by the truncation of the terms, series_reader::next() and
+ * series_writer::write().
+ */
+template <typename Series, typename T, enable_if_t<is_detected<stream_ptruncate_t, Series, T>::value, int> = 0>
+inline std::size_t stream_truncate_degree(series_reader<Series> &r, series_writer<Series> &w, const T &max_degree,
+                                          const symbol_fset &names)
+{
+    profiler::scope prof("s11n.stream_truncate_degree");
+    stream_check_symbol_sets(r, w);
+    const auto old_size = w.size();
+    const auto &ss = r.get_symbol_set();
+    const auto idx = ss_intersect_idx(ss, names);
+    typename Series::term_type t;
+    while (r.next(t)) {
+        const auto tmp = ps_truncate_term(t, max_degree, names, idx, ss);
+        if (tmp.first) {
+            w.write(tmp.second);
+        }
+    }
+    return w.size() - old_size;
+}
+
+/// Evaluate a series stream.
+/**
+ * \note
+ * This function is enabled only if piranha::math::evaluate() is enabled for \p Series and \p T.
+ *
+ * The remaining terms of \p r are read and evaluated, and the result is the same as calling
+ * piranha::math::evaluate() on the series formed by such terms.
+ *
+ * @param r the input stream.
+ * @param dict the dictionary that will be used for evaluation.
+ *
+ * @return the result of the evaluation of the terms read from \p r.
+ *
+ * @throws std::invalid_argument if a symbol of \p r does not appear in \p dict.
+ * @throws unspecified any exception thrown by series_reader::next(), by coefficient and key evaluation,
+ * by memory errors in standard containers or by arithmetic operations on the evaluation type.
+ */
+template <typename Series, typename T, typename = math_series_evaluate_enabler<Series, T>>
+inline series_eval_type<Series, T> stream_evaluate(series_reader<Series> &r, const symbol_fmap<T> &dict)
+{
+    profiler::scope prof("s11n.stream_evaluate");
+    const auto &ss = r.get_symbol_set();
+    const auto evec = series_evaluation_vector(ss, dict);
+    series_eval_type<Series, T> retval(0);
+    typename Series::term_type t;
+    while (r.next(t)) {
+        series_eval_multadd(retval, math::evaluate(t.m_cf, dict), t.m_key.evaluate(evec, ss));
+    }
+    return retval;
+}
+
+/// Multiply two series into a series stream.
+/**
+ * \note
+ * This function is enabled only if the piranha::series_multiplier of \p Series supports out-of-core multiplication
+ * (e.g., polynomials with Kronecker monomials, see piranha::series_multiplier::_out_of_core_multiplication()).
+ *
+ * The product of \p a and \p b is computed in partitions whose size is bounded by \p budget, and each partition
+ * is written to \p w as soon as it has been computed. The symbol set of \p w must be the union of the symbol sets
+ * of \p a and \p b. The result is never materialised in memory as a whole, and it can be read back with
+ * piranha::series_reader (or, if it fits in memory, with piranha::load_file()).
+ *
+ * @param a the first operand.
+ * @param b the second operand.
+ * @param w the output stream.
+ * @param budget the memory budget, in bytes (if zero, the value returned by
+ * tuning::get_multiplication_memory_budget() will be used).
+ *
+ * @return the number of terms written to \p w.
+ *
+ * @throws std::invalid_argument if the symbol set of \p w differs from the merged symbol set of the operands.
+ * @throws unspecified any exception thrown by the merging of the symbol sets of the operands, by the construction
+ * of the piranha::series_multiplier, by its out-of-core multiplication method and by series_writer::write().
+ */
+template <typename Series, enable_if_t<is_detected<stream_multiply_t, Series>::value, int> = 0>
+inline std::size_t stream_multiply(const Series &a, const Series &b, series_writer<Series> &w,
+                                   unsigned long long budget = 0u)
+{
+    profiler::scope prof("s11n.stream_multiply");
+    const auto old_size = w.size();
+    series_merge_f(a, b, [&w, budget](const Series &x, const Series &y) {
+        if (unlikely(x.get_symbol_set() != w.get_symbol_set())) {
+            piranha_throw(std::invalid_argument, "the symbol set of the output series stream differs from the "
+                                                 "symbol set of the operands");
+        }
+        series_multiplier<Series> m(x, y);
+        m._out_of_core_multiplication(stream_multiply_sink<Series>{&w}, budget);
+    });
+    return w.size() - old_size;
+}
+} // namespace piranha
+
+#endif
+
+#endif
@@ -55,6 +55,12 @@ struct base_settings {
     // NOTE: this corresponds to circa 2% overhead from thread management on a common desktop
     // machine around 2012 for the fastest series multiplication scenario.
     static const unsigned long long s_default_min_work_per_thread = 250000ull;
+    // Memory budget and statistics of the caches of natural powers of series.
+    static std::atomic_ullong s_pow_cache_memory_budget;
+    static const unsigned long long s_default_pow_cache_memory_budget = 1ull << 30;
+    static std::atomic_ullong s_pow_cache_hits;
+    static std::atomic_ullong s_pow_cache_misses;
+    static std::atomic_ullong s_pow_cache_evictions;
 };
 
 template <typename T>
@@ -74,6 +80,21 @@ const unsigned long long base_settings<T>::s_default_min_work_per_thread;
 
 template <typename T>
 std::atomic_ullong base_settings<T>::s_min_work_per_thread(base_settings<T>::s_default_min_work_per_thread);
+
+template <typename T>
+const unsigned long long base_settings<T>::s_default_pow_cache_memory_budget;
+
+template <typename T>
+std::atomic_ullong base_settings<T>::s_pow_cache_memory_budget(base_settings<T>::s_default_pow_cache_memory_budget);
+
+template <typename T>
+std::atomic_ullong base_settings<T>::s_pow_cache_hits(0u);
+
+template <typename T>
+std::atomic_ullong base_settings<T>::s_pow_cache_misses(0u);
+
+template <typename T>
+std::atomic_ullong base_settings<T>::s_pow_cache_evictions(0u);
 }
 
 /// Global settings.
@@ -256,6 +277,70 @@ public:
     {
         s_min_work_per_thread.store(s_default_min_work_per_thread);
     }
+    /// Get the memory budget of the pow caches.
+    /**
+     * piranha::series::pow() caches the natural powers of the series it computes, one cache per series type. When
+     * the estimated memory footprint of a cache exceeds this budget, the least recently used entries of the cache
+     * are evicted. A value of zero means that the caches are unbounded. The default value is 1 GiB.
+     *
+     * @return the memory budget of each pow cache, in bytes.
+     */
+    static unsigned long long get_pow_cache_memory_budget()
+    {
+        return s_pow_cache_memory_budget.load();
+    }
+    /// Set the memory budget of the pow caches.
+    /**
+     * The new budget will be enforced the next time an entry is added to a cache.
+     *
+     * @param n the desired memory budget, in bytes.
+     */
+    static void set_pow_cache_memory_budget(unsigned long long n)
+    {
+        s_pow_cache_memory_budget.store(n);
+    }
+    /// Reset the memory budget of the pow caches.
+    /**
+     * The value will be reset to the default initial value.
+     */
+    static void reset_pow_cache_memory_budget()
+    {
+        s_pow_cache_memory_budget.store(s_default_pow_cache_memory_budget);
+    }
+    /// Get the number of pow cache hits.
+    /**
+     * @return the number of calls to piranha::series::pow() which found the requested power in the cache.
+     */
+    static unsigned long long get_pow_cache_hits()
+    {
+        return s_pow_cache_hits.load();
+    }
+    /// Get the number of pow cache misses.
+    /**
+     * @return the number of calls to piranha::series::pow() which had to compute the requested power.
+     */
+    static unsigned long long get_pow_cache_misses()
+    {
+        return s_pow_cache_misses.load();
+    }
+    /// Get the number of pow cache evictions.
+    /**
+     * @return the number of entries evicted from the pow caches because of the memory budget.
+     */
+    static unsigned long long get_pow_cache_evictions()
+    {
+        return s_pow_cache_evictions.load();
+    }
+    /// Reset the pow cache statistics.
+    /**
+     * The numbers of hits, misses and evictions will be reset to zero.
+     */
+    static void reset_pow_cache_stats()
+    {
+        s_pow_cache_hits.store(0u);
+        s_pow_cache_misses.store(0u);
+        s_pow_cache_evictions.store(0u);
+    }
 };
 
 /// Alias for piranha::settings_.
@@ -32,10 +32,13 @@ see https://www.gnu.org/licenses/. */
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include <piranha/detail/bulk_subs.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/forwarding.hpp>
 #include <piranha/math.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/series.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/type_traits.hpp>
@@ -162,6 +165,42 @@ class substitutable_series : public Series, detail::substitutable_series_tag
         = enable_if_t<conjunction<std::is_constructible<subs_type_<T>, const int &>, is_addable_in_place<subs_type_<T>>,
                                   is_returnable<subs_type_<T>>, has_sm_intersect_idx<T>>::value,
                       subs_type_<T>>;
+    // Bulk substitution, enabled when the substitution involves only the keys and the keys can be probed
+    // with formal variables (see detail::bulk_subs()).
+    template <typename T, typename Term = typename Series::term_type>
+    using bulk_subs_enabler = enable_if_t<
+        conjunction<std::integral_constant<bool, subs_term_score<Term, T>::value == 2u>,
+                    key_has_subs<typename Term::key_type, detail::subs_formal>,
+                    std::is_same<k_subs_type<detail::subs_formal, Term>, detail::subs_formal>,
+                    detail::bulk_subs_evaluable<k_subs_type<T, Term>, T>, is_series<subs_type<T>>>::value,
+        int>;
+    template <typename T, bulk_subs_enabler<T> = 0>
+    subs_type<T> subs_impl(const symbol_fmap<T> &, const symbol_idx_fmap<T> &idx, int) const
+    {
+        using key_type = typename Series::term_type::key_type;
+        using w_type = k_subs_type<T, typename Series::term_type>;
+        symbol_idx_fmap<detail::subs_formal> f_idx;
+        std::vector<const T *> values;
+        for (const auto &p : idx) {
+            f_idx.emplace_hint(f_idx.end(), p.first, detail::subs_formal::var(values.size()));
+            values.push_back(&p.second);
+        }
+        detail::subs_power_table<T> table(std::move(values));
+        const auto &s_set = this->m_symbol_set;
+        return detail::bulk_subs<subs_type<T>, w_type>(
+            *static_cast<Derived const *>(this), table,
+            [&f_idx, &s_set](const key_type &k) { return k.subs(f_idx, s_set); },
+            [](const Derived &r, const w_type &v) { return r * v; });
+    }
+    template <typename T>
+    subs_type<T> subs_impl(const symbol_fmap<T> &dict, const symbol_idx_fmap<T> &idx, long) const
+    {
+        subs_type<T> retval(0);
+        for (const auto &t : this->m_container) {
+            retval += subs_term_impl(t, dict, idx, this->m_symbol_set);
+        }
+        return retval;
+    }
 
 public:
     /// Defaulted default constructor.
@@ -206,6 +245,11 @@ public:
      * This method will return an object resulting from the substitution in \p this of the symbols in \p dict
      * with the mapped values.
      *
+     * If the substitution involves only the keys, the terms of \p this are grouped according to the powers of the
+     * substituted symbols that appear in their keys. The powers of the mapped values are then computed only once,
+     * and the result is obtained with one multiplication per group (rather than per term). If the number of groups
+     * is large enough, the groups are processed in parallel.
+     *
      * @param dict a dictionary mapping a set of symbols to the values that will be substituted for them.
      *
      * @return the result of the substitution.
@@ -218,12 +262,10 @@ public:
     template <typename T>
     subs_type<T> subs(const symbol_fmap<T> &dict) const
     {
+        profiler::scope prof("series.subs");
+        prof.count("terms", this->m_container.size());
         const auto idx = sm_intersect_idx(this->m_symbol_set, dict);
-        subs_type<T> retval(0);
-        for (const auto &t : this->m_container) {
-            retval += subs_term_impl(t, dict, idx, this->m_symbol_set);
-        }
-        return retval;
+        return subs_impl(dict, idx, 0);
     }
 };
 
@@ -33,6 +33,7 @@ see https://www.gnu.org/licenses/. */
 #include <type_traits>
 #include <utility>
 
+#include <piranha/detail/bulk_subs.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/forwarding.hpp>
 #include <piranha/math.hpp>
@@ -162,6 +163,44 @@ class t_substitutable_series : public Series, detail::t_substitutable_series_tag
                                             std::declval<const std::string &>(), std::declval<const symbol_idx &>(),
                                             std::declval<const T &>(), std::declval<const U &>(),
                                             std::declval<symbol_fset const &>()));
+    // Bulk trigonometric substitution, enabled when the substitution involves only the keys and the keys
+    // can be probed with formal variables (see detail::bulk_subs()).
+    template <typename T, typename U, typename Term = typename Series::term_type>
+    using k_t_subs_type = uncvref_t<decltype(std::declval<typename Term::key_type const &>()
+                                                 .t_subs(std::declval<const symbol_idx &>(), std::declval<T const &>(),
+                                                         std::declval<U const &>(),
+                                                         std::declval<symbol_fset const &>())[0u]
+                                                 .first)>;
+    template <typename T, typename U, typename Term = typename Series::term_type>
+    using bulk_t_subs_enabler = enable_if_t<
+        conjunction<std::integral_constant<bool, t_subs_term_score<Term, T, U>::value == 2u>, std::is_same<T, U>,
+                    key_has_t_subs<typename Term::key_type, detail::subs_formal, detail::subs_formal>,
+                    std::is_same<k_t_subs_type<detail::subs_formal, detail::subs_formal>, detail::subs_formal>,
+                    detail::bulk_subs_evaluable<k_t_subs_type<T, U>, T>, is_series<t_subs_type<T, U>>>::value,
+        int>;
+    template <typename T, typename U, bulk_t_subs_enabler<T, U> = 0>
+    t_subs_type<T, U> t_subs_impl(const std::string &, const symbol_idx &idx, const T &c, const U &s, int) const
+    {
+        using key_type = typename Series::term_type::key_type;
+        using w_type = k_t_subs_type<T, U>;
+        const auto f_c = detail::subs_formal::var(0u), f_s = detail::subs_formal::var(1u);
+        detail::subs_power_table<T> table({&c, &s});
+        const auto &s_set = this->m_symbol_set;
+        return detail::bulk_subs<t_subs_type<T, U>, w_type>(
+            *static_cast<Derived const *>(this), table,
+            [&idx, &f_c, &f_s, &s_set](const key_type &k) { return k.t_subs(idx, f_c, f_s, s_set); },
+            [](const Derived &r, const w_type &v) { return v * r; });
+    }
+    template <typename T, typename U>
+    t_subs_type<T, U> t_subs_impl(const std::string &name, const symbol_idx &idx, const T &c, const U &s,
+                                  long) const
+    {
+        t_subs_type<T, U> retval(0);
+        for (const auto &t : this->m_container) {
+            retval += t_subs_utils<T, U>::subs(t, name, idx, c, s, this->m_symbol_set);
+        }
+        return retval;
+    }
 
 public:
     /// Defaulted default constructor.
@@ -202,6 +241,10 @@ public:
      *
      * Trigonometric substitution is the substitution of the cosine and sine of \p name for \p c and \p s.
      *
+     * If the substitution involves only the keys, the terms of \p this are grouped according to the multiple
+     * angle formulae resulting from the substitution in their keys. The powers of \p c and \p s are then computed
+     * only once, and the result is obtained with one multiplication per group (rather than per term).
+     *
      * @param name name of the symbol that will be subject to substitution.
      * @param c cosine of \p name.
      * @param s sine of \p name.
@@ -219,12 +262,7 @@ public:
     template <typename T, typename U>
     t_subs_type<T, U> t_subs(const std::string &name, const T &c, const U &s) const
     {
-        t_subs_type<T, U> retval(0);
-        const auto idx = ss_index_of(this->m_symbol_set, name);
-        for (const auto &t : this->m_container) {
-            retval += t_subs_utils<T, U>::subs(t, name, idx, c, s, this->m_symbol_set);
-        }
-        return retval;
+        return t_subs_impl(name, ss_index_of(this->m_symbol_set, name), c, s, 0);
     }
 };
 
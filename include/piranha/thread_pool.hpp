@@ -33,6 +33,7 @@ see https://www.gnu.org/licenses/. */
 #include <atomic>
 #include <boost/lexical_cast.hpp>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdlib>
 #include <functional>
 #include <future>
@@ -259,8 +260,128 @@ bool thread_pool_base<T>::s_bind = false;
 
 template <typename>
 void thread_pool_shutdown();
+
+// Range of indices owned by a thread in thread_pool_::parallel_for(). The owner consumes the range from the front,
+// other threads steal from the back. The padding is meant to keep the ranges of different threads
+// on different cache lines.
+struct pf_range {
+    pf_range() : m_begin(0u), m_end(0u)
+    {
+        m_lock.clear();
+    }
+    std::atomic_flag m_lock;
+    std::size_t m_begin;
+    std::size_t m_end;
+    char m_pad[64u];
+};
 }
 
+/// Class to store a list of futures.
+/**
+ * This class is a minimal thin wrapper around an \p std::list of \p std::future<T> objects.
+ * The class provides convenience methods to interact with the set of futures in an exception-safe manner.
+ */
+// NOTE: we could provide method to retrieve future values from get_all() using a vector (in case the future type
+// is not void or a reference, in which case the get_all() method stays as it is).
+template <typename T>
+class future_list
+{
+    // Wait on a valid future, or abort.
+    static void wait_or_abort(const std::future<T> &fut)
+    {
+        piranha_assert(fut.valid());
+        try {
+            fut.wait();
+        } catch (...) {
+            // NOTE: logging candidate, with info from exception.
+            std::abort();
+        }
+    }
+
+public:
+    /// Defaulted default constructor.
+    /**
+     * This constructor will initialise an empty list of futures.
+     */
+    future_list() = default;
+    /// Deleted copy constructor.
+    future_list(const future_list &) = delete;
+    /// Deleted move constructor.
+    future_list(future_list &&) = delete;
+
+private:
+    future_list &operator=(const future_list &) = delete;
+    future_list &operator=(future_list &&) = delete;
+
+public:
+    /// Destructor
+    /**
+     * Will call wait_all().
+     */
+    ~future_list()
+    {
+        wait_all();
+    }
+    /// Move-insert a future.
+    /**
+     * Will move-insert the input future \p f into the internal container.
+     * If the insertion fails due to memory allocation errors and \p f is a valid
+     * future, then the method will wait on \p f before throwing the exception.
+     *
+     * @param f std::future to be move-inserted.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors.
+     */
+    void push_back(std::future<T> &&f)
+    {
+        // Push back empty future.
+        try {
+            m_list.emplace_back();
+        } catch (...) {
+            // If we get some error here, we want to make sure we wait on the future
+            // before escaping out.
+            // NOTE: calling wait() on an invalid future is UB.
+            if (f.valid()) {
+                wait_or_abort(f);
+            }
+            throw;
+        }
+        // This cannot throw.
+        m_list.back() = std::move(f);
+    }
+    /// Wait on all the futures.
+    /**
+     * This method will call <tt>wait()</tt> on all the valid futures stored within the object.
+     */
+    void wait_all()
+    {
+        for (auto &f : m_list) {
+            if (f.valid()) {
+                wait_or_abort(f);
+            }
+        }
+    }
+    /// Get all the futures.
+    /**
+     * This method will call <tt>get()</tt> on all the valid futures stored within the object.
+     * The return values resulting from the calls to <tt>get()</tt> will be ignored.
+     *
+     * @throws unspecified an exception stored by a future.
+     */
+    void get_all()
+    {
+        for (auto &f : m_list) {
+            // NOTE: std::future's valid() method is noexcept.
+            if (f.valid()) {
+                (void)f.get();
+            }
+        }
+    }
+
+private:
+    std::list<std::future<T>> m_list;
+};
+
 /// Static thread pool.
 /**
  * \note
@@ -292,6 +413,10 @@ class thread_pool_ : private thread_pool_base<>
     // The return type for enqueue().
     template <typename F, typename... Args>
     using enqueue_t = decltype(std::declval<task_queue &>().enqueue(std::declval<F>(), std::declval<Args>()...));
+    // Enabler for parallel_for().
+    template <typename F>
+    using parallel_for_enabler = enable_if_t<
+        is_function_object<const F, void, const unsigned &, const std::size_t &, const std::size_t &>::value, int>;
 
 public:
     /// Enqueue task.
@@ -333,6 +458,134 @@ public:
         return base::s_queues.first[static_cast<decltype(base::s_queues.first.size())>(n)]->enqueue(
             std::forward<F>(f), std::forward<Args>(args)...);
     }
+    /// Parallel for loop with work stealing.
+    /**
+     * \note
+     * This method is enabled only if \p F is a function object with a const call operator which can be called
+     * with arguments of type <tt>const unsigned &</tt> and <tt>const std::size_t &</tt> (twice), returning \p void.
+     *
+     * This method will process the index range <tt>[0, size)</tt> in parallel using the first \p n_threads threads
+     * in the pool. The range is processed in chunks: for each chunk <tt>[begin, end)</tt>, <tt>f(thread_idx, begin,
+     * end)</tt> is invoked, where \p thread_idx is the index of the thread of the pool which is processing the chunk
+     * (it can be used, e.g., to access per-thread data). Each index is processed exactly once, and each chunk
+     * contains at most \p grain indices.
+     *
+     * The range is initially split in \p n_threads contiguous subranges of equal size (with the last one absorbing
+     * the remainder), the <tt>i</tt>-th subrange being assigned to the <tt>i</tt>-th thread. Each thread consumes its
+     * subrange from the front. When a thread runs out of work, it steals the back half of the remaining
+     * subrange of another thread, starting from the next thread index. The chunks are thus processed by the threads
+     * to which they are initially assigned (preserving the locality of the thread binding policy) unless the
+     * workload is unbalanced. The bookkeeping of the ranges does not allocate memory: apart from the setup of the
+     * per-thread ranges, the cost of the scheduling is a couple of spinlock-protected updates per chunk.
+     *
+     * If \p n_threads is 1, the chunks are processed sequentially in the calling thread. If an invocation of \p f
+     * throws, the threads stop processing new chunks and the exception is re-thrown (the chunks that were not
+     * processed are discarded).
+     *
+     * @param n_threads the number of threads to use.
+     * @param size the size of the index range.
+     * @param grain the maximum number of indices in a chunk.
+     * @param f the function object which will process the chunks.
+     *
+     * @throws std::invalid_argument if \p n_threads or \p grain is zero, or if \p n_threads is larger than
+     * the pool size.
+     * @throws unspecified any exception thrown by:
+     * - enqueue(),
+     * - the invocation of \p f,
+     * - threading primitives,
+     * - memory allocation errors.
+     */
+    template <typename F, parallel_for_enabler<F> = 0>
+    static void parallel_for(unsigned n_threads, std::size_t size, std::size_t grain, const F &f)
+    {
+        if (unlikely(!n_threads)) {
+            piranha_throw(std::invalid_argument, "the number of threads in a parallel for loop must be nonzero");
+        }
+        if (unlikely(!grain)) {
+            piranha_throw(std::invalid_argument, "the grain size in a parallel for loop must be nonzero");
+        }
+        if (!size) {
+            return;
+        }
+        if (n_threads == 1u) {
+            for (std::size_t begin = 0u; begin != size;) {
+                const std::size_t end = (size - begin > grain) ? begin + grain : size;
+                f(0u, begin, end);
+                begin = end;
+            }
+            return;
+        }
+        // Initial static partition of the range.
+        std::vector<pf_range> ranges(static_cast<std::vector<pf_range>::size_type>(n_threads));
+        const std::size_t wpt = size / n_threads;
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            ranges[i].m_begin = i * wpt;
+            ranges[i].m_end = (i == n_threads - 1u) ? size : (i + 1u) * wpt;
+        }
+        // Flag to signal the threads to stop in case of errors.
+        std::atomic<bool> stop(false);
+        auto worker = [&ranges, &stop, &f, n_threads, grain](unsigned t_idx) {
+            auto &own = ranges[t_idx];
+            try {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    // Pop a chunk from the front of our own range.
+                    std::size_t begin, end;
+                    {
+                        detail::atomic_lock_guard lock(own.m_lock);
+                        begin = own.m_begin;
+                        end = (own.m_end - begin > grain) ? begin + grain : own.m_end;
+                        own.m_begin = end;
+                    }
+                    if (begin != end) {
+                        f(t_idx, begin, end);
+                        continue;
+                    }
+                    // Our range is exhausted: steal the back half of the range of another thread.
+                    bool stolen = false;
+                    for (unsigned i = 1u; i < n_threads && !stolen; ++i) {
+                        auto &victim = ranges[(t_idx + i) % n_threads];
+                        {
+                            detail::atomic_lock_guard lock(victim.m_lock);
+                            const std::size_t rem = victim.m_end - victim.m_begin;
+                            if (rem) {
+                                // NOTE: if only one index is left, we steal it.
+                                end = victim.m_end;
+                                begin = victim.m_begin + rem / 2u;
+                                victim.m_end = begin;
+                                stolen = true;
+                            }
+                        }
+                        if (stolen) {
+                            detail::atomic_lock_guard lock(own.m_lock);
+                            own.m_begin = begin;
+                            own.m_end = end;
+                        }
+                    }
+                    if (!stolen) {
+                        // No work left anywhere (except, possibly, for ranges which are being stolen
+                        // by other threads).
+                        break;
+                    }
+                }
+            } catch (...) {
+                stop.store(true);
+                throw;
+            }
+        };
+        future_list<void> f_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                f_list.push_back(enqueue(i, worker, i));
+            }
+            // First let's wait for everything to finish.
+            f_list.wait_all();
+            // Then, let's handle the exceptions.
+            f_list.get_all();
+        } catch (...) {
+            f_list.wait_all();
+            throw;
+        }
+    }
     /// Size
     /**
      * @return the number of threads in the pool.
@@ -504,112 +757,6 @@ inline void thread_pool_shutdown()
     thread_pool::shutdown();
 }
 }
-
-/// Class to store a list of futures.
-/**
- * This class is a minimal thin wrapper around an \p std::list of \p std::future<T> objects.
- * The class provides convenience methods to interact with the set of futures in an exception-safe manner.
- */
-// NOTE: we could provide method to retrieve future values from get_all() using a vector (in case the future type
-// is not void or a reference, in which case the get_all() method stays as it is).
-template <typename T>
-class future_list
-{
-    // Wait on a valid future, or abort.
-    static void wait_or_abort(const std::future<T> &fut)
-    {
-        piranha_assert(fut.valid());
-        try {
-            fut.wait();
-        } catch (...) {
-            // NOTE: logging candidate, with info from exception.
-            std::abort();
-        }
-    }
-
-public:
-    /// Defaulted default constructor.
-    /**
-     * This constructor will initialise an empty list of futures.
-     */
-    future_list() = default;
-    /// Deleted copy constructor.
-    future_list(const future_list &) = delete;
-    /// Deleted move constructor.
-    future_list(future_list &&) = delete;
-
-private:
-    future_list &operator=(const future_list &) = delete;
-    future_list &operator=(future_list &&) = delete;
-
-public:
-    /// Destructor
-    /**
-     * Will call wait_all().
-     */
-    ~future_list()
-    {
-        wait_all();
-    }
-    /// Move-insert a future.
-    /**
-     * Will move-insert the input future \p f into the internal container.
-     * If the insertion fails due to memory allocation errors and \p f is a valid
-     * future, then the method will wait on \p f before throwing the exception.
-     *
-     * @param f std::future to be move-inserted.
-     *
-     * @throws unspecified any exception thrown by memory allocation errors.
-     */
-    void push_back(std::future<T> &&f)
-    {
-        // Push back empty future.
-        try {
-            m_list.emplace_back();
-        } catch (...) {
-            // If we get some error here, we want to make sure we wait on the future
-            // before escaping out.
-            // NOTE: calling wait() on an invalid future is UB.
-            if (f.valid()) {
-                wait_or_abort(f);
-            }
-            throw;
-        }
-        // This cannot throw.
-        m_list.back() = std::move(f);
-    }
-    /// Wait on all the futures.
-    /**
-     * This method will call <tt>wait()</tt> on all the valid futures stored within the object.
-     */
-    void wait_all()
-    {
-        for (auto &f : m_list) {
-            if (f.valid()) {
-                wait_or_abort(f);
-            }
-        }
-    }
-    /// Get all the futures.
-    /**
-     * This method will call <tt>get()</tt> on all the valid futures stored within the object.
-     * The return values resulting from the calls to <tt>get()</tt> will be ignored.
-     *
-     * @throws unspecified an exception stored by a future.
-     */
-    void get_all()
-    {
-        for (auto &f : m_list) {
-            // NOTE: std::future's valid() method is noexcept.
-            if (f.valid()) {
-                (void)f.get();
-            }
-        }
-    }
-
-private:
-    std::list<std::future<T>> m_list;
-};
 }
 
 #endif
@@ -48,6 +48,9 @@ struct base_tuning {
     static std::atomic<bool> s_parallel_memory_set;
     static std::atomic<unsigned long> s_mult_block_size;
     static std::atomic<unsigned long> s_estimate_threshold;
+    static std::atomic<unsigned long> s_dense_mult_ratio;
+    static std::atomic<unsigned long long> s_mult_memory_budget;
+    static std::atomic<unsigned long> s_parallel_merge_threshold;
 };
 
 template <typename T>
@@ -58,6 +61,15 @@ std::atomic<unsigned long> base_tuning<T>::s_mult_block_size(256u);
 
 template <typename T>
 std::atomic<unsigned long> base_tuning<T>::s_estimate_threshold(200u);
+
+template <typename T>
+std::atomic<unsigned long> base_tuning<T>::s_dense_mult_ratio(32u);
+
+template <typename T>
+std::atomic<unsigned long long> base_tuning<T>::s_mult_memory_budget(0u);
+
+template <typename T>
+std::atomic<unsigned long> base_tuning<T>::s_parallel_merge_threshold(100000u);
 }
 
 /// Performance tuning.
@@ -181,6 +193,112 @@ public:
     {
         s_estimate_threshold.store(200u);
     }
+    /// Get the dense multiplication ratio.
+    /**
+     * The multiplication of polynomials with Kronecker monomials can be performed either via a hash table
+     * (sparse multiplication) or via a flat array of coefficients indexed by a dense codification of the
+     * monomials of the result (dense multiplication). The dense multiplication is selected when the size of the
+     * flat array is not greater than the estimated number of terms of the result multiplied by this ratio.
+     * A value of zero disables the dense multiplication.
+     *
+     * The default value of this flag is 32.
+     *
+     * @return the dense multiplication ratio.
+     */
+    static unsigned long get_dense_multiplication_ratio()
+    {
+        return s_dense_mult_ratio.load();
+    }
+    /// Set the dense multiplication ratio.
+    /**
+     * @see piranha::tuning::get_dense_multiplication_ratio() for an explanation of the meaning of this value.
+     *
+     * @param ratio desired value for the dense multiplication ratio.
+     */
+    static void set_dense_multiplication_ratio(unsigned long ratio)
+    {
+        s_dense_mult_ratio.store(ratio);
+    }
+    /// Reset the dense multiplication ratio.
+    /**
+     * This method will reset the dense multiplication ratio to its default value.
+     *
+     * @see piranha::tuning::get_dense_multiplication_ratio() for an explanation of the meaning of this value.
+     */
+    static void reset_dense_multiplication_ratio()
+    {
+        s_dense_mult_ratio.store(32u);
+    }
+    /// Get the multiplication memory budget.
+    /**
+     * This value, expressed in bytes, is an upper limit to the amount of working memory that the multiplication
+     * algorithms for certain series types (e.g., polynomials) should use. If the memory estimated to be required by
+     * the fastest algorithm exceeds the budget, a slower algorithm with smaller memory requirements will be used.
+     * A value of zero means that there is no limit.
+     *
+     * The default value of this flag is 0.
+     *
+     * @return the multiplication memory budget.
+     */
+    static unsigned long long get_multiplication_memory_budget()
+    {
+        return s_mult_memory_budget.load();
+    }
+    /// Set the multiplication memory budget.
+    /**
+     * @see piranha::tuning::get_multiplication_memory_budget() for an explanation of the meaning of this value.
+     *
+     * @param budget desired value for the multiplication memory budget.
+     */
+    static void set_multiplication_memory_budget(unsigned long long budget)
+    {
+        s_mult_memory_budget.store(budget);
+    }
+    /// Reset the multiplication memory budget.
+    /**
+     * This method will reset the multiplication memory budget to its default value.
+     *
+     * @see piranha::tuning::get_multiplication_memory_budget() for an explanation of the meaning of this value.
+     */
+    static void reset_multiplication_memory_budget()
+    {
+        s_mult_memory_budget.store(0u);
+    }
+    /// Get the parallel merge threshold.
+    /**
+     * When adding or subtracting series, the terms of one operand are merged into the other. If the number of
+     * terms to be merged is not less than the value returned by this method, the merge will be performed using
+     * multiple threads (subject to the minimum work per thread setting, see
+     * piranha::settings::get_min_work_per_thread()).
+     *
+     * The default value of this flag is 100000.
+     *
+     * @return the parallel merge threshold.
+     */
+    static unsigned long get_parallel_merge_threshold()
+    {
+        return s_parallel_merge_threshold.load();
+    }
+    /// Set the parallel merge threshold.
+    /**
+     * @see piranha::tuning::get_parallel_merge_threshold() for an explanation of the meaning of this value.
+     *
+     * @param size desired value for the parallel merge threshold.
+     */
+    static void set_parallel_merge_threshold(unsigned long size)
+    {
+        s_parallel_merge_threshold.store(size);
+    }
+    /// Reset the parallel merge threshold.
+    /**
+     * This method will reset the parallel merge threshold to its default value.
+     *
+     * @see piranha::tuning::get_parallel_merge_threshold() for an explanation of the meaning of this value.
+     */
+    static void reset_parallel_merge_threshold()
+    {
+        s_parallel_merge_threshold.store(100000u);
+    }
 };
 }
 
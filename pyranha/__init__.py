@@ -348,6 +348,155 @@ class settings(object):
         return _s._get_thread_binding()
 
 
+class profiler(object):
+    """Profiler class.
+
+    This class is used to control the profiler of Piranha via static methods. When enabled, the profiler records
+    the time spent in the main phases of the operations on series (e.g., the size estimation, the construction
+    of the task table and the term-by-term multiplications in series multiplication, series arithmetic,
+    exponentiation, substitution and serialization). The profiler is disabled by default.
+    The methods are thread-safe.
+
+    """
+
+    @staticmethod
+    def enable():
+        """Enable the profiler.
+
+        :raises: any exception raised by the invoked low-level function
+
+        >>> profiler.enable()
+        >>> profiler.is_enabled()
+        True
+        >>> profiler.disable()
+        >>> profiler.reset()
+
+        """
+        from ._core import _profiler as _p
+        return _p._enable()
+
+    @staticmethod
+    def disable():
+        """Disable the profiler.
+
+        The data recorded so far is preserved.
+
+        :raises: any exception raised by the invoked low-level function
+
+        >>> profiler.disable()
+        >>> profiler.is_enabled()
+        False
+
+        """
+        from ._core import _profiler as _p
+        return _p._disable()
+
+    @staticmethod
+    def is_enabled():
+        """Check if the profiler is enabled.
+
+        :returns: ``True`` if the profiler is enabled, ``False`` otherwise
+        :rtype: ``bool``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> profiler.is_enabled()
+        False
+
+        """
+        from ._core import _profiler as _p
+        return _p._is_enabled()
+
+    @staticmethod
+    def reset():
+        """Erase all the recorded events and counters.
+
+        :raises: any exception raised by the invoked low-level function
+
+        >>> profiler.reset()
+        >>> profiler.get_events()
+        []
+
+        """
+        from ._core import _profiler as _p
+        return _p._reset()
+
+    @staticmethod
+    def get_events():
+        """Get the recorded events.
+
+        Each event is represented as a tuple containing the name of the instrumented section,
+        the index of the thread in which the section was executed, the start time (in seconds from
+        program startup), the wall-clock duration and the processor time of the process during the
+        section (in seconds), and a dictionary of counts attached to the event (e.g., the number of terms
+        of the operands).
+
+        :returns: the list of the recorded events
+        :rtype: ``list``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> from pyranha.types import polynomial, integer, k_monomial
+        >>> x = polynomial[integer,k_monomial]()('x')
+        >>> profiler.enable()
+        >>> p = (x + 1) * (x - 1)
+        >>> profiler.disable()
+        >>> 'series.mul' in [ev[0] for ev in profiler.get_events()]
+        True
+        >>> profiler.reset()
+
+        """
+        from ._core import _profiler as _p
+        return _p._get_events()
+
+    @staticmethod
+    def get_counters():
+        """Get the global counters.
+
+        :returns: a dictionary mapping the names of the counters (e.g., ``'hash_set.rehash'``) to their values
+        :rtype: ``dict``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> profiler.get_counters()
+        {}
+
+        """
+        from ._core import _profiler as _p
+        return _p._get_counters()
+
+    @staticmethod
+    def to_chrome_trace():
+        """Export the recorded data as a Chrome trace.
+
+        The returned string is in the JSON trace event format, which can be loaded into the trace viewer
+        of the Chrome browser (``chrome://tracing``) and into other tools.
+
+        :returns: a JSON representation of the recorded data
+        :rtype: ``str``
+        :raises: any exception raised by the invoked low-level function
+
+        >>> import json
+        >>> json.loads(profiler.to_chrome_trace())['traceEvents']
+        []
+
+        """
+        from ._core import _profiler as _p
+        return _p._to_chrome_trace()
+
+    @staticmethod
+    def save_chrome_trace(name):
+        """Save the recorded data as a Chrome trace.
+
+        :param name: the name of the output file
+        :type name: ``str``
+        :raises: :exc:`TypeError` if *name* is not a string
+        :raises: any exception raised by the invoked low-level function
+
+        """
+        if not isinstance(name, str):
+            raise TypeError("the file name must be a string")
+        from ._core import _profiler as _p
+        return _p._save_chrome_trace(name)
+
+
 class data_format(object):
     """Data format.
 
@@ -389,6 +538,8 @@ class compression(object):
     gzip = _cf.gzip
     #: bzip2 compression.
     bzip2 = _cf.bzip2
+    #: zstd compression.
+    zstd = _cf.zstd
 
 
 def _save_load_check_params(name, df, cf):
@@ -31,16 +31,19 @@ see https://www.gnu.org/licenses/. */
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/python/class.hpp>
 #include <boost/python/def.hpp>
+#include <boost/python/dict.hpp>
 #include <boost/python/docstring_options.hpp>
 #include <boost/python/enum.hpp>
 #include <boost/python/errors.hpp>
 #include <boost/python/extract.hpp>
 #include <boost/python/handle.hpp>
 #include <boost/python/init.hpp>
+#include <boost/python/list.hpp>
 #include <boost/python/module.hpp>
 #include <boost/python/object.hpp>
 #include <boost/python/scope.hpp>
 #include <boost/python/stl_iterator.hpp>
+#include <boost/python/tuple.hpp>
 #include <cstdint>
 #include <mutex>
 #include <stdexcept>
@@ -63,6 +66,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/monomial.hpp>
 #include <piranha/poisson_series.hpp>
 #include <piranha/polynomial.hpp>
+#include <piranha/profiler.hpp>
 #include <piranha/rational.hpp>
 #if defined(MPPP_WITH_MPFR)
 #include <piranha/real.hpp>
@@ -109,6 +113,30 @@ static inline void test_exception()
 // Small helper to retrieve the argument error exception from python.
 static inline void generate_argument_error(int) {}
 
+// Convert the events recorded by the profiler into a list of tuples.
+static inline bp::list profiler_get_events()
+{
+    bp::list retval;
+    for (const auto &ev : piranha::profiler::get_events()) {
+        bp::dict counts;
+        for (const auto &p : ev.counts) {
+            counts[p.first] = p.second;
+        }
+        retval.append(bp::make_tuple(ev.name, ev.thread, ev.start, ev.wall, ev.cpu, counts));
+    }
+    return retval;
+}
+
+// Convert the global counters of the profiler into a dict.
+static inline bp::dict profiler_get_counters()
+{
+    bp::dict retval;
+    for (const auto &p : piranha::profiler::get_counters()) {
+        retval[p.first] = p.second;
+    }
+    return retval;
+}
+
 BOOST_PYTHON_MODULE(_core)
 {
     // NOTE: this is a single big lock to avoid registering types/conversions multiple times and prevent contention
@@ -204,7 +232,8 @@ BOOST_PYTHON_MODULE(_core)
         .value("none", piranha::compression::none)
         .value("zlib", piranha::compression::zlib)
         .value("gzip", piranha::compression::gzip)
-        .value("bzip2", piranha::compression::bzip2);
+        .value("bzip2", piranha::compression::bzip2)
+        .value("zstd", piranha::compression::zstd);
     // Expose polynomials.
     pyranha::instantiate_type_generator_template<piranha::polynomial>("polynomial", types_module);
     pyranha::expose_polynomials_0();
@@ -261,6 +290,17 @@ BOOST_PYTHON_MODULE(_core)
         .staticmethod("_set_thread_binding");
     settings_class.def("_get_thread_binding", piranha::settings::get_thread_binding)
         .staticmethod("_get_thread_binding");
+    // Expose the profiler.
+    bp::class_<piranha::profiler> profiler_class("_profiler", bp::init<>());
+    profiler_class.def("_enable", piranha::profiler::enable).staticmethod("_enable");
+    profiler_class.def("_disable", piranha::profiler::disable).staticmethod("_disable");
+    profiler_class.def("_is_enabled", piranha::profiler::is_enabled).staticmethod("_is_enabled");
+    profiler_class.def("_reset", piranha::profiler::reset).staticmethod("_reset");
+    profiler_class.def("_get_events", profiler_get_events).staticmethod("_get_events");
+    profiler_class.def("_get_counters", profiler_get_counters).staticmethod("_get_counters");
+    profiler_class.def("_to_chrome_trace", piranha::profiler::to_chrome_trace).staticmethod("_to_chrome_trace");
+    profiler_class.def("_save_chrome_trace", piranha::profiler::save_chrome_trace)
+        .staticmethod("_save_chrome_trace");
     // Factorial.
     bp::def("_factorial", &piranha::math::factorial<1>);
 // Binomial coefficient.
@@ -39,7 +39,7 @@ def _s11n_load_save_test(self, p):
     import shutil
     from . import load_file, save_file, data_format as df, compression as comp
     for form in [df.boost_portable, df.boost_binary, df.msgpack_portable, df.msgpack_binary]:
-        for c in [comp.none, comp.bzip2, comp.gzip, comp.zlib]:
+        for c in [comp.none, comp.bzip2, comp.gzip, comp.zlib, comp.zstd]:
             f = tempfile.NamedTemporaryFile(delete=False)
             f.close()
             try:
@@ -55,14 +55,16 @@ def _s11n_load_save_test(self, p):
     temp_dir = tempfile.mkdtemp()
     try:
         for suff in ['.boostb', '.boostp', '.mpackb', '.mpackp']:
-            for comp in ['', '.bz2', '.zip', '.gz']:
+            for comp in ['', '.bz2', '.zip', '.gz', '.zst']:
                 filename = os.path.join(temp_dir, 'foo' + suff + comp)
-                save_file(p, filename)
+                # Skip only the combinations which are not available in this build.
+                try:
+                    save_file(p, filename)
+                except NotImplementedError:
+                    continue
                 ret = type(p)()
                 load_file(ret, filename)
                 self.assertEqual(ret, p)
-    except NotImplementedError:
-        pass
     finally:
         shutil.rmtree(temp_dir)
     self.assertRaises(ValueError, lambda: save_file(p, "foo"))
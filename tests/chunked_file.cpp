@@ -0,0 +1,213 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/chunked_file.hpp>
+
+#define BOOST_TEST_MODULE chunked_file_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <ios>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
+
+using namespace piranha;
+
+static std::random_device rd;
+
+struct tmp_file {
+    tmp_file() : m_path(PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd())) {}
+    ~tmp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+    std::string m_path;
+};
+
+using p_type = polynomial<integer, kronecker_monomial<>>;
+using q_type = polynomial<rational, monomial<int>>;
+
+static const std::initializer_list<data_format> dfs = {data_format::boost_binary, data_format::boost_portable,
+                                                       data_format::msgpack_binary, data_format::msgpack_portable};
+
+static const std::initializer_list<compression> cfs
+    = {compression::none, compression::bzip2, compression::zlib, compression::gzip, compression::zstd};
+
+// Save and load x in chunked form, returning false if the data or compression format is not available.
+template <typename T>
+static inline bool chunked_roundtrip(const T &x, data_format f, compression c, std::size_t chunk_size)
+{
+    tmp_file file;
+    try {
+        save_chunked_file(x, file.m_path, f, c, chunk_size);
+    } catch (const not_implemented_error &) {
+        return false;
+    }
+    T retval;
+    load_chunked_file(retval, file.m_path);
+    BOOST_CHECK_EQUAL(retval, x);
+    BOOST_CHECK(retval.get_symbol_set() == x.get_symbol_set());
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(chunked_file_roundtrip_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 12);
+    q_type a{"a"}, b{"b"};
+    const auto t = piranha::pow(a / 2 - b / 3 + 1, 10);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        for (auto f : dfs) {
+            for (auto c : cfs) {
+                if (!chunked_roundtrip(s, f, c, 0u)) {
+                    continue;
+                }
+                // Empty series, with and without symbols.
+                chunked_roundtrip(p_type{}, f, c, 0u);
+                chunked_roundtrip(p_type{} + x - x, f, c, 0u);
+                // Various chunk sizes, including a single chunk and one chunk per term.
+                for (std::size_t cs : {1u, 7u, 100u, 100000u}) {
+                    chunked_roundtrip(s, f, c, cs);
+                }
+                chunked_roundtrip(t, f, c, 13u);
+            }
+        }
+    }
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(chunked_file_error_test)
+{
+    p_type x{"x"}, y{"y"};
+    p_type out{"z"};
+    BOOST_CHECK_THROW(load_chunked_file(out, PIRANHA_BINARY_TESTS_DIR "/nonexistent_chunked_file"),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(out, p_type{"z"});
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    const auto s = piranha::pow(x - y + 1, 20);
+    tmp_file f;
+    save_chunked_file(s, f.m_path, data_format::boost_binary, compression::none, 10u);
+    std::string content;
+    {
+        std::ifstream ifs(f.m_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    auto write = [&f](const std::string &str) {
+        std::ofstream ofs(f.m_path, std::ios::binary | std::ios::trunc);
+        ofs.write(str.data(), static_cast<std::streamsize>(str.size()));
+    };
+    // Truncated file.
+    write(content.substr(0u, content.size() - 1u));
+    BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+    write(content.substr(0u, 20u));
+    BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+    // Trailing data.
+    write(content + "x");
+    BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+    // Invalid signature.
+    auto tmp = content;
+    tmp[0] = 'X';
+    write(tmp);
+    BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+    // Invalid compression format.
+    tmp = content;
+    tmp[24] = 100;
+    write(tmp);
+    BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+    // The output series was never modified.
+    BOOST_CHECK_EQUAL(out, p_type{"z"});
+    // The original file loads correctly.
+    write(content);
+    load_chunked_file(out, f.m_path);
+    BOOST_CHECK_EQUAL(out, s);
+#endif
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+// Little-endian encoding of a 64-bit unsigned integer, as used in the header of a chunked file.
+static inline std::string u64_le(std::uint64_t n)
+{
+    std::string retval;
+    for (auto i = 0; i < 8; ++i) {
+        retval.push_back(static_cast<char>(static_cast<unsigned char>(n & 0xffu)));
+        n >>= 8;
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(chunked_file_duplicate_test)
+{
+    p_type x{"x"}, y{"y"};
+    const auto s = piranha::pow(x - y + 1, 20);
+    tmp_file f;
+    save_chunked_file(s, f.m_path, data_format::boost_binary, compression::none, 10u);
+    std::string content;
+    {
+        std::ifstream ifs(f.m_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    // Build a file in which every chunk appears twice, so that each term is duplicated across chunks.
+    const std::size_t n_chunks = (s.size() - 1u) / 10u + 1u;
+    const auto sizes = content.substr(48u, 8u * n_chunks), chunks = content.substr(48u + 8u * n_chunks);
+    {
+        std::ofstream ofs(f.m_path, std::ios::binary | std::ios::trunc);
+        const auto dup = content.substr(0u, 32u) + u64_le(2u * s.size()) + u64_le(2u * n_chunks) + sizes + sizes
+                         + chunks + chunks;
+        ofs.write(dup.data(), static_cast<std::streamsize>(dup.size()));
+    }
+    // Make sure the terms are inserted concurrently when multiple threads are available.
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        p_type out{"z"};
+        BOOST_CHECK_THROW(load_chunked_file(out, f.m_path), std::invalid_argument);
+        BOOST_CHECK_EQUAL(out, p_type{"z"});
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
+#endif
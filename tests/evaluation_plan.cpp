@@ -0,0 +1,110 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#include <piranha/evaluation_plan.hpp>
+
+#define BOOST_TEST_MODULE evaluation_plan_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+// Check that the plan gives the same results as math::evaluate().
+template <typename T, typename P>
+static inline void check_plan(const P &p, const std::vector<std::vector<T>> &points)
+{
+    evaluation_plan<P, T> plan(p);
+    BOOST_CHECK_EQUAL(plan.size(), p.size());
+    BOOST_CHECK(plan.get_symbol_set() == p.get_symbol_set());
+    for (const auto &v : points) {
+        symbol_fmap<T> dict;
+        auto it = v.begin();
+        for (const auto &s : p.get_symbol_set()) {
+            dict.emplace(s, *it++);
+        }
+        const auto cmp = math::evaluate(p, dict);
+        BOOST_CHECK_EQUAL(plan(v), cmp);
+        // Copy and move.
+        auto plan2(plan);
+        BOOST_CHECK_EQUAL(plan2(v), cmp);
+        auto plan3(std::move(plan2));
+        BOOST_CHECK_EQUAL(plan3(v), cmp);
+    }
+    BOOST_CHECK_THROW(plan(std::vector<T>(p.get_symbol_set().size() + 1u)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_test)
+{
+    {
+        // Kronecker monomials.
+        using p_type = polynomial<integer, kronecker_monomial<>>;
+        BOOST_CHECK((evaluation_plan_enabled<p_type, integer>::value));
+        BOOST_CHECK((evaluation_plan_enabled<p_type, double>::value));
+        BOOST_CHECK((evaluation_plan_enabled<p_type, rational>::value));
+        BOOST_CHECK((!evaluation_plan_enabled<p_type, std::string>::value));
+        BOOST_CHECK((!evaluation_plan_enabled<integer, integer>::value));
+        p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+        // Empty and constant series.
+        check_plan<integer>(p_type{}, {{}});
+        check_plan<integer>(p_type{3}, {{}});
+        const auto p = piranha::pow(1 + x - 2 * y + 3 * z - t, 8) * (x - y);
+        check_plan<integer>(p, {{1_z, 2_z, 3_z, 4_z}, {-1_z, 0_z, 5_z, -7_z}});
+        check_plan<rational>(p, {{1 / 2_q, -2 / 3_q, 3_q, 4 / 5_q}});
+        check_plan<double>(p, {{1.1, -.3, .7, 2.}, {-1., .5, .25, -.125}});
+        // The products shared by the keys are computed only once.
+        evaluation_plan<p_type, double> plan(p);
+        BOOST_CHECK(integer(plan.n_multiplications()) < integer(p.size()) * 3);
+    }
+    {
+        // Monomials with negative exponents.
+        using p_type = polynomial<rational, monomial<int>>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p = piranha::pow(x / 2 + 1 / 3_q * y - z + 1, 6) * piranha::pow(x, -3) + piranha::pow(y, -10);
+        check_plan<rational>(p, {{1 / 3_q, -2_q, 5 / 7_q}, {-7 / 3_q, 1_q, 3_q}});
+        check_plan<double>(p, {{1.1, .3, .7}});
+    }
+    {
+        // Unsupported keys.
+        using p_type = polynomial<rational, monomial<rational>>;
+        BOOST_CHECK((!evaluation_plan_enabled<p_type, double>::value));
+    }
+}
@@ -0,0 +1,268 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/flat_hash_set.hpp>
+
+#define BOOST_TEST_MODULE flat_hash_set_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <piranha/detail/debug_access.hpp>
+#include <piranha/hash_set.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+// Polynomial type whose terms are stored in a flat_hash_set.
+using p_type = polynomial<integer, kronecker_monomial<int>>;
+
+namespace piranha
+{
+
+template <>
+struct series_container<p_type> {
+    template <typename Term>
+    using type = flat_hash_set<Term>;
+};
+
+struct sanity_check_tag {
+};
+
+template <>
+class debug_access<sanity_check_tag>
+{
+public:
+    template <typename T>
+    static bool run(const T &h)
+    {
+        return h.sanity_check();
+    }
+};
+}
+
+using sc = debug_access<sanity_check_tag>;
+
+// Hasher producing many collisions, to exercise the overflow groups.
+struct bad_hasher {
+    std::size_t operator()(int n) const
+    {
+        return static_cast<std::size_t>(n) % 5u;
+    }
+};
+
+template <typename Set>
+static void check_contents(const Set &h, const std::set<int> &ref)
+{
+    BOOST_CHECK_EQUAL(h.size(), ref.size());
+    std::set<int> tmp(h.begin(), h.end());
+    BOOST_CHECK(tmp == ref);
+    for (auto n : ref) {
+        const auto it = h.find(n);
+        BOOST_CHECK(it != h.end());
+        BOOST_CHECK_EQUAL(*it, n);
+    }
+    BOOST_CHECK(sc::run(h));
+}
+
+template <typename Set>
+static void random_ops_test()
+{
+    Set h;
+    std::set<int> ref;
+    std::uniform_int_distribution<int> dist(-3000, 3000);
+    for (int i = 0; i < 20000; ++i) {
+        const auto n = dist(rng);
+        if (rng() % 3u == 0u) {
+            const auto it = h.find(n);
+            BOOST_CHECK_EQUAL(it != h.end(), ref.count(n) == 1u);
+            if (it != h.end()) {
+                h.erase(it);
+                ref.erase(n);
+            }
+        } else {
+            const auto p = h.insert(n);
+            BOOST_CHECK_EQUAL(p.second, ref.count(n) == 0u);
+            BOOST_CHECK_EQUAL(*p.first, n);
+            ref.insert(n);
+        }
+    }
+    check_contents(h, ref);
+    // Copy, move and rehash.
+    auto h_copy(h);
+    check_contents(h_copy, ref);
+    auto h_move(std::move(h_copy));
+    check_contents(h_move, ref);
+    BOOST_CHECK(h_copy.empty() && h_copy.bucket_count() == 0u);
+    h_move.rehash(h_move.bucket_count() * 4u);
+    check_contents(h_move, ref);
+    h_move.rehash(1u);
+    check_contents(h_move, ref);
+    for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+        h_move.rehash(h_move.bucket_count() * 2u, n_threads);
+        check_contents(h_move, ref);
+    }
+    // Erase the odd elements while iterating.
+    for (auto it = h.begin(); it != h.end();) {
+        if (*it % 2) {
+            ref.erase(*it);
+            it = h.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    check_contents(h, ref);
+    // Sparsity.
+    std::size_t count = 0u;
+    for (const auto &p : h.evaluate_sparsity()) {
+        count += p.first * p.second;
+    }
+    BOOST_CHECK_EQUAL(count, h.size());
+    h.clear();
+    BOOST_CHECK(h.empty() && h.bucket_count() == 0u && h.begin() == h.end());
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_basic_test)
+{
+    flat_hash_set<int> h;
+    BOOST_CHECK(h.empty());
+    BOOST_CHECK_EQUAL(h.bucket_count(), 0u);
+    BOOST_CHECK(h.begin() == h.end());
+    BOOST_CHECK(h.find(1) == h.end());
+    BOOST_CHECK_THROW(h.bucket(1), std::invalid_argument);
+    BOOST_CHECK(h.insert(1).second);
+    BOOST_CHECK(!h.insert(1).second);
+    BOOST_CHECK_EQUAL(h.size(), 1u);
+    BOOST_CHECK_EQUAL(*h.begin(), 1);
+    BOOST_CHECK(h.max_load_factor() > 1.);
+    flat_hash_set<std::string> hs{std::string("a"), std::string("b"), std::string("a")};
+    BOOST_CHECK_EQUAL(hs.size(), 2u);
+    BOOST_CHECK(hs.find("b") != hs.end());
+    BOOST_CHECK(is_container_element<flat_hash_set<int>>::value);
+    BOOST_CHECK((flat_hash_set<int>(100u).bucket_count() >= 100u));
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_random_test)
+{
+    random_ops_test<flat_hash_set<int>>();
+    random_ops_test<flat_hash_set<int, bad_hasher>>();
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_low_level_test)
+{
+    // Fill a single bucket past the capacity of a group.
+    flat_hash_set<int, bad_hasher> h(1u);
+    BOOST_CHECK_EQUAL(h.bucket_count(), 1u);
+    for (int i = 0; i < 100; ++i) {
+        const auto b_idx = h._bucket(i);
+        BOOST_CHECK(h._find(i, b_idx) == h.end());
+        h._unique_insert(i, b_idx);
+        BOOST_CHECK(h._find(i, b_idx) != h.end());
+    }
+    h._update_size(100u);
+    BOOST_CHECK(sc::run(h));
+    int count = 0;
+    for (const auto &n : h._get_bucket_list(0u)) {
+        BOOST_CHECK(n >= 0 && n < 100);
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 100);
+    // Erase everything via the low-level interface: the overflow groups are released as they become empty.
+    for (int i = 0; i < 100; ++i) {
+        h._erase(h._find(i, 0u));
+    }
+    h._update_size(0u);
+    BOOST_CHECK(h._get_bucket_list(0u).begin() == h._get_bucket_list(0u).end());
+    BOOST_CHECK(sc::run(h));
+    h._increase_size();
+    BOOST_CHECK_EQUAL(h.bucket_count(), 2u);
+    // Mutable iterators.
+    flat_hash_set<int> h2;
+    BOOST_CHECK(h2._m_begin() == h2._m_end());
+    h2.insert(0);
+    *h2._m_begin() = 42;
+    BOOST_CHECK_EQUAL(*h2.begin(), 42);
+    h2.clear();
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_mt_test)
+{
+    thread_pool::resize(4u);
+    BOOST_CHECK_THROW(flat_hash_set<int>(10000, std::hash<int>(), std::equal_to<int>(), 0u), std::invalid_argument);
+    std::uniform_int_distribution<std::size_t> size_dist(0u, 10000u);
+    std::uniform_int_distribution<unsigned> thread_dist(1u, 4u);
+    for (int i = 0; i < 100; ++i) {
+        auto bcount = size_dist(rng);
+        flat_hash_set<int> h(bcount, std::hash<int>(), std::equal_to<int>(), thread_dist(rng));
+        BOOST_CHECK(h.bucket_count() >= bcount);
+        for (int j = 0; j < 1000; ++j) {
+            h.insert(j);
+        }
+        bcount = size_dist(rng);
+        h.rehash(bcount, thread_dist(rng));
+        BOOST_CHECK_EQUAL(h.size(), 1000u);
+        BOOST_CHECK(sc::run(h));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_series_test)
+{
+    using q_type = polynomial<rational, kronecker_monomial<int>>;
+    BOOST_CHECK((std::is_same<decltype(p_type{}._container()), flat_hash_set<p_type::term_type> &>::value));
+    BOOST_CHECK((std::is_same<decltype(q_type{}._container()), hash_set<q_type::term_type> &>::value));
+    for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+        settings::set_n_threads(n_threads);
+        p_type x{"x"}, y{"y"}, z{"z"};
+        q_type qx{"x"}, qy{"y"}, qz{"z"};
+        auto f = (x + y + z + 1).pow(10), g = (x - y + 2 * z - 1).pow(10);
+        auto qf = (qx + qy + qz + 1).pow(10), qg = (qx - qy + 2 * qz - 1).pow(10);
+        BOOST_CHECK(f == qf);
+        BOOST_CHECK(f * g == qf * qg);
+        BOOST_CHECK(f * (f + 1) - f * f - f == 0);
+        BOOST_CHECK(f + g == qf + qg);
+        BOOST_CHECK(f - g == qf - qg);
+    }
+    settings::reset_n_threads();
+}
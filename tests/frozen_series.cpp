@@ -0,0 +1,180 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/frozen_series.hpp>
+
+#define BOOST_TEST_MODULE frozen_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <piranha/config.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+using p_type = polynomial<integer, kronecker_monomial<>>;
+using q_type = polynomial<rational, monomial<int>>;
+
+BOOST_AUTO_TEST_CASE(frozen_series_ctor_test)
+{
+    using f_type = frozen_series<p_type>;
+    BOOST_CHECK((std::is_nothrow_move_constructible<f_type>::value));
+    f_type f0;
+    BOOST_CHECK(f0.empty());
+    BOOST_CHECK_EQUAL(f0.size(), 0u);
+    BOOST_CHECK(f0.get_symbol_set().empty());
+    BOOST_CHECK_EQUAL(f0.thaw(), p_type{});
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 6);
+    f_type f1(s);
+    BOOST_CHECK_EQUAL(f1.size(), s.size());
+    BOOST_CHECK_EQUAL(f1.cfs().size(), s.size());
+    BOOST_CHECK_EQUAL(f1.keys().size(), s.size());
+    BOOST_CHECK(f1.get_symbol_set() == s.get_symbol_set());
+    BOOST_CHECK_EQUAL(f1.thaw(), s);
+    BOOST_CHECK_EQUAL(f1.thaw().size(), s.size());
+    // Copy and move.
+    auto f2(f1);
+    BOOST_CHECK_EQUAL(f2.thaw(), s);
+    auto f3(std::move(f2));
+    BOOST_CHECK_EQUAL(f3.thaw(), s);
+    BOOST_CHECK(f2.empty());
+    BOOST_CHECK(f2.get_symbol_set().empty());
+    f2 = f3;
+    BOOST_CHECK_EQUAL(f2.thaw(), s);
+    f2 = std::move(f3);
+    BOOST_CHECK_EQUAL(f2.thaw(), s);
+    BOOST_CHECK(f3.empty());
+    // Construction from rvalue series.
+    auto s_copy(s);
+    f_type f4(std::move(s_copy));
+    BOOST_CHECK_EQUAL(f4.size(), s.size());
+    BOOST_CHECK_EQUAL(s_copy.size(), 0u);
+    BOOST_CHECK(s_copy.get_symbol_set().empty());
+    // Thaw an rvalue.
+    const auto s2 = std::move(f4).thaw();
+    BOOST_CHECK_EQUAL(s2, s);
+    BOOST_CHECK(f4.empty());
+    // The thawed series is fully functional.
+    BOOST_CHECK_EQUAL(s2 - s, 0);
+    BOOST_CHECK_EQUAL(f_type(s).thaw() * x, s * x);
+    // Rational coefficients, non-Kronecker keys.
+    q_type a{"a"}, b{"b"};
+    const auto t = piranha::pow(a / 2 - b / 3 + 1, 5);
+    BOOST_CHECK_EQUAL(frozen_series<q_type>(t).thaw(), t);
+}
+
+BOOST_AUTO_TEST_CASE(frozen_series_evaluate_degree_test)
+{
+    using f_type = frozen_series<p_type>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 5) * x;
+    const f_type f(s);
+    const symbol_fmap<integer> dict{{"x", integer{2}}, {"y", integer{-3}}, {"z", integer{5}}};
+    BOOST_CHECK_EQUAL(f.evaluate(dict), math::evaluate(s, dict));
+    const symbol_fmap<double> ddict{{"x", 1.5}, {"y", -.5}, {"z", 2.}};
+    BOOST_CHECK_EQUAL(f.evaluate(ddict), math::evaluate(s, ddict));
+    BOOST_CHECK_THROW(f.evaluate(symbol_fmap<integer>{{"x", integer{2}}}), std::invalid_argument);
+    BOOST_CHECK_EQUAL(f_type{}.evaluate(dict), 0);
+    BOOST_CHECK_EQUAL(f.degree(), s.degree());
+    BOOST_CHECK_EQUAL(f.degree({"x"}), s.degree({"x"}));
+    BOOST_CHECK_EQUAL(f.degree({"y", "z"}), s.degree({"y", "z"}));
+    BOOST_CHECK_EQUAL(f.degree({"t"}), 0);
+    BOOST_CHECK_EQUAL(f_type{}.degree(), 0);
+    BOOST_CHECK_EQUAL(f_type{}.degree({"x"}), 0);
+}
+
+BOOST_AUTO_TEST_CASE(frozen_series_filter_negate_test)
+{
+    using f_type = frozen_series<p_type>;
+    p_type x{"x"}, y{"y"};
+    const auto s = piranha::pow(1 + x - 2 * y, 6);
+    f_type f(s);
+    f.filter([](const integer &c, const kronecker_monomial<> &) { return math::abs(c) >= 100; });
+    BOOST_CHECK_EQUAL(f.thaw(),
+                      s.filter([](const std::pair<integer, p_type> &p) { return math::abs(p.first) >= 100; }));
+    f_type g(s);
+    g.negate();
+    BOOST_CHECK_EQUAL(g.thaw(), -s);
+    g.filter([](const integer &, const kronecker_monomial<> &) { return false; });
+    BOOST_CHECK(g.empty());
+    BOOST_CHECK_EQUAL(g.thaw(), 0);
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+BOOST_AUTO_TEST_CASE(frozen_series_boost_s11n_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 4);
+    std::stringstream ss;
+    {
+        boost::archive::binary_oarchive oa(ss);
+        boost_save(oa, frozen_series<p_type>(s));
+    }
+    p_type retval;
+    {
+        boost::archive::binary_iarchive ia(ss);
+        boost_load(ia, retval);
+    }
+    BOOST_CHECK_EQUAL(retval, s);
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+BOOST_AUTO_TEST_CASE(frozen_series_msgpack_s11n_test)
+{
+    BOOST_CHECK((has_msgpack_pack<msgpack::sbuffer, frozen_series<p_type>>::value));
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 4);
+    for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+        msgpack::sbuffer sbuf;
+        msgpack::packer<msgpack::sbuffer> p(sbuf);
+        msgpack_pack(p, frozen_series<p_type>(s), f);
+        auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        p_type retval;
+        msgpack_convert(retval, oh.get(), f);
+        BOOST_CHECK_EQUAL(retval, s);
+    }
+}
+
+#endif
@@ -0,0 +1,165 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/graded_series.hpp>
+
+#define BOOST_TEST_MODULE graded_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+using p_type = polynomial<integer, kronecker_monomial<>>;
+using q_type = polynomial<rational, monomial<int>>;
+
+BOOST_AUTO_TEST_CASE(graded_series_ctor_test)
+{
+    using g_type = graded_series<p_type>;
+    BOOST_CHECK((std::is_same<g_type::degree_type, decltype(p_type{}.degree())>::value));
+    g_type g0;
+    BOOST_CHECK(g0.empty());
+    BOOST_CHECK_EQUAL(g0.size(), 0u);
+    BOOST_CHECK_EQUAL(g0.degree(), 0);
+    BOOST_CHECK_EQUAL(g0.ldegree(), 0);
+    BOOST_CHECK(!g0.is_partial());
+    BOOST_CHECK_EQUAL(g0.to_series(), p_type{});
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 6) + x * x * piranha::pow(y, 7);
+    g_type g1(s);
+    BOOST_CHECK_EQUAL(g1.size(), s.size());
+    BOOST_CHECK(g1.get_symbol_set() == s.get_symbol_set());
+    BOOST_CHECK_EQUAL(g1.to_series(), s);
+    BOOST_CHECK_EQUAL(g1.degree(), 9);
+    BOOST_CHECK_EQUAL(g1.ldegree(), 0);
+    BOOST_CHECK_EQUAL(g1.slices().size(), 8u);
+    for (const auto &p : g1.slices()) {
+        BOOST_CHECK(!p.second.empty());
+        BOOST_CHECK_EQUAL(p.second.degree(), p.first);
+        BOOST_CHECK_EQUAL(p.second.ldegree(), p.first);
+    }
+    // Partial grading.
+    g_type g2(s, symbol_fset{"y"});
+    BOOST_CHECK(g2.is_partial());
+    BOOST_CHECK(g2.get_names() == symbol_fset{"y"});
+    BOOST_CHECK_EQUAL(g2.to_series(), s);
+    BOOST_CHECK_EQUAL(g2.degree(), s.degree(symbol_fset{"y"}));
+    BOOST_CHECK_EQUAL(g2.ldegree(), 0);
+    for (const auto &p : g2.slices()) {
+        BOOST_CHECK_EQUAL(p.second.degree(symbol_fset{"y"}), p.first);
+    }
+    BOOST_CHECK(g1 != g2);
+    // Copy and move.
+    auto g3(g1);
+    BOOST_CHECK(g3 == g1);
+    auto g4(std::move(g3));
+    BOOST_CHECK(g4 == g1);
+    g3 = g2;
+    BOOST_CHECK(g3 == g2);
+    g3 = std::move(g4);
+    BOOST_CHECK(g3 == g1);
+}
+
+BOOST_AUTO_TEST_CASE(graded_series_arith_test)
+{
+    using g_type = graded_series<q_type>;
+    q_type x{"x"}, y{"y"}, z{"z"};
+    const auto a = piranha::pow(1 + x - y / 2, 5), b = piranha::pow(z - x + 2, 4) - 3 * z;
+    g_type ga(a), gb(b);
+    BOOST_CHECK_EQUAL((ga + gb).to_series(), a + b);
+    BOOST_CHECK_EQUAL((ga - gb).to_series(), a - b);
+    BOOST_CHECK_EQUAL((ga * gb).to_series(), a * b);
+    BOOST_CHECK((ga * gb) == g_type(a * b));
+    BOOST_CHECK((ga + gb).get_symbol_set() == (a + b).get_symbol_set());
+    // Cancellation removes the slices.
+    BOOST_CHECK((ga - ga).empty());
+    BOOST_CHECK((ga + g_type(-a)).slices().empty());
+    auto gc(ga);
+    gc += gb;
+    gc -= gb;
+    BOOST_CHECK(gc == ga);
+    gc *= gb;
+    BOOST_CHECK_EQUAL(gc.to_series(), a * b);
+    // Truncation.
+    for (int d = -1; d <= 10; ++d) {
+        auto gt(gc);
+        gt.truncate_degree(d);
+        BOOST_CHECK_EQUAL(gt.to_series(), (a * b).truncate_degree(d));
+        BOOST_CHECK(gt.empty() || gt.degree() <= d);
+        BOOST_CHECK_EQUAL(g_type::truncated_multiplication(ga, gb, d).to_series(),
+                          q_type::truncated_multiplication(a, b, d));
+    }
+    // Partial grading.
+    const symbol_fset xz{"x", "z"};
+    g_type pa(a, xz), pb(b, xz);
+    BOOST_CHECK_EQUAL((pa * pb).to_series(), a * b);
+    for (int d = 0; d <= 9; ++d) {
+        BOOST_CHECK_EQUAL(g_type::truncated_multiplication(pa, pb, d).to_series(),
+                          q_type::truncated_multiplication(a, b, d, xz));
+    }
+    // Gradings must match.
+    BOOST_CHECK_THROW(ga + pb, std::invalid_argument);
+    BOOST_CHECK_THROW(ga * pb, std::invalid_argument);
+    BOOST_CHECK_THROW(g_type(a, symbol_fset{"x"}) - pb, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(graded_series_auto_truncation_test)
+{
+    using g_type = graded_series<q_type>;
+    q_type x{"x"}, y{"y"}, z{"z"};
+    const auto a = piranha::pow(1 + x - y / 2 + z, 6), b = piranha::pow(z - x + 2 * y, 5) + 1;
+    g_type ga(a), gb(b), pa(a, symbol_fset{"y"}), pb(b, symbol_fset{"y"});
+    // Total degree truncation with total grading: only the slices within the limit are multiplied.
+    q_type::set_auto_truncate_degree(7);
+    BOOST_CHECK_EQUAL((ga * gb).to_series(), a * b);
+    BOOST_CHECK((ga * gb).degree() <= 7);
+    // Total degree truncation with partial grading: the truncation is applied to the slice products.
+    BOOST_CHECK_EQUAL((pa * pb).to_series(), a * b);
+    // Partial degree truncation.
+    q_type::set_auto_truncate_degree(2, {"y"});
+    BOOST_CHECK_EQUAL((pa * pb).to_series(), a * b);
+    BOOST_CHECK((pa * pb).degree() <= 2);
+    BOOST_CHECK_EQUAL((ga * gb).to_series(), a * b);
+    q_type::set_auto_truncate_degree(3, {"x"});
+    BOOST_CHECK_EQUAL((pa * pb).to_series(), a * b);
+    // The explicit truncated multiplication ignores the automatic truncation.
+    BOOST_CHECK_EQUAL(g_type::truncated_multiplication(ga, gb, 4).to_series(),
+                      q_type::truncated_multiplication(a, b, 4));
+    q_type::unset_auto_truncate_degree();
+    BOOST_CHECK_EQUAL((ga * gb).to_series(), a * b);
+}
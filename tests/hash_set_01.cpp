@@ -675,6 +675,89 @@ BOOST_AUTO_TEST_CASE(hash_set_mt_test)
     }
 }
 
+struct zero_hasher {
+    std::size_t operator()(int) const
+    {
+        return 0u;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(hash_set_arena_test)
+{
+    // All elements end up in the same bucket: every element but the first one
+    // is stored in a node coming from the arena.
+    hash_set<int, zero_hasher> h;
+    BOOST_CHECK_EQUAL(h._arena_stats().first, 0u);
+    BOOST_CHECK_EQUAL(h._arena_stats().second, 0u);
+    for (int i = 0; i < 100; ++i) {
+        h.insert(i);
+    }
+    BOOST_CHECK_EQUAL(h._arena_stats().first, 99u);
+    BOOST_CHECK(h._arena_stats().second > 0u);
+    const auto bcount = h.bucket_count();
+    const auto n_slabs = h._arena_stats().second;
+    // Erased nodes are recycled.
+    for (int i = 0; i < 50; ++i) {
+        h.erase(h.find(i));
+    }
+    for (int i = 100; i < 150; ++i) {
+        h.insert(i);
+    }
+    BOOST_CHECK_EQUAL(h.bucket_count(), bcount);
+    BOOST_CHECK_EQUAL(h._arena_stats().first, 99u);
+    BOOST_CHECK_EQUAL(h._arena_stats().second, n_slabs);
+    for (int i = 50; i < 150; ++i) {
+        BOOST_CHECK(h.find(i) != h.end());
+    }
+    // Copies get their own arena.
+    auto h2(h);
+    BOOST_CHECK_EQUAL(h2._arena_stats().first, 99u);
+    BOOST_CHECK_EQUAL(h2.size(), 100u);
+    // Clearing releases the arena in bulk.
+    h.clear();
+    BOOST_CHECK_EQUAL(h._arena_stats().first, 0u);
+    BOOST_CHECK_EQUAL(h._arena_stats().second, 0u);
+    BOOST_CHECK_EQUAL(h2.size(), 100u);
+    for (int i = 50; i < 150; ++i) {
+        BOOST_CHECK(h2.find(i) != h2.end());
+    }
+    // The arena is created only at the first collision.
+    hash_set<int> h3(1000u);
+    for (int i = 0; i < 10; ++i) {
+        h3.insert(i);
+    }
+    std::size_t n_overflow = 0u;
+    for (const auto &p : h3.evaluate_sparsity()) {
+        if (p.first > 1u) {
+            n_overflow += (p.first - 1u) * p.second;
+        }
+    }
+    BOOST_CHECK_EQUAL(h3._arena_stats().first, n_overflow);
+    BOOST_CHECK_EQUAL(h3._arena_stats().second == 0u, n_overflow == 0u);
+    hash_set<int, zero_hasher> h4;
+    h4.insert(0);
+    BOOST_CHECK_EQUAL(h4._arena_stats().second, 0u);
+    h4.insert(1);
+    BOOST_CHECK_EQUAL(h4._arena_stats().first, 1u);
+    BOOST_CHECK_EQUAL(h4._arena_stats().second, 1u);
+    // Alternating insertions in two sets.
+    hash_set<int, zero_hasher> h5, h6;
+    for (int i = 0; i < 100; ++i) {
+        h5.insert(i);
+        h6.insert(-i);
+    }
+    BOOST_CHECK_EQUAL(h5._arena_stats().first, 99u);
+    BOOST_CHECK_EQUAL(h6._arena_stats().first, 99u);
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK(h5.find(i) != h5.end());
+        BOOST_CHECK(h6.find(-i) != h6.end());
+    }
+    // Swapping exchanges the arenas.
+    h5.swap(h4);
+    BOOST_CHECK_EQUAL(h5._arena_stats().first, 1u);
+    BOOST_CHECK_EQUAL(h4._arena_stats().first, 99u);
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(hash_set_serialization_test)
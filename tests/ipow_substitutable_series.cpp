@@ -61,6 +61,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/s11n.hpp>
 #include <piranha/series.hpp>
 #include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/term.hpp>
 
@@ -412,6 +413,56 @@ BOOST_AUTO_TEST_CASE(ipow_subs_series_subs_test)
     }
 }
 
+// Reference substitution computed without the bulk engine: the ipow_subs() method of each key is called
+// directly, and the products coefficient * value * key are accumulated.
+template <typename S, typename F,
+          typename R = decltype(std::declval<const S &>()
+                                * std::declval<const F &>()(std::declval<const typename S::term_type::key_type &>(),
+                                                            std::declval<const symbol_fset &>())[0u]
+                                      .first)>
+static inline R key_subs_reference(const S &f, const F &ksubs)
+{
+    R retval(0);
+    for (const auto &t : f._container()) {
+        for (auto &p : ksubs(t.m_key, f.get_symbol_set())) {
+            S tmp;
+            tmp.set_symbol_set(f.get_symbol_set());
+            tmp.insert(typename S::term_type(t.m_cf, std::move(p.second)));
+            retval += std::move(tmp) * std::move(p.first);
+        }
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(ipow_subs_series_bulk_subs_test)
+{
+    using stype0 = g_series_type<rational, monomial<int>>;
+    stype0 x{"x"}, y{"y"}, z{"z"};
+    const auto f = piranha::pow(x + y + z + 1, 8) + piranha::pow(x - 2 * y, 5) / 3;
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        BOOST_CHECK_EQUAL(piranha::pow(x + 1, 8).ipow_subs("x", 2, y),
+                          piranha::pow(y, 4) + 8 * x * piranha::pow(y, 3) + 28 * piranha::pow(y, 3)
+                              + 56 * x * y * y + 70 * y * y + 56 * x * y + 28 * y + 8 * x + 1);
+        const auto &ss = f.get_symbol_set();
+        const auto zy = z - y;
+        BOOST_CHECK_EQUAL(f.ipow_subs("x", 2, zy),
+                          key_subs_reference(f, [&ss, &zy](const monomial<int> &k, const symbol_fset &args) {
+                              return k.ipow_subs(ss_index_of(ss, "x"), integer(2), zy, args);
+                          }));
+        BOOST_CHECK_EQUAL(f.ipow_subs("y", 3, 2 / 3_q),
+                          key_subs_reference(f, [&ss](const monomial<int> &k, const symbol_fset &args) {
+                              return k.ipow_subs(ss_index_of(ss, "y"), integer(3), 2 / 3_q, args);
+                          }));
+        BOOST_CHECK_EQUAL(f.ipow_subs("z", 1, -2_z), piranha::pow(x + y - 1, 8) + piranha::pow(x - 2 * y, 5) / 3);
+        BOOST_CHECK_EQUAL(f.ipow_subs("t", 2, 3_z), f);
+        BOOST_CHECK_THROW(f.ipow_subs("x", 0, 3_z), std::invalid_argument);
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(ipow_subs_series_serialization_test)
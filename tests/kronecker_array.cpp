@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE kronecker_array_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <boost/integer_traits.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
@@ -158,3 +159,59 @@ BOOST_AUTO_TEST_CASE(kronecker_array_coding_test)
 {
     boost::mpl::for_each<int_types>(coding_tester());
 }
+
+// Coding/decoding of ranges.
+struct range_coding_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        typedef kronecker_array<T> ka_type;
+        typedef typename ka_type::size_type size_type;
+        auto &l = ka_type::get_limits();
+        std::mt19937 rng;
+        const size_type n = 1000u;
+        std::vector<T> codes(n), codes2(n);
+        // Zero-sized vectors.
+        ka_type::encode_range(codes.data(), nullptr, n, 0u);
+        BOOST_CHECK(codes == std::vector<T>(n, T(0)));
+        ka_type::decode_range(nullptr, codes.data(), n, 0u);
+        codes[n - 1u] = T(1);
+        BOOST_CHECK_THROW(ka_type::decode_range(nullptr, codes.data(), n, 0u), std::invalid_argument);
+        for (size_type m = 1u; m < l.size(); ++m) {
+            const auto &M = std::get<0u>(l[m]);
+            std::vector<T> v(n * m), out(n * m), tmp(m);
+            for (size_type j = 0u; j < n; ++j) {
+                for (size_type k = 0u; k < m; ++k) {
+                    // Include the extrema in the first two vectors.
+                    std::uniform_int_distribution<long long> dist(-M[k], M[k]);
+                    v[j * m + k] = static_cast<T>(j == 0u ? -M[k] : (j == 1u ? M[k] : dist(rng)));
+                }
+            }
+            ka_type::encode_range(codes.data(), v.data(), n, m);
+            for (size_type j = 0u; j < n; ++j) {
+                std::copy(v.begin() + static_cast<std::ptrdiff_t>(j * m),
+                          v.begin() + static_cast<std::ptrdiff_t>((j + 1u) * m), tmp.begin());
+                BOOST_CHECK(ka_type::encode(tmp) == codes[j]);
+            }
+            BOOST_CHECK(codes[0u] == std::get<1u>(l[m]));
+            BOOST_CHECK(codes[1u] == std::get<2u>(l[m]));
+            ka_type::decode_range(out.data(), codes.data(), n, m);
+            BOOST_CHECK(out == v);
+            // Out of bounds components and codes.
+            auto v_bad(v);
+            v_bad[(n - 1u) * m] = static_cast<T>(M[0u] + 1);
+            BOOST_CHECK_THROW(ka_type::encode_range(codes2.data(), v_bad.data(), n, m), std::invalid_argument);
+            if (std::get<2u>(l[m]) < boost::integer_traits<T>::const_max) {
+                codes[n - 1u] = static_cast<T>(std::get<2u>(l[m]) + 1);
+                BOOST_CHECK_THROW(ka_type::decode_range(out.data(), codes.data(), n, m), std::invalid_argument);
+            }
+        }
+        BOOST_CHECK_THROW(ka_type::encode_range(codes.data(), nullptr, 0u, l.size()), std::invalid_argument);
+        BOOST_CHECK_THROW(ka_type::decode_range(nullptr, codes.data(), 0u, l.size()), std::invalid_argument);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(kronecker_array_range_coding_test)
+{
+    boost::mpl::for_each<int_types>(range_coding_tester());
+}
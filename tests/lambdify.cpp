@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE lambdify_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <cmath>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -41,6 +42,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/integer.hpp>
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
 #include <piranha/polynomial.hpp>
 #include <piranha/rational.hpp>
 
@@ -289,3 +291,61 @@ BOOST_AUTO_TEST_CASE(lambdify_test_02)
     en = l2.get_extra_names();
     BOOST_CHECK((en == std::vector<std::string>{"t", "a"} || en == std::vector<std::string>{"a", "t"}));
 }
+
+BOOST_AUTO_TEST_CASE(lambdify_batch_test)
+{
+    std::uniform_int_distribution<int> dist(-10, 10);
+    {
+        // Series, evaluated via series_evaluator.
+        using p_type = polynomial<integer, k_monomial>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto tmp = piranha::pow(x - 2 * y + z + 1, 5) * z - x * y + 3;
+        auto l = lambdify<integer>(tmp, {"y", "x", "t"}, {{"z", [](const std::vector<integer> &v) -> integer {
+                                                               BOOST_CHECK_EQUAL(v.size(), 3u);
+                                                               return v[0] * v[1] + v[2];
+                                                           }}});
+        std::vector<std::vector<integer>> points;
+        BOOST_CHECK(l.batch(points).empty());
+        for (int i = 0; i < ntrials; ++i) {
+            points.push_back({integer(dist(rng)), integer(dist(rng)), integer(dist(rng))});
+        }
+        auto res = l.batch(points);
+        BOOST_CHECK_EQUAL(res.size(), points.size());
+        for (decltype(points.size()) i = 0u; i < points.size(); ++i) {
+            BOOST_CHECK_EQUAL(res[i], l(points[i]));
+        }
+        // The evaluator is reused, and it is moved along with the lambdified object.
+        BOOST_CHECK(l.batch(points) == res);
+        auto l1(l);
+        BOOST_CHECK(l1.batch(points) == res);
+        auto l2(std::move(l));
+        BOOST_CHECK(l2.batch(points) == res);
+        points.push_back({1_z, 2_z});
+        BOOST_CHECK_THROW(l2.batch(points), std::invalid_argument);
+        // No symbols at all.
+        auto l3 = lambdify<integer>(p_type{5}, {});
+        BOOST_CHECK((l3.batch({{}, {}}) == std::vector<integer>{5_z, 5_z}));
+    }
+    {
+        // Floating-point evaluation of a rational polynomial.
+        using p_type = polynomial<rational, k_monomial>;
+        p_type x{"x"}, y{"y"};
+        const auto tmp = piranha::pow(x / 3 - y + 1, 7) + y / 5;
+        auto l = lambdify<double>(tmp, {"x", "y"});
+        std::vector<std::vector<double>> points;
+        for (int i = 0; i < ntrials; ++i) {
+            points.push_back({dist(rng) / 10., dist(rng) / 10.});
+        }
+        const auto res = l.batch(points);
+        for (decltype(points.size()) i = 0u; i < points.size(); ++i) {
+            const auto cmp = l(points[i]);
+            BOOST_CHECK(std::abs(res[i] - cmp) <= 1E-12 * std::abs(cmp));
+        }
+    }
+    {
+        // Non-series type.
+        auto l = lambdify<double>(3., {"x"});
+        BOOST_CHECK((l.batch({{1.}, {2.}}) == std::vector<double>{3., 3.}));
+        BOOST_CHECK_THROW(l.batch({{1.}, {2., 3.}}), std::invalid_argument);
+    }
+}
@@ -0,0 +1,240 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/mapped_series.hpp>
+
+#define BOOST_TEST_MODULE mapped_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <piranha/config.hpp>
+#include <piranha/frozen_series.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+static std::random_device rd;
+
+struct tmp_file {
+    tmp_file() : m_path(PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd())) {}
+    ~tmp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+    std::string m_path;
+};
+
+using p_type = polynomial<double, kronecker_monomial<>>;
+using q_type = polynomial<float, kronecker_monomial<int>>;
+
+BOOST_AUTO_TEST_CASE(mapped_series_type_test)
+{
+    BOOST_CHECK((has_mapped_raw<double>::value));
+    BOOST_CHECK((has_mapped_raw<kronecker_monomial<>>::value));
+    BOOST_CHECK((!has_mapped_raw<integer>::value));
+    BOOST_CHECK((!has_mapped_raw<monomial<int>>::value));
+    BOOST_CHECK((std::is_nothrow_move_constructible<mapped_series<p_type>>::value));
+    BOOST_CHECK((!std::is_copy_constructible<mapped_series<p_type>>::value));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_roundtrip_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    // Empty series.
+    {
+        tmp_file f;
+        save_mapped_file(p_type{}, f.m_path);
+        mapped_series<p_type> m(f.m_path);
+        BOOST_CHECK(m.empty());
+        BOOST_CHECK_EQUAL(m.size(), 0u);
+        BOOST_CHECK(m.get_symbol_set().empty());
+        BOOST_CHECK(m.cf_data() == nullptr);
+        BOOST_CHECK(m.key_data() == nullptr);
+        BOOST_CHECK_EQUAL(m.thaw(), p_type{});
+        BOOST_CHECK(m.freeze().empty());
+        BOOST_CHECK_EQUAL(m.degree(), 0);
+    }
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 10);
+    tmp_file f;
+    save_mapped_file(s, f.m_path);
+    mapped_series<p_type> m(f.m_path);
+    BOOST_CHECK_EQUAL(m.size(), s.size());
+    BOOST_CHECK(m.get_symbol_set() == s.get_symbol_set());
+    // In-place access.
+    for (decltype(m.size()) i = 0u; i < m.size(); ++i) {
+        BOOST_CHECK_EQUAL(m.cf(i), m.cf_data()[i]);
+        BOOST_CHECK_EQUAL(m.key(i).get_int(), m.key_data()[i]);
+    }
+    // Rehydration, serial and parallel.
+    BOOST_CHECK_EQUAL(m.thaw(), s);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_EQUAL(m.thaw(), s);
+        BOOST_CHECK_EQUAL(m.thaw(nt), s);
+        BOOST_CHECK_EQUAL(m.thaw(nt).size(), s.size());
+    }
+    settings::reset_n_threads();
+    // The rehydrated series is fully functional.
+    BOOST_CHECK_EQUAL(m.thaw() * x, s * x);
+    // Freezing.
+    const auto fs = m.freeze();
+    BOOST_CHECK_EQUAL(fs.size(), s.size());
+    BOOST_CHECK_EQUAL(fs.thaw(), s);
+    // Saving a frozen series yields the same terms.
+    tmp_file f2;
+    save_mapped_file(frozen_series<p_type>(s), f2.m_path);
+    BOOST_CHECK_EQUAL(mapped_series<p_type>(f2.m_path).thaw(), s);
+    // Evaluation and degree.
+    const symbol_fmap<double> dict{{"x", 1.5}, {"y", -.25}, {"z", .5}};
+    BOOST_CHECK_EQUAL(m.evaluate(dict), frozen_series<p_type>(s).evaluate(dict));
+    BOOST_CHECK_EQUAL(m.degree(), frozen_series<p_type>(s).degree());
+    BOOST_CHECK_THROW(m.evaluate(symbol_fmap<double>{{"x", 1.}}), std::invalid_argument);
+    // Move semantics.
+    auto m2(std::move(m));
+    BOOST_CHECK(m.empty());
+    BOOST_CHECK(m.get_symbol_set().empty());
+    BOOST_CHECK_EQUAL(m2.thaw(), s);
+    m = std::move(m2);
+    BOOST_CHECK(m2.empty());
+    BOOST_CHECK_EQUAL(m.thaw(), s);
+    // Different coefficient and key types.
+    q_type a{"a"}, b{"b"};
+    const auto t = piranha::pow(a - b / 2 + 1, 8);
+    tmp_file f3;
+    save_mapped_file(t, f3.m_path);
+    BOOST_CHECK_EQUAL(mapped_series<q_type>(f3.m_path).thaw(), t);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_error_test)
+{
+    p_type x{"x"}, y{"y"};
+    const auto s = piranha::pow(x - y + 1, 4);
+    BOOST_CHECK_THROW(mapped_series<p_type>(PIRANHA_BINARY_TESTS_DIR "/nonexistent_mapped_file"), std::runtime_error);
+    tmp_file f;
+    save_mapped_file(s, f.m_path);
+    // Wrong series type.
+    BOOST_CHECK_THROW(mapped_series<q_type>{f.m_path}, std::invalid_argument);
+    BOOST_CHECK_THROW(mapped_series<polynomial<double, kronecker_monomial<int>>>{f.m_path}, std::invalid_argument);
+    // Corrupted signature.
+    {
+        std::fstream fs(f.m_path, std::ios::in | std::ios::out | std::ios::binary);
+        fs.put('X');
+    }
+    BOOST_CHECK_THROW(mapped_series<p_type>{f.m_path}, std::invalid_argument);
+    // Truncated file.
+    tmp_file f2;
+    save_mapped_file(s, f2.m_path);
+    std::string content;
+    {
+        std::ifstream ifs(f2.m_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream ofs(f2.m_path, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), static_cast<std::streamsize>(content.size() - 1u));
+    }
+    BOOST_CHECK_THROW(mapped_series<p_type>{f2.m_path}, std::invalid_argument);
+    {
+        std::ofstream ofs(f2.m_path, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), 10);
+    }
+    BOOST_CHECK_THROW(mapped_series<p_type>{f2.m_path}, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_invalid_terms_test)
+{
+    using raw_cf = mapped_series<p_type>::raw_cf_type;
+    using raw_key = mapped_series<p_type>::raw_key_type;
+    p_type x{"x"}, y{"y"};
+    const auto s = piranha::pow(x - y + 1, 4);
+    tmp_file f;
+    save_mapped_file(s, f.m_path);
+    std::string content;
+    {
+        std::ifstream ifs(f.m_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    // Locate the arrays of coefficients and keys: the keys are stored at the end of the file.
+    std::size_t cf_offset, key_offset;
+    {
+        mapped_series<p_type> m(f.m_path);
+        key_offset = content.size() - m.size() * sizeof(raw_key);
+        cf_offset = key_offset
+                    - static_cast<std::size_t>(reinterpret_cast<const char *>(m.key_data())
+                                               - reinterpret_cast<const char *>(m.cf_data()));
+    }
+    auto check_invalid = [&f](const std::string &str) {
+        {
+            std::ofstream ofs(f.m_path, std::ios::binary | std::ios::trunc);
+            ofs.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+        mapped_series<p_type> m(f.m_path);
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            BOOST_CHECK_THROW(m.thaw(nt), std::invalid_argument);
+        }
+    };
+    // Duplicate keys.
+    auto tmp = content;
+    std::memcpy(&tmp[key_offset + sizeof(raw_key)], &tmp[key_offset], sizeof(raw_key));
+    check_invalid(tmp);
+    // Zero coefficient.
+    tmp = content;
+    const raw_cf zero(0);
+    std::memcpy(&tmp[cf_offset + 3u * sizeof(raw_cf)], &zero, sizeof(raw_cf));
+    check_invalid(tmp);
+    // Key not compatible with the symbol set.
+    tmp = content;
+    const auto huge = std::numeric_limits<raw_key>::max();
+    std::memcpy(&tmp[key_offset + 5u * sizeof(raw_key)], &huge, sizeof(raw_key));
+    check_invalid(tmp);
+    // The original content is still valid.
+    {
+        std::ofstream ofs(f.m_path, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        BOOST_CHECK_EQUAL(mapped_series<p_type>(f.m_path).thaw(nt), s);
+    }
+}
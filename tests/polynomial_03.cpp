@@ -32,12 +32,17 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 #include <piranha/config.hpp>
 #include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
 #include <piranha/math/pow.hpp>
 #include <piranha/monomial.hpp>
+#include <piranha/rational.hpp>
 #include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
 
 using namespace piranha;
 
@@ -59,6 +64,138 @@ BOOST_AUTO_TEST_CASE(polynomial_truncation_pow_cache_test)
     BOOST_CHECK_EQUAL(piranha::pow(x + y + 1, 2), 2 * x + 1 + 2 * y + x * x + 2 * x * y);
     p_type::set_auto_truncate_degree(1, {"y"});
     BOOST_CHECK_EQUAL(piranha::pow(x + y + 1, 2), 2 * x + 1 + 2 * y + x * x + 2 * x * y);
+    p_type::unset_auto_truncate_degree();
+    BOOST_CHECK_EQUAL(piranha::pow(x + y + 1, 2), 2 * x + 1 + 2 * y + x * x + y * y + 2 * x * y);
+}
+
+// Power computed via repeated multiplications.
+template <typename T>
+static inline T rep_pow(const T &p, int n)
+{
+    T retval(1);
+    for (int i = 0; i < n; ++i) {
+        retval *= p;
+    }
+    return retval;
+}
+
+template <typename T>
+static inline void check_pow_strategies(const T &p, int n_max)
+{
+    for (int n = 0; n <= n_max; ++n) {
+        const auto cmp = rep_pow(p, n);
+        BOOST_CHECK_EQUAL(p._pow_multinomial(integer(n)), cmp);
+        BOOST_CHECK_EQUAL(p._pow_miller(integer(n)), cmp);
+        BOOST_CHECK_EQUAL(p._pow_squaring(integer(n)), cmp);
+        T::clear_pow_cache();
+        BOOST_CHECK_EQUAL(p.pow(n), cmp);
+        // Second time from the cache.
+        BOOST_CHECK_EQUAL(p.pow(n), cmp);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_pow_strategies_test)
+{
+    {
+        using p_type = polynomial<integer, monomial<int>>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        // Affinely independent exponents.
+        check_pow_strategies(x + y + z + 1, 8);
+        check_pow_strategies(3 * x * y - 2 * z + 5, 6);
+        // Dependent exponents.
+        check_pow_strategies(1 + x - 2 * x * y + 3 * y * y * z - x * x, 6);
+        check_pow_strategies(-1 + x + x * x + x * x * x, 8);
+        // The multinomial expansion and squaring work also without a constant term.
+        const auto q = x + y * z - 2 * x * x;
+        BOOST_CHECK_EQUAL(q._pow_multinomial(integer(5)), rep_pow(q, 5));
+        BOOST_CHECK_EQUAL(q._pow_squaring(integer(5)), rep_pow(q, 5));
+        BOOST_CHECK_EQUAL(q.pow(5), rep_pow(q, 5));
+        BOOST_CHECK_EQUAL(p_type{}._pow_multinomial(integer(0)), p_type{1});
+        BOOST_CHECK_EQUAL(p_type{}._pow_multinomial(integer(3)), p_type{});
+        BOOST_CHECK_EQUAL(p_type{}._pow_squaring(integer(3)), p_type{});
+        // Error handling.
+        BOOST_CHECK_THROW(q._pow_miller(integer(2)), std::invalid_argument);
+        BOOST_CHECK_THROW((1 + x * x * x * x * x * x)._pow_miller(integer(2)), std::invalid_argument);
+        BOOST_CHECK_THROW((1 + x + x * y)._pow_miller(integer(-1)), std::invalid_argument);
+        BOOST_CHECK_THROW((1 + x + x * y)._pow_multinomial(integer(-1)), std::invalid_argument);
+        BOOST_CHECK_THROW((1 + x + x * y)._pow_squaring(integer(-1)), std::invalid_argument);
+        // Non-unitary constant term.
+        const auto r = 3 + x - y * y + 2 * x * y;
+        BOOST_CHECK_EQUAL(r._pow_miller(integer(7)), rep_pow(r, 7));
+    }
+    {
+        using p_type = polynomial<rational, kronecker_monomial<>>;
+        p_type x{"x"}, y{"y"};
+        check_pow_strategies(rational(2, 3) + x / 2 - y / 3 + x * y, 6);
+    }
+    {
+        // Rational exponents: the multinomial expansion and Miller's recurrence require integral
+        // exponents, pow() falls back to the other strategies.
+        using p_type = polynomial<integer, monomial<rational>>;
+        p_type x{"x"}, y{"y"};
+        const auto f = x.pow(1 / 2_q) + y;
+        BOOST_CHECK_EQUAL(f.pow(2), x + 2 * x.pow(1 / 2_q) * y + y * y);
+        BOOST_CHECK_EQUAL(f.pow(5), rep_pow(f, 5));
+        BOOST_CHECK_EQUAL((1 + x.pow(2 / 3_q) - y).pow(4), rep_pow(1 + x.pow(2 / 3_q) - y, 4));
+        BOOST_CHECK_THROW(f._pow_multinomial(integer(2)), safe_cast_failure);
+        // Integral exponents in rational form.
+        check_pow_strategies(1 + x - 2 * y, 6);
+    }
+    {
+        // Floating-point coefficients: without auto-truncation, pow() still uses repeated multiplications,
+        // and the result is identical to the one obtained via the multiplication operator.
+        using p_type = polynomial<double, monomial<int>>;
+        BOOST_CHECK((!detail::is_exact_cf<double>::value));
+        BOOST_CHECK((!detail::is_exact_cf<p_type>::value));
+        BOOST_CHECK((detail::is_exact_cf<rational>::value));
+        BOOST_CHECK((detail::is_exact_cf<polynomial<polynomial<integer, monomial<int>>, monomial<int>>>::value));
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const std::vector<p_type> fs{x + y + z + 1.1, .1 + x / 3. - .7 * y + x * y,
+                                     1E-3 + x + .3 * x * x + x * x * x};
+        for (const auto &f : fs) {
+            for (int n = 2; n <= 8; ++n) {
+                p_type::clear_pow_cache();
+                BOOST_CHECK_EQUAL(f.pow(n), rep_pow(f, n));
+            }
+        }
+        // The other strategies are still available explicitly.
+        const auto g = 1 + x + .5 * x * x - y;
+        BOOST_CHECK_EQUAL(g._pow_miller(integer(4)).size(), rep_pow(g, 4).size());
+        BOOST_CHECK_EQUAL(g._pow_multinomial(integer(4)).size(), rep_pow(g, 4).size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_pow_strategies_truncation_test)
+{
+    using p_type = polynomial<integer, monomial<int>>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto f = 1 + x - 2 * y + x * y * z + 3 * z * z;
+    const auto g = x + y + x * y;
+    p_type::set_auto_truncate_degree(4);
+    for (int n = 0; n <= 8; ++n) {
+        const auto cmp = rep_pow(f, n);
+        BOOST_CHECK_EQUAL(f._pow_miller(integer(n)), cmp);
+        BOOST_CHECK_EQUAL(f._pow_squaring(integer(n)), cmp);
+        BOOST_CHECK_EQUAL(f.pow(n), cmp);
+        BOOST_CHECK_EQUAL(g._pow_squaring(integer(n)), rep_pow(g, n));
+        BOOST_CHECK_EQUAL(g.pow(n), rep_pow(g, n));
+    }
+    BOOST_CHECK(f.pow(8).degree() <= 4);
+    p_type::set_auto_truncate_degree(2, {"x", "z"});
+    for (int n = 0; n <= 8; ++n) {
+        const auto cmp = rep_pow(f, n);
+        BOOST_CHECK_EQUAL(f._pow_squaring(integer(n)), cmp);
+        BOOST_CHECK_EQUAL(f.pow(n), cmp);
+        BOOST_CHECK_EQUAL(g.pow(n), rep_pow(g, n));
+    }
+    // Miller's recurrence with respect to the partial degree.
+    const auto h = 1 + x + 2 * z + x * z - x * x;
+    BOOST_CHECK_EQUAL(h._pow_miller(integer(6)), rep_pow(h, 6));
+    BOOST_CHECK_EQUAL(h.pow(6), rep_pow(h, 6));
+    // The component of grade zero of f is not a single term.
+    BOOST_CHECK_THROW(f._pow_miller(integer(3)), std::invalid_argument);
+    p_type::unset_auto_truncate_degree();
+    BOOST_CHECK_EQUAL(f.pow(3), rep_pow(f, 3));
 }
 
 #if defined(PIRANHA_WITH_BOOST_S11N)
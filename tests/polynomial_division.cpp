@@ -0,0 +1,133 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+#include <piranha/polynomial.hpp>
+
+#define BOOST_TEST_MODULE polynomial_division_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdexcept>
+#include <type_traits>
+
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+#include <piranha/detail/polynomial_division.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math/gcd.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+using p_type = polynomial<integer, k_monomial>;
+
+template <typename T>
+using divexact_t = decltype(T::divexact(std::declval<const T &>(), std::declval<const T &>()));
+
+BOOST_AUTO_TEST_CASE(polynomial_divexact_test)
+{
+    BOOST_CHECK((is_detected<divexact_t, p_type>::value));
+    BOOST_CHECK((is_detected<divexact_t, polynomial<mppp::integer<2>, k_monomial>>::value));
+    BOOST_CHECK((!is_detected<divexact_t, polynomial<rational, k_monomial>>::value));
+    BOOST_CHECK((!is_detected<divexact_t, polynomial<integer, monomial<int>>>::value));
+    BOOST_CHECK((!is_detected<divexact_t, polynomial<double, k_monomial>>::value));
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    // Trivial cases.
+    BOOST_CHECK_EQUAL(p_type::divexact(p_type{}, x), p_type{});
+    BOOST_CHECK_EQUAL(p_type::divexact(p_type{6}, p_type{3}), 2);
+    BOOST_CHECK_EQUAL(p_type::divexact(x * 4, p_type{2}), 2 * x);
+    BOOST_CHECK_EQUAL(p_type::divexact(x, x), 1);
+    BOOST_CHECK_THROW(p_type::divexact(x, p_type{}), mppp::zero_division_error);
+    BOOST_CHECK_THROW(p_type::divexact(p_type{3}, p_type{2}), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(x + 1, x), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(x, y), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(x * x + 1, x + 1), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(2 * x * x - 2, 4 * x + 4), std::invalid_argument);
+    BOOST_CHECK_EQUAL(p_type::divexact(x * x - 1, x + 1), x - 1);
+    BOOST_CHECK_EQUAL(p_type::divexact(2 * x * x - 2, 2 * x + 2), x - 1);
+    // Symbol set merging.
+    BOOST_CHECK_EQUAL(p_type::divexact(x * y + y, x + 1), y);
+    BOOST_CHECK_EQUAL(p_type::divexact(x * y + y, y), x + 1);
+    // Negative exponents.
+    BOOST_CHECK_EQUAL(p_type::divexact(x.pow(-2) * (y + 1) * (x - 3), x - 3), x.pow(-2) * (y + 1));
+    BOOST_CHECK_EQUAL(p_type::divexact(x.pow(-2) * (y + 1) * (x - 3), x.pow(-1) * (y + 1)), x.pow(-1) * (x - 3));
+    // Larger products.
+    auto f = (1 + x + y + 2 * z * z + 3 * t * t * t).pow(6), g = (1 - x + y * y + z * t).pow(5);
+    const auto fg = f * g;
+    BOOST_CHECK_EQUAL(p_type::divexact(fg, f), g);
+    BOOST_CHECK_EQUAL(p_type::divexact(fg, g), f);
+    BOOST_CHECK_EQUAL(p_type::divexact(-fg, g), -f);
+    BOOST_CHECK_THROW(p_type::divexact(fg + 1, g), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(fg + x * y * z, f), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::divexact(fg, f + 1), std::invalid_argument);
+}
+
+template <typename T>
+using gcd_t = decltype(T::gcd(std::declval<const T &>(), std::declval<const T &>()));
+
+BOOST_AUTO_TEST_CASE(polynomial_gcd_test)
+{
+    BOOST_CHECK((is_detected<gcd_t, p_type>::value));
+    BOOST_CHECK((!is_detected<gcd_t, polynomial<rational, k_monomial>>::value));
+    BOOST_CHECK((are_gcd_types<p_type>::value));
+    BOOST_CHECK((!are_gcd_types<polynomial<integer, monomial<int>>>::value));
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    // Zeroes and constants.
+    BOOST_CHECK_EQUAL(p_type::gcd(p_type{}, p_type{}), p_type{});
+    BOOST_CHECK_EQUAL(p_type::gcd(p_type{}, -x - 1), x + 1);
+    BOOST_CHECK_EQUAL(p_type::gcd(-x - 1, p_type{}), x + 1);
+    BOOST_CHECK_EQUAL(p_type::gcd(p_type{6}, p_type{-4}), 2);
+    BOOST_CHECK_EQUAL(p_type::gcd(6 * x + 6, p_type{4}), 2);
+    BOOST_CHECK_EQUAL(p_type::gcd(6 * x + 6, 4 * x + 4), 2 * x + 2);
+    BOOST_CHECK_EQUAL(p_type::gcd(-x - 1, x + 1), x + 1);
+    BOOST_CHECK_EQUAL(piranha::gcd(x * x - 1, x * x + 2 * x + 1), x + 1);
+    // Monomials.
+    BOOST_CHECK_EQUAL(p_type::gcd(x * x * y, x * y * y * y), x * y);
+    BOOST_CHECK_EQUAL(p_type::gcd(x * x, y), 1);
+    // Coprime operands.
+    BOOST_CHECK_EQUAL(p_type::gcd(x + y, x - y), 1);
+    BOOST_CHECK_EQUAL(p_type::gcd(x * y + 1, x + 1), 1);
+    // Multivariate.
+    auto f = (1 + x + y + 2 * z * z + 3 * t * t * t).pow(4), g = (1 - x + y * y + z * t).pow(3),
+         h = (x * y - z + t + 2).pow(3);
+    BOOST_CHECK_EQUAL(p_type::gcd(f * g, f * h), f);
+    BOOST_CHECK_EQUAL(p_type::gcd(3 * f * g, -6 * f * h), 3 * f);
+    BOOST_CHECK_EQUAL(p_type::gcd(f * g * h, g * g * h), g * h);
+    BOOST_CHECK_EQUAL(p_type::gcd(f * (x - y), g * (y - x)), x - y);
+    // Negative exponents.
+    BOOST_CHECK_THROW(p_type::gcd(x.pow(-1), x), std::invalid_argument);
+    BOOST_CHECK_THROW(p_type::gcd(x, y * x.pow(-1)), std::invalid_argument);
+    // The fallback via polynomial remainder sequences, on primitive operands.
+    const auto a = (x + y + 1) * (x - 2 * y * z + 3), b = (x + y + 1) * (2 * x * x + z), c = (x + y + 1) * (x * z + 1);
+    for (symbol_idx i = 0u; i < 3u; ++i) {
+        BOOST_CHECK_EQUAL(detail::kpoly_gcd(detail::kpoly_gcd_prs(a, b, i), x + y + 1), x + y + 1);
+        BOOST_CHECK_EQUAL(detail::kpoly_normalise(detail::kpoly_gcd_prs(b, c, i)), x + y + 1);
+    }
+}
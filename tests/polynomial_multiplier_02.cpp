@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE polynomial_multiplier_02_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
 #include <cstddef>
@@ -40,9 +41,12 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/integer.hpp>
 #include <piranha/kronecker_monomial.hpp>
+#include <piranha/math/pow.hpp>
 #include <piranha/monomial.hpp>
 #include <piranha/rational.hpp>
+#include <piranha/series_multiplier.hpp>
 #include <piranha/settings.hpp>
+#include <piranha/tuning.hpp>
 
 using namespace piranha;
 
@@ -152,3 +156,315 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplier_finalise_test)
     }
     settings::reset_n_threads();
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_kronecker_no_estimate_test)
+{
+    // Check the Kronecker multiplication without size estimation against the estimated one,
+    // for operands of increasing size.
+    settings::set_n_threads(1u);
+    using pt1 = polynomial<integer, k_monomial>;
+    using pt2 = polynomial<rational, k_monomial>;
+    {
+        pt1 x("x"), y("y"), z("z"), t("t");
+        auto f = 1 + x + y + z + t;
+        auto tmp = f;
+        for (int i = 1; i < 8; ++i) {
+            f *= tmp;
+            auto g = f - 1;
+            tuning::set_estimate_threshold(0u);
+            const auto cmp = f * g;
+            tuning::set_estimate_threshold(100000u);
+            BOOST_CHECK_EQUAL(f * g, cmp);
+            // Check cancellations.
+            BOOST_CHECK_EQUAL(f * g - g * f, 0);
+            BOOST_CHECK_EQUAL((f + 1) * (f - 1), f * f - 1);
+        }
+    }
+    {
+        pt2 x("x"), y("y"), z("z");
+        auto f = 1 / 2_q + x + y / 3 + z;
+        auto tmp = f;
+        for (int i = 1; i < 6; ++i) {
+            f *= tmp;
+            tuning::set_estimate_threshold(0u);
+            const auto cmp = f * (f + x / 5);
+            tuning::set_estimate_threshold(100000u);
+            BOOST_CHECK_EQUAL(f * (f + x / 5), cmp);
+        }
+    }
+    tuning::reset_estimate_threshold();
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_dense_test)
+{
+    // Check the dense Kronecker multiplication against the sparse one.
+    using pt1 = polynomial<integer, k_monomial>;
+    using pt2 = polynomial<rational, k_monomial>;
+    using pt3 = polynomial<double, k_monomial>;
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        {
+            pt1 x("x"), y("y"), z("z"), t("t");
+            auto f = 1 + x + y + z + t;
+            auto tmp = f;
+            for (int i = 1; i < 10; ++i) {
+                f *= tmp;
+            }
+            auto g = f + 1;
+            series_multiplier<pt1> sm(f, g);
+            BOOST_CHECK(sm._use_dense_multiplication(10626u));
+            BOOST_CHECK(!sm._use_dense_multiplication(1u));
+            tuning::set_dense_multiplication_ratio(0u);
+            BOOST_CHECK(!sm._use_dense_multiplication(10626u));
+            const auto cmp = f * g;
+            tuning::reset_dense_multiplication_ratio();
+            BOOST_CHECK_EQUAL(f * g, cmp);
+            BOOST_CHECK_EQUAL(cmp.size(), 10626u);
+            // Negative exponents and cancellations.
+            auto h = x.pow(-3) + y.pow(-2) * z - t + 3;
+            auto l = h - 3;
+            for (int i = 1; i < 5; ++i) {
+                h *= l;
+            }
+            tuning::set_dense_multiplication_ratio(0u);
+            const auto cmp2 = h * (h - 1), cmp3 = (h + 1) * (h - 1);
+            tuning::set_dense_multiplication_ratio(1000u);
+            BOOST_CHECK_EQUAL(h * (h - 1), cmp2);
+            BOOST_CHECK_EQUAL((h + 1) * (h - 1), cmp3);
+            BOOST_CHECK_EQUAL((h + 1) * (h - 1), h * h - 1);
+            tuning::reset_dense_multiplication_ratio();
+        }
+        {
+            pt2 x("x"), y("y"), z("z");
+            auto f = 1 / 3_q + x / 2 + y + z * 2 / 5;
+            auto tmp = f;
+            for (int i = 1; i < 12; ++i) {
+                f *= tmp;
+            }
+            tuning::set_dense_multiplication_ratio(0u);
+            const auto cmp = f * (f - x);
+            tuning::set_dense_multiplication_ratio(1000u);
+            BOOST_CHECK_EQUAL(f * (f - x), cmp);
+            tuning::reset_dense_multiplication_ratio();
+        }
+        {
+            pt3 x("x"), y("y");
+            auto f = 1 + x + y;
+            auto tmp = f;
+            for (int i = 1; i < 15; ++i) {
+                f *= tmp;
+            }
+            // Force the estimation, so that the dense multiplication is used also in single-thread mode.
+            tuning::set_estimate_threshold(0u);
+            tuning::set_dense_multiplication_ratio(0u);
+            const auto cmp = f * (f + 1);
+            tuning::set_dense_multiplication_ratio(1000u);
+            BOOST_CHECK_EQUAL(f * (f + 1), cmp);
+            tuning::reset_dense_multiplication_ratio();
+            tuning::reset_estimate_threshold();
+        }
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_heap_test)
+{
+    // Check the heap-based Kronecker multiplication against the other algorithms.
+    using pt1 = polynomial<integer, k_monomial>;
+    using pt2 = polynomial<rational, k_monomial>;
+    settings::set_min_work_per_thread(1u);
+    // Force the estimation, so that the heap multiplication is used also in single-thread mode.
+    tuning::set_estimate_threshold(0u);
+    // Skewed operands: most of the products have codes in a small part of the range of the result. The
+    // single-thread result is the reference for the heap multiplication with any number of threads.
+    const pt1 sx("x"), sy("y");
+    const auto sf = piranha::pow(1 + sx + sy.pow(100), 8), sg = piranha::pow(1 + sx.pow(3) - sy.pow(100), 4);
+    settings::set_n_threads(1u);
+    const auto s_cmp = sf * sg;
+    tuning::set_multiplication_memory_budget(1u);
+    BOOST_CHECK_EQUAL(sf * sg, s_cmp);
+    tuning::reset_multiplication_memory_budget();
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        tuning::set_multiplication_memory_budget(1u);
+        BOOST_CHECK_EQUAL(sf * sg, s_cmp);
+        tuning::reset_multiplication_memory_budget();
+        {
+            pt1 x("x"), y("y"), z("z"), t("t");
+            auto f = 1 + x + y + z + t;
+            auto tmp = f;
+            for (int i = 1; i < 10; ++i) {
+                f *= tmp;
+            }
+            auto g = f + 1;
+            series_multiplier<pt1> sm(f, g);
+            BOOST_CHECK(!sm._use_heap_multiplication(10626u));
+            tuning::set_multiplication_memory_budget(1u);
+            BOOST_CHECK(sm._use_heap_multiplication(10626u));
+            BOOST_CHECK(!sm._use_dense_multiplication(10626u));
+            tuning::set_multiplication_memory_budget(std::numeric_limits<unsigned long long>::max());
+            BOOST_CHECK(!sm._use_heap_multiplication(10626u));
+            tuning::reset_multiplication_memory_budget();
+            const auto cmp = f * g;
+            tuning::set_multiplication_memory_budget(1u);
+            BOOST_CHECK_EQUAL(f * g, cmp);
+            BOOST_CHECK_EQUAL(cmp.size(), 10626u);
+            tuning::reset_multiplication_memory_budget();
+            // Negative exponents and cancellations.
+            auto h = x.pow(-3) + y.pow(-2) * z - t + 3;
+            auto l = h - 3;
+            for (int i = 1; i < 5; ++i) {
+                h *= l;
+            }
+            const auto cmp2 = h * (h - 1), cmp3 = (h + 1) * (h - 1);
+            tuning::set_multiplication_memory_budget(1u);
+            BOOST_CHECK_EQUAL(h * (h - 1), cmp2);
+            BOOST_CHECK_EQUAL((h + 1) * (h - 1), cmp3);
+            BOOST_CHECK_EQUAL((h + 1) * (h - 1), h * h - 1);
+            BOOST_CHECK_EQUAL((h - h) * h, pt1{});
+            tuning::reset_multiplication_memory_budget();
+        }
+        {
+            pt2 x("x"), y("y"), z("z");
+            auto f = 1 / 3_q + x / 2 + y + z * 2 / 5;
+            auto tmp = f;
+            for (int i = 1; i < 12; ++i) {
+                f *= tmp;
+            }
+            const auto cmp = f * (f - x);
+            tuning::set_multiplication_memory_budget(1u);
+            BOOST_CHECK_EQUAL(f * (f - x), cmp);
+            tuning::reset_multiplication_memory_budget();
+        }
+    }
+    tuning::reset_estimate_threshold();
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_load_balance_test)
+{
+    // Check the sparse Kronecker multiplication on operands whose products are clustered in a few regions
+    // of the output table, and the load balance statistics.
+    using pt1 = polynomial<integer, k_monomial>;
+    settings::set_min_work_per_thread(1u);
+    tuning::set_dense_multiplication_ratio(0u);
+    pt1 x("x"), y("y"), z("z"), t("t");
+    auto f = 1 + x + y + z;
+    auto tmp = f;
+    for (int i = 1; i < 8; ++i) {
+        f *= tmp;
+    }
+    // A few isolated terms far away from the bulk of the products.
+    f += t.pow(100) + t.pow(200) * x + t.pow(300) * y * z;
+    const auto g = f - 2 * x;
+    settings::set_n_threads(1u);
+    const auto cmp = f * g;
+    {
+        series_multiplier<pt1> sm(f, g);
+        BOOST_CHECK_EQUAL(sm(), cmp);
+        BOOST_CHECK(sm._get_load_balance().empty());
+    }
+    for (unsigned nt = 2u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        series_multiplier<pt1> sm(f, g);
+        BOOST_CHECK(sm._get_load_balance().empty());
+        BOOST_CHECK_EQUAL(sm(), cmp);
+        const auto lb = sm._get_load_balance();
+        BOOST_CHECK_EQUAL(lb.size(), nt);
+        for (const auto &p : lb) {
+            BOOST_CHECK(p.first >= 0.);
+            BOOST_CHECK(p.second >= 0.);
+        }
+        BOOST_CHECK_EQUAL(f * g, cmp);
+        BOOST_CHECK_EQUAL(f * g - g * f, 0);
+    }
+    tuning::reset_dense_multiplication_ratio();
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_out_of_core_test)
+{
+    // Check that the partitions of the out-of-core multiplication are disjoint, sorted by Kronecker code and
+    // that they add up to the product.
+    using pt1 = polynomial<integer, k_monomial>;
+    using pt2 = polynomial<rational, k_monomial>;
+    pt1 x("x"), y("y"), z("z"), t("t");
+    auto f = 1 + x + y + z + t;
+    auto tmp = f;
+    for (int i = 1; i < 8; ++i) {
+        f *= tmp;
+    }
+    f += x.pow(-4) * t.pow(100);
+    const auto g = f - 2 * x + 1, cmp = f * g;
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        for (auto budget : {0ull, 10000ull, 1000000ull}) {
+            series_multiplier<pt1> sm(f, g);
+            pt1 res;
+            std::size_t n_parts = 0u;
+            bool first = true;
+            decltype(f._container().begin()->m_key.get_int()) prev_max = 0;
+            sm._out_of_core_multiplication(
+                [&](pt1 &&part) {
+                    ++n_parts;
+                    BOOST_CHECK(part.get_symbol_set() == cmp.get_symbol_set());
+                    if (part.empty()) {
+                        return;
+                    }
+                    auto mm = std::minmax_element(part._container().begin(), part._container().end(),
+                                                  [](const pt1::term_type &t1, const pt1::term_type &t2) {
+                                                      return t1.m_key.get_int() < t2.m_key.get_int();
+                                                  });
+                    BOOST_CHECK(first || mm.first->m_key.get_int() > prev_max);
+                    first = false;
+                    prev_max = mm.second->m_key.get_int();
+                    const auto old_size = res.size();
+                    res += part;
+                    BOOST_CHECK_EQUAL(res.size(), old_size + part.size());
+                },
+                budget);
+            BOOST_CHECK_EQUAL(res, cmp);
+            BOOST_CHECK_EQUAL(n_parts % nt, 0u);
+            if (budget == 10000u) {
+                BOOST_CHECK(n_parts > nt);
+            }
+        }
+        // Empty operand.
+        pt1 e;
+        e.set_symbol_set(f.get_symbol_set());
+        series_multiplier<pt1> sm(f, e);
+        sm._out_of_core_multiplication([](pt1 &&) { BOOST_CHECK(false); }, 1000u);
+        // Cancellations.
+        pt2 a("a"), b("b");
+        const auto h = piranha::pow(a / 3 + b, 10), l = piranha::pow(a / 3 - b, 10);
+        series_multiplier<pt2> sm2(h, l);
+        pt2 res2;
+        sm2._out_of_core_multiplication([&res2](pt2 &&part) { res2 += part; }, 500u);
+        BOOST_CHECK_EQUAL(res2, h * l);
+        // Tiny budgets on small operands: the number of partitions is capped by the number of
+        // term-by-term multiplications.
+        auto check_tiny = [](const pt1 &p1, const pt1 &p2) {
+            series_multiplier<pt1> sm3(p1, p2);
+            pt1 res3;
+            std::size_t n_parts3 = 0u;
+            sm3._out_of_core_multiplication(
+                [&res3, &n_parts3](pt1 &&part) {
+                    ++n_parts3;
+                    res3 += part;
+                },
+                1u);
+            BOOST_CHECK_EQUAL(res3, p1 * p2);
+            BOOST_CHECK(n_parts3 >= 1u);
+            BOOST_CHECK(n_parts3 <= p1.size() * p2.size());
+        };
+        check_tiny(x + y - y, y + x - x);
+        check_tiny(1 + x + y - y, 1 + y + x - x);
+        check_tiny(1 + x, 1 + x);
+    }
+    settings::reset_n_threads();
+}
@@ -39,8 +39,11 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/monomial.hpp>
 #include <piranha/rational.hpp>
+#include <piranha/math/pow.hpp>
 #include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
+#include <piranha/tuning.hpp>
 
 using namespace piranha;
 
@@ -190,3 +193,33 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_truncated_test)
     BOOST_CHECK((!has_truncated_multiplication<polynomial<short, k_monomial>>()));
     BOOST_CHECK((!has_truncated_multiplication<polynomial<char, k_monomial>>()));
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_kronecker_truncated_test)
+{
+    // Check the truncated Kronecker multiplication against the truncation of the untruncated product,
+    // in the single-threaded and multi-threaded cases and with and without size estimation.
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    const auto f = piranha::pow(1 + x + y - 2 * z, 8), g = piranha::pow(1 - x + 3 * y + z + t, 7);
+    const auto fg = p_type::untruncated_multiplication(f, g);
+    const symbol_fset xz{"x", "z"};
+    for (unsigned long e_thr : {1ul, 1000ul}) {
+        tuning::set_estimate_threshold(e_thr);
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            for (int d : {-1, 0, 1, 5, 10, 14, 15, 20}) {
+                BOOST_CHECK_EQUAL(p_type::truncated_multiplication(f, g, d), fg.truncate_degree(d));
+                BOOST_CHECK_EQUAL(p_type::truncated_multiplication(g, f, d), fg.truncate_degree(d));
+                BOOST_CHECK_EQUAL(p_type::truncated_multiplication(f, g, d, xz), fg.truncate_degree(d, xz));
+                BOOST_CHECK_EQUAL(p_type::truncated_multiplication(g, f, d, xz), fg.truncate_degree(d, xz));
+            }
+            p_type::set_auto_truncate_degree(9);
+            BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(9));
+            p_type::set_auto_truncate_degree(3, {"y"});
+            BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(3, symbol_fset{"y"}));
+            p_type::unset_auto_truncate_degree();
+        }
+    }
+    settings::reset_n_threads();
+    tuning::reset_estimate_threshold();
+}
@@ -0,0 +1,188 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/profiler.hpp>
+
+#define BOOST_TEST_MODULE profiler_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
+
+using namespace piranha;
+
+using p_type = polynomial<integer, k_monomial>;
+
+// Check if an event with the given name was recorded.
+static bool has_event(const std::string &name)
+{
+    const auto ev = profiler::get_events();
+    return std::any_of(ev.begin(), ev.end(), [&name](const profiler::event &e) { return e.name == name; });
+}
+
+BOOST_AUTO_TEST_CASE(profiler_basic_test)
+{
+    BOOST_CHECK(!profiler::is_enabled());
+    // Nothing is recorded while disabled.
+    {
+        profiler::scope s("foo");
+        s.count("bar", 1u);
+        BOOST_CHECK(!s.active());
+    }
+    profiler::add_counter("baz");
+    BOOST_CHECK(profiler::get_events().empty());
+    BOOST_CHECK(profiler::get_counters().empty());
+    profiler::enable();
+    BOOST_CHECK(profiler::is_enabled());
+    {
+        profiler::scope s("foo");
+        BOOST_CHECK(s.active());
+        s.count("bar", 42u);
+    }
+    std::thread t([]() {
+        profiler::scope s("thread");
+        profiler::add_counter("baz", 2u);
+    });
+    t.join();
+    profiler::add_counter("baz");
+    auto ev = profiler::get_events();
+    BOOST_CHECK_EQUAL(ev.size(), 2u);
+    BOOST_CHECK_EQUAL(ev[0].name, "foo");
+    BOOST_CHECK_EQUAL(ev[0].counts.size(), 1u);
+    BOOST_CHECK_EQUAL(ev[0].counts[0].first, "bar");
+    BOOST_CHECK_EQUAL(ev[0].counts[0].second, 42u);
+    BOOST_CHECK(ev[0].wall >= 0.);
+    BOOST_CHECK(ev[0].start >= 0.);
+    BOOST_CHECK_EQUAL(ev[1].name, "thread");
+    BOOST_CHECK(ev[0].thread != ev[1].thread);
+    BOOST_CHECK_EQUAL(profiler::get_counters()["baz"], 3u);
+    // A scope created while disabled is not recorded even if the profiler is enabled in the meantime.
+    profiler::disable();
+    {
+        profiler::scope s("late");
+        profiler::enable();
+    }
+    BOOST_CHECK(!has_event("late"));
+    // Data is preserved when disabling.
+    profiler::disable();
+    BOOST_CHECK_EQUAL(profiler::get_events().size(), 2u);
+    profiler::reset();
+    BOOST_CHECK(profiler::get_events().empty());
+    BOOST_CHECK(profiler::get_counters().empty());
+}
+
+BOOST_AUTO_TEST_CASE(profiler_series_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    auto f = 1 + x + y + z;
+    for (int i = 0; i < 6; ++i) {
+        f *= 1 + x + y + z;
+    }
+    profiler::enable();
+    for (unsigned nt = 1u; nt <= 2u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        auto g = f * (f + 1);
+        g = g + f - x;
+        g = g.pow(2);
+        g = g.subs<p_type>({{"x", y}});
+        (void)g;
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+    profiler::disable();
+    BOOST_CHECK(has_event("series.mul"));
+    BOOST_CHECK(has_event("series.add"));
+    BOOST_CHECK(has_event("series.sub"));
+    BOOST_CHECK(has_event("series.pow"));
+    BOOST_CHECK(has_event("series.subs"));
+    BOOST_CHECK(has_event("multiplication.setup"));
+    BOOST_CHECK(has_event("multiplication.bounds"));
+    BOOST_CHECK(has_event("multiplication.finalise"));
+    BOOST_CHECK(profiler::get_counters()["hash_set.rehash"] > 0u);
+    for (const auto &e : profiler::get_events()) {
+        if (e.name == "series.mul") {
+            BOOST_CHECK_EQUAL(e.counts.size(), 2u);
+        }
+    }
+    profiler::reset();
+}
+
+BOOST_AUTO_TEST_CASE(profiler_chrome_trace_test)
+{
+    BOOST_CHECK_EQUAL(profiler::to_chrome_trace(), "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+    profiler::enable();
+    {
+        profiler::scope s("a\"b\\c\n");
+        s.count("n", 3u);
+    }
+    profiler::add_counter("cnt", 5u);
+    profiler::disable();
+    const auto trace = profiler::to_chrome_trace();
+    BOOST_CHECK(trace.find("\"name\":\"a\\\"b\\\\c\\u000a\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"n\":3") != std::string::npos);
+    BOOST_CHECK(trace.find("\"ph\":\"C\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"cnt\":5") != std::string::npos);
+    const std::string filename = "profiler_test_trace.json";
+    profiler::save_chrome_trace(filename);
+    {
+        std::ifstream ifile(filename);
+        const std::string content{std::istreambuf_iterator<char>(ifile), std::istreambuf_iterator<char>()};
+        BOOST_CHECK_EQUAL(content, trace);
+    }
+    std::remove(filename.c_str());
+    BOOST_CHECK_THROW(profiler::save_chrome_trace("/this/path/does/not/exist/trace.json"), std::runtime_error);
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    // s11n instrumentation.
+    profiler::reset();
+    profiler::enable();
+    const std::string s11n_file = "profiler_test_s11n.boostb";
+    const p_type x{"x"};
+    save_file(x + 1, s11n_file, data_format::boost_binary, compression::none);
+    p_type tmp;
+    load_file(tmp, s11n_file, data_format::boost_binary, compression::none);
+    std::remove(s11n_file.c_str());
+    profiler::disable();
+    BOOST_CHECK_EQUAL(tmp, x + 1);
+    BOOST_CHECK(has_event("s11n.save_file"));
+    BOOST_CHECK(has_event("s11n.load_file"));
+#endif
+    profiler::reset();
+}
@@ -1018,7 +1018,7 @@ static const std::vector<data_format> dfs = {data_format::boost_binary, data_for
                                              data_format::msgpack_binary, data_format::msgpack_portable};
 
 static const std::vector<compression> cfs
-    = {compression::none, compression::bzip2, compression::zlib, compression::gzip};
+    = {compression::none, compression::bzip2, compression::zlib, compression::gzip, compression::zstd};
 
 template <typename T>
 static inline T save_roundtrip(const T &x, data_format f, compression c)
@@ -1043,7 +1043,7 @@ struct int_save_load_tester {
                     for (auto c : cfs) {
                         const auto tmp = dist(eng);
 #if defined(PIRANHA_WITH_BOOST_S11N) && defined(PIRANHA_WITH_MSGPACK) && defined(PIRANHA_WITH_ZLIB)                    \
-    && defined(PIRANHA_WITH_BZIP2)
+    && defined(PIRANHA_WITH_BZIP2) && defined(PIRANHA_WITH_ZSTD)
                         // NOTE: we are not expecting any failure if we have all optional deps.
                         auto cmp = save_roundtrip(tmp, f, c);
                         if (cmp != tmp) {
@@ -1099,7 +1099,7 @@ struct fp_save_load_tester {
                     for (auto c : cfs) {
                         const auto tmp = dist(eng);
 #if defined(PIRANHA_WITH_BOOST_S11N) && defined(PIRANHA_WITH_MSGPACK) && defined(PIRANHA_WITH_ZLIB)                    \
-    && defined(PIRANHA_WITH_BZIP2)
+    && defined(PIRANHA_WITH_BZIP2) && defined(PIRANHA_WITH_ZSTD)
                         auto cmp = save_roundtrip(tmp, f, c);
                         if (cmp != tmp) {
                             status.store(false);
@@ -1174,7 +1174,7 @@ static inline void string_save_load_tester()
                     std::generate_n(achar.begin(), s, gen);
                     std::string str(achar.begin(), achar.begin() + s);
 #if defined(PIRANHA_WITH_BOOST_S11N) && defined(PIRANHA_WITH_MSGPACK) && defined(PIRANHA_WITH_ZLIB)                    \
-    && defined(PIRANHA_WITH_BZIP2)
+    && defined(PIRANHA_WITH_BZIP2) && defined(PIRANHA_WITH_ZSTD)
                     // NOTE: we are not expecting any failure if we have all optional deps.
                     auto cmp = save_roundtrip(str, f, c);
                     if (cmp != str) {
@@ -1234,26 +1234,30 @@ BOOST_AUTO_TEST_CASE(s11n_test_get_cdf_from_filename)
                 == std::make_pair(compression::zlib, data_format::msgpack_binary));
     BOOST_CHECK(get_cdf_from_filename("foo.mpackp.zip")
                 == std::make_pair(compression::zlib, data_format::msgpack_portable));
+    BOOST_CHECK(get_cdf_from_filename("foo.boostb.zst")
+                == std::make_pair(compression::zstd, data_format::boost_binary));
+    BOOST_CHECK(get_cdf_from_filename("foo.mpackp.zst")
+                == std::make_pair(compression::zstd, data_format::msgpack_portable));
     BOOST_CHECK(get_cdf_from_filename("foo.bz2.boostb")
                 == std::make_pair(compression::none, data_format::boost_binary));
     BOOST_CHECK_EXCEPTION(get_cdf_from_filename("foo"), std::invalid_argument, [](const std::invalid_argument &iae) {
         return boost::contains(iae.what(), "unable to deduce the data format from the filename 'foo'. The filename "
                                            "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
-                                           "optionally followed by one of ['.bz2','gz','zip'].");
+                                           "optionally followed by one of ['.bz2','gz','zip','zst'].");
     });
     BOOST_CHECK_EXCEPTION(
         get_cdf_from_filename("foo.bz2"), std::invalid_argument, [](const std::invalid_argument &iae) {
             return boost::contains(iae.what(),
                                    "unable to deduce the data format from the filename 'foo.bz2'. The filename "
                                    "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
-                                   "optionally followed by one of ['.bz2','gz','zip'].");
+                                   "optionally followed by one of ['.bz2','gz','zip','zst'].");
         });
     BOOST_CHECK_EXCEPTION(
         get_cdf_from_filename("foo.mpackb.bz2.bz2"), std::invalid_argument, [](const std::invalid_argument &iae) {
             return boost::contains(
                 iae.what(), "unable to deduce the data format from the filename 'foo.mpackb.bz2.bz2'. The filename "
                             "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
-                            "optionally followed by one of ['.bz2','gz','zip'].");
+                            "optionally followed by one of ['.bz2','gz','zip','zst'].");
         });
 }
 
@@ -1263,7 +1267,7 @@ BOOST_AUTO_TEST_CASE(s11n_test_save_load)
     tuple_for_each(fp_types{}, fp_save_load_tester{});
     string_save_load_tester();
 #if defined(PIRANHA_WITH_BOOST_S11N) && defined(PIRANHA_WITH_MSGPACK) && defined(PIRANHA_WITH_ZLIB)                    \
-    && defined(PIRANHA_WITH_BZIP2)
+    && defined(PIRANHA_WITH_BZIP2) && defined(PIRANHA_WITH_ZSTD)
     // Test failures.
     for (auto f : dfs) {
         for (auto c : cfs) {
@@ -48,7 +48,9 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/monomial.hpp>
 #include <piranha/rational.hpp>
 #include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 using namespace piranha;
@@ -508,6 +510,50 @@ BOOST_AUTO_TEST_CASE(series_merge_terms_test)
     tuple_for_each(cf_types{}, merge_terms_tester());
 }
 
+BOOST_AUTO_TEST_CASE(series_parallel_merge_terms_test)
+{
+    using series_type = g_series_type<integer, unsigned>;
+    using term_type = series_type::term_type;
+    using key_type = term_type::key_type;
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        series_type a{"x"}, b{"x"};
+        for (unsigned i = 2u; i < 2000u; ++i) {
+            a.insert(term_type(integer(i), key_type{i}));
+            // Half of the overlapping terms cancel out.
+            b.insert(term_type(i % 2u ? integer(i) + 500 : -(integer(i) + 500), key_type{i + 500u}));
+        }
+        // Compute the reference results serially.
+        const auto add = a + b, sub = a - b, rsub = b - a, dbl = a + a;
+        BOOST_CHECK(add.size() < a.size() + b.size());
+        BOOST_CHECK(sub.size() < a.size() + b.size());
+        tuning::set_parallel_merge_threshold(1u);
+        BOOST_CHECK_EQUAL(a + b, add);
+        BOOST_CHECK_EQUAL(a - b, sub);
+        BOOST_CHECK_EQUAL(b - a, rsub);
+        BOOST_CHECK_EQUAL(a + a, dbl);
+        BOOST_CHECK_EQUAL(a - a, 0);
+        // Move variants.
+        auto tmp_a(a), tmp_b(b);
+        BOOST_CHECK_EQUAL(std::move(tmp_a) + std::move(tmp_b), add);
+        tmp_a = a;
+        tmp_b = b;
+        tmp_a -= std::move(tmp_b);
+        BOOST_CHECK_EQUAL(tmp_a, sub);
+        tmp_a = a;
+        tmp_a += a;
+        BOOST_CHECK_EQUAL(tmp_a, dbl);
+        // Merge into an empty series.
+        series_type c;
+        c += a;
+        BOOST_CHECK_EQUAL(c, a);
+        tuning::reset_parallel_merge_threshold();
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
 struct merge_arguments_tag {
 };
 
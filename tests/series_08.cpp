@@ -33,13 +33,16 @@ see https://www.gnu.org/licenses/. */
 
 #include <boost/lexical_cast.hpp>
 #include <initializer_list>
+#include <iterator>
 #include <limits>
+#include <list>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <mp++/config.hpp>
 #include <mp++/exceptions.hpp>
@@ -532,3 +535,97 @@ BOOST_AUTO_TEST_CASE(series_pow_test)
     p_type3::clear_pow_cache();
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(series_pow_cache_test)
+{
+    using p_type = g_series_type<integer, int>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto f = x + y + 1, g = x - z + 2;
+    p_type::clear_pow_cache();
+    settings::reset_pow_cache_stats();
+    // Misses and hits.
+    const auto f5 = f.pow(5);
+    BOOST_CHECK_EQUAL(f5, f * f * f * f * f);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses(), 1u);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_hits(), 0u);
+    BOOST_CHECK_EQUAL(f.pow(3), f * f * f);
+    BOOST_CHECK_EQUAL(f.pow(5), f5);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses(), 1u);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_hits(), 2u);
+    BOOST_CHECK_EQUAL(f.pow(6), f5 * f);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses(), 2u);
+    // Single-coefficient series and zero exponents do not touch the cache.
+    BOOST_CHECK_EQUAL(p_type{3}.pow(2), 9);
+    BOOST_CHECK_EQUAL(f.pow(0), 1);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses() + settings::get_pow_cache_hits(), 4u);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_evictions(), 0u);
+    // Eviction: with a tiny budget, the entries are dropped as soon as they are computed.
+    settings::set_pow_cache_memory_budget(1u);
+    BOOST_CHECK_EQUAL(g.pow(4), g * g * g * g);
+    BOOST_CHECK(settings::get_pow_cache_evictions() >= 1u);
+    const auto misses = settings::get_pow_cache_misses();
+    BOOST_CHECK_EQUAL(g.pow(4), g * g * g * g);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses(), misses + 1u);
+    settings::reset_pow_cache_memory_budget();
+    // Concurrent exponentiation of different and identical bases.
+    p_type::clear_pow_cache();
+    const auto f8 = f5 * f * f * f, g8 = g * g * g * g * g * g * g * g;
+    std::vector<std::thread> threads;
+    std::vector<p_type> res(8u);
+    for (unsigned i = 0u; i < 8u; ++i) {
+        threads.emplace_back([i, &res, &f, &g]() {
+            for (int j = 0; j < 10; ++j) {
+                res[i] = (i % 2u ? f : g).pow(8 + j % 3);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (unsigned i = 0u; i < 8u; ++i) {
+        BOOST_CHECK_EQUAL(res[i], i % 2u ? f8 : g8);
+    }
+    p_type::clear_pow_cache();
+    settings::reset_pow_cache_stats();
+}
+
+BOOST_AUTO_TEST_CASE(series_nary_sum_product_test)
+{
+    using p_type = g_series_type<integer, int>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    // Empty ranges.
+    std::vector<p_type> v;
+    BOOST_CHECK_EQUAL(piranha::sum(v), p_type{});
+    BOOST_CHECK_EQUAL(piranha::product(v), p_type{1});
+    BOOST_CHECK((std::is_same<decltype(piranha::sum(v)), p_type>::value));
+    BOOST_CHECK((std::is_same<decltype(piranha::product(v.begin(), v.end())), p_type>::value));
+    // Single element.
+    v.push_back(x + 1);
+    BOOST_CHECK_EQUAL(piranha::sum(v), x + 1);
+    BOOST_CHECK_EQUAL(piranha::product(v), x + 1);
+    // Operands with different symbol sets.
+    v.push_back(y - x);
+    v.push_back(z + y + 3);
+    v.push_back(x * y);
+    BOOST_CHECK_EQUAL(piranha::sum(v), x + 1 + y - x + z + y + 3 + x * y);
+    BOOST_CHECK(piranha::sum(v).get_symbol_set() == (symbol_fset{"x", "y", "z"}));
+    BOOST_CHECK_EQUAL(piranha::product(v), (x + 1) * (y - x) * (z + y + 3) * (x * y));
+    // Cancellations.
+    v.push_back(-x * y);
+    BOOST_CHECK_EQUAL(piranha::sum(v), 2 * y + z + 4);
+    // Zero factor.
+    v.push_back(p_type{});
+    BOOST_CHECK_EQUAL(piranha::product(v), p_type{});
+    BOOST_CHECK(piranha::product(v).get_symbol_set() == (symbol_fset{"x", "y", "z"}));
+    // Other containers and iterator ranges.
+    std::list<p_type> l{x + y, x - y, z, 2 * x};
+    BOOST_CHECK_EQUAL(piranha::product(l), 2 * x * z * (x * x - y * y));
+    BOOST_CHECK_EQUAL(piranha::sum(l.begin(), std::next(l.begin(), 2)), 2 * x);
+    const p_type arr[] = {x, y, z};
+    BOOST_CHECK_EQUAL(piranha::sum(arr), x + y + z);
+    BOOST_CHECK_EQUAL(piranha::product(arr), x * y * z);
+    // Many factors.
+    std::vector<p_type> w(10u, x + y + 1);
+    BOOST_CHECK_EQUAL(piranha::product(w), (x + y + 1).pow(10));
+    BOOST_CHECK_EQUAL(piranha::sum(w), 10 * (x + y + 1));
+}
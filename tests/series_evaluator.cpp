@@ -0,0 +1,156 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/series_evaluator.hpp>
+
+#define BOOST_TEST_MODULE series_evaluator_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+// Number of points for the batch evaluation tests, spanning multiple blocks.
+static const int n_points = 130;
+
+template <typename P>
+static inline void check_eval_d(const series_evaluator<P> &ev, const P &p)
+{
+    const symbol_fmap<double> dict_d{{"x", 1.1}, {"y", .3}, {"z", .7}};
+    const auto res_d = ev(dict_d), cmp_d = math::evaluate(p, dict_d);
+    BOOST_CHECK(std::abs(res_d - cmp_d) <= 1E-12 * std::abs(cmp_d));
+    BOOST_CHECK_THROW(ev(symbol_fmap<double>{{"x", 1.}}), std::invalid_argument);
+    // Batch evaluation.
+    symbol_fmap<std::vector<double>> bdict{{"x", {}}, {"y", {}}, {"z", {}}};
+    for (int i = 0; i < n_points; ++i) {
+        bdict["x"].push_back(1. + i / 100.);
+        bdict["y"].push_back(.3 + i / 200.);
+        bdict["z"].push_back(.7 - i / 300.);
+    }
+    const auto res_b = ev.batch(bdict);
+    BOOST_CHECK_EQUAL(res_b.size(), static_cast<decltype(res_b.size())>(n_points));
+    for (int i = 0; i < n_points; ++i) {
+        const auto cmp = math::evaluate(p, symbol_fmap<double>{{"x", bdict["x"][static_cast<unsigned>(i)]},
+                                                               {"y", bdict["y"][static_cast<unsigned>(i)]},
+                                                               {"z", bdict["z"][static_cast<unsigned>(i)]}});
+        BOOST_CHECK(std::abs(res_b[static_cast<unsigned>(i)] - cmp) <= 1E-12 * std::abs(cmp));
+    }
+    BOOST_CHECK(ev.batch(symbol_fmap<std::vector<double>>{{"x", {}}, {"y", {}}, {"z", {}}}).empty());
+    BOOST_CHECK_THROW(ev.batch(symbol_fmap<std::vector<double>>{}), std::invalid_argument);
+    BOOST_CHECK_THROW(ev.batch(symbol_fmap<std::vector<double>>{{"x", {1.}}, {"y", {1., 2.}}, {"z", {1.}}}),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(ev.batch(symbol_fmap<std::vector<double>>{{"x", {1.}}, {"y", {1.}}}), std::invalid_argument);
+}
+
+template <typename P>
+static inline void check_eval(const P &p)
+{
+    series_evaluator<P> ev(p);
+    BOOST_CHECK_EQUAL(ev.size(), p.size());
+    const symbol_fmap<rational> dict_q{{"x", 1 / 3_q}, {"y", -2_q}, {"z", 5 / 7_q}};
+    BOOST_CHECK_EQUAL(ev(dict_q), math::evaluate(p, dict_q));
+    const symbol_fmap<rational> dict_q2{{"x", -7 / 3_q}, {"y", 1_q}, {"z", 3_q}};
+    BOOST_CHECK_EQUAL(ev(dict_q2), math::evaluate(p, dict_q2));
+    BOOST_CHECK_THROW(ev(symbol_fmap<rational>{{"x", 1_q}}), std::invalid_argument);
+    // Batch evaluation, with exact results.
+    symbol_fmap<std::vector<rational>> bdict{{"x", {}}, {"y", {}}, {"z", {}}};
+    for (int i = 0; i < n_points; ++i) {
+        bdict["x"].push_back(rational{i + 1, i + 3});
+        bdict["y"].push_back(rational{i - 20, 7} + 1 / 11_q);
+        bdict["z"].push_back(rational{-i, i + 2});
+    }
+    const auto res_b = ev.batch(bdict);
+    BOOST_CHECK_EQUAL(res_b.size(), static_cast<decltype(res_b.size())>(n_points));
+    for (int i = 0; i < n_points; ++i) {
+        BOOST_CHECK_EQUAL(res_b[static_cast<unsigned>(i)],
+                          math::evaluate(p, symbol_fmap<rational>{{"x", bdict["x"][static_cast<unsigned>(i)]},
+                                                                  {"y", bdict["y"][static_cast<unsigned>(i)]},
+                                                                  {"z", bdict["z"][static_cast<unsigned>(i)]}}));
+    }
+    check_eval_d(ev, p);
+}
+
+BOOST_AUTO_TEST_CASE(series_evaluator_test)
+{
+    // Empty series.
+    {
+        using p_type = polynomial<integer, kronecker_monomial<>>;
+        series_evaluator<p_type> ev{p_type{}};
+        BOOST_CHECK_EQUAL(ev.size(), 0u);
+        BOOST_CHECK_EQUAL(ev(symbol_fmap<integer>{}), 0);
+        BOOST_CHECK_EQUAL(series_evaluator<p_type>{p_type{1}}(symbol_fmap<integer>{}), 1);
+        BOOST_CHECK(ev.batch(symbol_fmap<std::vector<integer>>{{"x", {1_z, 2_z}}}) == std::vector<integer>(2u));
+        BOOST_CHECK(series_evaluator<p_type>{p_type{1}}.batch(symbol_fmap<std::vector<integer>>{{"x", {1_z, 2_z}}})
+                    == std::vector<integer>(2u, 1_z));
+    }
+    // Run the checks both in single-threaded mode and forcing the use of multiple threads.
+    for (auto mt : {false, true}) {
+        if (mt) {
+            settings::set_n_threads(4u);
+            settings::set_min_work_per_thread(1u);
+        }
+        {
+            // Kronecker monomials.
+            using p_type = polynomial<integer, kronecker_monomial<>>;
+            p_type x{"x"}, y{"y"}, z{"z"};
+            check_eval(piranha::pow(1 + x - 2 * y + 3 * z, 10));
+            check_eval(piranha::pow(1 + x - 2 * y + 3 * z, 10) * y * y + z);
+        }
+        {
+            // Monomials with negative exponents.
+            using p_type = polynomial<rational, monomial<int>>;
+            p_type x{"x"}, y{"y"}, z{"z"};
+            check_eval(piranha::pow(x / 2 + 1 / 3_q * y - z + 1, 8) * piranha::pow(x, -3));
+            // Wide exponent range: the powers are computed on the fly.
+            check_eval(piranha::pow(x, 1000) + piranha::pow(y, -500) * z + 1);
+        }
+        {
+            // Rational exponents: no power tables.
+            using p_type = polynomial<rational, monomial<rational>>;
+            p_type x{"x"}, y{"y"}, z{"z"};
+            const auto p = piranha::pow(x + y + z + 1, 6) * x * y;
+            series_evaluator<p_type> ev(p);
+            check_eval_d(ev, p);
+        }
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
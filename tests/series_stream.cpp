@@ -0,0 +1,313 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+
+#include <piranha/series_stream.hpp>
+
+#define BOOST_TEST_MODULE series_stream_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <piranha/config.hpp>
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <ios>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+static std::random_device rd;
+
+struct tmp_file {
+    tmp_file() : m_path(PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd())) {}
+    ~tmp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+    std::string m_path;
+};
+
+using p_type = polynomial<integer, kronecker_monomial<>>;
+using q_type = polynomial<rational, monomial<int>>;
+
+static const std::initializer_list<data_format> dfs = {data_format::msgpack_binary, data_format::msgpack_portable};
+
+static const std::initializer_list<compression> cfs
+    = {compression::none, compression::bzip2, compression::zlib, compression::gzip, compression::zstd};
+
+// Read all the terms from a reader into a series.
+template <typename T>
+static inline T read_all(series_reader<T> &r)
+{
+    T retval;
+    retval.set_symbol_set(r.get_symbol_set());
+    typename T::term_type t;
+    while (r.next(t)) {
+        retval.insert(t);
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(series_stream_roundtrip_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 12);
+    q_type a{"a"}, b{"b"};
+    const auto u = piranha::pow(a / 2 - b / 3 + 1, 10);
+    for (auto f : dfs) {
+        for (auto c : cfs) {
+            tmp_file file;
+            try {
+                save_file(s, file.m_path, f, c);
+            } catch (const not_implemented_error &) {
+                continue;
+            }
+            // Reading.
+            {
+                series_reader<p_type> r(file.m_path, f, c);
+                BOOST_CHECK(r.get_symbol_set() == s.get_symbol_set());
+                BOOST_CHECK_EQUAL(r.size(), s.size());
+                BOOST_CHECK_EQUAL(read_all(r), s);
+                typename p_type::term_type t;
+                BOOST_CHECK(!r.next(t));
+            }
+            // Writing, read back via load_file() and via the reader.
+            {
+                tmp_file out;
+                {
+                    series_writer<p_type> w(out.m_path, s.get_symbol_set(), f, c);
+                    w.write(s);
+                    BOOST_CHECK_EQUAL(w.size(), s.size());
+                    w.close();
+                    BOOST_CHECK_THROW(w.write(*s._container().begin()), std::invalid_argument);
+                }
+                p_type tmp;
+                load_file(tmp, out.m_path, f, c);
+                BOOST_CHECK_EQUAL(tmp, s);
+                series_reader<p_type> r(out.m_path, f, c);
+                BOOST_CHECK_EQUAL(read_all(r), s);
+            }
+            // Rational coefficients and monomials, written term by term and closed by the destructor.
+            {
+                tmp_file out;
+                {
+                    series_writer<q_type> w(out.m_path, u.get_symbol_set(), f, c);
+                    for (const auto &t : u._container()) {
+                        w.write(t);
+                    }
+                }
+                series_reader<q_type> r(out.m_path, f, c);
+                BOOST_CHECK_EQUAL(read_all(r), u);
+            }
+            // Empty series.
+            {
+                tmp_file out;
+                {
+                    series_writer<p_type> w(out.m_path, symbol_fset{"x", "y"}, f, c);
+                }
+                series_reader<p_type> r(out.m_path, f, c);
+                BOOST_CHECK(r.get_symbol_set() == (symbol_fset{"x", "y"}));
+                BOOST_CHECK_EQUAL(r.size(), 0u);
+                BOOST_CHECK_EQUAL(read_all(r), p_type{});
+            }
+        }
+    }
+    // Formats deduced from the file names.
+    tmp_file file;
+    const auto fname = file.m_path + ".mpackp";
+    {
+        series_writer<p_type> w(fname, s.get_symbol_set());
+        w.write(s);
+    }
+    series_reader<p_type> r(fname);
+    BOOST_CHECK_EQUAL(read_all(r), s);
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(series_stream_ops_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto s = piranha::pow(1 + x + 2 * y - 3 * z, 12);
+    tmp_file in;
+    save_file(s, in.m_path, data_format::msgpack_binary, compression::none);
+    // Filter.
+    {
+        tmp_file out;
+        {
+            series_reader<p_type> r(in.m_path, data_format::msgpack_binary, compression::none);
+            series_writer<p_type> w(out.m_path, r.get_symbol_set(), data_format::msgpack_binary, compression::none);
+            const auto n = stream_filter(r, w, [](const integer &cf, const k_monomial &) { return cf > 1000; });
+            w.close();
+            BOOST_CHECK_EQUAL(n, w.size());
+        }
+        p_type tmp;
+        load_file(tmp, out.m_path, data_format::msgpack_binary, compression::none);
+        BOOST_CHECK_EQUAL(tmp, s.filter([](const std::pair<integer, p_type> &p) { return p.first > 1000; }));
+    }
+    // Total and partial degree truncation.
+    {
+        tmp_file out;
+        {
+            series_reader<p_type> r(in.m_path, data_format::msgpack_binary, compression::none);
+            series_writer<p_type> w(out.m_path, r.get_symbol_set(), data_format::msgpack_binary, compression::none);
+            stream_truncate_degree(r, w, 5);
+        }
+        p_type tmp;
+        load_file(tmp, out.m_path, data_format::msgpack_binary, compression::none);
+        BOOST_CHECK_EQUAL(tmp, s.truncate_degree(5));
+    }
+    {
+        tmp_file out;
+        {
+            series_reader<p_type> r(in.m_path, data_format::msgpack_binary, compression::none);
+            series_writer<p_type> w(out.m_path, r.get_symbol_set(), data_format::msgpack_binary, compression::none);
+            stream_truncate_degree(r, w, 3, symbol_fset{"x", "z"});
+        }
+        p_type tmp;
+        load_file(tmp, out.m_path, data_format::msgpack_binary, compression::none);
+        BOOST_CHECK_EQUAL(tmp, s.truncate_degree(3, symbol_fset{"x", "z"}));
+    }
+    // Evaluation.
+    {
+        series_reader<p_type> r(in.m_path, data_format::msgpack_binary, compression::none);
+        const symbol_fmap<integer> dict{{"x", integer{2}}, {"y", integer{-3}}, {"z", integer{5}}};
+        BOOST_CHECK_EQUAL(stream_evaluate(r, dict), math::evaluate(s, dict));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(series_stream_error_test)
+{
+    p_type x{"x"}, y{"y"};
+    const auto s = piranha::pow(x - y + 1, 20);
+    tmp_file file;
+    BOOST_CHECK_THROW(series_reader<p_type>(PIRANHA_BINARY_TESTS_DIR "/nonexistent_series_stream",
+                                            data_format::msgpack_binary, compression::none),
+                      std::runtime_error);
+    BOOST_CHECK_THROW(series_reader<p_type>(file.m_path, data_format::boost_binary, compression::none),
+                      not_implemented_error);
+    BOOST_CHECK_THROW(series_writer<p_type>(file.m_path, symbol_fset{}, data_format::boost_portable, compression::none),
+                      not_implemented_error);
+    save_file(s, file.m_path, data_format::msgpack_portable, compression::none);
+    std::string content;
+    {
+        std::ifstream ifs(file.m_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    auto write = [&file](const std::string &str) {
+        std::ofstream ofs(file.m_path, std::ios::binary | std::ios::trunc);
+        ofs.write(str.data(), static_cast<std::streamsize>(str.size()));
+    };
+    // Truncated file.
+    write(content.substr(0u, content.size() - 1u));
+    {
+        series_reader<p_type> r(file.m_path, data_format::msgpack_portable, compression::none);
+        BOOST_CHECK_THROW(read_all(r), std::invalid_argument);
+    }
+    write(content.substr(0u, 1u));
+    BOOST_CHECK_THROW(series_reader<p_type>(file.m_path, data_format::msgpack_portable, compression::none),
+                      std::invalid_argument);
+    // Not an array.
+    write("\xc0");
+    BOOST_CHECK_THROW(series_reader<p_type>(file.m_path, data_format::msgpack_portable, compression::none),
+                      std::invalid_argument);
+    // Incompatible symbol sets.
+    write(content);
+    {
+        tmp_file out;
+        series_reader<p_type> r(file.m_path, data_format::msgpack_portable, compression::none);
+        series_writer<p_type> w(out.m_path, symbol_fset{"x"}, data_format::msgpack_portable, compression::none);
+        BOOST_CHECK_THROW(stream_truncate_degree(r, w, 2), std::invalid_argument);
+        BOOST_CHECK_THROW(w.write(s), std::invalid_argument);
+        BOOST_CHECK_EQUAL(w.size(), 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(series_stream_multiply_test)
+{
+    p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    const auto f = piranha::pow(1 + x + y + z, 6), g = piranha::pow(1 - x + t, 5) + x * y * z;
+    const auto cmp = f * g;
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        for (auto budget : {0ull, 5000ull, 50000ull}) {
+            tmp_file out;
+            {
+                series_writer<p_type> w(out.m_path, symbol_fset{"t", "x", "y", "z"}, data_format::msgpack_binary,
+                                        compression::none);
+                // The symbol sets are merged.
+                BOOST_CHECK_EQUAL(stream_multiply(f, g, w, budget), cmp.size());
+                BOOST_CHECK_EQUAL(w.size(), cmp.size());
+            }
+            p_type tmp;
+            load_file(tmp, out.m_path, data_format::msgpack_binary, compression::none);
+            BOOST_CHECK_EQUAL(tmp, cmp);
+        }
+    }
+    settings::reset_n_threads();
+    // Cancellations and empty operands.
+    {
+        tmp_file out;
+        {
+            series_writer<p_type> w(out.m_path, symbol_fset{"x", "y"}, data_format::msgpack_binary, compression::none);
+            BOOST_CHECK_EQUAL(stream_multiply(x - x, x + y, w, 1000u), 0u);
+            BOOST_CHECK_EQUAL(stream_multiply(x + y, x - y, w, 1u), 2u);
+        }
+        p_type tmp;
+        load_file(tmp, out.m_path, data_format::msgpack_binary, compression::none);
+        BOOST_CHECK_EQUAL(tmp, x * x - y * y);
+    }
+    // Mismatching symbol set.
+    tmp_file out;
+    series_writer<p_type> w(out.m_path, symbol_fset{"x", "y"}, data_format::msgpack_binary, compression::none);
+    BOOST_CHECK_THROW(stream_multiply(f, g, w), std::invalid_argument);
+    BOOST_CHECK_EQUAL(w.size(), 0u);
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(series_stream_empty_test) {}
+
+#endif
@@ -91,3 +91,19 @@ BOOST_AUTO_TEST_CASE(settings_min_work_per_thread_test)
     BOOST_CHECK_NO_THROW(settings::reset_min_work_per_thread());
     BOOST_CHECK_EQUAL(settings::get_min_work_per_thread(), def);
 }
+
+BOOST_AUTO_TEST_CASE(settings_pow_cache_test)
+{
+    const auto def = settings::get_pow_cache_memory_budget();
+    BOOST_CHECK(def > 0u);
+    BOOST_CHECK_NO_THROW(settings::set_pow_cache_memory_budget(0u));
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_memory_budget(), 0u);
+    BOOST_CHECK_NO_THROW(settings::set_pow_cache_memory_budget(1000u));
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_memory_budget(), 1000u);
+    BOOST_CHECK_NO_THROW(settings::reset_pow_cache_memory_budget());
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_memory_budget(), def);
+    BOOST_CHECK_NO_THROW(settings::reset_pow_cache_stats());
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_hits(), 0u);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_misses(), 0u);
+    BOOST_CHECK_EQUAL(settings::get_pow_cache_evictions(), 0u);
+}
@@ -40,6 +40,7 @@ see https://www.gnu.org/licenses/. */
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include <mp++/config.hpp>
 
@@ -61,6 +62,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/s11n.hpp>
 #include <piranha/series.hpp>
 #include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/term.hpp>
 
@@ -338,6 +340,61 @@ BOOST_AUTO_TEST_CASE(subs_series_subs_test)
     }
 }
 
+// Reference substitution computed without the bulk engine: the subs() method of each key is called directly,
+// and the products coefficient * value * key are accumulated.
+template <typename S, typename F,
+          typename R = decltype(std::declval<const S &>()
+                                * std::declval<const F &>()(std::declval<const typename S::term_type::key_type &>(),
+                                                            std::declval<const symbol_fset &>())[0u]
+                                      .first)>
+static inline R key_subs_reference(const S &f, const F &ksubs)
+{
+    R retval(0);
+    for (const auto &t : f._container()) {
+        for (auto &p : ksubs(t.m_key, f.get_symbol_set())) {
+            S tmp;
+            tmp.set_symbol_set(f.get_symbol_set());
+            tmp.insert(typename S::term_type(t.m_cf, std::move(p.second)));
+            retval += std::move(tmp) * std::move(p.first);
+        }
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(subs_series_bulk_subs_test)
+{
+    using stype0 = g_series_type<rational, monomial<int>>;
+    stype0 x{"x"}, y{"y"}, z{"z"};
+    const auto f = piranha::pow(x + y + z + 1, 8) + piranha::pow(x - 2 * y, 5) / 3;
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        // Substitution with series.
+        BOOST_CHECK_EQUAL(piranha::pow(x + y + z + 1, 8).subs<stype0>({{"y", x - z}}), piranha::pow(2 * x + 1, 8));
+        const symbol_fmap<stype0> d0{{"x", z + 1}, {"z", y - 1}};
+        const auto idx_d0 = sm_intersect_idx(f.get_symbol_set(), d0);
+        BOOST_CHECK_EQUAL(f.subs(d0), key_subs_reference(f, [&idx_d0](const monomial<int> &k, const symbol_fset &ss) {
+                              return k.subs(idx_d0, ss);
+                          }));
+        const symbol_fmap<stype0> d1{{"x", stype0{}}};
+        BOOST_CHECK_EQUAL(f.subs(d1), piranha::pow(y + z + 1, 8) - 32 * piranha::pow(y, 5) / 3);
+        // Substitution with scalars.
+        const symbol_fmap<rational> d2{{"x", 2 / 3_q}};
+        const auto idx_d2 = sm_intersect_idx(f.get_symbol_set(), d2);
+        BOOST_CHECK_EQUAL(f.subs(d2), key_subs_reference(f, [&idx_d2](const monomial<int> &k, const symbol_fset &ss) {
+                              return k.subs(idx_d2, ss);
+                          }));
+        const symbol_fmap<integer> d3{{"x", 2_z}, {"y", -1_z}, {"z", 3_z}};
+        BOOST_CHECK_EQUAL(f.subs(d3), 390625 + 1024 / 3_q);
+        // Symbols not in the series.
+        const symbol_fmap<integer> d4{{"t", 2_z}};
+        BOOST_CHECK_EQUAL(f.subs(d4), f);
+        BOOST_CHECK_EQUAL(stype0{}.subs(d4), 0);
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(subs_series_serialization_test)
@@ -62,6 +62,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/real.hpp>
 #endif
 #include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 
 using namespace piranha;
@@ -241,6 +242,63 @@ BOOST_AUTO_TEST_CASE(t_subs_series_t_subs_test)
     BOOST_CHECK((!has_t_subs<g_series_type<double, key02>, double, double>::value));
 }
 
+// Reference trigonometric substitution computed without the bulk engine: the t_subs() method of each key is
+// called directly, and the products coefficient * value * key are accumulated.
+template <typename S, typename F,
+          typename R = decltype(std::declval<const S &>()
+                                * std::declval<const F &>()(std::declval<const typename S::term_type::key_type &>(),
+                                                            std::declval<const symbol_fset &>())[0u]
+                                      .first)>
+static inline R key_subs_reference(const S &f, const F &ksubs)
+{
+    R retval(0);
+    for (const auto &t : f._container()) {
+        for (auto &p : ksubs(t.m_key, f.get_symbol_set())) {
+            S tmp;
+            tmp.set_symbol_set(f.get_symbol_set());
+            tmp.insert(typename S::term_type(t.m_cf, std::move(p.second)));
+            retval += std::move(tmp) * std::move(p.first);
+        }
+    }
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(t_subs_series_bulk_t_subs_test)
+{
+    typedef poisson_series<polynomial<rational, monomial<short>>> p_type1;
+    using k_type = p_type1::term_type::key_type;
+    p_type1 x{"x"}, y{"y"}, z{"z"}, c{"c"}, s{"s"};
+    p_type1 f;
+    for (int i = -5; i <= 5; ++i) {
+        for (int j = 0; j <= 4; ++j) {
+            f += (i + j + 1) * z * piranha::cos(i * x + j * y) + (i - j) * piranha::sin(i * x - j * y + z);
+        }
+    }
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        const auto &ss = f.get_symbol_set();
+        const auto cz = c - z, sz = s + z;
+        BOOST_CHECK_EQUAL(f.t_subs("x", c, s),
+                          key_subs_reference(f, [&ss, &c, &s](const k_type &k, const symbol_fset &args) {
+                              return k.t_subs(ss_index_of(ss, "x"), c, s, args);
+                          }));
+        BOOST_CHECK_EQUAL(f.t_subs("y", cz, sz),
+                          key_subs_reference(f, [&ss, &cz, &sz](const k_type &k, const symbol_fset &args) {
+                              return k.t_subs(ss_index_of(ss, "y"), cz, sz, args);
+                          }));
+        BOOST_CHECK_EQUAL(f.t_subs("x", 3 / 5_q, 4 / 5_q),
+                          key_subs_reference(f, [&ss](const k_type &k, const symbol_fset &args) {
+                              return k.t_subs(ss_index_of(ss, "x"), 3 / 5_q, 4 / 5_q, args);
+                          }));
+        BOOST_CHECK_EQUAL(f.t_subs("t", c, s), f);
+        BOOST_CHECK_EQUAL((piranha::pow(piranha::cos(x), 6) + piranha::pow(piranha::sin(x), 6)).t_subs("x", c, s),
+                          piranha::pow(c, 6) + piranha::pow(s, 6));
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(t_subs_series_serialization_test)
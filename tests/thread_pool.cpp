@@ -32,8 +32,10 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/predicate.hpp>
 #include <chrono>
+#include <cstddef>
 #include <limits>
 #include <list>
 #include <stdexcept>
@@ -419,3 +421,73 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
     BOOST_CHECK_EQUAL(f8.get(), 1u);
     BOOST_CHECK_THROW(f9.get(), std::invalid_argument);
 }
+
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_for_test)
+{
+    // Check that every index is processed exactly once, for various combinations of sizes, grains and threads.
+    for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+        thread_pool::resize(4u);
+        for (std::size_t size : {std::size_t(0u), std::size_t(1u), std::size_t(3u), std::size_t(100u),
+                                 std::size_t(1001u)}) {
+            for (std::size_t grain : {std::size_t(1u), std::size_t(7u), std::size_t(2000u)}) {
+                std::vector<std::atomic<unsigned>> hits(size);
+                for (auto &h : hits) {
+                    h.store(0u);
+                }
+                std::atomic<bool> bad_chunk(false);
+                thread_pool::parallel_for(n_threads, size, grain,
+                                          [&hits, &bad_chunk, n_threads, grain](const unsigned &t_idx,
+                                                                                const std::size_t &begin,
+                                                                                const std::size_t &end) {
+                                              if (t_idx >= n_threads || begin >= end || end - begin > grain) {
+                                                  bad_chunk.store(true);
+                                              }
+                                              for (auto i = begin; i != end; ++i) {
+                                                  ++hits[i];
+                                              }
+                                          });
+                BOOST_CHECK(!bad_chunk.load());
+                BOOST_CHECK(std::all_of(hits.begin(), hits.end(),
+                                        [](const std::atomic<unsigned> &h) { return h.load() == 1u; }));
+            }
+        }
+    }
+    // Unbalanced workload: the first thread gets all the expensive indices.
+    std::vector<std::atomic<unsigned>> hits(100u);
+    for (auto &h : hits) {
+        h.store(0u);
+    }
+    thread_pool::parallel_for(
+        4u, 100u, 1u, [&hits](const unsigned &, const std::size_t &begin, const std::size_t &end) {
+            for (auto i = begin; i != end; ++i) {
+                if (i < 25u) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                ++hits[i];
+            }
+        });
+    BOOST_CHECK(
+        std::all_of(hits.begin(), hits.end(), [](const std::atomic<unsigned> &h) { return h.load() == 1u; }));
+    // Error handling.
+    auto null_f = [](const unsigned &, const std::size_t &, const std::size_t &) {};
+    BOOST_CHECK_THROW(thread_pool::parallel_for(0u, 10u, 1u, null_f), std::invalid_argument);
+    BOOST_CHECK_THROW(thread_pool::parallel_for(2u, 10u, 0u, null_f), std::invalid_argument);
+    BOOST_CHECK_THROW(thread_pool::parallel_for(5u, 10u, 1u, null_f), std::invalid_argument);
+    for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+        BOOST_CHECK_THROW(thread_pool::parallel_for(n_threads, 100u, 3u,
+                                                    [](const unsigned &, const std::size_t &begin,
+                                                       const std::size_t &end) {
+                                                        if (begin <= 50u && 50u < end) {
+                                                            throw std::runtime_error("");
+                                                        }
+                                                    }),
+                          std::runtime_error);
+    }
+    // The pool is still usable after an exception.
+    std::atomic<std::size_t> count(0u);
+    thread_pool::parallel_for(4u, 100u, 3u,
+                              [&count](const unsigned &, const std::size_t &begin, const std::size_t &end) {
+                                  count += end - begin;
+                              });
+    BOOST_CHECK_EQUAL(count.load(), 100u);
+}
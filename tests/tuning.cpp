@@ -89,3 +89,54 @@ BOOST_AUTO_TEST_CASE(tuning_estimation_threshold_test)
     tuning::reset_estimate_threshold();
     BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 200u);
 }
+
+BOOST_AUTO_TEST_CASE(tuning_dense_multiplication_ratio_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_dense_multiplication_ratio(), 32u);
+    tuning::set_dense_multiplication_ratio(0u);
+    BOOST_CHECK_EQUAL(tuning::get_dense_multiplication_ratio(), 0u);
+    std::thread t1([]() noexcept {
+        while (tuning::get_dense_multiplication_ratio() != 64u) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_dense_multiplication_ratio(64u); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK_EQUAL(tuning::get_dense_multiplication_ratio(), 64u);
+    tuning::reset_dense_multiplication_ratio();
+    BOOST_CHECK_EQUAL(tuning::get_dense_multiplication_ratio(), 32u);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_multiplication_memory_budget_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_memory_budget(), 0u);
+    tuning::set_multiplication_memory_budget(1024u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_memory_budget(), 1024u);
+    std::thread t1([]() noexcept {
+        while (tuning::get_multiplication_memory_budget() != 2048u) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_multiplication_memory_budget(2048u); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_memory_budget(), 2048u);
+    tuning::reset_multiplication_memory_budget();
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_memory_budget(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_parallel_merge_threshold_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_parallel_merge_threshold(), 100000u);
+    tuning::set_parallel_merge_threshold(1000u);
+    BOOST_CHECK_EQUAL(tuning::get_parallel_merge_threshold(), 1000u);
+    std::thread t1([]() noexcept {
+        while (tuning::get_parallel_merge_threshold() != 2000u) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_parallel_merge_threshold(2000u); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK_EQUAL(tuning::get_parallel_merge_threshold(), 2000u);
+    tuning::reset_parallel_merge_threshold();
+    BOOST_CHECK_EQUAL(tuning::get_parallel_merge_threshold(), 100000u);
+}
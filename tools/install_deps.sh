@@ -18,7 +18,7 @@ export PATH="$HOME/miniconda/bin:$PATH"
 bash miniconda.sh -b -p $HOME/miniconda
 conda config --add channels conda-forge --force
 
-conda_pkgs="cmake boost-cpp bzip2 zlib msgpack-c mppp"
+conda_pkgs="cmake boost-cpp bzip2 zlib zstd msgpack-c mppp"
 
 if [[ "${TRAVIS_OS_NAME}" == "linux" ]]; then
     conda_pkgs="$conda_pkgs backtrace"